@@ -0,0 +1,136 @@
+//JsonUtil转义与逐字节转义对比, 负载为ASCII/UTF-8混合文本
+#include "bench_util.h"
+#include "sylar/util/json_util.h"
+#include <random>
+#include <string>
+
+using namespace sylar::bench;
+
+//逐字节判断并追加的朴素实现, 作为对照
+static void NaiveEscapeAppend(std::string &out, const std::string &v)
+{
+    static const char s_hex[] = "0123456789abcdef";
+    for (unsigned char c : v)
+    {
+        switch (c)
+        {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\b':
+            out += "\\b";
+            break;
+        case '\f':
+            out += "\\f";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+            if (c < 0x20)
+            {
+                out += "\\u00";
+                out.push_back(s_hex[c >> 4]);
+                out.push_back(s_hex[c & 0xf]);
+            }
+            else
+            {
+                out.push_back((char)c);
+            }
+        }
+    }
+}
+
+/**
+ * @brief 生成测试文本
+ * @param[in] special_per_mille 每千个片段中需要转义的字符数
+ */
+static std::string MakePayload(size_t size, int special_per_mille, uint32_t seed)
+{
+    static const char *s_pieces[] = {"hello", "world", "sylar", " ", "config", "2024-01-01",
+                                     "\xe4\xbd\xa0\xe5\xa5\xbd", "\xe4\xb8\x96\xe7\x95\x8c",
+                                     "\xc3\xa9t\xc3\xa9", "\xf0\x9f\x98\x80"};
+    static const char *s_special[] = {"\"", "\\", "\n", "\t", "\x01"};
+    std::mt19937 rng(seed);
+    std::string rt;
+    while (rt.size() < size)
+    {
+        if ((int)(rng() % 1000) < special_per_mille)
+        {
+            rt += s_special[rng() % 5];
+        }
+        else
+        {
+            rt += s_pieces[rng() % 10];
+        }
+    }
+    rt.resize(size);
+    return rt;
+}
+
+static void Run(size_t size, int special_per_mille)
+{
+    std::string payload = MakePayload(size, special_per_mille, 1);
+    size_t iters = std::max<size_t>(100, 200000000 / (size * 20));
+    char title[64];
+    snprintf(title, sizeof(title), "== %zu bytes, %d special per 1000", size, special_per_mille);
+    puts(title);
+
+    Report("naive byte loop", Measure(iters, [&](size_t n)
+                                      {
+        std::string out;
+        for (size_t i = 0; i < n; ++i)
+        {
+            out.clear();
+            NaiveEscapeAppend(out, payload);
+            DoNotOptimize(out);
+        } }),
+           size);
+    Report("JsonUtil::Escape", Measure(iters, [&](size_t n)
+                                       {
+        for (size_t i = 0; i < n; ++i)
+        {
+            std::string out = sylar::JsonUtil::Escape(payload);
+            DoNotOptimize(out);
+        } }),
+           size);
+    Report("JsonUtil::EscapeAppend (reused)", Measure(iters, [&](size_t n)
+                                                      {
+        std::string out;
+        for (size_t i = 0; i < n; ++i)
+        {
+            out.clear();
+            sylar::JsonUtil::EscapeAppend(out, payload);
+            DoNotOptimize(out);
+        } }),
+           size);
+    Report("JsonUtil::EscapeSize + EscapeTo", Measure(iters, [&](size_t n)
+                                                      {
+        std::string out;
+        for (size_t i = 0; i < n; ++i)
+        {
+            out.resize(sylar::JsonUtil::EscapeSize(payload));
+            sylar::JsonUtil::EscapeTo(&out[0], payload);
+            DoNotOptimize(out);
+        } }),
+           size);
+}
+
+int main()
+{
+    for (size_t size : {16, 256, 4096, 1 << 20})
+    {
+        Run(size, 0);
+        Run(size, 10);
+    }
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+//PBJsonConverter与protobuf自带的反射JSON转换(util::MessageToJsonString)对比
+#include "bench_util.h"
+#include "sylar/util/pb_json.h"
+#include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/util/json_util.h>
+#include <string>
+
+namespace pb = google::protobuf;
+using namespace sylar::bench;
+
+//用protobuf自带的FileDescriptorProto构造测试消息, 不需要额外的.proto文件
+static void BuildMessage(pb::FileDescriptorProto &file, int messages, int fields)
+{
+    file.set_name("bench/test.proto");
+    file.set_package("bench");
+    file.set_syntax("proto3");
+    for (int i = 0; i < messages; ++i)
+    {
+        pb::DescriptorProto *msg = file.add_message_type();
+        msg->set_name("Message" + std::to_string(i));
+        for (int j = 0; j < fields; ++j)
+        {
+            pb::FieldDescriptorProto *f = msg->add_field();
+            f->set_name("field_" + std::to_string(j));
+            f->set_json_name("field" + std::to_string(j));
+            f->set_number(j + 1);
+            f->set_type(j % 2 ? pb::FieldDescriptorProto::TYPE_INT64 : pb::FieldDescriptorProto::TYPE_STRING);
+            f->set_label(pb::FieldDescriptorProto::LABEL_OPTIONAL);
+            f->set_default_value(std::to_string(j * 131));
+        }
+        msg->add_reserved_name("old_" + std::to_string(i));
+        msg->add_reserved_range()->set_start(1000 + i);
+    }
+}
+
+static void Run(const char *title, int messages, int fields)
+{
+    pb::FileDescriptorProto file;
+    BuildMessage(file, messages, fields);
+    std::string json = sylar::PBJsonConverter::ToJson(file);
+    std::string ref;
+    pb::util::MessageToJsonString(file, &ref);
+    size_t iters = std::max<size_t>(20, 2000000 / json.size());
+
+    printf("== %s (%zu bytes)\n", title, json.size());
+    Report("ToJson PBJsonConverter", Measure(iters, [&](size_t n)
+                                             {
+        std::string out;
+        for (size_t i = 0; i < n; ++i)
+        {
+            out.clear();
+            sylar::PBJsonConverter::ToJson(out, file);
+            DoNotOptimize(out);
+        } }),
+           json.size());
+    Report("ToJson util::MessageToJsonString", Measure(iters, [&](size_t n)
+                                                       {
+        std::string out;
+        for (size_t i = 0; i < n; ++i)
+        {
+            out.clear();
+            pb::util::MessageToJsonString(file, &out);
+            DoNotOptimize(out);
+        } }),
+           ref.size());
+    Report("FromJson PBJsonConverter", Measure(iters, [&](size_t n)
+                                               {
+        for (size_t i = 0; i < n; ++i)
+        {
+            pb::FileDescriptorProto m;
+            sylar::PBJsonConverter::FromJson(json, m);
+            DoNotOptimize(m);
+        } }),
+           json.size());
+    Report("FromJson util::JsonStringToMessage", Measure(iters, [&](size_t n)
+                                                         {
+        for (size_t i = 0; i < n; ++i)
+        {
+            pb::FileDescriptorProto m;
+            pb::util::JsonStringToMessage(ref, &m);
+            DoNotOptimize(m);
+        } }),
+           ref.size());
+}
+
+int main()
+{
+    Run("small", 1, 4);
+    Run("medium", 8, 16);
+    Run("large", 64, 32);
+    return 0;
+}
\ No newline at end of file
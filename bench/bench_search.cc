@@ -0,0 +1,67 @@
+//有序数组查找: BinarySearch, std::lower_bound, BranchlessSearch, EytzingerSearch, LinearSearch在不同表大小下的对比
+#include "bench_util.h"
+#include "sylar/util.h"
+#include "sylar/util/search_util.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace sylar::bench;
+
+static const size_t s_query_count = 1 << 20;
+
+template <class F>
+static void Run(const char *name, size_t size, const std::vector<int32_t> &queries, F fn)
+{
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%s n=%zu", name, size);
+    Report(buf, Measure(s_query_count, [&](size_t n)
+                        {
+        int64_t sum = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            sum += fn(queries[i & (s_query_count - 1)]);
+        }
+        DoNotOptimize(sum); }));
+}
+
+int main()
+{
+    std::mt19937 rng(42);
+    for (size_t size : {16, 64, 256, 1024, 4096, 65536, 1 << 20, 1 << 24})
+    {
+        //偶数值, 查询一半命中一半落在两个元素之间
+        std::vector<int32_t> arr(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            arr[i] = (int32_t)(i * 2);
+        }
+        std::vector<int32_t> layout(size);
+        sylar::EytzingerLayout(arr.data(), (int)size, layout.data());
+        std::vector<int32_t> queries(s_query_count);
+        for (auto &i : queries)
+        {
+            i = (int32_t)(rng() % (size * 2));
+        }
+
+        const int32_t *a = arr.data();
+        const int32_t *t = layout.data();
+        int n = (int)size;
+        printf("== %zu elements, %zu KB\n", size, size * sizeof(int32_t) / 1024);
+        Run("BinarySearch", size, queries, [&](int32_t v)
+            { return sylar::BinarySearch(a, n, v); });
+        Run("std::lower_bound", size, queries, [&](int32_t v)
+            { return (int)(std::lower_bound(a, a + n, v) - a); });
+        Run("BranchlessSearch", size, queries, [&](int32_t v)
+            { return sylar::BranchlessSearch(a, n, v); });
+        Run("EytzingerSearch", size, queries, [&](int32_t v)
+            { return sylar::EytzingerSearch(t, n, v); });
+        //线性查找只适合小表
+        if (size <= 4096)
+        {
+            Run("LinearSearch", size, queries, [&](int32_t v)
+                { return sylar::LinearSearch(a, n, v); });
+        }
+    }
+    return 0;
+}
\ No newline at end of file
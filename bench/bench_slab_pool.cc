@@ -0,0 +1,219 @@
+//SlabPool与malloc/free在多线程下的对比: 同线程混合大小的分配释放, 以及跨线程释放
+#include "bench_util.h"
+#include "sylar/util/slab_pool.h"
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace sylar::bench;
+
+struct SlabAlloc
+{
+    static void *Alloc(size_t size) { return sylar::SlabPool::Allocate(size); }
+    static void Free(void *p, size_t size) { sylar::SlabPool::Deallocate(p, size); }
+};
+
+struct MallocAlloc
+{
+    static void *Alloc(size_t size) { return malloc(size); }
+    static void Free(void *p, size_t) { free(p); }
+};
+
+//请求大小表: 大部分是小对象(16~256), 少量到4KB, 与连接/请求对象和IO缓冲区的分布相近
+static std::vector<size_t> MakeSizes(size_t count, uint64_t seed)
+{
+    std::vector<size_t> sizes(count);
+    for (auto &i : sizes)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        uint64_t r = seed % 100;
+        if (r < 60)
+        {
+            i = 16 + seed / 100 % 113;
+        }
+        else if (r < 90)
+        {
+            i = 128 + seed / 100 % 385;
+        }
+        else
+        {
+            i = 512 + seed / 100 % 3585;
+        }
+    }
+    return sizes;
+}
+
+static const size_t s_size_count = 4096;
+
+/**
+ * @brief 同线程churn
+ * @details 每个线程保持live个存活对象, 每次随机替换一个槽位(先释放再分配),
+ *          返回墙钟时间除以所有线程的总次数, 即合计吞吐下每次释放+分配的纳秒数
+ */
+template <class A>
+static double Churn(int threads, size_t live, size_t ops)
+{
+    return Measure(ops, [&](size_t n)
+                   {
+        std::vector<std::thread> ts;
+        for (int t = 0; t < threads; ++t)
+        {
+            ts.emplace_back([&, t]() {
+                std::vector<size_t> sizes = MakeSizes(s_size_count, 88172645463325252ull + t);
+                std::vector<std::pair<void *, size_t>> slots(live);
+                for (size_t i = 0; i < live; ++i)
+                {
+                    size_t size = sizes[i % s_size_count];
+                    slots[i] = std::make_pair(A::Alloc(size), size);
+                    memset(slots[i].first, 0, 8);
+                }
+                size_t per = n / threads;
+                for (size_t i = 0; i < per; ++i)
+                {
+                    auto &s = slots[(i * 2654435761u) % live];
+                    A::Free(s.first, s.second);
+                    s.second = sizes[i % s_size_count];
+                    s.first = A::Alloc(s.second);
+                    memset(s.first, 0, 8);
+                }
+                for (auto &s : slots)
+                {
+                    A::Free(s.first, s.second);
+                }
+            });
+        }
+        for (auto &i : ts)
+        {
+            i.join();
+        }
+    });
+}
+
+/**
+ * @brief 跨线程释放
+ * @details 线程i成批分配后交给线程i + 1, 释放从线程i - 1收到的批次,
+ *          模拟IO线程分配缓冲区、工作线程用完后释放。
+ *          每个信箱最多积压4批, 满了就先处理自己的信箱, 存活对象数不随线程调度失控
+ */
+template <class A>
+static double CrossThread(int threads, size_t ops)
+{
+    typedef std::vector<std::pair<void *, size_t>> Batch;
+    const size_t batch_size = 256;
+    const size_t max_pending = 4;
+    return Measure(ops, [&](size_t n)
+                   {
+        std::vector<std::mutex> mutexes(threads);
+        std::vector<std::vector<Batch>> mailboxes(threads);
+        std::atomic<int> done{0};
+        std::vector<std::thread> ts;
+        for (int t = 0; t < threads; ++t)
+        {
+            ts.emplace_back([&, t]() {
+                std::vector<size_t> sizes = MakeSizes(s_size_count, 88172645463325252ull + t);
+                int next = (t + 1) % threads;
+                std::vector<Batch> inbox;
+                auto drain = [&]() {
+                    {
+                        std::lock_guard<std::mutex> lock(mutexes[t]);
+                        inbox.swap(mailboxes[t]);
+                    }
+                    for (auto &i : inbox)
+                    {
+                        for (auto &j : i)
+                        {
+                            A::Free(j.first, j.second);
+                        }
+                    }
+                    inbox.clear();
+                };
+                size_t rounds = n / threads / batch_size + 1;
+                size_t k = 0;
+                for (size_t r = 0; r < rounds; ++r)
+                {
+                    Batch b;
+                    b.reserve(batch_size);
+                    for (size_t i = 0; i < batch_size; ++i)
+                    {
+                        size_t size = sizes[k++ % s_size_count];
+                        void *p = A::Alloc(size);
+                        memset(p, 0, 8);
+                        b.push_back(std::make_pair(p, size));
+                    }
+                    while (true)
+                    {
+                        {
+                            std::lock_guard<std::mutex> lock(mutexes[next]);
+                            if (mailboxes[next].size() < max_pending)
+                            {
+                                mailboxes[next].push_back(std::move(b));
+                                break;
+                            }
+                        }
+                        drain();
+                        std::this_thread::yield();
+                    }
+                    drain();
+                }
+                //所有线程都不再投递后才能退出, 否则上一个线程可能一直等信箱有空位
+                done.fetch_add(1);
+                while (done.load() < threads)
+                {
+                    drain();
+                    std::this_thread::yield();
+                }
+                drain();
+            });
+        }
+        for (auto &i : ts)
+        {
+            i.join();
+        } });
+}
+
+int main()
+{
+    //线程数超过CPU数时结果包含调度开销, 仍能看出锁和缓存行竞争
+    const int max_threads = 8;
+    const size_t ops = 4000000;
+    char name[64];
+    printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+
+    printf("== churn, 1024 live objects per thread, 16B~4KB\n");
+    for (int t = 1; t <= max_threads; t *= 2)
+    {
+        snprintf(name, sizeof(name), "malloc/free threads=%d", t);
+        Report(name, Churn<MallocAlloc>(t, 1024, ops));
+        snprintf(name, sizeof(name), "SlabPool threads=%d", t);
+        Report(name, Churn<SlabAlloc>(t, 1024, ops));
+    }
+
+    printf("== churn, 64K live objects per thread (beyond L2)\n");
+    for (int t = 1; t <= max_threads; t *= 2)
+    {
+        snprintf(name, sizeof(name), "malloc/free threads=%d", t);
+        Report(name, Churn<MallocAlloc>(t, 65536, ops));
+        snprintf(name, sizeof(name), "SlabPool threads=%d", t);
+        Report(name, Churn<SlabAlloc>(t, 65536, ops));
+    }
+
+    printf("== cross-thread free, batches of 256\n");
+    for (int t = 2; t <= max_threads; t *= 2)
+    {
+        snprintf(name, sizeof(name), "malloc/free threads=%d", t);
+        Report(name, CrossThread<MallocAlloc>(t, ops));
+        snprintf(name, sizeof(name), "SlabPool threads=%d", t);
+        Report(name, CrossThread<SlabAlloc>(t, ops));
+    }
+
+    sylar::SlabStats total = sylar::SlabPool::GetTotalStats();
+    printf("SlabPool reserved %.1f MB in %llu slabs\n", total.reservedBytes / 1048576.0,
+           (unsigned long long)total.slabs);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+//基准测试程序公用的计时工具
+#ifndef __SYLAR_BENCH_BENCH_UTIL_H__
+#define __SYLAR_BENCH_BENCH_UTIL_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <time.h>
+
+namespace sylar
+{
+    namespace bench
+    {
+
+        //单调时钟纳秒
+        inline int64_t NowNS()
+        {
+            struct timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return ts.tv_sec * 1000000000ll + ts.tv_nsec;
+        }
+
+        //阻止编译器把v的计算当作无用代码删掉
+        template <class T>
+        inline void DoNotOptimize(const T &v)
+        {
+            asm volatile("" : : "g"(&v) : "memory");
+        }
+
+        /**
+         * @brief 运行fn(iters)并返回每次迭代的纳秒数
+         * @details 先以iters / 10预热一次, 取3轮中最快的一轮, 减少调度和频率抖动的影响
+         */
+        template <class F>
+        double Measure(size_t iters, F fn)
+        {
+            fn(iters / 10 + 1);
+            double best = 0;
+            for (int round = 0; round < 3; ++round)
+            {
+                int64_t start = NowNS();
+                fn(iters);
+                double ns = (double)(NowNS() - start) / iters;
+                if (round == 0 || ns < best)
+                {
+                    best = ns;
+                }
+            }
+            return best;
+        }
+
+        /**
+         * @brief 输出一行结果
+         * @param[in] bytes 每次迭代处理的字节数, 非0时同时输出吞吐
+         */
+        inline void Report(const char *name, double ns_per_op, size_t bytes = 0)
+        {
+            if (bytes)
+            {
+                printf("%-40s %12.1f ns/op %10.1f MB/s\n", name, ns_per_op, bytes * 1000.0 / ns_per_op);
+            }
+            else
+            {
+                printf("%-40s %12.1f ns/op\n", name, ns_per_op);
+            }
+        }
+
+    }
+}
+
+#endif
\ No newline at end of file
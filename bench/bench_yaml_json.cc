@@ -0,0 +1,133 @@
+//流式YAML<->JSON转换与先建YAML::Node/Json::Value树再转换的对比(耗时和峰值内存)
+#include "bench_util.h"
+#include "sylar/util.h"
+#include "sylar/util/yaml_json.h"
+#include <sys/resource.h>
+#include <stdlib.h>
+#include <json/json.h>
+#include <yaml-cpp/yaml.h>
+#include <memory>
+#include <sstream>
+#include <streambuf>
+#include <string>
+
+using namespace sylar::bench;
+
+//只计数不保存的输出, 避免输出缓冲本身计入内存
+class CountingStreamBuf : public std::streambuf
+{
+public:
+    size_t count() const { return m_count; }
+
+protected:
+    int_type overflow(int_type c) override
+    {
+        if (c != traits_type::eof())
+        {
+            ++m_count;
+        }
+        return c;
+    }
+
+    std::streamsize xsputn(const char *, std::streamsize n) override
+    {
+        m_count += n;
+        return n;
+    }
+
+private:
+    size_t m_count = 0;
+};
+
+//生成records条记录的YAML文档
+static std::string MakeYaml(size_t records)
+{
+    std::string rt = "service: bench\nversion: 3\nrecords:\n";
+    for (size_t i = 0; i < records; ++i)
+    {
+        rt += "  - id: " + std::to_string(i) + "\n";
+        rt += "    name: \"user_" + std::to_string(i) + "\"\n";
+        rt += "    enabled: " + std::string(i % 3 ? "true" : "false") + "\n";
+        rt += "    score: " + std::to_string(i * 0.25) + "\n";
+        rt += "    tags: [alpha, beta, \"" + std::to_string(i % 97) + "\"]\n";
+        rt += "    address:\n      city: Shenzhen\n      zip: 518000\n";
+    }
+    return rt;
+}
+
+//峰值常驻内存(KB), 只增不减, 所以各阶段按内存占用从小到大的顺序运行
+static long MaxRssKB()
+{
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss;
+}
+
+static void StreamYamlToJson(const std::string &yaml, std::ostream &out)
+{
+    std::istringstream in(yaml);
+    sylar::YamlJsonConverter::YamlToJson(in, out);
+}
+
+static void TreeYamlToJson(const std::string &yaml, std::ostream &out)
+{
+    YAML::Node node = YAML::Load(yaml);
+    Json::Value json;
+    sylar::YamlToJson(node, json);
+    Json::StreamWriterBuilder builder;
+    builder["indentation"] = "";
+    std::unique_ptr<Json::StreamWriter> writer(builder.newStreamWriter());
+    writer->write(json, &out);
+}
+
+static void StreamJsonToYaml(const std::string &json, std::ostream &out)
+{
+    std::istringstream in(json);
+    sylar::YamlJsonConverter::JsonToYaml(in, out);
+}
+
+static void TreeJsonToYaml(const std::string &json, std::ostream &out)
+{
+    Json::Value value;
+    std::istringstream in(json);
+    in >> value;
+    YAML::Node node;
+    sylar::JsonToYaml(value, node);
+    YAML::Emitter emitter;
+    emitter << node;
+    out << emitter.c_str();
+}
+
+template <class F>
+static void RunOne(const char *name, const std::string &input, F fn)
+{
+    long rss = MaxRssKB();
+    double ns = Measure(1, [&](size_t n)
+                        {
+        for (size_t i = 0; i < n; ++i)
+        {
+            CountingStreamBuf buf;
+            std::ostream out(&buf);
+            fn(input, out);
+            DoNotOptimize(buf);
+        } });
+    Report(name, ns, input.size());
+    printf("%-40s %12ld KB peak rss growth\n", "", MaxRssKB() - rss);
+}
+
+//参数: 记录数, 默认20000条(约3MB YAML)
+int main(int argc, char **argv)
+{
+    size_t records = argc > 1 ? strtoul(argv[1], nullptr, 10) : 20000;
+    std::string yaml = MakeYaml(records);
+    std::ostringstream json_out;
+    StreamYamlToJson(yaml, json_out);
+    std::string json = json_out.str();
+    printf("== yaml %zu bytes, json %zu bytes\n", yaml.size(), json.size());
+
+    RunOne("YamlToJson streaming", yaml, StreamYamlToJson);
+    RunOne("JsonToYaml streaming", json, StreamJsonToYaml);
+    RunOne("YamlToJson via YAML::Node/Json::Value", yaml, TreeYamlToJson);
+    RunOne("JsonToYaml via Json::Value/YAML::Node", json, TreeJsonToYaml);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,730 @@
+#include "sylar/async_file.h"
+#include "sylar/config.h"
+#include "sylar/fiber.h"
+#include "sylar/iomanager.h"
+#include "sylar/log.h"
+#include "sylar/util.h"
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <stdlib.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sylar
+{
+
+    static sylar::Logger::ptr g_logger = SYLAR_LOG_NAME("system");
+
+    static ConfigVar<bool>::ptr g_async_io_use_uring =
+        Config::Lookup("async_io.use_uring", true, "async file io use io_uring if available");
+
+    static ConfigVar<uint32_t>::ptr g_async_io_uring_entries =
+        Config::Lookup("async_io.uring_entries", (uint32_t)256, "async file io io_uring entries per thread");
+
+    static ConfigVar<int>::ptr g_async_io_pool_threads =
+        Config::Lookup("async_io.pool_threads", 4, "async file io fallback thread pool size");
+
+    //io_uring读写长度字段是32位
+    static const size_t s_max_io_len = 0x7ffff000;
+
+    namespace
+    {
+
+        enum OpType
+        {
+            OP_READ,
+            OP_WRITE,
+            OP_FSYNC,
+            OP_OPENAT,
+            OP_CLOSE
+        };
+
+        //一次异步操作, 在发起协程的栈上, 协程恢复前一直有效
+        struct AsyncOp
+        {
+            OpType type;
+            int fd = -1;
+            void *buf = nullptr;
+            size_t len = 0;
+            off_t offset = -1;
+            const char *path = nullptr;
+            int flags = 0;
+            mode_t mode = 0;
+            bool datasync = false;
+
+            int64_t res = 0;              /// 结果, 失败为-errno
+            Scheduler *scheduler = nullptr;
+            Fiber::ptr fiber;
+            int thread = -1;              /// 发起线程, 完成后在该线程上恢复协程
+        };
+
+        int64_t RunSync(const AsyncOp &op)
+        {
+            while (true)
+            {
+                int64_t rt = -1;
+                switch (op.type)
+                {
+                case OP_READ:
+                    rt = op.offset < 0 ? ::read(op.fd, op.buf, op.len) : ::pread(op.fd, op.buf, op.len, op.offset);
+                    break;
+                case OP_WRITE:
+                    rt = op.offset < 0 ? ::write(op.fd, op.buf, op.len) : ::pwrite(op.fd, op.buf, op.len, op.offset);
+                    break;
+                case OP_FSYNC:
+                    rt = op.datasync ? ::fdatasync(op.fd) : ::fsync(op.fd);
+                    break;
+                case OP_OPENAT:
+                    rt = ::openat(op.fd, op.path, op.flags, op.mode);
+                    break;
+                case OP_CLOSE:
+                    //close被信号打断时fd已经释放, 不能重试
+                    rt = ::close(op.fd);
+                    return rt < 0 && errno != EINTR ? -errno : 0;
+                }
+                if (rt >= 0)
+                {
+                    return rt;
+                }
+                if (errno != EINTR)
+                {
+                    return -errno;
+                }
+            }
+        }
+
+        //恢复发起协程, 之后op可能已经失效
+        void Resume(AsyncOp *op)
+        {
+            Scheduler *scheduler = op->scheduler;
+            Fiber::ptr fiber = std::move(op->fiber);
+            int thread = op->thread;
+            scheduler->schedule(fiber, thread);
+        }
+
+        /**
+         * @brief 阻塞执行的后备线程池
+         * @details 第一次使用时按async_io.pool_threads启动
+         */
+        class AsyncIOPool
+        {
+        public:
+            static AsyncIOPool &Get()
+            {
+                static AsyncIOPool s_pool;
+                return s_pool;
+            }
+
+            void submit(AsyncOp *op)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_threads.empty())
+                {
+                    int n = std::max(1, g_async_io_pool_threads->getValue());
+                    for (int i = 0; i < n; ++i)
+                    {
+                        m_threads.emplace_back(&AsyncIOPool::run, this);
+                    }
+                }
+                m_ops.push_back(op);
+                m_cond.notify_one();
+            }
+
+            ~AsyncIOPool()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_stop = true;
+                    m_cond.notify_all();
+                }
+                for (auto &i : m_threads)
+                {
+                    i.join();
+                }
+            }
+
+        private:
+            void run()
+            {
+                while (true)
+                {
+                    AsyncOp *op = nullptr;
+                    {
+                        std::unique_lock<std::mutex> lock(m_mutex);
+                        while (m_ops.empty() && !m_stop)
+                        {
+                            m_cond.wait(lock);
+                        }
+                        if (m_ops.empty())
+                        {
+                            return;
+                        }
+                        op = m_ops.front();
+                        m_ops.pop_front();
+                    }
+                    op->res = RunSync(*op);
+                    Resume(op);
+                }
+            }
+
+        private:
+            std::mutex m_mutex;
+            std::condition_variable m_cond;
+            std::deque<AsyncOp *> m_ops;
+            std::vector<std::thread> m_threads;
+            bool m_stop = false;
+        };
+
+        int SysIoUringSetup(unsigned entries, struct io_uring_params *p)
+        {
+            return (int)syscall(__NR_io_uring_setup, entries, p);
+        }
+
+        int SysIoUringEnter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+        {
+            return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0);
+        }
+
+        int SysIoUringRegister(int fd, unsigned opcode, void *arg, unsigned nr_args)
+        {
+            return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+        }
+
+        //io_uring在本进程是否可用: 0未知, 1可用, -1不可用(不再尝试)
+        static std::atomic<int> s_uring_state{0};
+
+        /**
+         * @brief 线程私有的io_uring
+         * @details 提交队列只由本线程写入; 完成回调可能在IOManager的其他线程执行,
+         *          提交和收割都在m_mutex下进行
+         */
+        class UringContext
+        {
+        public:
+            typedef Mutex MutexType;
+
+            //当前线程的ring, 不可用时返回nullptr
+            static UringContext *GetThis(IOManager *iom)
+            {
+                static thread_local std::unique_ptr<UringContext> t_ctx;
+                static thread_local bool t_failed = false;
+                if (t_ctx)
+                {
+                    if (t_ctx->m_iom == iom)
+                    {
+                        return t_ctx.get();
+                    }
+                    //线程换了IOManager, 旧ring空闲时重建
+                    if (!t_ctx->isIdle())
+                    {
+                        return nullptr;
+                    }
+                    t_ctx.reset();
+                }
+                if (t_failed || s_uring_state.load(std::memory_order_relaxed) < 0 || !g_async_io_use_uring->getValue())
+                {
+                    return nullptr;
+                }
+                std::unique_ptr<UringContext> ctx(new UringContext(iom));
+                if (!ctx->init(g_async_io_uring_entries->getValue()))
+                {
+                    t_failed = true;
+                    return nullptr;
+                }
+                s_uring_state.store(1, std::memory_order_relaxed);
+                t_ctx = std::move(ctx);
+                return t_ctx.get();
+            }
+
+            ~UringContext()
+            {
+                if (m_armed)
+                {
+                    m_iom->delEvent(m_eventFd, IOManager::READ);
+                }
+                if (m_sqes)
+                {
+                    munmap(m_sqes, m_sqesSize);
+                }
+                if (m_cqRing && m_cqRing != m_sqRing)
+                {
+                    munmap(m_cqRing, m_cqRingSize);
+                }
+                if (m_sqRing)
+                {
+                    munmap(m_sqRing, m_sqRingSize);
+                }
+                if (m_eventFd >= 0)
+                {
+                    ::close(m_eventFd);
+                }
+                if (m_ringFd >= 0)
+                {
+                    ::close(m_ringFd);
+                }
+            }
+
+            /**
+             * @brief 写入提交队列
+             * @details 只在本线程第一次有未提交请求时安排一次flush,
+             *          同一轮调度中其他协程的请求随同一次io_uring_enter提交
+             * @return 在途请求已达完成队列容量时返回false, 由调用者改用线程池
+             */
+            bool submit(AsyncOp *op)
+            {
+                MutexType::Lock lock(m_mutex);
+                if (m_inflight >= m_cqEntries)
+                {
+                    return false;
+                }
+                unsigned tail = *m_sqTail;
+                if (tail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE) >= m_sqEntries)
+                {
+                    enter();
+                    if (tail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE) >= m_sqEntries)
+                    {
+                        return false;
+                    }
+                }
+                unsigned idx = tail & m_sqMask;
+                prepare(&m_sqes[idx], op);
+                m_sqArray[idx] = idx;
+                __atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+                ++m_pending;
+                ++m_inflight;
+
+                if (!m_armed)
+                {
+                    m_armed = true;
+                    m_iom->addEvent(m_eventFd, IOManager::READ, std::bind(&UringContext::onComplete, this));
+                }
+                if (!m_flushScheduled)
+                {
+                    m_flushScheduled = true;
+                    m_iom->schedule(std::bind(&UringContext::flush, this), m_thread);
+                }
+                return true;
+            }
+
+            //没有在途请求
+            bool isIdle()
+            {
+                MutexType::Lock lock(m_mutex);
+                return m_inflight == 0 && !m_flushScheduled;
+            }
+
+        private:
+            explicit UringContext(IOManager *iom)
+                : m_iom(iom), m_thread(GetThreadId())
+            {
+            }
+
+            bool init(unsigned entries)
+            {
+                struct io_uring_params p;
+                memset(&p, 0, sizeof(p));
+                m_ringFd = SysIoUringSetup(entries, &p);
+                if (m_ringFd < 0)
+                {
+                    if (errno == ENOSYS || errno == EPERM)
+                    {
+                        s_uring_state.store(-1, std::memory_order_relaxed);
+                    }
+                    SYLAR_LOG_INFO(g_logger) << "io_uring_setup fail, errno=" << errno
+                                             << " errstr=" << strerror(errno) << ", use thread pool";
+                    return false;
+                }
+                if (!probe())
+                {
+                    s_uring_state.store(-1, std::memory_order_relaxed);
+                    SYLAR_LOG_INFO(g_logger) << "io_uring lacks required opcodes, use thread pool";
+                    return false;
+                }
+
+                m_sqEntries = p.sq_entries;
+                m_cqEntries = p.cq_entries;
+                m_sqRingSize = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+                m_cqRingSize = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+                if (p.features & IORING_FEAT_SINGLE_MMAP)
+                {
+                    m_sqRingSize = m_cqRingSize = std::max(m_sqRingSize, m_cqRingSize);
+                }
+                m_sqRing = mmap(nullptr, m_sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_SQ_RING);
+                if (m_sqRing == MAP_FAILED)
+                {
+                    m_sqRing = nullptr;
+                    return false;
+                }
+                if (p.features & IORING_FEAT_SINGLE_MMAP)
+                {
+                    m_cqRing = m_sqRing;
+                }
+                else
+                {
+                    m_cqRing = mmap(nullptr, m_cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_CQ_RING);
+                    if (m_cqRing == MAP_FAILED)
+                    {
+                        m_cqRing = nullptr;
+                        return false;
+                    }
+                }
+                m_sqesSize = p.sq_entries * sizeof(struct io_uring_sqe);
+                m_sqes = (struct io_uring_sqe *)mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_SQES);
+                if (m_sqes == MAP_FAILED)
+                {
+                    m_sqes = nullptr;
+                    return false;
+                }
+
+                char *sq = (char *)m_sqRing;
+                m_sqHead = (unsigned *)(sq + p.sq_off.head);
+                m_sqTail = (unsigned *)(sq + p.sq_off.tail);
+                m_sqMask = *(unsigned *)(sq + p.sq_off.ring_mask);
+                m_sqArray = (unsigned *)(sq + p.sq_off.array);
+                char *cq = (char *)m_cqRing;
+                m_cqHead = (unsigned *)(cq + p.cq_off.head);
+                m_cqTail = (unsigned *)(cq + p.cq_off.tail);
+                m_cqMask = *(unsigned *)(cq + p.cq_off.ring_mask);
+                m_cqes = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+
+                m_eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+                if (m_eventFd < 0 || SysIoUringRegister(m_ringFd, IORING_REGISTER_EVENTFD, &m_eventFd, 1) != 0)
+                {
+                    SYLAR_LOG_ERROR(g_logger) << "io_uring register eventfd fail, errno=" << errno
+                                              << " errstr=" << strerror(errno);
+                    return false;
+                }
+                return true;
+            }
+
+            //检查用到的操作码是否都支持(IORING_OP_OPENAT等需要5.6以上内核)
+            bool probe()
+            {
+                const unsigned nops = 256;
+                size_t size = sizeof(struct io_uring_probe) + nops * sizeof(struct io_uring_probe_op);
+                std::unique_ptr<char[]> buf(new char[size]);
+                memset(buf.get(), 0, size);
+                struct io_uring_probe *p = (struct io_uring_probe *)buf.get();
+                if (SysIoUringRegister(m_ringFd, IORING_REGISTER_PROBE, p, nops) != 0)
+                {
+                    return false;
+                }
+                static const int s_ops[] = {IORING_OP_READ, IORING_OP_WRITE, IORING_OP_FSYNC,
+                                            IORING_OP_OPENAT, IORING_OP_CLOSE};
+                for (int op : s_ops)
+                {
+                    if (op > p->last_op || !(p->ops[op].flags & IO_URING_OP_SUPPORTED))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            static void prepare(struct io_uring_sqe *sqe, AsyncOp *op)
+            {
+                memset(sqe, 0, sizeof(*sqe));
+                sqe->fd = op->fd;
+                sqe->user_data = (uint64_t)(uintptr_t)op;
+                switch (op->type)
+                {
+                case OP_READ:
+                case OP_WRITE:
+                    sqe->opcode = op->type == OP_READ ? IORING_OP_READ : IORING_OP_WRITE;
+                    sqe->addr = (uint64_t)(uintptr_t)op->buf;
+                    sqe->len = (uint32_t)op->len;
+                    sqe->off = (uint64_t)op->offset;
+                    break;
+                case OP_FSYNC:
+                    sqe->opcode = IORING_OP_FSYNC;
+                    sqe->fsync_flags = op->datasync ? IORING_FSYNC_DATASYNC : 0;
+                    break;
+                case OP_OPENAT:
+                    sqe->opcode = IORING_OP_OPENAT;
+                    sqe->addr = (uint64_t)(uintptr_t)op->path;
+                    sqe->len = op->mode;
+                    sqe->open_flags = op->flags;
+                    break;
+                case OP_CLOSE:
+                    sqe->opcode = IORING_OP_CLOSE;
+                    break;
+                }
+            }
+
+            //把未提交的请求交给内核, 需持有m_mutex
+            void enter()
+            {
+                while (m_pending)
+                {
+                    int rt = SysIoUringEnter(m_ringFd, m_pending, 0, 0);
+                    if (rt > 0)
+                    {
+                        m_pending -= rt;
+                        continue;
+                    }
+                    if (rt < 0 && errno == EINTR)
+                    {
+                        continue;
+                    }
+                    if (rt < 0 && (errno == EAGAIN || errno == EBUSY))
+                    {
+                        //内核资源暂时不足, 下一轮调度再提交
+                        if (!m_flushScheduled)
+                        {
+                            m_flushScheduled = true;
+                            m_iom->schedule(std::bind(&UringContext::flush, this), m_thread);
+                        }
+                        return;
+                    }
+                    SYLAR_LOG_ERROR(g_logger) << "io_uring_enter fail, rt=" << rt << " errno=" << errno
+                                              << " errstr=" << strerror(errno);
+                    return;
+                }
+            }
+
+            void flush()
+            {
+                MutexType::Lock lock(m_mutex);
+                m_flushScheduled = false;
+                enter();
+            }
+
+            //eventfd可读: 收割全部完成项
+            void onComplete()
+            {
+                uint64_t v;
+                while (::read(m_eventFd, &v, sizeof(v)) < 0 && errno == EINTR)
+                {
+                }
+                std::vector<AsyncOp *> done;
+                {
+                    MutexType::Lock lock(m_mutex);
+                    unsigned head = *m_cqHead;
+                    unsigned tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+                    for (; head != tail; ++head)
+                    {
+                        struct io_uring_cqe *cqe = &m_cqes[head & m_cqMask];
+                        AsyncOp *op = (AsyncOp *)(uintptr_t)cqe->user_data;
+                        op->res = cqe->res;
+                        done.push_back(op);
+                    }
+                    __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+                    m_inflight -= done.size();
+                    //IOManager的事件是一次性的, 还有在途请求时重新注册
+                    if (m_inflight > 0)
+                    {
+                        m_iom->addEvent(m_eventFd, IOManager::READ, std::bind(&UringContext::onComplete, this));
+                    }
+                    else
+                    {
+                        m_armed = false;
+                    }
+                }
+                for (auto op : done)
+                {
+                    Resume(op);
+                }
+            }
+
+        private:
+            IOManager *m_iom;
+            int m_thread;
+            MutexType m_mutex;
+            int m_ringFd = -1;
+            int m_eventFd = -1;
+
+            void *m_sqRing = nullptr;
+            size_t m_sqRingSize = 0;
+            void *m_cqRing = nullptr;
+            size_t m_cqRingSize = 0;
+            struct io_uring_sqe *m_sqes = nullptr;
+            size_t m_sqesSize = 0;
+
+            unsigned *m_sqHead = nullptr;
+            unsigned *m_sqTail = nullptr;
+            unsigned *m_sqArray = nullptr;
+            unsigned m_sqMask = 0;
+            unsigned m_sqEntries = 0;
+            unsigned *m_cqHead = nullptr;
+            unsigned *m_cqTail = nullptr;
+            struct io_uring_cqe *m_cqes = nullptr;
+            unsigned m_cqMask = 0;
+            unsigned m_cqEntries = 0;
+
+            unsigned m_pending = 0;  /// 已写入提交队列, 还没有io_uring_enter的请求数
+            unsigned m_inflight = 0; /// 已写入提交队列, 还没有收割的请求数
+            bool m_flushScheduled = false;
+            bool m_armed = false;    /// eventfd是否已注册到IOManager
+        };
+
+        //执行操作, 失败返回-1并设置errno
+        int64_t Execute(AsyncOp &op)
+        {
+            int64_t rt;
+            IOManager *iom = IOManager::GetThis();
+            if (!iom || Fiber::GetFiberId() == 0)
+            {
+                rt = RunSync(op);
+            }
+            else
+            {
+                op.scheduler = iom;
+                op.fiber = Fiber::GetThis();
+                op.thread = GetThreadId();
+                UringContext *ctx = UringContext::GetThis(iom);
+                if (!ctx || !ctx->submit(&op))
+                {
+                    AsyncIOPool::Get().submit(&op);
+                }
+                Fiber::YieldToHold();
+                rt = op.res;
+            }
+            if (rt < 0)
+            {
+                errno = (int)-rt;
+                return -1;
+            }
+            return rt;
+        }
+
+    }
+
+    ssize_t AsyncIO::Read(int fd, void *buf, size_t len, off_t offset)
+    {
+        AsyncOp op;
+        op.type = OP_READ;
+        op.fd = fd;
+        op.buf = buf;
+        op.len = std::min(len, s_max_io_len);
+        op.offset = offset;
+        return Execute(op);
+    }
+
+    ssize_t AsyncIO::Write(int fd, const void *buf, size_t len, off_t offset)
+    {
+        AsyncOp op;
+        op.type = OP_WRITE;
+        op.fd = fd;
+        op.buf = const_cast<void *>(buf);
+        op.len = std::min(len, s_max_io_len);
+        op.offset = offset;
+        return Execute(op);
+    }
+
+    int AsyncIO::Fsync(int fd, bool datasync)
+    {
+        AsyncOp op;
+        op.type = OP_FSYNC;
+        op.fd = fd;
+        op.datasync = datasync;
+        return (int)Execute(op);
+    }
+
+    int AsyncIO::Openat(int dirfd, const char *path, int flags, mode_t mode)
+    {
+        AsyncOp op;
+        op.type = OP_OPENAT;
+        op.fd = dirfd;
+        op.path = path;
+        op.flags = flags;
+        op.mode = mode;
+        return (int)Execute(op);
+    }
+
+    int AsyncIO::Close(int fd)
+    {
+        AsyncOp op;
+        op.type = OP_CLOSE;
+        op.fd = fd;
+        return (int)Execute(op);
+    }
+
+    AsyncIO::Backend AsyncIO::GetBackend()
+    {
+        IOManager *iom = IOManager::GetThis();
+        if (!iom || Fiber::GetFiberId() == 0)
+        {
+            return SYNC;
+        }
+        return UringContext::GetThis(iom) ? URING : THREAD_POOL;
+    }
+
+    AsyncFile::ptr AsyncFile::Open(const std::string &path, int flags, mode_t mode)
+    {
+        int fd = AsyncIO::Openat(AT_FDCWD, path.c_str(), flags | O_CLOEXEC, mode);
+        if (fd < 0)
+        {
+            return nullptr;
+        }
+        return std::make_shared<AsyncFile>(fd, true);
+    }
+
+    AsyncFile::AsyncFile(int fd, bool owner)
+        : m_fd(fd), m_owner(owner)
+    {
+    }
+
+    AsyncFile::~AsyncFile()
+    {
+        if (m_owner)
+        {
+            close();
+        }
+    }
+
+    ssize_t AsyncFile::readFull(void *buf, size_t len)
+    {
+        size_t offset = 0;
+        while (offset < len)
+        {
+            ssize_t n = read((char *)buf + offset, len - offset);
+            if (n < 0)
+            {
+                return -1;
+            }
+            if (n == 0)
+            {
+                break;
+            }
+            offset += n;
+        }
+        return offset;
+    }
+
+    ssize_t AsyncFile::writeFull(const void *buf, size_t len)
+    {
+        size_t offset = 0;
+        while (offset < len)
+        {
+            ssize_t n = write((const char *)buf + offset, len - offset);
+            if (n < 0)
+            {
+                return -1;
+            }
+            offset += n;
+        }
+        return offset;
+    }
+
+    int AsyncFile::close()
+    {
+        if (m_fd < 0)
+        {
+            return 0;
+        }
+        int fd = m_fd;
+        m_fd = -1;
+        return AsyncIO::Close(fd);
+    }
+
+}
\ No newline at end of file
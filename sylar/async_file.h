@@ -0,0 +1,124 @@
+//协程异步文件IO
+#ifndef __SYLAR_ASYNC_FILE_H__
+#define __SYLAR_ASYNC_FILE_H__
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include "noncopyable.h"
+
+namespace sylar
+{
+
+    /**
+     * @brief 异步文件操作
+     * @details 在IOManager协程中调用时, 操作提交后协程YieldToHold, 完成后在原线程上恢复,
+     *          等待磁盘期间线程继续执行其他协程:
+     *          - io_uring后端: 每个线程一个ring, 同一线程上多个协程的请求只写入提交队列,
+     *            由一个调度任务统一调用一次io_uring_enter提交; 完成通过注册到ring的eventfd
+     *            交给IOManager, 一次收割全部完成项
+     *          - 线程池后端: 内核不支持io_uring(或被禁用, 或ring已满)时,
+     *            操作交给后台线程以阻塞方式执行
+     *          不在协程中调用时直接同步执行。
+     *          返回值与对应的系统调用一致: 失败返回-1并设置errno
+     */
+    class AsyncIO
+    {
+    public:
+        //执行后端
+        enum Backend
+        {
+            SYNC,        /// 同步执行(不在协程中)
+            URING,       /// io_uring
+            THREAD_POOL  /// 后台线程池
+        };
+
+        /**
+         * @brief 读
+         * @param[in] offset 文件偏移, -1表示使用并推进文件当前偏移
+         */
+        static ssize_t Read(int fd, void *buf, size_t len, off_t offset = -1);
+
+        /**
+         * @brief 写
+         * @param[in] offset 文件偏移, -1表示使用并推进文件当前偏移(O_APPEND时追加)
+         */
+        static ssize_t Write(int fd, const void *buf, size_t len, off_t offset = -1);
+
+        //fsync, datasync为true时fdatasync
+        static int Fsync(int fd, bool datasync = false);
+
+        //openat, 返回文件描述符
+        static int Openat(int dirfd, const char *path, int flags, mode_t mode = 0644);
+
+        //close
+        static int Close(int fd);
+
+        //当前线程调用时使用的后端
+        static Backend GetBackend();
+    };
+
+    /**
+     * @brief 异步文件
+     * @details 对AsyncIO的封装, 持有文件描述符, 析构时关闭
+     */
+    class AsyncFile : Noncopyable
+    {
+    public:
+        typedef std::shared_ptr<AsyncFile> ptr;
+
+        /**
+         * @brief 打开文件
+         * @param[in] flags open的flags, 自动加上O_CLOEXEC
+         * @return 失败返回nullptr, errno为失败原因
+         */
+        static ptr Open(const std::string &path, int flags, mode_t mode = 0644);
+
+        /**
+         * @brief 构造函数
+         * @param[in] owner 是否在析构时关闭fd
+         */
+        explicit AsyncFile(int fd, bool owner = true);
+        ~AsyncFile();
+
+        //从当前偏移读
+        ssize_t read(void *buf, size_t len) { return AsyncIO::Read(m_fd, buf, len); }
+
+        //从当前偏移写
+        ssize_t write(const void *buf, size_t len) { return AsyncIO::Write(m_fd, buf, len); }
+
+        //从offset读, 不改变当前偏移
+        ssize_t pread(void *buf, size_t len, off_t offset) { return AsyncIO::Read(m_fd, buf, len, offset); }
+
+        //写到offset, 不改变当前偏移
+        ssize_t pwrite(const void *buf, size_t len, off_t offset) { return AsyncIO::Write(m_fd, buf, len, offset); }
+
+        /**
+         * @brief 从当前偏移读满len字节
+         * @return 读取的字节数, 小于len表示遇到EOF; 出错返回-1
+         */
+        ssize_t readFull(void *buf, size_t len);
+
+        /**
+         * @brief 从当前偏移写完len字节
+         * @return 写入的字节数; 出错返回-1
+         */
+        ssize_t writeFull(const void *buf, size_t len);
+
+        int fsync(bool datasync = false) { return AsyncIO::Fsync(m_fd, datasync); }
+
+        //关闭文件
+        int close();
+
+        int getFd() const { return m_fd; }
+        bool isOpen() const { return m_fd >= 0; }
+
+    private:
+        int m_fd;
+        bool m_owner;
+    };
+
+}
+
+#endif
\ No newline at end of file
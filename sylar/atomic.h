@@ -0,0 +1,302 @@
+//原子操作封装
+#ifndef __SYLAR_ATOMIC_H__
+#define __SYLAR_ATOMIC_H__
+
+#include <atomic>
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+namespace sylar
+{
+
+    //缓存行大小
+    static constexpr size_t kCacheLineSize = 64;
+
+    /**
+     * @brief 原子操作静态封装(兼容接口)
+     * @details 基于__atomic内建函数, 可以直接作用于已有的volatile T&变量;
+     *          默认顺序为memory_order_seq_cst, 与原先__sync_*的全屏障语义一致,
+     *          调用者可以按需传入更弱的内存序
+     */
+    class Atomic
+    {
+    public:
+        template <class T, class S = T>
+        static T addFetch(volatile T &t, S v = 1, std::memory_order mo = std::memory_order_seq_cst)
+        {
+            return __atomic_add_fetch(&t, (T)v, (int)mo);
+        }
+
+        template <class T, class S = T>
+        static T subFetch(volatile T &t, S v = 1, std::memory_order mo = std::memory_order_seq_cst)
+        {
+            return __atomic_sub_fetch(&t, (T)v, (int)mo);
+        }
+
+        template <class T, class S>
+        static T orFetch(volatile T &t, S v, std::memory_order mo = std::memory_order_seq_cst)
+        {
+            return __atomic_or_fetch(&t, (T)v, (int)mo);
+        }
+
+        template <class T, class S>
+        static T andFetch(volatile T &t, S v, std::memory_order mo = std::memory_order_seq_cst)
+        {
+            return __atomic_and_fetch(&t, (T)v, (int)mo);
+        }
+
+        template <class T, class S>
+        static T xorFetch(volatile T &t, S v, std::memory_order mo = std::memory_order_seq_cst)
+        {
+            return __atomic_xor_fetch(&t, (T)v, (int)mo);
+        }
+
+        template <class T, class S>
+        static T nandFetch(volatile T &t, S v, std::memory_order mo = std::memory_order_seq_cst)
+        {
+            return __atomic_nand_fetch(&t, (T)v, (int)mo);
+        }
+
+        template <class T, class S>
+        static T fetchAdd(volatile T &t, S v = 1, std::memory_order mo = std::memory_order_seq_cst)
+        {
+            return __atomic_fetch_add(&t, (T)v, (int)mo);
+        }
+
+        template <class T, class S>
+        static T fetchSub(volatile T &t, S v = 1, std::memory_order mo = std::memory_order_seq_cst)
+        {
+            return __atomic_fetch_sub(&t, (T)v, (int)mo);
+        }
+
+        template <class T, class S>
+        static T fetchOr(volatile T &t, S v, std::memory_order mo = std::memory_order_seq_cst)
+        {
+            return __atomic_fetch_or(&t, (T)v, (int)mo);
+        }
+
+        template <class T, class S>
+        static T fetchAnd(volatile T &t, S v, std::memory_order mo = std::memory_order_seq_cst)
+        {
+            return __atomic_fetch_and(&t, (T)v, (int)mo);
+        }
+
+        template <class T, class S>
+        static T fetchXor(volatile T &t, S v, std::memory_order mo = std::memory_order_seq_cst)
+        {
+            return __atomic_fetch_xor(&t, (T)v, (int)mo);
+        }
+
+        template <class T, class S>
+        static T fetchNand(volatile T &t, S v, std::memory_order mo = std::memory_order_seq_cst)
+        {
+            return __atomic_fetch_nand(&t, (T)v, (int)mo);
+        }
+
+        /**
+         * @brief 比较并交换
+         * @return 交换前的值
+         */
+        template <class T, class S>
+        static T compareAndSwap(volatile T &t, S old_val, S new_val, std::memory_order mo = std::memory_order_seq_cst)
+        {
+            T expected = (T)old_val;
+            __atomic_compare_exchange_n(&t, &expected, (T)new_val, false, (int)mo, (int)FailureOrder(mo));
+            return expected;
+        }
+
+        /**
+         * @brief 比较并交换
+         * @return 交换成功返回true
+         */
+        template <class T, class S>
+        static bool compareAndSwapBool(volatile T &t, S old_val, S new_val, std::memory_order mo = std::memory_order_seq_cst)
+        {
+            T expected = (T)old_val;
+            return __atomic_compare_exchange_n(&t, &expected, (T)new_val, false, (int)mo, (int)FailureOrder(mo));
+        }
+
+        //原子读取, 发布-订阅场景使用memory_order_acquire
+        template <class T>
+        static T load(const volatile T &t, std::memory_order mo = std::memory_order_seq_cst)
+        {
+            return __atomic_load_n(&t, (int)mo);
+        }
+
+        //原子写入, 发布-订阅场景使用memory_order_release
+        template <class T, class S>
+        static void store(volatile T &t, S v, std::memory_order mo = std::memory_order_seq_cst)
+        {
+            __atomic_store_n(&t, (T)v, (int)mo);
+        }
+
+        //原子交换, 返回旧值
+        template <class T, class S>
+        static T exchange(volatile T &t, S v, std::memory_order mo = std::memory_order_seq_cst)
+        {
+            return __atomic_exchange_n(&t, (T)v, (int)mo);
+        }
+
+    private:
+        //CAS失败时的内存序不能包含release语义
+        static constexpr std::memory_order FailureOrder(std::memory_order mo)
+        {
+            return mo == std::memory_order_acq_rel   ? std::memory_order_acquire
+                   : mo == std::memory_order_release ? std::memory_order_relaxed
+                                                     : mo;
+        }
+    };
+
+    /**
+     * @brief 统计用计数器
+     * @details 所有操作使用memory_order_relaxed, 只保证计数本身正确,
+     *          不对其他内存访问建立顺序
+     */
+    template <class T = int64_t>
+    class RelaxedCounter
+    {
+    public:
+        RelaxedCounter(T v = 0)
+            : m_value(v)
+        {
+        }
+
+        //增加v, 返回增加前的值
+        T add(T v = 1) { return m_value.fetch_add(v, std::memory_order_relaxed); }
+
+        //减少v, 返回减少前的值
+        T sub(T v = 1) { return m_value.fetch_sub(v, std::memory_order_relaxed); }
+
+        //返回当前值
+        T get() const { return m_value.load(std::memory_order_relaxed); }
+
+        //设置当前值
+        void set(T v) { m_value.store(v, std::memory_order_relaxed); }
+
+        //读取并清零, 返回清零前的值
+        T reset() { return m_value.exchange(0, std::memory_order_relaxed); }
+
+        RelaxedCounter &operator++()
+        {
+            add(1);
+            return *this;
+        }
+
+        RelaxedCounter &operator+=(T v)
+        {
+            add(v);
+            return *this;
+        }
+
+        operator T() const { return get(); }
+
+    private:
+        std::atomic<T> m_value;
+    };
+
+    /**
+     * @brief 发布-订阅变量
+     * @details 写者release发布, 读者acquire读取,
+     *          读者读到新值后可以看到写者发布前的全部写入
+     */
+    template <class T>
+    class Published
+    {
+    public:
+        Published(T v = T())
+            : m_value(v)
+        {
+        }
+
+        //发布新值
+        void publish(T v) { m_value.store(v, std::memory_order_release); }
+
+        //读取最近发布的值
+        T read() const { return m_value.load(std::memory_order_acquire); }
+
+    private:
+        std::atomic<T> m_value;
+    };
+
+    /**
+     * @brief 分段计数器(LongAdder)
+     * @details 计数分散到N个独占缓存行的槽位, 线程按线程id散列到固定槽位,
+     *          写入只做relaxed加法, 热点统计不再争抢同一条缓存行;
+     *          读取时累加所有槽位, 并发写入期间的结果是近似值
+     */
+    template <size_t N = 32>
+    class StripedCounter
+    {
+    public:
+        static_assert(N > 0 && (N & (N - 1)) == 0, "N must be power of 2");
+
+        StripedCounter() {}
+
+        //增加v
+        void add(int64_t v = 1)
+        {
+            m_cells[Index()].value.fetch_add(v, std::memory_order_relaxed);
+        }
+
+        //减少v
+        void sub(int64_t v = 1)
+        {
+            m_cells[Index()].value.fetch_sub(v, std::memory_order_relaxed);
+        }
+
+        //返回所有槽位之和
+        int64_t sum() const
+        {
+            int64_t rt = 0;
+            for (size_t i = 0; i < N; ++i)
+            {
+                rt += m_cells[i].value.load(std::memory_order_relaxed);
+            }
+            return rt;
+        }
+
+        //读取并清零所有槽位, 返回清零前的和
+        int64_t sumThenReset()
+        {
+            int64_t rt = 0;
+            for (size_t i = 0; i < N; ++i)
+            {
+                rt += m_cells[i].value.exchange(0, std::memory_order_relaxed);
+            }
+            return rt;
+        }
+
+        StripedCounter &operator++()
+        {
+            add(1);
+            return *this;
+        }
+
+        StripedCounter &operator+=(int64_t v)
+        {
+            add(v);
+            return *this;
+        }
+
+    private:
+        //当前线程对应的槽位, 首次调用时按线程id散列
+        static size_t Index()
+        {
+            static thread_local size_t s_index = (size_t)(syscall(SYS_gettid) * 0x9E3779B97F4A7C15ULL >> 32) & (N - 1);
+            return s_index;
+        }
+
+    private:
+        //独占缓存行的槽位
+        struct alignas(kCacheLineSize) Cell
+        {
+            std::atomic<int64_t> value{0};
+        };
+        Cell m_cells[N];
+    };
+}
+
+#endif
\ No newline at end of file
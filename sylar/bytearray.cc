@@ -0,0 +1,676 @@
+#include "sylar/bytearray.h"
+#include "sylar/endian.h"
+#include "sylar/log.h"
+#include "sylar/io_util.h"
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string.h>
+#include <math.h>
+#include <stdexcept>
+#include <algorithm>
+
+namespace sylar
+{
+
+    static sylar::Logger::ptr g_logger = SYLAR_LOG_NAME("system");
+
+    ByteArray::Node::Node(size_t s)
+        : ptr(new char[s]), next(nullptr), size(s)
+    {
+    }
+
+    ByteArray::Node::Node()
+        : ptr(nullptr), next(nullptr), size(0)
+    {
+    }
+
+    ByteArray::Node::~Node()
+    {
+        if (ptr)
+        {
+            delete[] ptr;
+        }
+    }
+
+    ByteArray::ByteArray(size_t base_size)
+        : m_baseSize(base_size ? base_size : 4096), m_position(0), m_capacity(m_baseSize), m_size(0), m_endian(SYLAR_BIG_ENDIAN), m_root(new Node(m_baseSize)), m_cur(m_root), m_tail(m_root)
+    {
+    }
+
+    ByteArray::~ByteArray()
+    {
+        Node *tmp = m_root;
+        while (tmp)
+        {
+            m_cur = tmp;
+            tmp = tmp->next;
+            delete m_cur;
+        }
+    }
+
+    bool ByteArray::isLittleEndian() const
+    {
+        return m_endian == SYLAR_LITTLE_ENDIAN;
+    }
+
+    void ByteArray::setIsLittleEndian(bool val)
+    {
+        m_endian = val ? SYLAR_LITTLE_ENDIAN : SYLAR_BIG_ENDIAN;
+    }
+
+    template <class T>
+    void ByteArray::writeFixed(T value)
+    {
+        if (m_endian != SYLAR_BYTE_ORDER)
+        {
+            value = byteswap(value);
+        }
+        write(&value, sizeof(value));
+    }
+
+    template <class T>
+    T ByteArray::readFixed()
+    {
+        T v;
+        read(&v, sizeof(v));
+        if (m_endian != SYLAR_BYTE_ORDER)
+        {
+            v = byteswap(v);
+        }
+        return v;
+    }
+
+    void ByteArray::writeFint8(int8_t value)
+    {
+        write(&value, sizeof(value));
+    }
+
+    void ByteArray::writeFuint8(uint8_t value)
+    {
+        write(&value, sizeof(value));
+    }
+
+    void ByteArray::writeFint16(int16_t value)
+    {
+        writeFixed(value);
+    }
+
+    void ByteArray::writeFuint16(uint16_t value)
+    {
+        writeFixed(value);
+    }
+
+    void ByteArray::writeFint32(int32_t value)
+    {
+        writeFixed(value);
+    }
+
+    void ByteArray::writeFuint32(uint32_t value)
+    {
+        writeFixed(value);
+    }
+
+    void ByteArray::writeFint64(int64_t value)
+    {
+        writeFixed(value);
+    }
+
+    void ByteArray::writeFuint64(uint64_t value)
+    {
+        writeFixed(value);
+    }
+
+    //zigzag编码, 让绝对值小的负数也只占用少量字节
+    static uint32_t EncodeZigzag32(const int32_t &v)
+    {
+        return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+    }
+
+    static uint64_t EncodeZigzag64(const int64_t &v)
+    {
+        return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63);
+    }
+
+    static int32_t DecodeZigzag32(const uint32_t &v)
+    {
+        return (int32_t)((v >> 1) ^ -(v & 1));
+    }
+
+    static int64_t DecodeZigzag64(const uint64_t &v)
+    {
+        return (int64_t)((v >> 1) ^ -(v & 1));
+    }
+
+    void ByteArray::writeInt32(int32_t value)
+    {
+        writeUint32(EncodeZigzag32(value));
+    }
+
+    void ByteArray::writeUint32(uint32_t value)
+    {
+        uint8_t tmp[5];
+        uint8_t i = 0;
+        while (value >= 0x80)
+        {
+            tmp[i++] = (value & 0x7F) | 0x80;
+            value >>= 7;
+        }
+        tmp[i++] = value;
+        write(tmp, i);
+    }
+
+    void ByteArray::writeInt64(int64_t value)
+    {
+        writeUint64(EncodeZigzag64(value));
+    }
+
+    void ByteArray::writeUint64(uint64_t value)
+    {
+        uint8_t tmp[10];
+        uint8_t i = 0;
+        while (value >= 0x80)
+        {
+            tmp[i++] = (value & 0x7F) | 0x80;
+            value >>= 7;
+        }
+        tmp[i++] = value;
+        write(tmp, i);
+    }
+
+    void ByteArray::writeFloat(float value)
+    {
+        uint32_t v;
+        memcpy(&v, &value, sizeof(value));
+        writeFuint32(v);
+    }
+
+    void ByteArray::writeDouble(double value)
+    {
+        uint64_t v;
+        memcpy(&v, &value, sizeof(value));
+        writeFuint64(v);
+    }
+
+    void ByteArray::writeStringF16(const std::string &value)
+    {
+        writeFuint16(value.size());
+        write(value.c_str(), value.size());
+    }
+
+    void ByteArray::writeStringF32(const std::string &value)
+    {
+        writeFuint32(value.size());
+        write(value.c_str(), value.size());
+    }
+
+    void ByteArray::writeStringF64(const std::string &value)
+    {
+        writeFuint64(value.size());
+        write(value.c_str(), value.size());
+    }
+
+    void ByteArray::writeStringVint(const std::string &value)
+    {
+        writeUint64(value.size());
+        write(value.c_str(), value.size());
+    }
+
+    void ByteArray::writeStringWithoutLength(const std::string &value)
+    {
+        write(value.c_str(), value.size());
+    }
+
+    int8_t ByteArray::readFint8()
+    {
+        int8_t v;
+        read(&v, sizeof(v));
+        return v;
+    }
+
+    uint8_t ByteArray::readFuint8()
+    {
+        uint8_t v;
+        read(&v, sizeof(v));
+        return v;
+    }
+
+    int16_t ByteArray::readFint16()
+    {
+        return readFixed<int16_t>();
+    }
+
+    uint16_t ByteArray::readFuint16()
+    {
+        return readFixed<uint16_t>();
+    }
+
+    int32_t ByteArray::readFint32()
+    {
+        return readFixed<int32_t>();
+    }
+
+    uint32_t ByteArray::readFuint32()
+    {
+        return readFixed<uint32_t>();
+    }
+
+    int64_t ByteArray::readFint64()
+    {
+        return readFixed<int64_t>();
+    }
+
+    uint64_t ByteArray::readFuint64()
+    {
+        return readFixed<uint64_t>();
+    }
+
+    int32_t ByteArray::readInt32()
+    {
+        return DecodeZigzag32(readUint32());
+    }
+
+    uint32_t ByteArray::readUint32()
+    {
+        uint32_t result = 0;
+        for (int i = 0; i < 35; i += 7)
+        {
+            uint8_t b = readFuint8();
+            result |= ((uint32_t)(b & 0x7F)) << i;
+            if (!(b & 0x80))
+            {
+                return result;
+            }
+        }
+        throw std::out_of_range("varint32 too long");
+    }
+
+    int64_t ByteArray::readInt64()
+    {
+        return DecodeZigzag64(readUint64());
+    }
+
+    uint64_t ByteArray::readUint64()
+    {
+        uint64_t result = 0;
+        for (int i = 0; i < 70; i += 7)
+        {
+            uint8_t b = readFuint8();
+            result |= ((uint64_t)(b & 0x7F)) << i;
+            if (!(b & 0x80))
+            {
+                return result;
+            }
+        }
+        throw std::out_of_range("varint64 too long");
+    }
+
+    float ByteArray::readFloat()
+    {
+        uint32_t v = readFuint32();
+        float value;
+        memcpy(&value, &v, sizeof(v));
+        return value;
+    }
+
+    double ByteArray::readDouble()
+    {
+        uint64_t v = readFuint64();
+        double value;
+        memcpy(&value, &v, sizeof(v));
+        return value;
+    }
+
+    //按长度前缀读取字符串, 长度超过可读数据时抛出异常, 避免按错误长度分配内存
+    static std::string ReadLengthString(ByteArray &ba, uint64_t len)
+    {
+        if (len > ba.getReadSize())
+        {
+            throw std::out_of_range("not enough len");
+        }
+        std::string buff;
+        buff.resize(len);
+        if (len)
+        {
+            ba.read(&buff[0], len);
+        }
+        return buff;
+    }
+
+    std::string ByteArray::readStringF16()
+    {
+        return ReadLengthString(*this, readFuint16());
+    }
+
+    std::string ByteArray::readStringF32()
+    {
+        return ReadLengthString(*this, readFuint32());
+    }
+
+    std::string ByteArray::readStringF64()
+    {
+        return ReadLengthString(*this, readFuint64());
+    }
+
+    std::string ByteArray::readStringVint()
+    {
+        return ReadLengthString(*this, readUint64());
+    }
+
+    void ByteArray::clear()
+    {
+        m_position = m_size = 0;
+        m_capacity = m_baseSize;
+        Node *tmp = m_root->next;
+        while (tmp)
+        {
+            m_cur = tmp;
+            tmp = tmp->next;
+            delete m_cur;
+        }
+        m_cur = m_root;
+        m_tail = m_root;
+        m_root->next = nullptr;
+    }
+
+    void ByteArray::write(const void *buf, size_t size)
+    {
+        if (size == 0)
+        {
+            return;
+        }
+        addCapacity(size);
+
+        const char *src = (const char *)buf;
+        while (size > 0)
+        {
+            size_t npos = m_position % m_baseSize;
+            size_t ncap = m_cur->size - npos;
+            size_t n = size < ncap ? size : ncap;
+            memcpy(m_cur->ptr + npos, src, n);
+            m_position += n;
+            src += n;
+            size -= n;
+            if (n == ncap)
+            {
+                m_cur = m_cur->next;
+            }
+        }
+
+        if (m_position > m_size)
+        {
+            m_size = m_position;
+        }
+    }
+
+    void ByteArray::read(void *buf, size_t size)
+    {
+        if (size > getReadSize())
+        {
+            throw std::out_of_range("not enough len");
+        }
+
+        char *dst = (char *)buf;
+        while (size > 0)
+        {
+            size_t npos = m_position % m_baseSize;
+            size_t ncap = m_cur->size - npos;
+            size_t n = size < ncap ? size : ncap;
+            memcpy(dst, m_cur->ptr + npos, n);
+            m_position += n;
+            dst += n;
+            size -= n;
+            if (n == ncap)
+            {
+                m_cur = m_cur->next;
+            }
+        }
+    }
+
+    void ByteArray::read(void *buf, size_t size, size_t position) const
+    {
+        if (position > m_size || size > (m_size - position))
+        {
+            throw std::out_of_range("not enough len");
+        }
+
+        Node *cur = findNode(position);
+        char *dst = (char *)buf;
+        while (size > 0)
+        {
+            size_t npos = position % m_baseSize;
+            size_t ncap = cur->size - npos;
+            size_t n = size < ncap ? size : ncap;
+            memcpy(dst, cur->ptr + npos, n);
+            position += n;
+            dst += n;
+            size -= n;
+            cur = cur->next;
+        }
+    }
+
+    ByteArray::Node *ByteArray::findNode(size_t position) const
+    {
+        Node *cur = m_root;
+        size_t count = position / m_baseSize;
+        while (count-- > 0 && cur)
+        {
+            cur = cur->next;
+        }
+        return cur;
+    }
+
+    void ByteArray::setPosition(size_t v)
+    {
+        if (v > m_capacity)
+        {
+            throw std::out_of_range("set_position out of range");
+        }
+        m_position = v;
+        if (m_position > m_size)
+        {
+            m_size = m_position;
+        }
+        m_cur = findNode(v);
+    }
+
+    bool ByteArray::writeToFile(const std::string &name) const
+    {
+        std::ofstream ofs;
+        ofs.open(name, std::ios::trunc | std::ios::binary);
+        if (!ofs)
+        {
+            SYLAR_LOG_ERROR(g_logger) << "writeToFile name=" << name
+                                      << " error , errno=" << errno << " errstr=" << strerror(errno);
+            return false;
+        }
+
+        std::vector<iovec> iovs;
+        getReadBuffers(iovs);
+        for (auto &i : iovs)
+        {
+            ofs.write((const char *)i.iov_base, i.iov_len);
+        }
+        return (bool)ofs;
+    }
+
+    bool ByteArray::readFromFile(const std::string &name)
+    {
+        //不用mmap: 文件可能被外部截断, 映射读取会SIGBUS
+        int fd = open(name.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            SYLAR_LOG_ERROR(g_logger) << "readFromFile name=" << name
+                                      << " error, errno=" << errno << " errstr=" << strerror(errno);
+            return false;
+        }
+
+        //按文件大小一次分配并读入内存块(多读1字节以确认到达EOF), 文件在读取期间变大时再按批追加
+        struct stat st;
+        uint64_t batch = 0;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
+        {
+            batch = (uint64_t)st.st_size + 1;
+        }
+        batch = std::max<uint64_t>(batch, m_baseSize);
+        while (true)
+        {
+            std::vector<iovec> iovs;
+            uint64_t len = getWriteBuffers(iovs, batch);
+            ssize_t rt = IOUtil::ReadvFull(fd, &iovs[0], iovs.size());
+            if (rt < 0)
+            {
+                SYLAR_LOG_ERROR(g_logger) << "readFromFile name=" << name
+                                          << " error, errno=" << errno << " errstr=" << strerror(errno);
+                close(fd);
+                return false;
+            }
+            //与write()相同, 沿m_cur逐块推进, 不从头查找节点
+            size_t left = rt;
+            while (left > 0)
+            {
+                size_t npos = m_position % m_baseSize;
+                size_t ncap = m_cur->size - npos;
+                size_t n = left < ncap ? left : ncap;
+                m_position += n;
+                left -= n;
+                if (n == ncap)
+                {
+                    m_cur = m_cur->next;
+                }
+            }
+            if (m_position > m_size)
+            {
+                m_size = m_position;
+            }
+            if ((uint64_t)rt < len)
+            {
+                break;
+            }
+            batch = std::max<uint64_t>(batch, 64 * m_baseSize);
+        }
+        close(fd);
+        return true;
+    }
+
+    void ByteArray::addCapacity(size_t size)
+    {
+        size_t old_cap = getCapacity();
+        if (old_cap >= size)
+        {
+            return;
+        }
+
+        size = size - old_cap;
+        size_t count = (size + m_baseSize - 1) / m_baseSize;
+        Node *first = nullptr;
+        for (size_t i = 0; i < count; ++i)
+        {
+            m_tail->next = new Node(m_baseSize);
+            m_tail = m_tail->next;
+            if (!first)
+            {
+                first = m_tail;
+            }
+            m_capacity += m_baseSize;
+        }
+
+        if (!m_cur)
+        {
+            m_cur = first;
+        }
+    }
+
+    std::string ByteArray::toString() const
+    {
+        std::string str;
+        str.resize(getReadSize());
+        if (str.empty())
+        {
+            return str;
+        }
+        read(&str[0], str.size(), m_position);
+        return str;
+    }
+
+    std::string ByteArray::toHexString() const
+    {
+        std::string str = toString();
+        std::stringstream ss;
+
+        for (size_t i = 0; i < str.size(); ++i)
+        {
+            if (i > 0 && i % 32 == 0)
+            {
+                ss << std::endl;
+            }
+            ss << std::setw(2) << std::setfill('0') << std::hex
+               << (int)(uint8_t)str[i] << " ";
+        }
+
+        return ss.str();
+    }
+
+    uint64_t ByteArray::getReadBuffers(std::vector<iovec> &buffers, uint64_t len) const
+    {
+        return getReadBuffers(buffers, len, m_position);
+    }
+
+    uint64_t ByteArray::getReadBuffers(std::vector<iovec> &buffers, uint64_t len, uint64_t position) const
+    {
+        if (position >= m_size)
+        {
+            return 0;
+        }
+        len = len > m_size - position ? m_size - position : len;
+        if (len == 0)
+        {
+            return 0;
+        }
+
+        uint64_t size = len;
+        Node *cur = findNode(position);
+        size_t npos = position % m_baseSize;
+        while (len > 0)
+        {
+            size_t ncap = cur->size - npos;
+            struct iovec iov;
+            iov.iov_base = cur->ptr + npos;
+            iov.iov_len = len < ncap ? len : ncap;
+            len -= iov.iov_len;
+            buffers.push_back(iov);
+            cur = cur->next;
+            npos = 0;
+        }
+        return size;
+    }
+
+    uint64_t ByteArray::getWriteBuffers(std::vector<iovec> &buffers, uint64_t len)
+    {
+        if (len == 0)
+        {
+            return 0;
+        }
+        addCapacity(len);
+        uint64_t size = len;
+
+        Node *cur = m_cur;
+        size_t npos = m_position % m_baseSize;
+        while (len > 0)
+        {
+            size_t ncap = cur->size - npos;
+            struct iovec iov;
+            iov.iov_base = cur->ptr + npos;
+            iov.iov_len = len < ncap ? len : ncap;
+            len -= iov.iov_len;
+            buffers.push_back(iov);
+            cur = cur->next;
+            npos = 0;
+        }
+        return size;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,279 @@
+//二进制数组(序列化/反序列化)
+#ifndef __SYLAR_BYTEARRAY_H__
+#define __SYLAR_BYTEARRAY_H__
+
+#include <memory>
+#include <string>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <vector>
+
+namespace sylar
+{
+
+    /**
+     * @brief 二进制数组, 提供基础类型的序列化与反序列化功能
+     * @details 数据存放在固定大小内存块组成的链表中, 扩容时只追加新块不搬移旧数据;
+     *          定长整数按设置的字节序编码(默认网络字节序), 变长整数使用varint,
+     *          有符号变长整数先做zigzag编码
+     */
+    class ByteArray
+    {
+    public:
+        typedef std::shared_ptr<ByteArray> ptr;
+
+        //ByteArray的存储节点
+        struct Node
+        {
+            /**
+             * @brief 构造指定大小的内存块
+             * @param[in] s 内存块字节数
+             */
+            Node(size_t s);
+
+            //无参构造函数
+            Node();
+
+            //析构函数, 释放内存
+            ~Node();
+
+            char *ptr;   /// 内存块地址指针
+            Node *next;  /// 下一个内存块地址
+            size_t size; /// 内存块大小
+        };
+
+        /**
+         * @brief 使用指定长度的内存块构造ByteArray
+         * @param[in] base_size 内存块大小
+         */
+        ByteArray(size_t base_size = 4096);
+
+        //析构函数
+        ~ByteArray();
+
+        /**
+         * @brief 写入固定长度的数据
+         * @post m_position += sizeof(value)
+         *       如果m_position > m_size 则 m_size = m_position
+         */
+        void writeFint8(int8_t value);
+        void writeFuint8(uint8_t value);
+        void writeFint16(int16_t value);
+        void writeFuint16(uint16_t value);
+        void writeFint32(int32_t value);
+        void writeFuint32(uint32_t value);
+        void writeFint64(int64_t value);
+        void writeFuint64(uint64_t value);
+
+        /**
+         * @brief 写入变长数据(varint, 有符号数先zigzag编码)
+         * @post m_position += 实际占用内存(1 ~ 10字节)
+         *       如果m_position > m_size 则 m_size = m_position
+         */
+        void writeInt32(int32_t value);
+        void writeUint32(uint32_t value);
+        void writeInt64(int64_t value);
+        void writeUint64(uint64_t value);
+
+        //写入float类型的数据
+        void writeFloat(float value);
+
+        //写入double类型的数据
+        void writeDouble(double value);
+
+        /**
+         * @brief 写入std::string类型的数据, 用uint16_t作为长度类型
+         * @post m_position += 2 + value.size()
+         */
+        void writeStringF16(const std::string &value);
+
+        /**
+         * @brief 写入std::string类型的数据, 用uint32_t作为长度类型
+         * @post m_position += 4 + value.size()
+         */
+        void writeStringF32(const std::string &value);
+
+        /**
+         * @brief 写入std::string类型的数据, 用uint64_t作为长度类型
+         * @post m_position += 8 + value.size()
+         */
+        void writeStringF64(const std::string &value);
+
+        /**
+         * @brief 写入std::string类型的数据, 用无符号varint作为长度类型
+         * @post m_position += varint长度 + value.size()
+         */
+        void writeStringVint(const std::string &value);
+
+        /**
+         * @brief 写入std::string类型的数据, 无长度
+         * @post m_position += value.size()
+         */
+        void writeStringWithoutLength(const std::string &value);
+
+        /**
+         * @brief 读取固定长度的数据
+         * @pre getReadSize() >= sizeof(类型)
+         * @post m_position += sizeof(类型)
+         * @exception 如果getReadSize() < sizeof(类型) 抛出 std::out_of_range
+         */
+        int8_t readFint8();
+        uint8_t readFuint8();
+        int16_t readFint16();
+        uint16_t readFuint16();
+        int32_t readFint32();
+        uint32_t readFuint32();
+        int64_t readFint64();
+        uint64_t readFuint64();
+
+        /**
+         * @brief 读取变长数据
+         * @exception 数据不足或varint超长时抛出 std::out_of_range
+         */
+        int32_t readInt32();
+        uint32_t readUint32();
+        int64_t readInt64();
+        uint64_t readUint64();
+
+        //读取float类型的数据
+        float readFloat();
+
+        //读取double类型的数据
+        double readDouble();
+
+        //读取std::string类型的数据, 用uint16_t作为长度
+        std::string readStringF16();
+
+        //读取std::string类型的数据, 用uint32_t作为长度
+        std::string readStringF32();
+
+        //读取std::string类型的数据, 用uint64_t作为长度
+        std::string readStringF64();
+
+        //读取std::string类型的数据, 用无符号varint作为长度
+        std::string readStringVint();
+
+        //清空ByteArray
+        void clear();
+
+        /**
+         * @brief 写入size长度的数据
+         * @param[in] buf 内存缓存指针
+         * @param[in] size 数据大小
+         * @post m_position += size, 如果m_position > m_size 则 m_size = m_position
+         */
+        void write(const void *buf, size_t size);
+
+        /**
+         * @brief 读取size长度的数据
+         * @post m_position += size
+         * @exception 如果getReadSize() < size 则抛出 std::out_of_range
+         */
+        void read(void *buf, size_t size);
+
+        /**
+         * @brief 从position位置读取size长度的数据, 不改变当前位置
+         * @exception 如果(m_size - position) < size 则抛出 std::out_of_range
+         */
+        void read(void *buf, size_t size, size_t position) const;
+
+        //返回ByteArray当前位置
+        size_t getPosition() const { return m_position; }
+
+        /**
+         * @brief 设置ByteArray当前位置
+         * @post 如果m_position > m_size 则 m_size = m_position
+         * @exception 如果m_position > m_capacity 则抛出 std::out_of_range
+         */
+        void setPosition(size_t v);
+
+        /**
+         * @brief 把ByteArray从当前位置开始的可读数据写入到文件中
+         * @param[in] name 文件名
+         */
+        bool writeToFile(const std::string &name) const;
+
+        /**
+         * @brief 从文件中读取数据, 追加写入到当前位置
+         * @param[in] name 文件名
+         */
+        bool readFromFile(const std::string &name);
+
+        //返回内存块的大小
+        size_t getBaseSize() const { return m_baseSize; }
+
+        //返回可读取数据大小
+        size_t getReadSize() const { return m_size - m_position; }
+
+        //是否是小端
+        bool isLittleEndian() const;
+
+        //设置是否为小端
+        void setIsLittleEndian(bool val);
+
+        //将ByteArray里面的数据[m_position, m_size)转成std::string
+        std::string toString() const;
+
+        //将ByteArray里面的数据[m_position, m_size)转成16进制的std::string(格式:FF FF FF)
+        std::string toHexString() const;
+
+        /**
+         * @brief 获取可读取的缓存, 保存成iovec数组, 用于readv/writev/sendmsg
+         * @param[out] buffers 保存可读取数据的iovec数组
+         * @param[in] len 读取数据的长度, 如果len > getReadSize() 则 len = getReadSize()
+         * @return 返回实际数据的长度
+         */
+        uint64_t getReadBuffers(std::vector<iovec> &buffers, uint64_t len = ~0ull) const;
+
+        /**
+         * @brief 获取从position位置开始的可读取缓存, 保存成iovec数组
+         * @return 返回实际数据的长度
+         */
+        uint64_t getReadBuffers(std::vector<iovec> &buffers, uint64_t len, uint64_t position) const;
+
+        /**
+         * @brief 获取可写入的缓存, 保存成iovec数组
+         * @param[out] buffers 保存可写入的内存的iovec数组
+         * @param[in] len 写入的长度
+         * @return 返回实际的长度
+         * @post 如果(m_position + len) > m_capacity 则 m_capacity扩容N个节点以容纳len长度;
+         *       写入完成后由调用者setPosition(getPosition() + 实际写入长度)
+         */
+        uint64_t getWriteBuffers(std::vector<iovec> &buffers, uint64_t len);
+
+        //返回数据的长度
+        size_t getSize() const { return m_size; }
+
+    private:
+        //扩容ByteArray, 使其可以容纳size个数据(如果原本可以容纳, 则不扩容)
+        void addCapacity(size_t size);
+
+        //获取当前的可写入容量
+        size_t getCapacity() const { return m_capacity - m_position; }
+
+        //返回position所在的内存块
+        Node *findNode(size_t position) const;
+
+        //写入定长整数, 按需转换字节序
+        template <class T>
+        void writeFixed(T value);
+
+        //读取定长整数, 按需转换字节序
+        template <class T>
+        T readFixed();
+
+    private:
+        size_t m_baseSize;  /// 内存块的大小
+        size_t m_position;  /// 当前操作位置
+        size_t m_capacity;  /// 当前的总容量
+        size_t m_size;      /// 当前数据的大小
+        int8_t m_endian;    /// 字节序, 默认大端
+        Node *m_root;       /// 第一个内存块指针
+        Node *m_cur;        /// 当前位置所在的内存块指针, 位置恰好在容量末尾时为nullptr
+        Node *m_tail;       /// 最后一个内存块指针
+    };
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,416 @@
+#include "sylar/config.h"
+#include <sys/inotify.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <poll.h>
+#include <dirent.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <algorithm>
+#include <thread>
+
+namespace sylar
+{
+
+    static sylar::Logger::ptr g_logger = SYLAR_LOG_NAME("system");
+
+    //inotify事件后等待的合并时间, 编辑器保存通常会产生一串事件
+    static const int s_watch_settle_ms = 200;
+    //第一个事件之后最多等待的时间, 持续写入的目录也要按时重新加载
+    static const int s_watch_max_delay_ms = 2000;
+
+    static int64_t MonotonicMS()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000ll + ts.tv_nsec / 1000000;
+    }
+
+    ConfigVarBase::ptr Config::LookupBase(const std::string &name)
+    {
+        RWMutexType::ReadLock lock(GetMutex());
+        auto it = GetDatas().find(ToLower(name));
+        return it == GetDatas().end() ? nullptr : it->second;
+    }
+
+    bool Config::IsValidName(const std::string &name)
+    {
+        if (name.empty())
+        {
+            return false;
+        }
+        for (char c : name)
+        {
+            if (!((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_' || c == '.'))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //"A.B", 10
+    //A:
+    //  B: 10
+    //  C: str
+    static void ListAllMember(const std::string &prefix,
+                              const YAML::Node &node,
+                              std::list<std::pair<std::string, const YAML::Node>> &output)
+    {
+        if (!Config::IsValidName(prefix) && !prefix.empty())
+        {
+            SYLAR_LOG_ERROR(g_logger) << "Config invalid name: " << prefix << " : " << node;
+            return;
+        }
+        output.push_back(std::make_pair(prefix, node));
+        if (node.IsMap())
+        {
+            for (auto it = node.begin(); it != node.end(); ++it)
+            {
+                ListAllMember(prefix.empty() ? it->first.Scalar()
+                                             : prefix + "." + it->first.Scalar(),
+                              it->second, output);
+            }
+        }
+    }
+
+    void Config::LoadFromYaml(const YAML::Node &root)
+    {
+        std::list<std::pair<std::string, const YAML::Node>> all_nodes;
+        ListAllMember("", root, all_nodes);
+
+        for (auto &i : all_nodes)
+        {
+            std::string key = i.first;
+            if (key.empty())
+            {
+                continue;
+            }
+
+            ToLowerInPlace(key);
+            ConfigVarBase::ptr var = LookupBase(key);
+
+            if (var)
+            {
+                if (i.second.IsScalar())
+                {
+                    var->fromString(i.second.Scalar());
+                }
+                else
+                {
+                    std::stringstream ss;
+                    ss << i.second;
+                    var->fromString(ss.str());
+                }
+            }
+        }
+    }
+
+    //文件的修改标记, 修改时间精确到纳秒, 同一秒内的多次保存也能识别
+    struct FileStamp
+    {
+        int64_t mtime = 0;
+        int64_t size = -1;
+
+        bool operator==(const FileStamp &o) const
+        {
+            return mtime == o.mtime && size == o.size;
+        }
+    };
+
+    static Mutex s_file_mutex;
+    static std::map<std::string, FileStamp> s_file2stamp;
+
+    void Config::LoadFromConfDir(const std::string &path, bool force)
+    {
+        std::vector<std::string> files;
+        FSUtil::ListAllFile(files, path, ".yml");
+
+        for (auto &i : files)
+        {
+            struct stat st;
+            if (stat(i.c_str(), &st) != 0)
+            {
+                continue;
+            }
+            FileStamp stamp;
+            stamp.mtime = st.st_mtim.tv_sec * 1000000000ll + st.st_mtim.tv_nsec;
+            stamp.size = st.st_size;
+            {
+                Mutex::Lock lock(s_file_mutex);
+                if (!force && s_file2stamp[i] == stamp)
+                {
+                    continue;
+                }
+                s_file2stamp[i] = stamp;
+            }
+            //配置文件可能正被外部编辑截断, 按普通读取, 不做mmap(截断时会SIGBUS)
+            try
+            {
+                YAML::Node root = YAML::LoadFile(i);
+                LoadFromYaml(root);
+                SYLAR_LOG_INFO(g_logger) << "LoadConfFile file="
+                                         << i << " ok";
+            }
+            catch (...)
+            {
+                SYLAR_LOG_ERROR(g_logger) << "LoadConfFile file="
+                                          << i << " failed";
+            }
+        }
+    }
+
+    void Config::Visit(std::function<void(ConfigVarBase::ptr)> cb)
+    {
+        RWMutexType::ReadLock lock(GetMutex());
+        ConfigVarMap &m = GetDatas();
+        for (auto it = m.begin(); it != m.end(); ++it)
+        {
+            cb(it->second);
+        }
+    }
+
+    /**
+     * @brief 配置目录监听器
+     * @details inotify不支持递归监听, 启动时和新建子目录时逐个目录添加watch。
+     *          停止时通过eventfd唤醒后台线程
+     */
+    class ConfigWatcher
+    {
+    public:
+        ConfigWatcher(const std::string &path)
+            : m_path(path), m_inotifyFd(-1), m_stopFd(-1)
+        {
+        }
+
+        ~ConfigWatcher()
+        {
+            stop();
+            if (m_inotifyFd >= 0)
+            {
+                close(m_inotifyFd);
+            }
+            if (m_stopFd >= 0)
+            {
+                close(m_stopFd);
+            }
+        }
+
+        bool start()
+        {
+            m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (m_inotifyFd < 0)
+            {
+                SYLAR_LOG_ERROR(g_logger) << "inotify_init1 errno=" << errno
+                                          << " errstr=" << strerror(errno);
+                return false;
+            }
+            m_stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+            if (m_stopFd < 0)
+            {
+                SYLAR_LOG_ERROR(g_logger) << "eventfd errno=" << errno
+                                          << " errstr=" << strerror(errno);
+                return false;
+            }
+            if (!addWatchRecursive(m_path))
+            {
+                return false;
+            }
+            m_thread = std::thread(&ConfigWatcher::run, this);
+            return true;
+        }
+
+        void stop()
+        {
+            if (!m_thread.joinable())
+            {
+                return;
+            }
+            uint64_t one = 1;
+            if (write(m_stopFd, &one, sizeof(one)) != sizeof(one))
+            {
+                SYLAR_LOG_ERROR(g_logger) << "ConfigWatcher stop write eventfd failed errno=" << errno;
+            }
+            m_thread.join();
+        }
+
+    private:
+        bool addWatch(const std::string &dir)
+        {
+            int wd = inotify_add_watch(m_inotifyFd, dir.c_str(),
+                                       IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_CREATE | IN_DELETE | IN_ONLYDIR);
+            if (wd < 0)
+            {
+                SYLAR_LOG_ERROR(g_logger) << "inotify_add_watch dir=" << dir
+                                          << " errno=" << errno << " errstr=" << strerror(errno);
+                return false;
+            }
+            m_wd2dir[wd] = dir;
+            return true;
+        }
+
+        bool addWatchRecursive(const std::string &dir)
+        {
+            if (!addWatch(dir))
+            {
+                return false;
+            }
+            DIR *d = opendir(dir.c_str());
+            if (!d)
+            {
+                return true;
+            }
+            struct dirent *dp = nullptr;
+            while ((dp = readdir(d)) != nullptr)
+            {
+                if (dp->d_type == DT_DIR && strcmp(dp->d_name, ".") && strcmp(dp->d_name, ".."))
+                {
+                    addWatchRecursive(dir + "/" + dp->d_name);
+                }
+            }
+            closedir(d);
+            return true;
+        }
+
+        /**
+         * @brief 读出所有就绪的inotify事件
+         * @return 是否有需要重新加载的变化
+         */
+        bool drain()
+        {
+            alignas(struct inotify_event) char buf[4096];
+            bool changed = false;
+            while (true)
+            {
+                ssize_t n = read(m_inotifyFd, buf, sizeof(buf));
+                if (n <= 0)
+                {
+                    break;
+                }
+                for (char *p = buf; p < buf + n;)
+                {
+                    struct inotify_event *ev = (struct inotify_event *)p;
+                    p += sizeof(struct inotify_event) + ev->len;
+                    if (ev->mask & IN_IGNORED)
+                    {
+                        m_wd2dir.erase(ev->wd);
+                        continue;
+                    }
+                    if (ev->mask & IN_Q_OVERFLOW)
+                    {
+                        changed = true;
+                        continue;
+                    }
+                    auto it = m_wd2dir.find(ev->wd);
+                    if (it == m_wd2dir.end() || ev->len == 0)
+                    {
+                        continue;
+                    }
+                    if (ev->mask & IN_ISDIR)
+                    {
+                        if (ev->mask & (IN_CREATE | IN_MOVED_TO))
+                        {
+                            addWatchRecursive(it->second + "/" + ev->name);
+                            changed = true;
+                        }
+                        continue;
+                    }
+                    //临时文件/交换文件不关心, 只看.yml
+                    size_t len = strlen(ev->name);
+                    if (len >= 4 && !strcmp(ev->name + len - 4, ".yml"))
+                    {
+                        changed = true;
+                    }
+                }
+            }
+            return changed;
+        }
+
+        void run()
+        {
+            struct pollfd fds[2];
+            fds[0].fd = m_inotifyFd;
+            fds[0].events = POLLIN;
+            fds[1].fd = m_stopFd;
+            fds[1].events = POLLIN;
+
+            //pending时: settle为最后一个事件后的静默截止时间, deadline为第一个事件后的最迟重新加载时间
+            bool pending = false;
+            int64_t settle = 0;
+            int64_t deadline = 0;
+            while (true)
+            {
+                int timeout = -1;
+                if (pending)
+                {
+                    int64_t now = MonotonicMS();
+                    if (now >= settle || now >= deadline)
+                    {
+                        pending = false;
+                        SYLAR_LOG_INFO(g_logger) << "config dir changed, reload path=" << m_path;
+                        Config::LoadFromConfDir(m_path, false);
+                        continue;
+                    }
+                    timeout = (int)(std::min(settle, deadline) - now);
+                }
+                fds[0].revents = fds[1].revents = 0;
+                int rt = poll(fds, 2, timeout);
+                if (rt < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    SYLAR_LOG_ERROR(g_logger) << "ConfigWatcher poll errno=" << errno
+                                              << " errstr=" << strerror(errno);
+                    break;
+                }
+                if (fds[1].revents)
+                {
+                    break;
+                }
+                if (rt > 0 && drain())
+                {
+                    int64_t now = MonotonicMS();
+                    if (!pending)
+                    {
+                        pending = true;
+                        deadline = now + s_watch_max_delay_ms;
+                    }
+                    settle = now + s_watch_settle_ms;
+                }
+            }
+        }
+
+    private:
+        std::string m_path;
+        int m_inotifyFd;
+        int m_stopFd;
+        std::thread m_thread;
+        std::map<int, std::string> m_wd2dir; /// 仅在后台线程和start中访问
+    };
+
+    static Mutex s_watch_mutex;
+    static std::unique_ptr<ConfigWatcher> s_watcher;
+
+    bool Config::StartWatch(const std::string &path)
+    {
+        Mutex::Lock lock(s_watch_mutex);
+        s_watcher.reset();
+        std::unique_ptr<ConfigWatcher> w(new ConfigWatcher(path));
+        if (!w->start())
+        {
+            return false;
+        }
+        s_watcher = std::move(w);
+        return true;
+    }
+
+    void Config::StopWatch()
+    {
+        Mutex::Lock lock(s_watch_mutex);
+        s_watcher.reset();
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,631 @@
+#ifndef __SYLAR_CONFIG_H__
+#define __SYLAR_CONFIG_H__
+
+#include <memory>
+#include <string>
+#include <sstream>
+#include <functional>
+#include <atomic>
+#include <vector>
+#include <list>
+#include <set>
+#include <map>
+#include <unordered_set>
+#include <unordered_map>
+#include <boost/lexical_cast.hpp>
+#include <yaml-cpp/yaml.h>
+#include "log.h"
+#include "util.h"
+#include "mutex.h"
+#include "epoch.h"
+
+namespace sylar
+{
+
+    /**
+     * @brief 配置变量的基类
+     */
+    class ConfigVarBase
+    {
+    public:
+        typedef std::shared_ptr<ConfigVarBase> ptr;
+
+        /**
+         * @brief 构造函数
+         * @param[in] name 配置参数名称[0-9a-z_.]
+         * @param[in] description 配置参数描述
+         */
+        ConfigVarBase(const std::string &name, const std::string &description = "")
+            : m_name(name), m_description(description)
+        {
+            ToLowerInPlace(m_name);
+        }
+
+        virtual ~ConfigVarBase() {}
+
+        //返回配置参数名称
+        const std::string &getName() const { return m_name; }
+
+        //返回配置参数的描述
+        const std::string &getDescription() const { return m_description; }
+
+        //转成字符串
+        virtual std::string toString() = 0;
+
+        /**
+         * @brief 从字符串初始化值
+         * @return 转换失败返回false, 原值保持不变
+         */
+        virtual bool fromString(const std::string &val) = 0;
+
+        //返回配置参数值的类型名称
+        virtual std::string getTypeName() const = 0;
+
+    protected:
+        std::string m_name;        /// 配置参数的名称
+        std::string m_description; /// 配置参数的描述
+    };
+
+    /**
+     * @brief 类型转换模板类(F 源类型, T 目标类型)
+     */
+    template <class F, class T>
+    class LexicalCast
+    {
+    public:
+        T operator()(const F &v)
+        {
+            return boost::lexical_cast<T>(v);
+        }
+    };
+
+    /**
+     * @brief YAML String 转换成 std::vector<T>
+     */
+    template <class T>
+    class LexicalCast<std::string, std::vector<T>>
+    {
+    public:
+        std::vector<T> operator()(const std::string &v)
+        {
+            YAML::Node node = YAML::Load(v);
+            std::vector<T> vec;
+            std::stringstream ss;
+            for (size_t i = 0; i < node.size(); ++i)
+            {
+                ss.str("");
+                ss << node[i];
+                vec.push_back(LexicalCast<std::string, T>()(ss.str()));
+            }
+            return vec;
+        }
+    };
+
+    /**
+     * @brief std::vector<T> 转换成 YAML String
+     */
+    template <class T>
+    class LexicalCast<std::vector<T>, std::string>
+    {
+    public:
+        std::string operator()(const std::vector<T> &v)
+        {
+            YAML::Node node(YAML::NodeType::Sequence);
+            for (auto &i : v)
+            {
+                node.push_back(YAML::Load(LexicalCast<T, std::string>()(i)));
+            }
+            std::stringstream ss;
+            ss << node;
+            return ss.str();
+        }
+    };
+
+    /**
+     * @brief YAML String 转换成 std::list<T>
+     */
+    template <class T>
+    class LexicalCast<std::string, std::list<T>>
+    {
+    public:
+        std::list<T> operator()(const std::string &v)
+        {
+            YAML::Node node = YAML::Load(v);
+            std::list<T> vec;
+            std::stringstream ss;
+            for (size_t i = 0; i < node.size(); ++i)
+            {
+                ss.str("");
+                ss << node[i];
+                vec.push_back(LexicalCast<std::string, T>()(ss.str()));
+            }
+            return vec;
+        }
+    };
+
+    /**
+     * @brief std::list<T> 转换成 YAML String
+     */
+    template <class T>
+    class LexicalCast<std::list<T>, std::string>
+    {
+    public:
+        std::string operator()(const std::list<T> &v)
+        {
+            YAML::Node node(YAML::NodeType::Sequence);
+            for (auto &i : v)
+            {
+                node.push_back(YAML::Load(LexicalCast<T, std::string>()(i)));
+            }
+            std::stringstream ss;
+            ss << node;
+            return ss.str();
+        }
+    };
+
+    /**
+     * @brief YAML String 转换成 std::set<T>
+     */
+    template <class T>
+    class LexicalCast<std::string, std::set<T>>
+    {
+    public:
+        std::set<T> operator()(const std::string &v)
+        {
+            YAML::Node node = YAML::Load(v);
+            std::set<T> vec;
+            std::stringstream ss;
+            for (size_t i = 0; i < node.size(); ++i)
+            {
+                ss.str("");
+                ss << node[i];
+                vec.insert(LexicalCast<std::string, T>()(ss.str()));
+            }
+            return vec;
+        }
+    };
+
+    /**
+     * @brief std::set<T> 转换成 YAML String
+     */
+    template <class T>
+    class LexicalCast<std::set<T>, std::string>
+    {
+    public:
+        std::string operator()(const std::set<T> &v)
+        {
+            YAML::Node node(YAML::NodeType::Sequence);
+            for (auto &i : v)
+            {
+                node.push_back(YAML::Load(LexicalCast<T, std::string>()(i)));
+            }
+            std::stringstream ss;
+            ss << node;
+            return ss.str();
+        }
+    };
+
+    /**
+     * @brief YAML String 转换成 std::unordered_set<T>
+     */
+    template <class T>
+    class LexicalCast<std::string, std::unordered_set<T>>
+    {
+    public:
+        std::unordered_set<T> operator()(const std::string &v)
+        {
+            YAML::Node node = YAML::Load(v);
+            std::unordered_set<T> vec;
+            std::stringstream ss;
+            for (size_t i = 0; i < node.size(); ++i)
+            {
+                ss.str("");
+                ss << node[i];
+                vec.insert(LexicalCast<std::string, T>()(ss.str()));
+            }
+            return vec;
+        }
+    };
+
+    /**
+     * @brief std::unordered_set<T> 转换成 YAML String
+     */
+    template <class T>
+    class LexicalCast<std::unordered_set<T>, std::string>
+    {
+    public:
+        std::string operator()(const std::unordered_set<T> &v)
+        {
+            YAML::Node node(YAML::NodeType::Sequence);
+            for (auto &i : v)
+            {
+                node.push_back(YAML::Load(LexicalCast<T, std::string>()(i)));
+            }
+            std::stringstream ss;
+            ss << node;
+            return ss.str();
+        }
+    };
+
+    /**
+     * @brief YAML String 转换成 std::map<std::string, T>
+     */
+    template <class T>
+    class LexicalCast<std::string, std::map<std::string, T>>
+    {
+    public:
+        std::map<std::string, T> operator()(const std::string &v)
+        {
+            YAML::Node node = YAML::Load(v);
+            std::map<std::string, T> vec;
+            std::stringstream ss;
+            for (auto it = node.begin(); it != node.end(); ++it)
+            {
+                ss.str("");
+                ss << it->second;
+                vec.insert(std::make_pair(it->first.Scalar(),
+                                          LexicalCast<std::string, T>()(ss.str())));
+            }
+            return vec;
+        }
+    };
+
+    /**
+     * @brief std::map<std::string, T> 转换成 YAML String
+     */
+    template <class T>
+    class LexicalCast<std::map<std::string, T>, std::string>
+    {
+    public:
+        std::string operator()(const std::map<std::string, T> &v)
+        {
+            YAML::Node node(YAML::NodeType::Map);
+            for (auto &i : v)
+            {
+                node[i.first] = YAML::Load(LexicalCast<T, std::string>()(i.second));
+            }
+            std::stringstream ss;
+            ss << node;
+            return ss.str();
+        }
+    };
+
+    /**
+     * @brief YAML String 转换成 std::unordered_map<std::string, T>
+     */
+    template <class T>
+    class LexicalCast<std::string, std::unordered_map<std::string, T>>
+    {
+    public:
+        std::unordered_map<std::string, T> operator()(const std::string &v)
+        {
+            YAML::Node node = YAML::Load(v);
+            std::unordered_map<std::string, T> vec;
+            std::stringstream ss;
+            for (auto it = node.begin(); it != node.end(); ++it)
+            {
+                ss.str("");
+                ss << it->second;
+                vec.insert(std::make_pair(it->first.Scalar(),
+                                          LexicalCast<std::string, T>()(ss.str())));
+            }
+            return vec;
+        }
+    };
+
+    /**
+     * @brief std::unordered_map<std::string, T> 转换成 YAML String
+     */
+    template <class T>
+    class LexicalCast<std::unordered_map<std::string, T>, std::string>
+    {
+    public:
+        std::string operator()(const std::unordered_map<std::string, T> &v)
+        {
+            YAML::Node node(YAML::NodeType::Map);
+            for (auto &i : v)
+            {
+                node[i.first] = YAML::Load(LexicalCast<T, std::string>()(i.second));
+            }
+            std::stringstream ss;
+            ss << node;
+            return ss.str();
+        }
+    };
+
+    /**
+     * @brief 配置参数模板子类, 保存对应类型的参数值
+     * @details T 参数的具体类型
+     *          FromStr 从std::string转换成T类型的仿函数
+     *          ToStr 从T转换成std::string的仿函数
+     *
+     *  值保存在EpochPtr中, 读取只进入epoch临界区后加载指针, 不加锁;
+     *  修改时复制出新值再原子替换, 旧值在所有读者离开后回收。
+     *  写操作之间用互斥锁串行, 监听回调在替换完成后按注册顺序调用
+     */
+    template <class T, class FromStr = LexicalCast<std::string, T>, class ToStr = LexicalCast<T, std::string>>
+    class ConfigVar : public ConfigVarBase
+    {
+    public:
+        typedef std::shared_ptr<ConfigVar> ptr;
+        typedef Mutex MutexType;
+        typedef RWMutex RWMutexType;
+        typedef std::function<void(const T &old_value, const T &new_value)> on_change_cb;
+
+        /**
+         * @brief 通过参数名,参数值,描述构造ConfigVar
+         * @param[in] name 参数名称有效字符为[0-9a-z_.]
+         * @param[in] default_value 参数的默认值
+         * @param[in] description 参数的描述
+         */
+        ConfigVar(const std::string &name, const T &default_value, const std::string &description = "")
+            : ConfigVarBase(name, description), m_val(new T(default_value))
+        {
+        }
+
+        //将参数值转换成YAML String
+        std::string toString() override
+        {
+            try
+            {
+                EpochGuard guard;
+                return ToStr()(*m_val.load());
+            }
+            catch (std::exception &e)
+            {
+                SYLAR_LOG_ERROR(SYLAR_LOG_ROOT()) << "ConfigVar::toString exception "
+                                                  << e.what() << " convert: " << TypeToName<T>() << " to string"
+                                                  << " name=" << m_name;
+            }
+            return "";
+        }
+
+        //从YAML String转成参数的值
+        bool fromString(const std::string &val) override
+        {
+            try
+            {
+                setValue(FromStr()(val));
+                return true;
+            }
+            catch (std::exception &e)
+            {
+                SYLAR_LOG_ERROR(SYLAR_LOG_ROOT()) << "ConfigVar::fromString exception "
+                                                  << e.what() << " convert: string to " << TypeToName<T>()
+                                                  << " name=" << m_name
+                                                  << " - " << val;
+            }
+            return false;
+        }
+
+        /**
+         * @brief 获取当前参数值的拷贝
+         * @details 无锁, 可以在热点路径调用; 大对象请用read()避免拷贝
+         */
+        T getValue() const
+        {
+            EpochGuard guard;
+            return *m_val.load();
+        }
+
+        /**
+         * @brief 在不拷贝的情况下访问当前值
+         * @details cb在epoch临界区内执行, 期间看到的是同一个快照,
+         *          引用不能保存到cb之外, cb中也不能修改本配置
+         * @return cb的返回值
+         */
+        template <class F>
+        auto read(F &&cb) const -> decltype(cb(std::declval<const T &>()))
+        {
+            EpochGuard guard;
+            return cb(*m_val.load());
+        }
+
+        /**
+         * @brief 设置当前参数的值
+         * @details 值没有变化时直接返回; 否则替换快照后通知监听者。
+         *          监听回调中不能再设置同一个配置
+         */
+        void setValue(const T &v)
+        {
+            MutexType::Lock lock(m_mutex);
+            //写者串行, 持锁期间当前值不会被替换和回收, 无需进入临界区
+            const T *cur = m_val.load();
+            if (*cur == v)
+            {
+                return;
+            }
+            T old_value(*cur);
+            m_val.store(new T(v));
+            m_version.fetch_add(1, std::memory_order_release);
+
+            RWMutexType::ReadLock lock2(m_cbMutex);
+            for (auto &i : m_cbs)
+            {
+                i.second(old_value, v);
+            }
+        }
+
+        //返回参数值的类型名称(typeinfo), 保持abi::__cxa_demangle的格式
+        std::string getTypeName() const override { return DemangledTypeName<T>(); }
+
+        /**
+         * @brief 返回值的版本号
+         * @details 每次修改加一, 调用方可以缓存由配置计算出的结果, 版本变化时再重新计算
+         */
+        uint64_t getVersion() const { return m_version.load(std::memory_order_acquire); }
+
+        /**
+         * @brief 添加变化回调函数
+         * @return 返回该回调函数对应的唯一id,用于删除回调
+         */
+        uint64_t addListener(on_change_cb cb)
+        {
+            static std::atomic<uint64_t> s_fun_id{0};
+            RWMutexType::WriteLock lock(m_cbMutex);
+            uint64_t id = ++s_fun_id;
+            m_cbs[id] = cb;
+            return id;
+        }
+
+        /**
+         * @brief 删除回调函数
+         * @param[in] key 回调函数的唯一id
+         */
+        void delListener(uint64_t key)
+        {
+            RWMutexType::WriteLock lock(m_cbMutex);
+            m_cbs.erase(key);
+        }
+
+        /**
+         * @brief 获取回调函数
+         * @param[in] key 回调函数的唯一id
+         * @return 如果存在返回对应的回调函数,否则返回nullptr
+         */
+        on_change_cb getListener(uint64_t key)
+        {
+            RWMutexType::ReadLock lock(m_cbMutex);
+            auto it = m_cbs.find(key);
+            return it == m_cbs.end() ? nullptr : it->second;
+        }
+
+        //清理所有的回调函数
+        void clearListener()
+        {
+            RWMutexType::WriteLock lock(m_cbMutex);
+            m_cbs.clear();
+        }
+
+    private:
+        MutexType m_mutex;                       /// 串行化写操作
+        EpochPtr<T> m_val;                       /// 当前值的快照
+        std::atomic<uint64_t> m_version{0};      /// 修改次数
+        RWMutexType m_cbMutex;                   /// 保护m_cbs
+        std::map<uint64_t, on_change_cb> m_cbs;  /// 变更回调函数组, uint64_t key,要求唯一
+    };
+
+    /**
+     * @brief ConfigVar的管理类
+     * @details 提供便捷的方法创建/访问ConfigVar, 从YAML文件或目录加载配置,
+     *          并可以用inotify监听配置目录, 文件变化后在后台线程重新加载
+     */
+    class Config
+    {
+    public:
+        typedef std::unordered_map<std::string, ConfigVarBase::ptr> ConfigVarMap;
+        typedef RWMutex RWMutexType;
+
+        /**
+         * @brief 获取/创建对应参数名的配置参数
+         * @param[in] name 配置参数名称
+         * @param[in] default_value 参数默认值
+         * @param[in] description 参数描述
+         * @details 获取参数名为name的配置参数,如果存在直接返回
+         *          如果不存在,创建参数配置并用default_value赋值
+         * @return 返回对应的配置参数,如果参数名存在但是类型不匹配则返回nullptr
+         * @exception 如果参数名包含非法字符[^0-9a-z_.] 抛出异常 std::invalid_argument
+         */
+        template <class T>
+        static typename ConfigVar<T>::ptr Lookup(const std::string &name,
+                                                 const T &default_value, const std::string &description = "")
+        {
+            std::string key = ToLower(name);
+            RWMutexType::WriteLock lock(GetMutex());
+            auto it = GetDatas().find(key);
+            if (it != GetDatas().end())
+            {
+                auto tmp = std::dynamic_pointer_cast<ConfigVar<T>>(it->second);
+                if (tmp)
+                {
+                    return tmp;
+                }
+                SYLAR_LOG_ERROR(SYLAR_LOG_ROOT()) << "Lookup name=" << key << " exists but type not "
+                                                  << DemangledTypeName<T>() << " real_type=" << it->second->getTypeName()
+                                                  << " " << it->second->toString();
+                return nullptr;
+            }
+
+            if (!IsValidName(key))
+            {
+                SYLAR_LOG_ERROR(SYLAR_LOG_ROOT()) << "Lookup name invalid " << key;
+                throw std::invalid_argument(key);
+            }
+
+            typename ConfigVar<T>::ptr v(new ConfigVar<T>(key, default_value, description));
+            GetDatas()[key] = v;
+            return v;
+        }
+
+        /**
+         * @brief 查找配置参数
+         * @return 找到返回配置参数, 不存在或类型不匹配返回nullptr
+         */
+        template <class T>
+        static typename ConfigVar<T>::ptr Lookup(const std::string &name)
+        {
+            RWMutexType::ReadLock lock(GetMutex());
+            auto it = GetDatas().find(ToLower(name));
+            if (it == GetDatas().end())
+            {
+                return nullptr;
+            }
+            return std::dynamic_pointer_cast<ConfigVar<T>>(it->second);
+        }
+
+        //查找配置参数,返回配置参数的基类
+        static ConfigVarBase::ptr LookupBase(const std::string &name);
+
+        /**
+         * @brief 使用YAML::Node初始化配置模块
+         * @details 只更新已注册的配置参数, 未注册的键忽略
+         */
+        static void LoadFromYaml(const YAML::Node &root);
+
+        /**
+         * @brief 加载path目录(含子目录)下的所有.yml配置文件
+         * @param[in] path 配置目录
+         * @param[in] force 为false时跳过自上次加载后没有变化的文件
+         */
+        static void LoadFromConfDir(const std::string &path, bool force = false);
+
+        /**
+         * @brief 监听配置目录, 文件变化后自动重新加载
+         * @details 使用inotify, 在后台线程中等待事件, 合并短时间内的多次变化后
+         *          调用LoadFromConfDir(path, false); 持续有变化时最迟在第一个事件后2秒重新加载。
+         *          同一时间只能监听一个目录
+         * @return 成功返回true
+         */
+        static bool StartWatch(const std::string &path);
+
+        //停止监听, 等待后台线程退出
+        static void StopWatch();
+
+        /**
+         * @brief 遍历配置模块里面所有配置项
+         * @param[in] cb 配置项回调函数
+         */
+        static void Visit(std::function<void(ConfigVarBase::ptr)> cb);
+
+        //配置参数名是否合法
+        static bool IsValidName(const std::string &name);
+
+    private:
+        //返回所有的配置项
+        static ConfigVarMap &GetDatas()
+        {
+            static ConfigVarMap s_datas;
+            return s_datas;
+        }
+
+        //配置项的RWMutex
+        static RWMutexType &GetMutex()
+        {
+            static RWMutexType s_mutex;
+            return s_mutex;
+        }
+    };
+
+}
+
+#endif
\ No newline at end of file
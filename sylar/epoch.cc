@@ -0,0 +1,324 @@
+#include "sylar/epoch.h"
+#include "sylar/fiber.h"
+#include <sched.h>
+#include <utility>
+
+namespace sylar
+{
+
+    //线程在某个EpochManager上的状态
+    struct EpochManager::ThreadState
+    {
+        EpochRecord *record = nullptr;             /// 线程独占的记录
+        std::vector<EpochManager::Retired> retired; /// 待回收对象
+    };
+
+    struct EpochManager::Handle
+    {
+        explicit Handle(EpochManager *m) : mgr(m) {}
+
+        MutexType mutex;
+        EpochManager *mgr; /// 管理器析构后为nullptr
+    };
+
+    namespace
+    {
+        /**
+         * @brief 线程局部的状态表, 线程退出时归还记录并移交未回收对象
+         * @details 以Handle而不是管理器地址为key: 管理器析构后Handle仍被状态表引用,
+         *          地址不会被新的管理器复用
+         */
+        struct ThreadStates
+        {
+            typedef std::pair<std::shared_ptr<void>, void *> Item;
+            std::vector<Item> items;
+            void (*release)(void *, void *) = nullptr;
+
+            ~ThreadStates();
+        };
+
+        static thread_local ThreadStates t_states;
+        //t_states已析构(线程退出时其他线程局部或静态对象析构期间)
+        static thread_local bool t_states_dead = false;
+
+        ThreadStates::~ThreadStates()
+        {
+            for (auto &i : items)
+            {
+                release(i.first.get(), i.second);
+            }
+            items.clear();
+            t_states_dead = true;
+        }
+    }
+
+    EpochManager::EpochManager()
+        : m_handle(new Handle(this))
+    {
+    }
+
+    EpochManager::~EpochManager()
+    {
+        {
+            MutexType::Lock lock(m_handle->mutex);
+            m_handle->mgr = nullptr;
+        }
+        //其他线程的状态在线程退出时发现管理器已析构, 自行释放; 当前线程的状态这里直接清理
+        if (!t_states_dead)
+        {
+            auto &items = t_states.items;
+            for (auto it = items.begin(); it != items.end(); ++it)
+            {
+                if (it->first.get() == m_handle.get())
+                {
+                    ThreadState *ts = static_cast<ThreadState *>(it->second);
+                    m_orphans.insert(m_orphans.end(), ts->retired.begin(), ts->retired.end());
+                    delete ts;
+                    items.erase(it);
+                    break;
+                }
+            }
+        }
+
+        for (auto &i : m_orphans)
+        {
+            i.deleter(i.ptr);
+        }
+        m_orphans.clear();
+
+        EpochRecord *rec = m_records.exchange(nullptr);
+        while (rec)
+        {
+            EpochRecord *next = rec->next;
+            delete rec;
+            rec = next;
+        }
+    }
+
+    EpochManager::ThreadState &EpochManager::getThreadState()
+    {
+        auto &items = t_states.items;
+        if (!items.empty() && items.front().first.get() == m_handle.get())
+        {
+            return *static_cast<ThreadState *>(items.front().second);
+        }
+        for (auto &i : items)
+        {
+            if (i.first.get() == m_handle.get())
+            {
+                return *static_cast<ThreadState *>(i.second);
+            }
+        }
+
+        ThreadState *ts = new ThreadState;
+        ts->record = acquireRecord();
+        items.push_back(std::make_pair(std::shared_ptr<void>(m_handle), static_cast<void *>(ts)));
+        t_states.release = [](void *h, void *p)
+        {
+            Handle *handle = static_cast<Handle *>(h);
+            ThreadState *ts = static_cast<ThreadState *>(p);
+            {
+                MutexType::Lock lock(handle->mutex);
+                if (handle->mgr)
+                {
+                    handle->mgr->adoptOrphans(ts->retired);
+                    //记录可能仍被迁移走的协程占用, 由借用方在epoch归零后再复用
+                    ts->record->inUse.store(false, std::memory_order_release);
+                }
+            }
+            //管理器已析构, 不会再有读者, 剩下的对象直接释放; 记录已随管理器释放
+            for (auto &i : ts->retired)
+            {
+                i.deleter(i.ptr);
+            }
+            delete ts;
+        };
+        return *ts;
+    }
+
+    EpochRecord *EpochManager::acquireRecord()
+    {
+        for (EpochRecord *rec = m_records.load(std::memory_order_acquire); rec; rec = rec->next)
+        {
+            if (rec->inUse.load(std::memory_order_relaxed))
+            {
+                continue;
+            }
+            bool expected = false;
+            if (!rec->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire))
+            {
+                continue;
+            }
+            if (rec->epoch.load(std::memory_order_acquire) != 0)
+            {
+                //所属线程已退出但挂起的协程仍在临界区内
+                rec->inUse.store(false, std::memory_order_release);
+                continue;
+            }
+            return rec;
+        }
+
+        EpochRecord *rec = new EpochRecord;
+        rec->inUse.store(true, std::memory_order_relaxed);
+        EpochRecord *head = m_records.load(std::memory_order_relaxed);
+        do
+        {
+            rec->next = head;
+        } while (!m_records.compare_exchange_weak(head, rec, std::memory_order_release, std::memory_order_relaxed));
+        return rec;
+    }
+
+    EpochRecord *EpochManager::enter(bool &pooled)
+    {
+        ThreadState &ts = getThreadState();
+        EpochRecord *rec = ts.record;
+        //只有所属线程会把线程记录从0改为非0, 读到0即可独占使用;
+        //非0说明嵌套进入, 或者同线程有协程挂起在临界区内
+        if (rec->epoch.load(std::memory_order_relaxed) == 0)
+        {
+            pooled = false;
+        }
+        else
+        {
+            rec = acquireRecord();
+            pooled = true;
+        }
+
+        uint64_t e = m_epoch.load(std::memory_order_relaxed);
+        while (true)
+        {
+            rec->epoch.store(e, std::memory_order_seq_cst);
+            uint64_t now = m_epoch.load(std::memory_order_seq_cst);
+            if (now == e)
+            {
+                break;
+            }
+            e = now;
+        }
+        return rec;
+    }
+
+    void EpochManager::leave(EpochRecord *rec, bool pooled)
+    {
+        rec->epoch.store(0, std::memory_order_release);
+        if (pooled)
+        {
+            rec->inUse.store(false, std::memory_order_release);
+        }
+    }
+
+    void EpochManager::retire(void *ptr, Deleter deleter)
+    {
+        if (!ptr)
+        {
+            return;
+        }
+        ThreadState &ts = getThreadState();
+        ts.retired.push_back({ptr, deleter, m_epoch.load(std::memory_order_seq_cst)});
+        m_retired.fetch_add(1, std::memory_order_relaxed);
+        if (ts.retired.size() >= m_batchSize)
+        {
+            collect();
+        }
+    }
+
+    uint64_t EpochManager::tryAdvance()
+    {
+        uint64_t global = m_epoch.load(std::memory_order_seq_cst);
+        uint64_t min_epoch = global;
+        bool all_current = true;
+        for (EpochRecord *rec = m_records.load(std::memory_order_acquire); rec; rec = rec->next)
+        {
+            uint64_t e = rec->epoch.load(std::memory_order_seq_cst);
+            if (e == 0)
+            {
+                continue;
+            }
+            if (e < min_epoch)
+            {
+                min_epoch = e;
+            }
+            if (e != global)
+            {
+                all_current = false;
+            }
+        }
+        if (all_current)
+        {
+            //失败说明其他线程已推进, 不影响本次计算出的安全边界
+            m_epoch.compare_exchange_strong(global, global + 1, std::memory_order_seq_cst);
+        }
+        return min_epoch;
+    }
+
+    size_t EpochManager::reclaim(std::vector<Retired> &list, uint64_t safe)
+    {
+        size_t n = 0;
+        size_t keep = 0;
+        for (size_t i = 0; i < list.size(); ++i)
+        {
+            if (list[i].epoch < safe)
+            {
+                list[i].deleter(list[i].ptr);
+                ++n;
+            }
+            else
+            {
+                list[keep++] = list[i];
+            }
+        }
+        list.resize(keep);
+        if (n)
+        {
+            m_reclaimed.fetch_add(n, std::memory_order_relaxed);
+        }
+        return n;
+    }
+
+    void EpochManager::adoptOrphans(std::vector<Retired> &list)
+    {
+        if (list.empty())
+        {
+            return;
+        }
+        MutexType::Lock lock(m_mutex);
+        m_orphans.insert(m_orphans.end(), list.begin(), list.end());
+        list.clear();
+    }
+
+    size_t EpochManager::collect()
+    {
+        uint64_t safe = tryAdvance();
+        size_t n = reclaim(getThreadState().retired, safe);
+
+        std::vector<Retired> orphans;
+        {
+            MutexType::Lock lock(m_mutex);
+            orphans.swap(m_orphans);
+        }
+        if (!orphans.empty())
+        {
+            n += reclaim(orphans, safe);
+            adoptOrphans(orphans);
+        }
+        return n;
+    }
+
+    void EpochManager::synchronize()
+    {
+        //调用前retire的对象epoch不超过target, 所有记录越过target即可全部释放
+        uint64_t target = m_epoch.load(std::memory_order_seq_cst);
+        while (tryAdvance() <= target)
+        {
+            if (Fiber::GetFiberId() != 0)
+            {
+                Fiber::YieldToReady();
+            }
+            else
+            {
+                sched_yield();
+            }
+        }
+        collect();
+    }
+}
\ No newline at end of file
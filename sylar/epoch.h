@@ -0,0 +1,250 @@
+//基于epoch的延迟内存回收(EBR)
+#ifndef __SYLAR_EPOCH_H__
+#define __SYLAR_EPOCH_H__
+
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "noncopyable.h"
+#include "mutex.h"
+#include "singleton.h"
+
+namespace sylar
+{
+
+    /**
+     * @brief epoch记录
+     * @details 每个线程独占一个记录, 协程嵌套或线程记录被挂起的协程占用时
+     *          从全局池里借用空闲记录。记录只追加不释放, 独占一条缓存行
+     */
+    struct alignas(64) EpochRecord
+    {
+        std::atomic<uint64_t> epoch{0};  /// 0表示不在临界区, 否则为进入时的全局epoch
+        std::atomic<bool> inUse{false};  /// 是否被线程或临界区占用
+        EpochRecord *next = nullptr;     /// 全局链表的下一个记录
+    };
+
+    /**
+     * @brief epoch回收管理器
+     * @details 读者在EpochGuard保护的临界区内可无锁访问共享对象;
+     *          写者摘除对象后调用retire, 对象在所有可能持有它的读者离开后批量释放。
+     *          临界区通过EpochGuard记住所用的记录, 协程在临界区内被调度到其他线程时
+     *          依然在原记录上退出, 不依赖线程局部状态
+     */
+    class EpochManager : Noncopyable
+    {
+    public:
+        typedef Mutex MutexType;
+        //释放函数
+        typedef void (*Deleter)(void *);
+
+        //构造函数
+        EpochManager();
+
+        //析构函数, 释放所有尚未回收的对象
+        ~EpochManager();
+
+        /**
+         * @brief 进入读临界区
+         * @param[out] pooled 返回的记录是否借自全局池
+         * @return 本次临界区使用的记录
+         */
+        EpochRecord *enter(bool &pooled);
+
+        /**
+         * @brief 离开读临界区
+         * @param[in] rec enter返回的记录
+         * @param[in] pooled enter返回的pooled
+         * @attention 可以在与enter不同的线程上调用
+         */
+        void leave(EpochRecord *rec, bool pooled);
+
+        /**
+         * @brief 延迟释放对象
+         * @param[in] ptr 已从共享结构中摘除的对象
+         * @param[in] deleter 释放函数
+         * @details 放入当前线程的待回收列表, 积累到批量大小时尝试回收
+         */
+        void retire(void *ptr, Deleter deleter);
+
+        /**
+         * @brief 延迟delete对象
+         */
+        template <class T>
+        void retire(T *ptr)
+        {
+            retire(static_cast<void *>(ptr), [](void *p)
+                   { delete static_cast<T *>(p); });
+        }
+
+        /**
+         * @brief 尝试推进epoch并回收当前线程可以释放的对象
+         * @return 本次释放的对象数量
+         */
+        size_t collect();
+
+        /**
+         * @brief 等待调用前进入的所有读者离开, 并回收当前线程的全部待回收对象
+         * @pre 当前执行流不在读临界区内
+         * @details 在协程内等待时让出协程, 避免和同线程挂起的读者协程互相等待
+         */
+        void synchronize();
+
+        //返回全局epoch
+        uint64_t getEpoch() const { return m_epoch.load(std::memory_order_relaxed); }
+
+        //返回累计retire的对象数量
+        uint64_t getRetiredCount() const { return m_retired.load(std::memory_order_relaxed); }
+
+        //返回累计释放的对象数量
+        uint64_t getReclaimedCount() const { return m_reclaimed.load(std::memory_order_relaxed); }
+
+        //设置触发回收的批量大小
+        void setBatchSize(size_t v) { m_batchSize = v ? v : 1; }
+
+        //返回触发回收的批量大小
+        size_t getBatchSize() const { return m_batchSize; }
+
+    public:
+        //待回收对象
+        struct Retired
+        {
+            void *ptr;
+            Deleter deleter;
+            uint64_t epoch;
+        };
+
+    private:
+        /**
+         * @brief 所有记录都已到达当前epoch时推进全局epoch
+         * @return 当前所有活跃读者中最小的epoch(没有活跃读者时为全局epoch)
+         */
+        uint64_t tryAdvance();
+
+        //从全局池借用一个空闲记录, 没有则新建
+        EpochRecord *acquireRecord();
+
+        //释放列表中epoch小于safe的对象, 返回释放数量
+        size_t reclaim(std::vector<Retired> &list, uint64_t safe);
+
+        //线程退出时接管其未回收的对象
+        void adoptOrphans(std::vector<Retired> &list);
+
+        //返回当前线程的epoch状态
+        struct ThreadState;
+        ThreadState &getThreadState();
+
+        //线程状态对管理器的引用, 管理器析构后置空, 退出的线程据此判断管理器是否还在
+        struct Handle;
+
+    private:
+        std::atomic<uint64_t> m_epoch{1};           /// 全局epoch, 0保留给静止状态
+        std::atomic<EpochRecord *> m_records{nullptr}; /// 所有记录组成的链表
+        std::atomic<uint64_t> m_retired{0};         /// 累计retire数量
+        std::atomic<uint64_t> m_reclaimed{0};       /// 累计释放数量
+        size_t m_batchSize = 64;                    /// 触发回收的批量大小
+        MutexType m_mutex;                          /// 保护m_orphans
+        std::vector<Retired> m_orphans;             /// 已退出线程遗留的待回收对象
+        std::shared_ptr<Handle> m_handle;           /// 各线程状态共享的引用
+    };
+
+    typedef sylar::SingleTon<EpochManager> EpochMgr;
+
+    /**
+     * @brief 读临界区RAII封装
+     * @details 构造时进入, 析构时离开; 协程在临界区内可以让出或迁移线程
+     */
+    class EpochGuard : Noncopyable
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param[in] mgr epoch管理器, 默认使用全局单例
+         */
+        EpochGuard(EpochManager *mgr = EpochMgr::GetInstance())
+            : m_mgr(mgr)
+        {
+            m_record = m_mgr->enter(m_pooled);
+        }
+
+        //析构函数, 离开临界区
+        ~EpochGuard()
+        {
+            m_mgr->leave(m_record, m_pooled);
+        }
+
+    private:
+        EpochManager *m_mgr;   /// epoch管理器
+        EpochRecord *m_record; /// 本次临界区使用的记录
+        bool m_pooled = false; /// 记录是否借自全局池
+    };
+
+    /**
+     * @brief 受epoch保护的原子指针
+     * @details 读者在EpochGuard内load后即可安全使用对象;
+     *          写者store/exchange替换后旧对象交给EpochManager延迟delete
+     */
+    template <class T>
+    class EpochPtr : Noncopyable
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param[in] p 初始对象, 所有权转移给EpochPtr
+         * @param[in] mgr epoch管理器
+         */
+        explicit EpochPtr(T *p = nullptr, EpochManager *mgr = EpochMgr::GetInstance())
+            : m_ptr(p), m_mgr(mgr)
+        {
+        }
+
+        //析构函数, 直接释放当前对象
+        ~EpochPtr()
+        {
+            delete m_ptr.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief 读取当前对象
+         * @pre 调用者处于EpochGuard内
+         */
+        T *load() const { return m_ptr.load(std::memory_order_acquire); }
+
+        /**
+         * @brief 发布新对象, 旧对象延迟释放
+         */
+        void store(T *p)
+        {
+            T *old = m_ptr.exchange(p, std::memory_order_acq_rel);
+            if (old)
+            {
+                m_mgr->retire(old);
+            }
+        }
+
+        /**
+         * @brief 当前对象为expected时替换为desired, 旧对象延迟释放
+         * @return 替换成功返回true, 失败时desired的所有权仍在调用者
+         */
+        bool compareExchange(T *expected, T *desired)
+        {
+            if (m_ptr.compare_exchange_strong(expected, desired, std::memory_order_acq_rel))
+            {
+                if (expected)
+                {
+                    m_mgr->retire(expected);
+                }
+                return true;
+            }
+            return false;
+        }
+
+    private:
+        std::atomic<T *> m_ptr; /// 当前对象
+        EpochManager *m_mgr;    /// epoch管理器
+    };
+}
+
+#endif
\ No newline at end of file
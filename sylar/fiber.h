@@ -5,14 +5,16 @@
 #include <memory>
 #include <functional>
 #include <ucontext.h>
+#include "util/slab_pool.h"
 
 namespace sylar
 {
 
     class Scheduler;
+    class Arena;
 
     //协程类
-    class Fiber : public std::_Enable_shared_from_this<Fiber>
+    class Fiber : public std::_Enable_shared_from_this<Fiber>, public SlabAllocated
     {
         friend class Scheduler;
 
@@ -89,6 +91,17 @@ namespace sylar
          */
         State getState() const { return m_state; }
 
+        /**
+         * @brief 返回协程绑定的内存池
+         * @details 由Arena::SetCurrent/ArenaScope设置, 协程在线程间迁移时随协程走
+         */
+        Arena *getArena() const { return m_arena; }
+
+        /**
+         * @brief 绑定内存池, 不转移所有权
+         */
+        void setArena(Arena *arena) { m_arena = arena; }
+
     public:
         /**
          * @brief 设置当前线程的运行协程
@@ -147,6 +160,8 @@ namespace sylar
         void *m_stack = nullptr; /// 协程运行栈指针
 
         std::function<void()> m_cb; /// 协程运行函数
+
+        Arena *m_arena = nullptr; /// 协程绑定的内存池
     };
 }
 
@@ -0,0 +1,336 @@
+#include "sylar/io_util.h"
+#include "sylar/fiber.h"
+#include "sylar/iomanager.h"
+#include <sys/sendfile.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+#include <algorithm>
+
+namespace sylar
+{
+
+    //单次sendfile/splice的最大长度
+    static const size_t s_max_chunk = 0x7ffff000;
+
+    bool IOUtil::Wait(int fd, bool write)
+    {
+        IOManager *iom = IOManager::GetThis();
+        if (iom && Fiber::GetFiberId() != 0)
+        {
+            if (iom->addEvent(fd, write ? IOManager::WRITE : IOManager::READ) != 0)
+            {
+                return false;
+            }
+            Fiber::YieldToHold();
+            return true;
+        }
+
+        struct pollfd pfd;
+        pfd.fd = fd;
+        pfd.events = write ? POLLOUT : POLLIN;
+        pfd.revents = 0;
+        while (true)
+        {
+            int rt = poll(&pfd, 1, -1);
+            if (rt >= 0)
+            {
+                return true;
+            }
+            if (errno != EINTR)
+            {
+                return false;
+            }
+        }
+    }
+
+    /**
+     * @brief iovec批量读写的公共循环
+     * @param[in] op 执行一次系统调用, 参数为(iov, iovcnt, 已完成字节数)
+     * @details 跳过空缓冲区, 按IOV_MAX分批, 部分完成时推进iov
+     */
+    template <class Op>
+    static ssize_t IovLoop(int fd, struct iovec *iov, int iovcnt, bool write, Op op)
+    {
+        ssize_t total = 0;
+        while (iovcnt > 0)
+        {
+            if (iov->iov_len == 0)
+            {
+                ++iov;
+                --iovcnt;
+                continue;
+            }
+            ssize_t n = op(iov, std::min(iovcnt, IOV_MAX), total);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                if (errno == EAGAIN && IOUtil::Wait(fd, write))
+                {
+                    continue;
+                }
+                return -1;
+            }
+            if (n == 0)
+            {
+                //读到EOF, 或者写入无进展
+                break;
+            }
+            total += n;
+            while (n > 0)
+            {
+                if ((size_t)n >= iov->iov_len)
+                {
+                    n -= iov->iov_len;
+                    ++iov;
+                    --iovcnt;
+                }
+                else
+                {
+                    iov->iov_base = (char *)iov->iov_base + n;
+                    iov->iov_len -= n;
+                    n = 0;
+                }
+            }
+        }
+        return total;
+    }
+
+    ssize_t IOUtil::ReadvFull(int fd, struct iovec *iov, int iovcnt)
+    {
+        return IovLoop(fd, iov, iovcnt, false, [fd](struct iovec *v, int cnt, ssize_t)
+                       { return readv(fd, v, cnt); });
+    }
+
+    ssize_t IOUtil::WritevFull(int fd, struct iovec *iov, int iovcnt)
+    {
+        return IovLoop(fd, iov, iovcnt, true, [fd](struct iovec *v, int cnt, ssize_t)
+                       { return writev(fd, v, cnt); });
+    }
+
+    ssize_t IOUtil::PreadvFull(int fd, struct iovec *iov, int iovcnt, off_t offset)
+    {
+        return IovLoop(fd, iov, iovcnt, false, [fd, offset](struct iovec *v, int cnt, ssize_t done)
+                       { return preadv(fd, v, cnt, offset + done); });
+    }
+
+    ssize_t IOUtil::PwritevFull(int fd, struct iovec *iov, int iovcnt, off_t offset)
+    {
+        return IovLoop(fd, iov, iovcnt, true, [fd, offset](struct iovec *v, int cnt, ssize_t done)
+                       { return pwritev(fd, v, cnt, offset + done); });
+    }
+
+    ssize_t IOUtil::ReadFull(int fd, void *data, size_t length)
+    {
+        struct iovec iov;
+        iov.iov_base = data;
+        iov.iov_len = length;
+        return ReadvFull(fd, &iov, 1);
+    }
+
+    ssize_t IOUtil::WriteFull(int fd, const void *data, size_t length)
+    {
+        struct iovec iov;
+        iov.iov_base = (void *)data;
+        iov.iov_len = length;
+        return WritevFull(fd, &iov, 1);
+    }
+
+    /**
+     * @brief sendfile循环
+     * @param[out] done 已发送字节数, 出错时也有效
+     * @return 出错返回false并保留errno
+     */
+    static bool SendFileLoop(int out_fd, int in_fd, off_t *offset, size_t count, size_t &done)
+    {
+        done = 0;
+        while (done < count)
+        {
+            ssize_t n = sendfile(out_fd, in_fd, offset, std::min(count - done, s_max_chunk));
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                if (errno == EAGAIN && IOUtil::Wait(out_fd, true))
+                {
+                    continue;
+                }
+                return false;
+            }
+            if (n == 0)
+            {
+                break;
+            }
+            done += n;
+        }
+        return true;
+    }
+
+    namespace
+    {
+        //线程复用的splice中转管道
+        struct SplicePipe
+        {
+            int fds[2] = {-1, -1};
+
+            ~SplicePipe()
+            {
+                reset();
+            }
+
+            bool get()
+            {
+                if (fds[0] >= 0)
+                {
+                    return true;
+                }
+                return pipe2(fds, O_CLOEXEC | O_NONBLOCK) == 0;
+            }
+
+            //管道中残留数据时只能重建
+            void reset()
+            {
+                if (fds[0] >= 0)
+                {
+                    close(fds[0]);
+                    close(fds[1]);
+                    fds[0] = fds[1] = -1;
+                }
+            }
+        };
+
+        static thread_local SplicePipe t_pipe;
+    }
+
+    /**
+     * @brief splice循环: in_fd -> 管道 -> out_fd
+     * @param[out] done 已写入out_fd的字节数, 出错时也有效
+     */
+    static bool SpliceLoop(int out_fd, int in_fd, off_t *offset, size_t count, size_t &done)
+    {
+        done = 0;
+        if (!t_pipe.get())
+        {
+            return false;
+        }
+        const unsigned flags = SPLICE_F_MOVE | SPLICE_F_MORE;
+        while (done < count)
+        {
+            ssize_t in = splice(in_fd, offset, t_pipe.fds[1], nullptr,
+                                std::min(count - done, s_max_chunk), flags | SPLICE_F_NONBLOCK);
+            if (in < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                if (errno == EAGAIN && IOUtil::Wait(in_fd, false))
+                {
+                    continue;
+                }
+                return false;
+            }
+            if (in == 0)
+            {
+                break;
+            }
+
+            while (in > 0)
+            {
+                ssize_t out = splice(t_pipe.fds[0], nullptr, out_fd, nullptr, in, flags);
+                if (out < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    if (errno == EAGAIN && IOUtil::Wait(out_fd, true))
+                    {
+                        continue;
+                    }
+                    int err = errno;
+                    t_pipe.reset();
+                    errno = err;
+                    return false;
+                }
+                in -= out;
+                done += out;
+            }
+        }
+        return true;
+    }
+
+    ssize_t IOUtil::SendFile(int out_fd, int in_fd, off_t *offset, size_t count)
+    {
+        size_t done = 0;
+        return SendFileLoop(out_fd, in_fd, offset, count, done) ? (ssize_t)done : -1;
+    }
+
+    ssize_t IOUtil::Splice(int out_fd, int in_fd, off_t *offset, size_t count)
+    {
+        size_t done = 0;
+        return SpliceLoop(out_fd, in_fd, offset, count, done) ? (ssize_t)done : -1;
+    }
+
+    ssize_t IOUtil::CopyFileToSocket(int out_fd, int in_fd, off_t *offset, size_t count)
+    {
+        size_t done = 0;
+        if (SendFileLoop(out_fd, in_fd, offset, count, done))
+        {
+            return done;
+        }
+        if ((errno != EINVAL && errno != ENOSYS) || done > 0)
+        {
+            return -1;
+        }
+
+        if (SpliceLoop(out_fd, in_fd, offset, count, done))
+        {
+            return done;
+        }
+        if ((errno != EINVAL && errno != ENOSYS) || done > 0)
+        {
+            return -1;
+        }
+
+        //两种零拷贝方式都不支持时退回到用户态缓冲
+        std::vector<char> buf(std::min(count, (size_t)1024 * 64));
+        off_t pos = offset ? *offset : -1;
+        while (done < count)
+        {
+            size_t len = std::min(buf.size(), count - done);
+            ssize_t n = offset ? pread(in_fd, &buf[0], len, pos) : read(in_fd, &buf[0], len);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return -1;
+            }
+            if (n == 0)
+            {
+                break;
+            }
+            if (WriteFull(out_fd, &buf[0], n) != n)
+            {
+                return -1;
+            }
+            done += n;
+            if (offset)
+            {
+                pos += n;
+                *offset = pos;
+            }
+        }
+        return done;
+    }
+
+}
\ No newline at end of file
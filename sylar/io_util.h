@@ -0,0 +1,128 @@
+//基于文件描述符的零拷贝读写工具
+#ifndef __SYLAR_IO_UTIL_H__
+#define __SYLAR_IO_UTIL_H__
+
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <stdint.h>
+#include <vector>
+#include <string>
+
+namespace sylar
+{
+
+    /**
+     * @brief 文件描述符读写工具
+     * @details 直接在fd上做readv/writev/preadv/pwritev, 数据不经过iostream缓冲;
+     *          所有函数都会处理EINTR和部分读写, 非阻塞fd返回EAGAIN时
+     *          在IOManager协程中挂起等待可读写事件, 否则poll等待
+     */
+    class IOUtil
+    {
+    public:
+        /**
+         * @brief 读满iov描述的全部缓冲区
+         * @param[in] fd 文件描述符
+         * @param[in,out] iov 缓冲区数组, 函数返回后内容被修改(已读部分被跳过)
+         * @param[in] iovcnt 缓冲区个数
+         * @return 读取的字节数, 小于总长度表示遇到EOF; 出错返回-1并设置errno
+         */
+        static ssize_t ReadvFull(int fd, struct iovec *iov, int iovcnt);
+
+        /**
+         * @brief 写完iov描述的全部数据
+         * @param[in,out] iov 缓冲区数组, 函数返回后内容被修改
+         * @return 写入的字节数; 出错返回-1并设置errno
+         */
+        static ssize_t WritevFull(int fd, struct iovec *iov, int iovcnt);
+
+        /**
+         * @brief 从offset开始读满iov描述的全部缓冲区, 不改变文件偏移
+         * @return 读取的字节数, 小于总长度表示遇到EOF; 出错返回-1
+         */
+        static ssize_t PreadvFull(int fd, struct iovec *iov, int iovcnt, off_t offset);
+
+        /**
+         * @brief 从offset开始写完iov描述的全部数据, 不改变文件偏移
+         * @return 写入的字节数; 出错返回-1
+         */
+        static ssize_t PwritevFull(int fd, struct iovec *iov, int iovcnt, off_t offset);
+
+        //读满length字节
+        static ssize_t ReadFull(int fd, void *data, size_t length);
+
+        //写完length字节
+        static ssize_t WriteFull(int fd, const void *data, size_t length);
+
+        /**
+         * @brief 用sendfile把文件内容发送到socket
+         * @param[in] out_fd 目标socket
+         * @param[in] in_fd 源文件, 必须支持mmap
+         * @param[in,out] offset 源文件偏移, 返回时指向已发送数据之后
+         * @param[in] count 发送字节数
+         * @return 发送的字节数, 小于count表示源文件EOF; 出错返回-1
+         */
+        static ssize_t SendFile(int out_fd, int in_fd, off_t *offset, size_t count);
+
+        /**
+         * @brief 通过管道splice把in_fd的数据搬运到out_fd, 数据不进入用户态
+         * @param[in,out] offset in_fd的偏移, 为nullptr时使用并推进in_fd当前偏移
+         * @return 搬运的字节数; 出错返回-1
+         */
+        static ssize_t Splice(int out_fd, int in_fd, off_t *offset, size_t count);
+
+        /**
+         * @brief 文件到socket的拷贝, 依次尝试sendfile, splice, pread+write
+         * @return 拷贝的字节数; 出错返回-1
+         */
+        static ssize_t CopyFileToSocket(int out_fd, int in_fd, off_t *offset, size_t count);
+
+        /**
+         * @brief 等待fd可读或可写
+         * @param[in] write true等待可写, false等待可读
+         * @return 成功返回true
+         */
+        static bool Wait(int fd, bool write);
+    };
+
+    //从fd读取定长对象
+    template <class T>
+    bool ReadFromFd(int fd, T &v)
+    {
+        return IOUtil::ReadFull(fd, &v, sizeof(T)) == (ssize_t)sizeof(T);
+    }
+
+    //从fd读取v.size()个元素
+    template <class T>
+    bool ReadFromFd(int fd, std::vector<T> &v)
+    {
+        if (v.empty())
+        {
+            return true;
+        }
+        ssize_t len = sizeof(T) * v.size();
+        return IOUtil::ReadFull(fd, v.data(), len) == len;
+    }
+
+    //把定长对象写入fd
+    template <class T>
+    bool WriteToFd(int fd, const T &v)
+    {
+        return IOUtil::WriteFull(fd, &v, sizeof(T)) == (ssize_t)sizeof(T);
+    }
+
+    //把数组写入fd
+    template <class T>
+    bool WriteToFd(int fd, const std::vector<T> &v)
+    {
+        if (v.empty())
+        {
+            return true;
+        }
+        ssize_t len = sizeof(T) * v.size();
+        return IOUtil::WriteFull(fd, v.data(), len) == len;
+    }
+
+}
+
+#endif
\ No newline at end of file
@@ -12,6 +12,8 @@
 #include "util.h"
 #include "singleton.h"
 #include "thread.h"
+#include "atomic.h"
+#include "util/slab_pool.h"
 
 //使用流式方式将日志级别level的日志写入到logger
 #define SYLAR_LOG_LEVEL(logger, level)                                                                                     \
@@ -116,8 +118,8 @@ namespace sylar
         static const LogLevel::Level FromString(const std::string &str);
     };
 
-    //日志事件
-    class LogEvent
+    //日志事件, 从SlabPool分配
+    class LogEvent : public SlabAllocated
     {
     public:
         typedef std::shared_ptr<LogEvent> ptr; //智能指针
@@ -251,7 +253,7 @@ namespace sylar
         /**
          * @brief 将日志输出目标的配置转成YAML String
          */
-        virtual std::string toYamlStrin() = 0;
+        virtual std::string toYamlString() = 0;
         /**
          * @brief 更改日志格式器
          */
@@ -263,11 +265,11 @@ namespace sylar
         /**
          * @brief 获取日志级别
          */
-        LogLevel::Level getLevel() const { return m_level; }
+        LogLevel::Level getLevel() const { return Atomic::load(m_level, std::memory_order_relaxed); }
         /**
          * @brief 设置日志级别
          */
-        void setLeve(LogLevel::Level val) { m_level = val; }
+        void setLevel(LogLevel::Level val) { Atomic::store(m_level, val, std::memory_order_relaxed); }
 
     protected:
         LogLevel::Level m_level = LogLevel::DEBUG; //日志级别
@@ -342,13 +344,14 @@ namespace sylar
 
         /**
          * @brief 返回日志级别
+         * @details 每条日志都会调用, 级别可能被配置线程修改, 用relaxed原子读写
          */
-        LogLevel::Level getLevel() const { return m_level; }
+        LogLevel::Level getLevel() const { return Atomic::load(m_level, std::memory_order_relaxed); }
 
         /**
          * @brief 设置日志级别
          */
-        void setLevel(LogLevel::Level val) { m_level = val; }
+        void setLevel(LogLevel::Level val) { Atomic::store(m_level, val, std::memory_order_relaxed); }
 
         /**
          * @brief 返回日志名称
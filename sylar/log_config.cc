@@ -0,0 +1,252 @@
+#include "sylar/log.h"
+#include "sylar/config.h"
+
+namespace sylar
+{
+
+    //日志输出目标的配置
+    struct LogAppenderDefine
+    {
+        int type = 0; // 1 File, 2 Stdout
+        LogLevel::Level level = LogLevel::UNKNOW;
+        std::string formatter;
+        std::string file;
+
+        bool operator==(const LogAppenderDefine &oth) const
+        {
+            return type == oth.type && level == oth.level && formatter == oth.formatter && file == oth.file;
+        }
+    };
+
+    //日志器的配置
+    struct LogDefine
+    {
+        std::string name;
+        LogLevel::Level level = LogLevel::UNKNOW;
+        std::string formatter;
+        std::vector<LogAppenderDefine> appenders;
+
+        bool operator==(const LogDefine &oth) const
+        {
+            return name == oth.name && level == oth.level && formatter == oth.formatter && appenders == oth.appenders;
+        }
+
+        bool operator<(const LogDefine &oth) const
+        {
+            return name < oth.name;
+        }
+
+        bool isValid() const
+        {
+            return !name.empty();
+        }
+    };
+
+    /**
+     * @brief YAML String 转换成 LogDefine
+     * @details
+     *  - name: root
+     *    level: info
+     *    formatter: "%d%T%m%n"
+     *    appenders:
+     *      - type: FileLogAppender
+     *        file: /logs/root.txt
+     *        level: debug
+     *      - type: StdoutLogAppender
+     */
+    template <>
+    class LexicalCast<std::string, LogDefine>
+    {
+    public:
+        LogDefine operator()(const std::string &v)
+        {
+            YAML::Node n = YAML::Load(v);
+            LogDefine ld;
+            if (!n["name"].IsDefined())
+            {
+                std::stringstream ss;
+                ss << "log config error: name is null, " << n;
+                throw std::logic_error(ss.str());
+            }
+            ld.name = n["name"].as<std::string>();
+            ld.level = LogLevel::FromString(n["level"].IsDefined() ? n["level"].as<std::string>() : "");
+            if (n["formatter"].IsDefined())
+            {
+                ld.formatter = n["formatter"].as<std::string>();
+            }
+
+            if (n["appenders"].IsDefined())
+            {
+                for (size_t x = 0; x < n["appenders"].size(); ++x)
+                {
+                    auto a = n["appenders"][x];
+                    if (!a["type"].IsDefined())
+                    {
+                        SYLAR_LOG_ERROR(SYLAR_LOG_ROOT()) << "log config error: appender type is null, " << a;
+                        continue;
+                    }
+                    std::string type = a["type"].as<std::string>();
+                    LogAppenderDefine lad;
+                    if (type == "FileLogAppender")
+                    {
+                        lad.type = 1;
+                        if (!a["file"].IsDefined())
+                        {
+                            SYLAR_LOG_ERROR(SYLAR_LOG_ROOT()) << "log config error: fileappender file is null, " << a;
+                            continue;
+                        }
+                        lad.file = a["file"].as<std::string>();
+                    }
+                    else if (type == "StdoutLogAppender")
+                    {
+                        lad.type = 2;
+                    }
+                    else
+                    {
+                        SYLAR_LOG_ERROR(SYLAR_LOG_ROOT()) << "log config error: appender type is invalid, " << a;
+                        continue;
+                    }
+                    if (a["level"].IsDefined())
+                    {
+                        lad.level = LogLevel::FromString(a["level"].as<std::string>());
+                    }
+                    if (a["formatter"].IsDefined())
+                    {
+                        lad.formatter = a["formatter"].as<std::string>();
+                    }
+                    ld.appenders.push_back(lad);
+                }
+            }
+            return ld;
+        }
+    };
+
+    //LogDefine 转换成 YAML String
+    template <>
+    class LexicalCast<LogDefine, std::string>
+    {
+    public:
+        std::string operator()(const LogDefine &i)
+        {
+            YAML::Node n;
+            n["name"] = i.name;
+            if (i.level != LogLevel::UNKNOW)
+            {
+                n["level"] = LogLevel::ToString(i.level);
+            }
+            if (!i.formatter.empty())
+            {
+                n["formatter"] = i.formatter;
+            }
+
+            for (auto &a : i.appenders)
+            {
+                YAML::Node na;
+                if (a.type == 1)
+                {
+                    na["type"] = "FileLogAppender";
+                    na["file"] = a.file;
+                }
+                else if (a.type == 2)
+                {
+                    na["type"] = "StdoutLogAppender";
+                }
+                if (a.level != LogLevel::UNKNOW)
+                {
+                    na["level"] = LogLevel::ToString(a.level);
+                }
+                if (!a.formatter.empty())
+                {
+                    na["formatter"] = a.formatter;
+                }
+                n["appenders"].push_back(na);
+            }
+            std::stringstream ss;
+            ss << n;
+            return ss.str();
+        }
+    };
+
+    static sylar::ConfigVar<std::set<LogDefine>>::ptr g_log_defines =
+        sylar::Config::Lookup("logs", std::set<LogDefine>(), "logs config");
+
+    //按配置重建日志器的级别、格式和输出目标
+    static void ApplyLogDefine(const LogDefine &i)
+    {
+        sylar::Logger::ptr logger = SYLAR_LOG_NAME(i.name);
+        logger->setLevel(i.level);
+        if (!i.formatter.empty())
+        {
+            logger->setFormatter(i.formatter);
+        }
+
+        logger->clearAppenders();
+        for (auto &a : i.appenders)
+        {
+            sylar::LogAppender::ptr ap;
+            if (a.type == 1)
+            {
+                ap.reset(new FileLogAppender(a.file));
+            }
+            else if (a.type == 2)
+            {
+                ap.reset(new StdoutLogAppender);
+            }
+            else
+            {
+                continue;
+            }
+            ap->setLevel(a.level);
+            if (!a.formatter.empty())
+            {
+                LogFormatter::ptr fmt(new LogFormatter(a.formatter));
+                if (!fmt->isError())
+                {
+                    ap->setFormatter(fmt);
+                }
+                else
+                {
+                    SYLAR_LOG_ERROR(SYLAR_LOG_ROOT()) << "log.name=" << i.name << " appender type=" << a.type
+                                                      << " formatter=" << a.formatter << " is invalid";
+                }
+            }
+            logger->addAppender(ap);
+        }
+    }
+
+    struct LogIniter
+    {
+        LogIniter()
+        {
+            g_log_defines->addListener([](const std::set<LogDefine> &old_value,
+                                          const std::set<LogDefine> &new_value)
+                                       {
+                                           SYLAR_LOG_INFO(SYLAR_LOG_ROOT()) << "on_logger_conf_changed";
+                                           for (auto &i : new_value)
+                                           {
+                                               auto it = old_value.find(i);
+                                               if (it != old_value.end() && i == *it)
+                                               {
+                                                   //没有变化
+                                                   continue;
+                                               }
+                                               ApplyLogDefine(i);
+                                           }
+
+                                           for (auto &i : old_value)
+                                           {
+                                               if (new_value.find(i) == new_value.end())
+                                               {
+                                                   //删除logger: 级别设为大于FATAL关闭输出, 并清空目标
+                                                   auto logger = SYLAR_LOG_NAME(i.name);
+                                                   logger->setLevel((LogLevel::Level)100);
+                                                   logger->clearAppenders();
+                                               }
+                                           }
+                                       });
+        }
+    };
+
+    static LogIniter __log_init;
+
+}
\ No newline at end of file
@@ -110,6 +110,7 @@ namespace sylar
         //析构函数 - 自动释放锁
         ~ReadScopedLockImpl()
         {
+            unlock();
         }
 
         void lock()
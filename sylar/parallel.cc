@@ -0,0 +1,160 @@
+#include "sylar/parallel.h"
+#include "sylar/fiber.h"
+#include "sylar/mutex.h"
+#include "sylar/scheduler.h"
+#include "sylar/util.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace sylar
+{
+
+    namespace
+    {
+
+        //一次ParallelForIndex的共享状态, 投递出去的任务可能在调用返回后才开始, 所以用shared_ptr
+        struct ParallelState
+        {
+            typedef std::shared_ptr<ParallelState> ptr;
+
+            ParallelState(size_t c, const std::function<void(size_t)> *b)
+                : count(c), body(b), remaining(c)
+            {
+            }
+
+            const size_t count;
+            //只在领取到下标后访问, 此时调用者一定还在等待
+            const std::function<void(size_t)> *body;
+            std::atomic<size_t> next{0};
+            std::atomic<size_t> remaining;
+            std::atomic<bool> failed{false};
+
+            std::mutex mutex;
+            std::exception_ptr error;
+            Scheduler *waiterScheduler = nullptr;
+            Fiber::ptr waiterFiber;
+            int waiterThread = -1; /// 等待协程所在线程, 唤醒后回到该线程继续
+            Semaphore *waiterSem = nullptr;
+
+            //领取并执行下标, 直到全部领完
+            void run()
+            {
+                size_t i;
+                while ((i = next.fetch_add(1, std::memory_order_relaxed)) < count)
+                {
+                    if (!failed.load(std::memory_order_relaxed))
+                    {
+                        try
+                        {
+                            (*body)(i);
+                        }
+                        catch (...)
+                        {
+                            std::lock_guard<std::mutex> lock(mutex);
+                            if (!error)
+                            {
+                                error = std::current_exception();
+                            }
+                            failed = true;
+                        }
+                    }
+                    if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    {
+                        wake();
+                    }
+                }
+            }
+
+            void wake()
+            {
+                Scheduler *scheduler = nullptr;
+                Fiber::ptr fiber;
+                int thread = -1;
+                Semaphore *sem = nullptr;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    scheduler = waiterScheduler;
+                    fiber.swap(waiterFiber);
+                    thread = waiterThread;
+                    sem = waiterSem;
+                }
+                if (fiber)
+                {
+                    scheduler->schedule(fiber, thread);
+                }
+                else if (sem)
+                {
+                    sem->notify();
+                }
+            }
+        };
+
+    }
+
+    void ParallelForIndex(size_t count, const std::function<void(size_t)> &body,
+                          Scheduler *scheduler, size_t workers)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        Scheduler *current = Scheduler::GetThis();
+        if (!scheduler)
+        {
+            scheduler = current;
+        }
+        if (!scheduler || count == 1)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                body(i);
+            }
+            return;
+        }
+
+        if (workers == 0)
+        {
+            workers = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        ParallelState::ptr state = std::make_shared<ParallelState>(count, &body);
+        //调用者自己执行一份, 其余投递到调度器
+        size_t tasks = std::min(workers, count) - 1;
+        for (size_t i = 0; i < tasks; ++i)
+        {
+            scheduler->schedule(std::function<void()>([state]() { state->run(); }));
+        }
+        state->run();
+
+        bool in_fiber = Fiber::GetFiberId() != 0 && current;
+        Semaphore sem;
+        {
+            std::unique_lock<std::mutex> lock(state->mutex);
+            if (state->remaining.load(std::memory_order_acquire) != 0)
+            {
+                if (in_fiber)
+                {
+                    state->waiterScheduler = current;
+                    state->waiterFiber = Fiber::GetThis();
+                    state->waiterThread = GetThreadId();
+                    lock.unlock();
+                    Fiber::YieldToHold();
+                }
+                else
+                {
+                    state->waiterSem = &sem;
+                    lock.unlock();
+                    sem.wait();
+                }
+            }
+        }
+        if (state->error)
+        {
+            std::rethrow_exception(state->error);
+        }
+    }
+
+}
\ No newline at end of file
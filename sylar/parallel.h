@@ -0,0 +1,57 @@
+//协程并行循环
+#ifndef __SYLAR_PARALLEL_H__
+#define __SYLAR_PARALLEL_H__
+
+#include <stddef.h>
+#include <functional>
+#include <vector>
+#include "util/span.h"
+
+namespace sylar
+{
+
+    class Scheduler;
+
+    /**
+     * @brief 在调度器的工作线程上执行body(0)到body(count - 1), 全部完成后返回
+     * @param[in] scheduler 为nullptr时使用当前线程的调度器; 都没有时在当前线程串行执行
+     * @param[in] workers 最多投递的任务数, 0表示CPU核数
+     * @details 任务按下标从共享计数器领取, 调用者本身也参与执行。
+     *          在协程中调用时等待期间YieldToHold, 不占用线程; 否则阻塞在信号量上。
+     *          body抛出异常后不再执行尚未开始的下标, 第一个异常在所有已开始的body结束后重新抛出
+     */
+    void ParallelForIndex(size_t count, const std::function<void(size_t)> &body,
+                          Scheduler *scheduler = nullptr, size_t workers = 0);
+
+    /**
+     * @brief 把items按每块chunk个元素切分, 每块调用一次fn(Span<T>), 块之间并行
+     * @details 块是items的视图, 不复制元素; chunk为0时整个items作为一块。其他规则见ParallelForIndex
+     */
+    template <class T, class F>
+    void ParallelFor(Span<T> items, size_t chunk, F fn, Scheduler *scheduler = nullptr, size_t workers = 0)
+    {
+        if (chunk == 0)
+        {
+            chunk = items.size();
+        }
+        ParallelForIndex(
+            SliceCount(items.size(), chunk),
+            [&](size_t i) { fn(items.subspan(i * chunk, chunk)); },
+            scheduler, workers);
+    }
+
+    template <class T, class A, class F>
+    void ParallelFor(std::vector<T, A> &items, size_t chunk, F fn, Scheduler *scheduler = nullptr, size_t workers = 0)
+    {
+        ParallelFor(MakeSpan(items), chunk, fn, scheduler, workers);
+    }
+
+    template <class T, class A, class F>
+    void ParallelFor(const std::vector<T, A> &items, size_t chunk, F fn, Scheduler *scheduler = nullptr, size_t workers = 0)
+    {
+        ParallelFor(MakeSpan(items), chunk, fn, scheduler, workers);
+    }
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,410 @@
+#include "sylar/resolver.h"
+#include "sylar/scheduler.h"
+#include "sylar/util.h"
+#include "sylar/log.h"
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+namespace sylar
+{
+
+    static sylar::Logger::ptr g_logger = SYLAR_LOG_NAME("system");
+
+    //解析数字地址, IPv6可带方括号, 不是数字地址或协议族不匹配返回nullptr
+    static IPAddress::ptr ParseNumeric(const std::string &host, int family)
+    {
+        std::string str = host;
+        if (str.size() > 2 && str.front() == '[' && str.back() == ']')
+        {
+            str = str.substr(1, str.size() - 2);
+        }
+        if (family != AF_INET6)
+        {
+            sockaddr_in addr;
+            memset(&addr, 0, sizeof(addr));
+            addr.sin_family = AF_INET;
+            if (inet_pton(AF_INET, str.c_str(), &addr.sin_addr) == 1)
+            {
+                return std::dynamic_pointer_cast<IPAddress>(Address::Create((const sockaddr *)&addr, sizeof(addr)));
+            }
+        }
+        if (family != AF_INET)
+        {
+            sockaddr_in6 addr;
+            memset(&addr, 0, sizeof(addr));
+            addr.sin6_family = AF_INET6;
+            if (inet_pton(AF_INET6, str.c_str(), &addr.sin6_addr) == 1)
+            {
+                return std::dynamic_pointer_cast<IPAddress>(Address::Create((const sockaddr *)&addr, sizeof(addr)));
+            }
+        }
+        return nullptr;
+    }
+
+    //复制地址, 缓存中的地址是共享的, 返回给调用者前必须复制
+    static IPAddress::ptr CloneAddress(const IPAddress::ptr &addr)
+    {
+        return std::dynamic_pointer_cast<IPAddress>(Address::Create(addr->getAddr(), addr->getAddrLen()));
+    }
+
+    static std::string MakeKey(const std::string &host, int family)
+    {
+        return std::to_string(family) + ":" + host;
+    }
+
+    int SystemResolver::resolve(const std::string &host, int family, std::vector<IPAddress::ptr> &result)
+    {
+        addrinfo hints, *results = nullptr;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = family;
+        hints.ai_socktype = SOCK_STREAM;
+
+        int error = getaddrinfo(host.c_str(), nullptr, &hints, &results);
+        if (error)
+        {
+            SYLAR_LOG_DEBUG(g_logger) << "SystemResolver::resolve(" << host << ", "
+                                      << family << ") err=" << error
+                                      << " errstr=" << gai_strerror(error);
+            return error;
+        }
+        for (addrinfo *next = results; next; next = next->ai_next)
+        {
+            IPAddress::ptr addr = std::dynamic_pointer_cast<IPAddress>(
+                Address::Create(next->ai_addr, (socklen_t)next->ai_addrlen));
+            if (addr)
+            {
+                result.push_back(addr);
+            }
+        }
+        freeaddrinfo(results);
+        return result.empty() ? EAI_NONAME : 0;
+    }
+
+    StubResolver::StubResolver()
+        : m_delay(0), m_calls(0)
+    {
+    }
+
+    void StubResolver::setHost(const std::string &host, const std::vector<std::string> &addrs)
+    {
+        MutexType::Lock lock(m_mutex);
+        m_hosts[host] = addrs;
+    }
+
+    void StubResolver::delHost(const std::string &host)
+    {
+        MutexType::Lock lock(m_mutex);
+        m_hosts.erase(host);
+    }
+
+    int StubResolver::resolve(const std::string &host, int family, std::vector<IPAddress::ptr> &result)
+    {
+        ++m_calls;
+        uint64_t delay = m_delay;
+        if (delay)
+        {
+            usleep(delay * 1000);
+        }
+        std::vector<std::string> addrs;
+        {
+            MutexType::Lock lock(m_mutex);
+            auto it = m_hosts.find(host);
+            if (it == m_hosts.end())
+            {
+                return EAI_NONAME;
+            }
+            addrs = it->second;
+        }
+        for (auto &i : addrs)
+        {
+            IPAddress::ptr addr = ParseNumeric(i, family);
+            if (addr)
+            {
+                result.push_back(addr);
+            }
+        }
+        return result.empty() ? EAI_NONAME : 0;
+    }
+
+    DnsCache::DnsCache()
+        : m_resolver(new SystemResolver), m_stopping(false), m_positiveTTL(60 * 1000), m_negativeTTL(5 * 1000), m_maxSize(4096), m_threadCount(2), m_hits(0), m_misses(0), m_joins(0)
+    {
+    }
+
+    DnsCache::~DnsCache()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_taskMutex);
+            m_stopping = true;
+        }
+        m_taskCond.notify_all();
+        for (auto &i : m_workers)
+        {
+            i.join();
+        }
+    }
+
+    bool DnsCache::lookup(const std::string &host, std::vector<IPAddress::ptr> &result, int family)
+    {
+        IPAddress::ptr addr = ParseNumeric(host, family);
+        if (addr)
+        {
+            result.push_back(addr);
+            return true;
+        }
+        Entry::ptr entry = get(host, family);
+        if (entry->error)
+        {
+            return false;
+        }
+        for (auto &i : entry->addrs)
+        {
+            result.push_back(CloneAddress(i));
+        }
+        return true;
+    }
+
+    IPAddress::ptr DnsCache::lookupAny(const std::string &host, int family)
+    {
+        IPAddress::ptr addr = ParseNumeric(host, family);
+        if (addr)
+        {
+            return addr;
+        }
+        Entry::ptr entry = get(host, family);
+        if (entry->error)
+        {
+            return nullptr;
+        }
+        uint32_t idx = entry->next.fetch_add(1, std::memory_order_relaxed);
+        return CloneAddress(entry->addrs[idx % entry->addrs.size()]);
+    }
+
+    DnsCache::Entry::ptr DnsCache::get(const std::string &host, int family)
+    {
+        //域名不区分大小写, 统一转为小写后缓存和解析
+        std::string name = ToLower(host);
+        std::string key = MakeKey(name, family);
+        {
+            RWMutexType::ReadLock lock(m_mutex);
+            auto it = m_hosts.find(key);
+            if (it != m_hosts.end())
+            {
+                ++m_hits;
+                return it->second;
+            }
+            it = m_cache.find(key);
+            if (it != m_cache.end() && it->second->expire > GetCurrentMS())
+            {
+                ++m_hits;
+                return it->second;
+            }
+        }
+
+        bool in_fiber = Fiber::GetFiberId() != 0 && Scheduler::GetThis();
+        std::unique_lock<std::mutex> lock(m_flightMutex);
+        Flight::ptr flight;
+        auto it = m_flights.find(key);
+        if (it != m_flights.end())
+        {
+            ++m_joins;
+            flight = it->second;
+        }
+        else
+        {
+            flight.reset(new Flight);
+            m_flights[key] = flight;
+            if (!in_fiber)
+            {
+                lock.unlock();
+                run(key, name, family, flight);
+                return flight->result;
+            }
+            post(std::bind(&DnsCache::run, this, key, name, family, flight));
+        }
+
+        if (in_fiber)
+        {
+            //固定回当前线程: 解锁后到YieldToHold切出前, 协程仍在本线程栈上运行
+            flight->fibers.push_back({Scheduler::GetThis(), Fiber::GetThis(), GetThreadId()});
+            lock.unlock();
+            Fiber::YieldToHold();
+        }
+        else
+        {
+            Semaphore sem;
+            flight->threads.push_back(&sem);
+            lock.unlock();
+            sem.wait();
+        }
+        return flight->result;
+    }
+
+    void DnsCache::run(const std::string &key, const std::string &host, int family, Flight::ptr flight)
+    {
+        ++m_misses;
+        Resolver::ptr resolver = getResolver();
+        Entry::ptr entry(new Entry);
+        entry->error = resolver->resolve(host, family, entry->addrs);
+        if (!entry->error && entry->addrs.empty())
+        {
+            entry->error = EAI_NONAME;
+        }
+        entry->expire = GetCurrentMS() + (entry->error ? m_negativeTTL : m_positiveTTL);
+
+        {
+            RWMutexType::WriteLock lock(m_mutex);
+            //解析期间更换了解析器, 结果只返回给等待者, 不进缓存
+            if (m_resolver == resolver)
+            {
+                if (m_cache.size() >= m_maxSize)
+                {
+                    uint64_t now = GetCurrentMS();
+                    for (auto it = m_cache.begin(); it != m_cache.end();)
+                    {
+                        if (it->second->expire <= now)
+                        {
+                            it = m_cache.erase(it);
+                        }
+                        else
+                        {
+                            ++it;
+                        }
+                    }
+                    if (m_cache.size() >= m_maxSize)
+                    {
+                        m_cache.erase(m_cache.begin());
+                    }
+                }
+                m_cache[key] = entry;
+            }
+        }
+
+        std::vector<FiberWaiter> fibers;
+        std::vector<Semaphore *> threads;
+        {
+            std::lock_guard<std::mutex> lock(m_flightMutex);
+            flight->result = entry;
+            fibers.swap(flight->fibers);
+            threads.swap(flight->threads);
+            m_flights.erase(key);
+        }
+        for (auto &i : threads)
+        {
+            i->notify();
+        }
+        for (auto &i : fibers)
+        {
+            i.scheduler->schedule(i.fiber, i.thread);
+        }
+    }
+
+    void DnsCache::post(std::function<void()> cb)
+    {
+        std::lock_guard<std::mutex> lock(m_taskMutex);
+        if (m_workers.empty())
+        {
+            size_t count = std::max(m_threadCount, (size_t)1);
+            for (size_t i = 0; i < count; ++i)
+            {
+                m_workers.emplace_back(&DnsCache::workerMain, this);
+            }
+        }
+        m_tasks.push_back(std::move(cb));
+        m_taskCond.notify_one();
+    }
+
+    void DnsCache::workerMain()
+    {
+        while (true)
+        {
+            std::function<void()> cb;
+            {
+                std::unique_lock<std::mutex> lock(m_taskMutex);
+                m_taskCond.wait(lock, [this]()
+                                { return m_stopping || !m_tasks.empty(); });
+                if (m_tasks.empty())
+                {
+                    return;
+                }
+                cb.swap(m_tasks.front());
+                m_tasks.pop_front();
+            }
+            cb();
+        }
+    }
+
+    int DnsCache::loadHosts(const std::string &path)
+    {
+        std::ifstream ifs(path);
+        if (!ifs)
+        {
+            SYLAR_LOG_ERROR(g_logger) << "DnsCache::loadHosts open " << path << " fail";
+            return -1;
+        }
+        std::unordered_map<std::string, Entry::ptr> hosts;
+        int count = 0;
+        std::string line;
+        while (std::getline(ifs, line))
+        {
+            size_t pos = line.find('#');
+            if (pos != std::string::npos)
+            {
+                line.resize(pos);
+            }
+            std::istringstream iss(line);
+            std::string ip, name;
+            if (!(iss >> ip))
+            {
+                continue;
+            }
+            IPAddress::ptr addr = ParseNumeric(ip, AF_UNSPEC);
+            if (!addr)
+            {
+                continue;
+            }
+            while (iss >> name)
+            {
+                int families[] = {AF_UNSPEC, addr->getFamily()};
+                for (int family : families)
+                {
+                    Entry::ptr &entry = hosts[MakeKey(ToLower(name), family)];
+                    if (!entry)
+                    {
+                        entry.reset(new Entry);
+                    }
+                    entry->addrs.push_back(addr);
+                }
+            }
+            ++count;
+        }
+        RWMutexType::WriteLock lock(m_mutex);
+        m_hosts.swap(hosts);
+        return count;
+    }
+
+    void DnsCache::setResolver(Resolver::ptr v)
+    {
+        RWMutexType::WriteLock lock(m_mutex);
+        m_resolver = v;
+        m_cache.clear();
+    }
+
+    Resolver::ptr DnsCache::getResolver()
+    {
+        RWMutexType::ReadLock lock(m_mutex);
+        return m_resolver;
+    }
+
+    void DnsCache::clear()
+    {
+        RWMutexType::WriteLock lock(m_mutex);
+        m_cache.clear();
+    }
+
+}
\ No newline at end of file
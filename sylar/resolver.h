@@ -0,0 +1,237 @@
+//带缓存的域名解析
+#ifndef __SYLAR_RESOLVER_H__
+#define __SYLAR_RESOLVER_H__
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <list>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <functional>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include "address.h"
+#include "fiber.h"
+#include "mutex.h"
+#include "singleton.h"
+
+namespace sylar
+{
+
+    class Scheduler;
+
+    /**
+     * @brief 解析器接口
+     * @details 只负责一次阻塞解析, 缓存/去重由DnsCache完成
+     */
+    class Resolver
+    {
+    public:
+        typedef std::shared_ptr<Resolver> ptr;
+
+        virtual ~Resolver() {}
+
+        /**
+         * @brief 阻塞解析主机名
+         * @param[in] host 主机名
+         * @param[in] family 协议族(AF_INET, AF_INET6, AF_UNSPEC)
+         * @param[out] result 解析到的地址(端口为0)
+         * @return 成功返回0, 失败返回getaddrinfo风格的错误码
+         */
+        virtual int resolve(const std::string &host, int family, std::vector<IPAddress::ptr> &result) = 0;
+    };
+
+    //基于getaddrinfo的系统解析器
+    class SystemResolver : public Resolver
+    {
+    public:
+        typedef std::shared_ptr<SystemResolver> ptr;
+
+        int resolve(const std::string &host, int family, std::vector<IPAddress::ptr> &result) override;
+    };
+
+    /**
+     * @brief 本地桩解析器
+     * @details 从内存表返回结果, 可设置延迟, 用于测试缓存/去重逻辑
+     */
+    class StubResolver : public Resolver
+    {
+    public:
+        typedef std::shared_ptr<StubResolver> ptr;
+        typedef Mutex MutexType;
+
+        StubResolver();
+
+        /**
+         * @brief 设置主机名对应的地址
+         * @param[in] addrs 数字地址列表, 为空表示解析失败
+         */
+        void setHost(const std::string &host, const std::vector<std::string> &addrs);
+
+        //删除主机名
+        void delHost(const std::string &host);
+
+        //设置每次解析的延迟(毫秒)
+        void setDelay(uint64_t ms) { m_delay = ms; }
+
+        //返回resolve被调用的次数
+        uint64_t getCallCount() const { return m_calls; }
+
+        int resolve(const std::string &host, int family, std::vector<IPAddress::ptr> &result) override;
+
+    private:
+        MutexType m_mutex;
+        std::map<std::string, std::vector<std::string>> m_hosts;
+        std::atomic<uint64_t> m_delay;
+        std::atomic<uint64_t> m_calls;
+    };
+
+    /**
+     * @brief 域名解析缓存
+     * @details
+     *  - 成功结果缓存positive_ttl, 失败结果缓存negative_ttl
+     *  - 同一(host, family)的并发解析只会发起一次, 其他调用者等待同一结果
+     *  - 在协程中调用时, 阻塞的解析交给后台线程执行, 当前协程让出,
+     *    解析完成后重新调度回原来的调度器, 不会阻塞工作线程
+     *  - 不在协程中调用时, 直接在当前线程解析
+     *  - /etc/hosts中的条目和数字地址不经过解析器, 也不会过期
+     */
+    class DnsCache : Noncopyable
+    {
+    public:
+        typedef std::shared_ptr<DnsCache> ptr;
+        typedef RWMutex RWMutexType;
+
+        DnsCache();
+        ~DnsCache();
+
+        /**
+         * @brief 解析主机名的所有地址
+         * @param[in] host 主机名或数字地址(IPv6可带方括号)
+         * @param[out] result 地址列表, 每个地址都是独立的副本, 可以直接修改端口
+         * @param[in] family 协议族
+         * @return 成功返回true
+         */
+        bool lookup(const std::string &host, std::vector<IPAddress::ptr> &result, int family = AF_INET);
+
+        /**
+         * @brief 解析主机名的任意一个地址
+         * @details 多个地址时轮询返回
+         * @return 失败返回nullptr
+         */
+        IPAddress::ptr lookupAny(const std::string &host, int family = AF_INET);
+
+        /**
+         * @brief 加载hosts文件
+         * @return 成功加载的条目数, 文件打开失败返回-1
+         */
+        int loadHosts(const std::string &path = "/etc/hosts");
+
+        //设置解析器, 同时清空缓存
+        void setResolver(Resolver::ptr v);
+
+        //返回解析器
+        Resolver::ptr getResolver();
+
+        //设置成功结果的缓存时间(毫秒)
+        void setPositiveTTL(uint64_t ms) { m_positiveTTL = ms; }
+        uint64_t getPositiveTTL() const { return m_positiveTTL; }
+
+        //设置失败结果的缓存时间(毫秒)
+        void setNegativeTTL(uint64_t ms) { m_negativeTTL = ms; }
+        uint64_t getNegativeTTL() const { return m_negativeTTL; }
+
+        //设置缓存的最大条目数
+        void setMaxSize(size_t v) { m_maxSize = v; }
+
+        //设置后台解析线程数, 只在第一次异步解析前生效
+        void setThreadCount(size_t v) { m_threadCount = v; }
+
+        //清空缓存(不包括hosts)
+        void clear();
+
+        //缓存命中次数
+        uint64_t getHits() const { return m_hits; }
+
+        //调用解析器的次数
+        uint64_t getMisses() const { return m_misses; }
+
+        //等待其他调用者解析结果的次数
+        uint64_t getJoins() const { return m_joins; }
+
+    private:
+        //缓存条目
+        struct Entry
+        {
+            typedef std::shared_ptr<Entry> ptr;
+            std::vector<IPAddress::ptr> addrs;
+            int error = 0;
+            uint64_t expire = 0;
+            std::atomic<uint32_t> next{0};
+        };
+
+        //等待解析结果的协程, 在原线程上恢复
+        struct FiberWaiter
+        {
+            Scheduler *scheduler;
+            Fiber::ptr fiber;
+            int thread;
+        };
+
+        //一次进行中的解析
+        struct Flight
+        {
+            typedef std::shared_ptr<Flight> ptr;
+            std::vector<FiberWaiter> fibers;
+            std::vector<Semaphore *> threads;
+            Entry::ptr result;
+        };
+
+        //获取(host, family)的结果, 必要时发起或等待解析
+        Entry::ptr get(const std::string &host, int family);
+
+        //在当前线程执行解析并发布结果
+        void run(const std::string &key, const std::string &host, int family, Flight::ptr flight);
+
+        //把任务交给后台线程
+        void post(std::function<void()> cb);
+
+        //后台线程主函数
+        void workerMain();
+
+    private:
+        RWMutexType m_mutex;
+        Resolver::ptr m_resolver;
+        std::unordered_map<std::string, Entry::ptr> m_cache;
+        std::unordered_map<std::string, Entry::ptr> m_hosts;
+
+        //进行中的解析, 由m_flightMutex保护
+        std::mutex m_flightMutex;
+        std::unordered_map<std::string, Flight::ptr> m_flights;
+
+        //后台线程
+        std::mutex m_taskMutex;
+        std::condition_variable m_taskCond;
+        std::deque<std::function<void()>> m_tasks;
+        std::vector<std::thread> m_workers;
+        bool m_stopping;
+
+        std::atomic<uint64_t> m_positiveTTL;
+        std::atomic<uint64_t> m_negativeTTL;
+        std::atomic<size_t> m_maxSize;
+        size_t m_threadCount;
+
+        std::atomic<uint64_t> m_hits;
+        std::atomic<uint64_t> m_misses;
+        std::atomic<uint64_t> m_joins;
+    };
+
+    typedef sylar::SingleTon<DnsCache> DnsCacheMgr;
+
+}
+
+#endif
\ No newline at end of file
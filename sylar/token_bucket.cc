@@ -0,0 +1,190 @@
+#include "sylar/token_bucket.h"
+#include "sylar/fiber.h"
+#include "sylar/iomanager.h"
+#include "sylar/util.h"
+#include <time.h>
+#include <errno.h>
+#include <stdint.h>
+#include <algorithm>
+
+namespace sylar
+{
+
+    static const int64_t s_ns_per_sec = 1000 * 1000 * 1000;
+    static const int64_t s_ns_per_ms = 1000 * 1000;
+    //单次预约的最大纳秒数(约36年), 保证与时间戳相加不溢出int64
+    static const int64_t s_max_cost_ns = (int64_t)1 << 60;
+
+    //b >= 0, 饱和加法, 连续的超大预约把桶的空时间推到上限而不是回绕为负数
+    static int64_t SaturateAdd(int64_t a, int64_t b)
+    {
+        return a > INT64_MAX - b ? INT64_MAX : a + b;
+    }
+
+    int64_t TokenBucket::NowNS()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * s_ns_per_sec + ts.tv_nsec;
+    }
+
+    void TokenBucket::WaitNS(uint64_t ns)
+    {
+        if (ns == 0)
+        {
+            return;
+        }
+        IOManager *iom = IOManager::GetThis();
+        if (!iom || Fiber::GetFiberId() == 0)
+        {
+            struct timespec ts;
+            ts.tv_sec = ns / s_ns_per_sec;
+            ts.tv_nsec = ns % s_ns_per_sec;
+            while (nanosleep(&ts, &ts) == -1 && errno == EINTR)
+                ;
+            return;
+        }
+
+        //定时器是毫秒精度, 向上取整到毫秒, 不在剩余的不足1ms上空转;
+        //定时器提前触发时按剩余时间重新等待
+        int64_t deadline = NowNS() + (int64_t)std::min(ns, (uint64_t)s_max_cost_ns);
+        //定时器回调可能在其他线程触发, 固定回当前线程, 避免本线程尚未切出时被别的线程恢复
+        int thread = GetThreadId();
+        int64_t now = 0;
+        while ((now = NowNS()) < deadline)
+        {
+            uint64_t ms = (deadline - now + s_ns_per_ms - 1) / s_ns_per_ms;
+            Fiber::ptr fiber = Fiber::GetThis();
+            iom->addTimer(ms, [iom, fiber, thread]()
+                          { iom->schedule(fiber, thread); });
+            Fiber::YieldToHold();
+        }
+    }
+
+    TokenBucket::TokenBucket(uint64_t rate, uint64_t burst, TokenBucket::ptr parent)
+        : m_rate(0), m_burst(0), m_burstNS(0), m_emptyAt(0), m_parent(parent)
+    {
+        setRate(rate, burst);
+        //初始时桶是满的
+        m_emptyAt.store(NowNS() - m_burstNS.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    void TokenBucket::setRate(uint64_t rate, uint64_t burst)
+    {
+        if (burst == 0)
+        {
+            burst = rate;
+        }
+        m_rate.store(rate, std::memory_order_relaxed);
+        m_burst.store(burst, std::memory_order_relaxed);
+        m_burstNS.store(rate ? costNS(burst) : 0, std::memory_order_relaxed);
+    }
+
+    int64_t TokenBucket::costNS(uint64_t n) const
+    {
+        uint64_t rate = m_rate.load(std::memory_order_relaxed);
+        if (rate == 0)
+        {
+            return 0;
+        }
+        unsigned __int128 v = ((unsigned __int128)n * s_ns_per_sec + rate - 1) / rate;
+        return v > (unsigned __int128)s_max_cost_ns ? s_max_cost_ns : (int64_t)v;
+    }
+
+    int64_t TokenBucket::reserveLocal(uint64_t n, int64_t now)
+    {
+        if (m_rate.load(std::memory_order_relaxed) == 0)
+        {
+            return 0;
+        }
+        int64_t cost = costNS(n);
+        int64_t floor = now - m_burstNS.load(std::memory_order_relaxed);
+        int64_t empty_at = m_emptyAt.load(std::memory_order_relaxed);
+        int64_t next = 0;
+        do
+        {
+            next = SaturateAdd(std::max(empty_at, floor), cost);
+        } while (!m_emptyAt.compare_exchange_weak(empty_at, next, std::memory_order_relaxed));
+        return next > now ? next - now : 0;
+    }
+
+    bool TokenBucket::tryLocal(uint64_t n, int64_t now)
+    {
+        if (m_rate.load(std::memory_order_relaxed) == 0)
+        {
+            return true;
+        }
+        int64_t cost = costNS(n);
+        int64_t floor = now - m_burstNS.load(std::memory_order_relaxed);
+        int64_t empty_at = m_emptyAt.load(std::memory_order_relaxed);
+        int64_t next = 0;
+        do
+        {
+            next = SaturateAdd(std::max(empty_at, floor), cost);
+            if (next > now)
+            {
+                return false;
+            }
+        } while (!m_emptyAt.compare_exchange_weak(empty_at, next, std::memory_order_relaxed));
+        return true;
+    }
+
+    bool TokenBucket::tryAcquire(uint64_t n)
+    {
+        if (!tryLocal(n, NowNS()))
+        {
+            return false;
+        }
+        if (m_parent && !m_parent->tryAcquire(n))
+        {
+            refund(n);
+            return false;
+        }
+        return true;
+    }
+
+    uint64_t TokenBucket::reserve(uint64_t n)
+    {
+        int64_t wait = reserveLocal(n, NowNS());
+        if (m_parent)
+        {
+            wait = std::max(wait, (int64_t)m_parent->reserve(n));
+        }
+        return wait;
+    }
+
+    void TokenBucket::acquire(uint64_t n)
+    {
+        WaitNS(reserve(n));
+    }
+
+    void TokenBucket::refund(uint64_t n)
+    {
+        if (m_rate.load(std::memory_order_relaxed) == 0)
+        {
+            return;
+        }
+        int64_t cost = costNS(n);
+        int64_t empty_at = m_emptyAt.load(std::memory_order_relaxed);
+        while (!m_emptyAt.compare_exchange_weak(empty_at, empty_at - cost, std::memory_order_relaxed))
+            ;
+    }
+
+    uint64_t TokenBucket::getAvailable() const
+    {
+        uint64_t rate = m_rate.load(std::memory_order_relaxed);
+        uint64_t burst = m_burst.load(std::memory_order_relaxed);
+        if (rate == 0)
+        {
+            return (uint64_t)-1;
+        }
+        int64_t elapse = NowNS() - m_emptyAt.load(std::memory_order_relaxed);
+        if (elapse <= 0)
+        {
+            return 0;
+        }
+        unsigned __int128 v = (unsigned __int128)elapse * rate / s_ns_per_sec;
+        return v > burst ? burst : (uint64_t)v;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,103 @@
+//令牌桶限速器
+#ifndef __SYLAR_TOKEN_BUCKET_H__
+#define __SYLAR_TOKEN_BUCKET_H__
+
+#include <memory>
+#include <atomic>
+#include <stdint.h>
+
+namespace sylar
+{
+
+    /**
+     * @brief 无锁令牌桶
+     * @details 用一个原子变量保存"桶被取空的虚拟时间"(GCRA):
+     *          当前可用令牌 = min(burst, (now - m_emptyAt) * rate)。
+     *          取令牌只需一次CAS推进m_emptyAt, 精度为纳秒;
+     *          设置父桶后同时受父桶限制, 用于单连接+全局的分层限速
+     */
+    class TokenBucket
+    {
+    public:
+        typedef std::shared_ptr<TokenBucket> ptr;
+
+        /**
+         * @brief 构造函数
+         * @param[in] rate 每秒产生的令牌数, 0表示不限速
+         * @param[in] burst 桶容量(允许的突发量), 0表示等于rate
+         * @param[in] parent 父桶
+         */
+        TokenBucket(uint64_t rate, uint64_t burst = 0, TokenBucket::ptr parent = nullptr);
+
+        /**
+         * @brief 尝试立即取出n个令牌
+         * @return 本桶及所有父桶都有足够令牌时返回true, 否则不消耗任何令牌
+         */
+        bool tryAcquire(uint64_t n = 1);
+
+        /**
+         * @brief 预约n个令牌
+         * @return 需要等待的纳秒数, 等待结束后令牌归调用者所有
+         * @details 令牌不足时也会预约成功, 后续调用者依次排在其后
+         */
+        uint64_t reserve(uint64_t n = 1);
+
+        /**
+         * @brief 取出n个令牌, 不足时等待
+         * @details 在IOManager协程中通过定时器挂起当前协程, 不阻塞工作线程;
+         *          在普通线程中休眠
+         */
+        void acquire(uint64_t n = 1);
+
+        /**
+         * @brief 归还n个令牌(不超过桶容量)
+         */
+        void refund(uint64_t n);
+
+        //修改速率和容量, 已有的预约不受影响
+        void setRate(uint64_t rate, uint64_t burst = 0);
+
+        //返回每秒产生的令牌数
+        uint64_t getRate() const { return m_rate.load(std::memory_order_relaxed); }
+
+        //返回桶容量
+        uint64_t getBurst() const { return m_burst.load(std::memory_order_relaxed); }
+
+        //返回当前可用令牌数
+        uint64_t getAvailable() const;
+
+        //返回父桶
+        TokenBucket::ptr getParent() const { return m_parent; }
+
+    public:
+        //返回单调时钟纳秒
+        static int64_t NowNS();
+
+        /**
+         * @brief 等待ns纳秒
+         * @details 协程中挂到IOManager定时器上, 等待时间向上取整到毫秒(最多多等1ms), 不占用线程;
+         *          非协程环境nanosleep
+         */
+        static void WaitNS(uint64_t ns);
+
+    private:
+        //n个令牌对应的纳秒数, 128位计算, 超大的值截断到约36年
+        int64_t costNS(uint64_t n) const;
+
+        //只在本桶上预约, 返回需要等待的纳秒数
+        int64_t reserveLocal(uint64_t n, int64_t now);
+
+        //只在本桶上尝试取令牌
+        bool tryLocal(uint64_t n, int64_t now);
+
+    private:
+        std::atomic<uint64_t> m_rate;     /// 每秒令牌数
+        std::atomic<uint64_t> m_burst;    /// 桶容量
+        std::atomic<int64_t> m_burstNS;   /// 桶容量对应的纳秒数
+        std::atomic<int64_t> m_emptyAt;   /// 桶被取空的虚拟时间
+        TokenBucket::ptr m_parent;        /// 父桶
+    };
+
+}
+
+#endif
\ No newline at end of file
@@ -1 +0,0 @@
-#include"json_util.h"
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include "sylar/uri.h"
+#include "sylar/resolver.h"
+#include <sstream>
+
+namespace sylar
+{
+
+    Uri::ptr Uri::Create(const std::string &uristr)
+    {
+        UriView view;
+        if (!view.parse(uristr))
+        {
+            return nullptr;
+        }
+        return Create(view);
+    }
+
+    Uri::ptr Uri::Create(const UriView &view)
+    {
+        Uri::ptr uri(new Uri);
+        uri->m_scheme.assign(view.getScheme().data(), view.getScheme().size());
+        uri->m_userinfo.assign(view.getUserinfo().data(), view.getUserinfo().size());
+        uri->m_host.assign(view.getHost().data(), view.getHost().size());
+        uri->m_path.assign(view.getPath().data(), view.getPath().size());
+        uri->m_query.assign(view.getQuery().data(), view.getQuery().size());
+        uri->m_fragment.assign(view.getFragment().data(), view.getFragment().size());
+        uri->m_port = view.getPort();
+        return uri;
+    }
+
+    Uri::Uri()
+        : m_port(0)
+    {
+    }
+
+    bool Uri::isDefaultPort() const
+    {
+        if (m_port == 0)
+        {
+            return true;
+        }
+        if (m_scheme == "http" || m_scheme == "ws")
+        {
+            return m_port == 80;
+        }
+        else if (m_scheme == "https" || m_scheme == "wss")
+        {
+            return m_port == 443;
+        }
+        return false;
+    }
+
+    const std::string &Uri::getPath() const
+    {
+        static std::string s_default_path = "/";
+        return m_path.empty() ? s_default_path : m_path;
+    }
+
+    int32_t Uri::getPort() const
+    {
+        if (m_port)
+        {
+            return m_port;
+        }
+        if (m_scheme == "http" || m_scheme == "ws")
+        {
+            return 80;
+        }
+        else if (m_scheme == "https" || m_scheme == "wss")
+        {
+            return 443;
+        }
+        return m_port;
+    }
+
+    std::ostream &Uri::dump(std::ostream &os) const
+    {
+        if (!m_scheme.empty())
+        {
+            os << m_scheme << ":";
+        }
+        if (!m_host.empty() || !m_userinfo.empty())
+        {
+            os << "//" << m_userinfo
+               << (m_userinfo.empty() ? "" : "@")
+               << m_host << (isDefaultPort() ? "" : ":" + std::to_string(m_port));
+        }
+        os << getPath()
+           << (m_query.empty() ? "" : "?")
+           << m_query
+           << (m_fragment.empty() ? "" : "#")
+           << m_fragment;
+        return os;
+    }
+
+    std::string Uri::toString() const
+    {
+        std::stringstream ss;
+        dump(ss);
+        return ss.str();
+    }
+
+    Address::ptr Uri::createAddress() const
+    {
+        auto addr = DnsCacheMgr::GetInstance()->lookupAny(m_host);
+        if (addr)
+        {
+            addr->setPort(getPort());
+        }
+        return addr;
+    }
+
+}
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <string>
 #include <stdint.h>
 #include "address.h"
+#include "uri_view.h"
 
 namespace sylar
 {
@@ -29,6 +30,11 @@ namespace sylar
         /// @return 解析成功返回Uri对象，否则返回nullptr
         static Uri::ptr Create(const std::string &uri);
 
+        /// @brief 从已解析的UriView创建Uri对象
+        /// @param view 解析结果, 各部分按原样复制
+        /// @return Uri对象
+        static Uri::ptr Create(const UriView &view);
+
         //构造函数
         Uri();
 
@@ -84,6 +90,10 @@ namespace sylar
 
         //获取address
         Address::ptr createAddress() const;
+
+    private:
+        //是否为scheme的默认端口
+        bool isDefaultPort() const;
     };
 
 }
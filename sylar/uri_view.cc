@@ -0,0 +1,330 @@
+#include "sylar/uri_view.h"
+#include "sylar/util.h"
+#include <array>
+
+namespace sylar
+{
+
+    //字符所属的URI组成部分
+    enum UriCharMask
+    {
+        URI_SCHEME = 0x01,   /// scheme
+        URI_USERINFO = 0x02, /// userinfo
+        URI_HOST = 0x04,     /// reg-name
+        URI_IPLIT = 0x08,    /// IP-literal(方括号内)
+        URI_PATH = 0x10,     /// path
+        URI_QUERY = 0x20     /// query和fragment
+    };
+
+    static constexpr bool IsAlpha(int c) { return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'); }
+    static constexpr bool IsDigit(int c) { return c >= '0' && c <= '9'; }
+    static constexpr bool IsXdigit(int c) { return IsDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'); }
+
+    static constexpr bool IsUnreserved(int c)
+    {
+        return IsAlpha(c) || IsDigit(c) || c == '-' || c == '.' || c == '_' || c == '~';
+    }
+
+    static constexpr bool IsSubDelim(int c)
+    {
+        return c == '!' || c == '$' || c == '&' || c == '\'' || c == '(' || c == ')' || c == '*' || c == '+' || c == ',' || c == ';' || c == '=';
+    }
+
+    static constexpr std::array<uint8_t, 256> MakeUriCharTable()
+    {
+        std::array<uint8_t, 256> t{};
+        for (int c = 0; c < 256; ++c)
+        {
+            uint8_t m = 0;
+            if (IsAlpha(c) || IsDigit(c) || c == '+' || c == '-' || c == '.')
+            {
+                m |= URI_SCHEME;
+            }
+            if (IsUnreserved(c) || IsSubDelim(c))
+            {
+                m |= URI_USERINFO | URI_HOST | URI_IPLIT | URI_PATH | URI_QUERY;
+            }
+            if (c == ':')
+            {
+                m |= URI_USERINFO | URI_IPLIT | URI_PATH | URI_QUERY;
+            }
+            if (c == '@')
+            {
+                m |= URI_PATH | URI_QUERY;
+            }
+            if (c == '/')
+            {
+                m |= URI_PATH | URI_QUERY;
+            }
+            if (c == '?')
+            {
+                m |= URI_QUERY;
+            }
+            t[c] = m;
+        }
+        return t;
+    }
+
+    static constexpr std::array<uint8_t, 256> s_uri_chars = MakeUriCharTable();
+
+    /**
+     * @brief 扫描一个组成部分直到遇到stop字符或结尾
+     * @details 校验字符是否合法, 百分号后必须跟两个16进制数字
+     * @return 有非法字符返回false
+     */
+    static bool ScanComponent(const char *&p, const char *end, uint8_t mask, char stop1, char stop2)
+    {
+        while (p < end)
+        {
+            char c = *p;
+            if (c == stop1 || c == stop2)
+            {
+                break;
+            }
+            if (c == '%')
+            {
+                if (end - p < 3 || !IsXdigit(p[1]) || !IsXdigit(p[2]))
+                {
+                    return false;
+                }
+                p += 3;
+                continue;
+            }
+            if (!(s_uri_chars[(uint8_t)c] & mask))
+            {
+                return false;
+            }
+            ++p;
+        }
+        return true;
+    }
+
+    //校验整段字符
+    static bool CheckComponent(std::string_view str, uint8_t mask)
+    {
+        const char *p = str.data();
+        return ScanComponent(p, p + str.size(), mask, '\0', '\0') && p == str.data() + str.size();
+    }
+
+    UriView::UriView()
+        : m_port(0), m_hasAuthority(false)
+    {
+    }
+
+    bool UriView::parse(std::string_view uri)
+    {
+        *this = UriView();
+        m_uri = uri;
+        const char *p = uri.data();
+        const char *end = p + uri.size();
+
+        //scheme = ALPHA *( ALPHA / DIGIT / "+" / "-" / "." ) ":"
+        if (p < end && IsAlpha(*p))
+        {
+            const char *s = p + 1;
+            while (s < end && (s_uri_chars[(uint8_t)*s] & URI_SCHEME))
+            {
+                ++s;
+            }
+            if (s < end && *s == ':')
+            {
+                m_scheme = std::string_view(p, s - p);
+                p = s + 1;
+            }
+        }
+
+        //"//" authority
+        if (end - p >= 2 && p[0] == '/' && p[1] == '/')
+        {
+            p += 2;
+            const char *s = p;
+            while (p < end && *p != '/' && *p != '?' && *p != '#')
+            {
+                ++p;
+            }
+            m_hasAuthority = true;
+            if (!parseAuthority(std::string_view(s, p - s)))
+            {
+                return false;
+            }
+        }
+
+        const char *s = p;
+        if (!ScanComponent(p, end, URI_PATH, '?', '#'))
+        {
+            return false;
+        }
+        m_path = std::string_view(s, p - s);
+        if (m_scheme.empty() && !m_hasAuthority)
+        {
+            //相对引用的第一段路径不能包含':', 否则会被当作scheme
+            size_t slash = m_path.find('/');
+            if (m_path.substr(0, slash).find(':') != std::string_view::npos)
+            {
+                return false;
+            }
+        }
+
+        if (p < end && *p == '?')
+        {
+            s = ++p;
+            if (!ScanComponent(p, end, URI_QUERY, '#', '#'))
+            {
+                return false;
+            }
+            m_query = std::string_view(s, p - s);
+        }
+
+        if (p < end && *p == '#')
+        {
+            s = ++p;
+            if (!ScanComponent(p, end, URI_QUERY, '\0', '\0') || p != end)
+            {
+                return false;
+            }
+            m_fragment = std::string_view(s, p - s);
+        }
+        return p == end;
+    }
+
+    bool UriView::parseAuthority(std::string_view authority)
+    {
+        size_t at = authority.rfind('@');
+        if (at != std::string_view::npos)
+        {
+            m_userinfo = authority.substr(0, at);
+            if (!CheckComponent(m_userinfo, URI_USERINFO))
+            {
+                return false;
+            }
+            authority.remove_prefix(at + 1);
+        }
+
+        std::string_view port;
+        if (!authority.empty() && authority[0] == '[')
+        {
+            size_t close = authority.find(']');
+            if (close == std::string_view::npos)
+            {
+                return false;
+            }
+            m_host = authority.substr(0, close + 1);
+            if (!CheckComponent(m_host.substr(1, m_host.size() - 2), URI_IPLIT))
+            {
+                return false;
+            }
+            std::string_view rest = authority.substr(close + 1);
+            if (!rest.empty())
+            {
+                if (rest[0] != ':')
+                {
+                    return false;
+                }
+                port = rest.substr(1);
+            }
+        }
+        else
+        {
+            size_t colon = authority.rfind(':');
+            if (colon != std::string_view::npos)
+            {
+                port = authority.substr(colon + 1);
+                authority = authority.substr(0, colon);
+            }
+            m_host = authority;
+            if (!CheckComponent(m_host, URI_HOST))
+            {
+                return false;
+            }
+        }
+
+        int32_t v = 0;
+        for (char c : port)
+        {
+            if (!IsDigit(c))
+            {
+                return false;
+            }
+            v = v * 10 + (c - '0');
+            if (v > 65535)
+            {
+                return false;
+            }
+        }
+        m_port = v;
+        return true;
+    }
+
+    std::string UriView::Decode(std::string_view str, bool space_as_plus)
+    {
+        std::string rt;
+        StringUtil::UrlDecodeAppend(rt, str, space_as_plus);
+        return rt;
+    }
+
+    bool UriView::findQueryParam(std::string_view name, std::string &value) const
+    {
+        for (auto &i : getQueryParams())
+        {
+            std::string_view key = i.key();
+            bool match = false;
+            if (key.find_first_of("%+") == std::string_view::npos)
+            {
+                match = key == name;
+            }
+            else
+            {
+                match = i.decodedKey() == name;
+            }
+            if (match)
+            {
+                value = i.decodedValue();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    UriView::QueryIterator::QueryIterator(std::string_view query)
+        : m_rest(query), m_end(false)
+    {
+        next();
+    }
+
+    void UriView::QueryIterator::next()
+    {
+        while (!m_rest.empty())
+        {
+            size_t amp = m_rest.find('&');
+            m_item = m_rest.substr(0, amp);
+            m_rest = amp == std::string_view::npos ? std::string_view() : m_rest.substr(amp + 1);
+            if (m_item.empty())
+            {
+                continue;
+            }
+            size_t eq = m_item.find('=');
+            m_key = m_item.substr(0, eq);
+            m_value = eq == std::string_view::npos ? std::string_view() : m_item.substr(eq + 1);
+            return;
+        }
+        m_end = true;
+        m_item = m_key = m_value = std::string_view();
+    }
+
+    UriView::QueryIterator &UriView::QueryIterator::operator++()
+    {
+        next();
+        return *this;
+    }
+
+    std::string UriView::QueryIterator::decodedKey() const
+    {
+        return Decode(m_key, true);
+    }
+
+    std::string UriView::QueryIterator::decodedValue() const
+    {
+        return Decode(m_value, true);
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,165 @@
+//零分配URI解析
+#ifndef __SYLAR_URI_VIEW_H__
+#define __SYLAR_URI_VIEW_H__
+
+#include <string>
+#include <string_view>
+#include <stdint.h>
+
+namespace sylar
+{
+
+    /**
+     * @brief URI视图
+     * @details 按RFC 3986解析URI引用, 各部分均为原始字符串上的string_view切片,
+     *          解析过程不分配内存; 百分号编码在调用decode系列函数时才解码。
+     *          视图不持有原始字符串, 调用者需保证其生命周期
+     *
+     *     foo://user@sylar.com:8042/over/there?name=ferret#nose
+     *       \_/   \______________/\_________/ \_________/ \__/
+     *        |           |            |            |        |
+     *     scheme     authority       path        query   fragment
+     */
+    class UriView
+    {
+    public:
+        /**
+         * @brief 查询参数迭代器
+         * @details 按'&'切分查询串, 每项按第一个'='切分为key/value,
+         *          取到的key/value均为未解码的切片
+         */
+        class QueryIterator
+        {
+        public:
+            //构造结束迭代器
+            QueryIterator() {}
+
+            //从查询串构造迭代器
+            explicit QueryIterator(std::string_view query);
+
+            //原始key
+            std::string_view key() const { return m_key; }
+
+            //原始value
+            std::string_view value() const { return m_value; }
+
+            //解码后的key
+            std::string decodedKey() const;
+
+            //解码后的value
+            std::string decodedValue() const;
+
+            QueryIterator &operator++();
+
+            const QueryIterator &operator*() const { return *this; }
+
+            bool operator==(const QueryIterator &o) const { return m_end == o.m_end && (m_end || m_item.data() == o.m_item.data()); }
+            bool operator!=(const QueryIterator &o) const { return !(*this == o); }
+
+        private:
+            //解析下一个非空参数
+            void next();
+
+        private:
+            std::string_view m_rest;  /// 尚未解析的部分
+            std::string_view m_item;  /// 当前参数
+            std::string_view m_key;   /// 当前key
+            std::string_view m_value; /// 当前value
+            bool m_end = true;        /// 是否已结束
+        };
+
+        //查询参数区间, 用于range-for
+        class QueryRange
+        {
+        public:
+            explicit QueryRange(std::string_view query)
+                : m_query(query)
+            {
+            }
+            QueryIterator begin() const { return QueryIterator(m_query); }
+            QueryIterator end() const { return QueryIterator(); }
+
+        private:
+            std::string_view m_query;
+        };
+
+    public:
+        //构造函数
+        UriView();
+
+        /**
+         * @brief 解析URI引用(绝对URI或相对引用)
+         * @param[in] uri 原始字符串
+         * @return 语法正确返回true
+         */
+        bool parse(std::string_view uri);
+
+        //返回原始字符串
+        std::string_view getUri() const { return m_uri; }
+
+        //返回scheme
+        std::string_view getScheme() const { return m_scheme; }
+
+        //返回用户信息
+        std::string_view getUserinfo() const { return m_userinfo; }
+
+        //返回host(IPv6字面量包含方括号)
+        std::string_view getHost() const { return m_host; }
+
+        //返回端口, 未指定时返回0
+        int32_t getPort() const { return m_port; }
+
+        //返回路径
+        std::string_view getPath() const { return m_path; }
+
+        //返回查询条件
+        std::string_view getQuery() const { return m_query; }
+
+        //返回fragment
+        std::string_view getFragment() const { return m_fragment; }
+
+        //是否包含authority("//"开头)
+        bool hasAuthority() const { return m_hasAuthority; }
+
+        //返回查询参数区间
+        QueryRange getQueryParams() const { return QueryRange(m_query); }
+
+        /**
+         * @brief 查找查询参数(按解码后的key比较)
+         * @param[in] name 参数名
+         * @param[out] value 解码后的参数值
+         * @return 找到返回true
+         */
+        bool findQueryParam(std::string_view name, std::string &value) const;
+
+        //返回解码后的路径
+        std::string getDecodedPath() const { return Decode(m_path, false); }
+
+        //返回解码后的fragment
+        std::string getDecodedFragment() const { return Decode(m_fragment, false); }
+
+        /**
+         * @brief 百分号解码
+         * @param[in] space_as_plus 是否把'+'解码为空格(查询参数使用)
+         */
+        static std::string Decode(std::string_view str, bool space_as_plus);
+
+    private:
+        //解析authority部分
+        bool parseAuthority(std::string_view authority);
+
+    private:
+        std::string_view m_uri;
+        std::string_view m_scheme;
+        std::string_view m_userinfo;
+        std::string_view m_host;
+        std::string_view m_path;
+        std::string_view m_query;
+        std::string_view m_fragment;
+        int32_t m_port;
+        bool m_hasAuthority;
+    };
+
+}
+
+#endif
\ No newline at end of file
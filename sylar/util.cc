@@ -0,0 +1,422 @@
+#include "sylar/util.h"
+#include "sylar/util/string_simd.h"
+#include "sylar/util/yaml_json.h"
+#include "sylar/util/pb_json.h"
+#include "sylar/util/stack_trace.h"
+#include "sylar/util/time_formatter.h"
+#include "sylar/util/number_parser.h"
+#include "sylar/util/dir_walker.h"
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/time.h>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <unordered_map>
+
+namespace sylar {
+
+void BackTrace(std::vector<std::string>& bt, int size, int skip) {
+    StackTrace st;
+    st.capture(skip, false, size);
+    std::vector<StackFrame> frames;
+    SymbolizerMgr::GetInstance()->symbolize(st, frames);
+    for(auto& i : frames) {
+        bt.push_back(i.toString());
+    }
+}
+
+std::string BacktraceToString(int size, int skip, const std::string& prefix) {
+    std::vector<std::string> bt;
+    BackTrace(bt, size, skip);
+    std::stringstream ss;
+    for(size_t i = 0; i < bt.size(); ++i) {
+        ss << prefix << bt[i] << std::endl;
+    }
+    return ss.str();
+}
+
+uint64_t GetCurrentMS() {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000ul + tv.tv_usec / 1000;
+}
+
+uint64_t GetCurrentUS() {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return tv.tv_sec * 1000 * 1000ul + tv.tv_usec;
+}
+
+//每个线程按格式缓存TimeFormatter, 避免每次重新解析格式
+static const TimeFormatter& GetTimeFormatter(const char* format) {
+    static const char* s_default = "%Y-%m-%d %H:%M:%S";
+    static const TimeFormatter s_default_formatter(s_default);
+    if(format == s_default || strcmp(format, s_default) == 0) {
+        return s_default_formatter;
+    }
+    static thread_local std::unordered_map<std::string_view, TimeFormatter::ptr> t_formatters;
+    auto it = t_formatters.find(format);
+    if(it != t_formatters.end()) {
+        return *it->second;
+    }
+    if(t_formatters.size() >= 32) {
+        t_formatters.clear();
+    }
+    TimeFormatter::ptr f(new TimeFormatter(format));
+    t_formatters[f->getFormat()] = f;
+    return *f;
+}
+
+std::string Time2Str(time_t ts, const std::string& format) {
+    return GetTimeFormatter(format.c_str()).format(ts);
+}
+
+time_t Str2Time(const char* str, const char* format) {
+    time_t ts = 0;
+    if(!GetTimeFormatter(format).parse(str, ts)) {
+        return 0;
+    }
+    return ts;
+}
+
+SpeedLimit::SpeedLimit(uint64_t speed, SpeedLimit::ptr parent, uint64_t burst)
+    :m_bucket(new TokenBucket(speed, burst, parent ? parent->getBucket() : nullptr)) {
+}
+
+void SpeedLimit::add(uint64_t v) {
+    m_bucket->acquire(v);
+}
+
+//每次读写的块大小, 兼顾限速平滑度和系统调用次数
+static uint64_t SpeedChunkSize(uint64_t speed) {
+    return std::max(speed / 100, (uint64_t)1024 * 64);
+}
+
+bool ReadFixFromStreamWithSpeed(std::istream& is, char* data,
+                    const uint64_t& size, const uint64_t& speed,
+                    SpeedLimit::ptr limit) {
+    if(speed != (uint64_t)-1) {
+        limit.reset(new SpeedLimit(speed, limit));
+    }
+    uint64_t per = limit ? SpeedChunkSize(speed == (uint64_t)-1 ? 0 : speed) : size;
+    uint64_t offset = 0;
+    while(is && (offset < size)) {
+        uint64_t s = std::min(size - offset, per);
+        if(limit) {
+            limit->add(s);
+        }
+        if(!ReadFixFromStream(is, data + offset, s)) {
+            return false;
+        }
+        offset += s;
+    }
+    return offset == size;
+}
+
+bool WriteFixToStreamWithSpeed(std::ostream& os, const char* data,
+                            const uint64_t& size, const uint64_t& speed,
+                            SpeedLimit::ptr limit) {
+    if(speed != (uint64_t)-1) {
+        limit.reset(new SpeedLimit(speed, limit));
+    }
+    uint64_t per = limit ? SpeedChunkSize(speed == (uint64_t)-1 ? 0 : speed) : size;
+    uint64_t offset = 0;
+    while(os && (offset < size)) {
+        uint64_t s = std::min(size - offset, per);
+        if(limit) {
+            limit->add(s);
+        }
+        os.write(data + offset, s);
+        offset += s;
+    }
+    return os && offset == size;
+}
+
+std::string ToUpper(const std::string& name) {
+    std::string rt = name;
+    ToUpperInPlace(rt);
+    return rt;
+}
+
+std::string ToLower(const std::string& name) {
+    std::string rt = name;
+    ToLowerInPlace(rt);
+    return rt;
+}
+
+void ToUpperInPlace(std::string& name) {
+    if(!name.empty()) {
+        StringSimd::ToUpper(&name[0], name.size());
+    }
+}
+
+void ToLowerInPlace(std::string& name) {
+    if(!name.empty()) {
+        StringSimd::ToLower(&name[0], name.size());
+    }
+}
+
+static const char s_xdigit_chars[] = "0123456789ABCDEF";
+
+static int XdigitValue(char c) {
+    if(c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    c |= 0x20;
+    if(c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+void StringUtil::UrlEncodeAppend(std::string& out, std::string_view str, bool space_as_plus) {
+    const char* data = str.data();
+    size_t len = str.size();
+    size_t pos = 0;
+    while(pos < len) {
+        size_t n = StringSimd::FindUrlEscape(data + pos, len - pos);
+        out.append(data + pos, n);
+        pos += n;
+        if(pos >= len) {
+            break;
+        }
+        uint8_t c = data[pos++];
+        if(c == ' ' && space_as_plus) {
+            out.push_back('+');
+        } else {
+            char tmp[3] = {'%', s_xdigit_chars[c >> 4], s_xdigit_chars[c & 0xf]};
+            out.append(tmp, 3);
+        }
+    }
+}
+
+std::string StringUtil::UrlEncode(const std::string& str, bool space_as_plus) {
+    size_t n = StringSimd::FindUrlEscape(str.data(), str.size());
+    if(n == str.size()) {
+        return str;
+    }
+    std::string ss;
+    ss.reserve(str.size() + (str.size() - n) * 2);
+    UrlEncodeAppend(ss, str, space_as_plus);
+    return ss;
+}
+
+size_t StringUtil::UrlDecodeInPlace(char* data, size_t len, bool space_as_plus) {
+    size_t r = StringSimd::FindUrlUnescape(data, len, space_as_plus);
+    size_t w = r;
+    while(r < len) {
+        char c = data[r];
+        if(c == '+' && space_as_plus) {
+            data[w++] = ' ';
+            ++r;
+        } else if(c == '%' && r + 2 < len
+                && XdigitValue(data[r + 1]) >= 0 && XdigitValue(data[r + 2]) >= 0) {
+            data[w++] = (char)((XdigitValue(data[r + 1]) << 4) | XdigitValue(data[r + 2]));
+            r += 3;
+        } else {
+            data[w++] = c;
+            ++r;
+        }
+        size_t n = StringSimd::FindUrlUnescape(data + r, len - r, space_as_plus);
+        if(n) {
+            memmove(data + w, data + r, n);
+            w += n;
+            r += n;
+        }
+    }
+    return w;
+}
+
+void StringUtil::UrlDecodeInPlace(std::string& str, bool space_as_plus) {
+    if(!str.empty()) {
+        str.resize(UrlDecodeInPlace(&str[0], str.size(), space_as_plus));
+    }
+}
+
+void StringUtil::UrlDecodeAppend(std::string& out, std::string_view str, bool space_as_plus) {
+    size_t old = out.size();
+    out.append(str.data(), str.size());
+    out.resize(old + UrlDecodeInPlace(&out[0] + old, str.size(), space_as_plus));
+}
+
+std::string StringUtil::UrlDecode(const std::string& str, bool space_as_plus) {
+    if(StringSimd::FindUrlUnescape(str.data(), str.size(), space_as_plus) == str.size()) {
+        return str;
+    }
+    std::string rt = str;
+    UrlDecodeInPlace(rt, space_as_plus);
+    return rt;
+}
+
+std::string_view StringUtil::TrimLeftView(std::string_view str, std::string_view delimit) {
+    size_t begin = StringSimd::FindFirstNotOf(str.data(), str.size(), delimit.data(), delimit.size());
+    return str.substr(begin);
+}
+
+std::string_view StringUtil::TrimRightView(std::string_view str, std::string_view delimit) {
+    size_t end = StringSimd::FindLastNotOf(str.data(), str.size(), delimit.data(), delimit.size());
+    return str.substr(0, end);
+}
+
+std::string_view StringUtil::TrimView(std::string_view str, std::string_view delimit) {
+    return TrimRightView(TrimLeftView(str, delimit), delimit);
+}
+
+std::string StringUtil::Trim(const std::string& str, const std::string& delimit) {
+    return std::string(TrimView(str, delimit));
+}
+
+std::string StringUtil::TrimLeft(const std::string& str, const std::string& delimit) {
+    return std::string(TrimLeftView(str, delimit));
+}
+
+std::string StringUtil::TrimRight(const std::string& str, const std::string& delimit) {
+    return std::string(TrimRightView(str, delimit));
+}
+
+int8_t TypeUtil::ToChar(const std::string& str) {
+    if(str.empty()) {
+        return 0;
+    }
+    return *str.begin();
+}
+
+int64_t TypeUtil::Atoi(const std::string& str) {
+    return Atoi(str.c_str());
+}
+
+double TypeUtil::Atof(const std::string& str) {
+    return Atof(str.c_str());
+}
+
+int8_t TypeUtil::ToChar(const char* str) {
+    if(str == nullptr) {
+        return 0;
+    }
+    return str[0];
+}
+
+//整个字符串是合法数值时走快速路径, 否则(前导空白/多余字符/溢出等)保持strtoull/atof的语义
+int64_t TypeUtil::Atoi(const char* str) {
+    if(str == nullptr) {
+        return 0;
+    }
+    int64_t v = 0;
+    if(NumberParser::ParseInt(str, v)) {
+        return v;
+    }
+    return strtoull(str, nullptr, 10);
+}
+
+double TypeUtil::Atof(const char* str) {
+    if(str == nullptr) {
+        return 0;
+    }
+    double v = 0;
+    if(NumberParser::ParseDouble(str, v)) {
+        return v;
+    }
+    return atof(str);
+}
+
+bool YamlToJson(const YAML::Node& ynode, Json::Value& jnode) {
+    try {
+        if(ynode.IsScalar()) {
+            Json::Value v(ynode.Scalar());
+            jnode.swapPayload(v);
+            return true;
+        }
+        if(ynode.IsSequence()) {
+            for(size_t i = 0; i < ynode.size(); ++i) {
+                Json::Value v;
+                if(YamlToJson(ynode[i], v)) {
+                    jnode.append(v);
+                } else {
+                    return false;
+                }
+            }
+        } else if(ynode.IsMap()) {
+            for(auto it = ynode.begin();
+                    it != ynode.end(); ++it) {
+                Json::Value v;
+                if(YamlToJson(it->second, v)) {
+                    jnode[it->first.Scalar()] = v;
+                } else {
+                    return false;
+                }
+            }
+        }
+    } catch(...) {
+        return false;
+    }
+    return true;
+}
+
+bool JsonToYaml(const Json::Value& jnode, YAML::Node& ynode) {
+    try {
+        if(jnode.isArray()) {
+            for(int i = 0; i < (int)jnode.size(); ++i) {
+                YAML::Node n;
+                if(JsonToYaml(jnode[i], n)) {
+                    ynode.push_back(n);
+                } else {
+                    return false;
+                }
+            }
+        } else if(jnode.isObject()) {
+            for(auto it = jnode.begin();
+                    it != jnode.end();
+                    ++it) {
+                YAML::Node n;
+                if(JsonToYaml(*it, n)) {
+                    ynode[it.name()] = n;
+                } else {
+                    return false;
+                }
+            }
+        } else {
+            ynode = jnode.asString();
+        }
+    } catch(...) {
+        return false;
+    }
+    return true;
+}
+
+bool YamlToJson(std::istream& in, std::ostream& out) {
+    return YamlJsonConverter::YamlToJson(in, out);
+}
+
+bool JsonToYaml(std::istream& in, std::ostream& out) {
+    return YamlJsonConverter::JsonToYaml(in, out);
+}
+
+std::string PBToJsonString(const google::protobuf::Message& message) {
+    return PBJsonConverter::ToJson(message);
+}
+
+bool JsonStringToPB(const std::string& json, google::protobuf::Message& message) {
+    return PBJsonConverter::FromJson(json, message);
+}
+
+
+void FSUtil::ListAllFile(std::vector<std::string>& files
+                            ,const std::string& path
+                            ,const std::string& subfix
+                            ,int threads) {
+    size_t begin = files.size();
+    sylar::Mutex mutex;
+    DirWalker::Options opt;
+    opt.threads = threads;
+    DirWalker::WalkFiles(path, subfix, [&files, &mutex](const std::string& file) {
+        sylar::Mutex::Lock lock(mutex);
+        files.push_back(file);
+        return true;
+    }, opt);
+    //目录项顺序和多线程交付顺序都不确定, 排序后保证加载顺序稳定
+    std::sort(files.begin() + begin, files.end());
+}
+
+}
\ No newline at end of file
@@ -10,6 +10,11 @@
 #include <stdint.h>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <charconv>
+#include <iterator>
+#include <sstream>
+#include <type_traits>
 #include <iomanip>
 #include <json/json.h>
 #include <yaml-cpp/yaml.h>
@@ -19,6 +24,13 @@
 #include "sylar/util/hash_util.h"
 #include "sylar/util/json_util.h"
 #include "sylar/util/crypto_util.h"
+#include "sylar/util/demangle.h"
+#include "sylar/util/number_parser.h"
+#include "sylar/util/search_util.h"
+#include "sylar/util/span.h"
+#include "sylar/atomic.h"
+#include "sylar/token_bucket.h"
+#include "sylar/io_util.h"
 
 namespace sylar
 {
@@ -29,6 +41,8 @@ namespace sylar
     uint32_t GetFiberId();
 
     /// @brief 获取当前的调用栈
+    /// @details 采集后立即符号化, 只适合低频调用; 高频采样用StackTrace::capture保存原始地址,
+    ///          需要时再交给SymbolizerMgr
     /// @param bt 保存调用栈
     /// @param size 最多返回层数
     /// @param skip 跳过栈顶的层数
@@ -53,13 +67,22 @@ namespace sylar
 
     std::string ToUpper(const std::string &name);
     std::string ToLower(const std::string &name);
+    //原地转换大小写(只处理ASCII), 不分配内存
+    void ToUpperInPlace(std::string &name);
+    void ToLowerInPlace(std::string &name);
     std::string Time2Str(time_t ts = time(0), const std::string &format = "%Y-%m-%d %H:%M:%S");
     time_t Str2Time(const char *str, const char *format = "%Y-%m-%d %H:%M:%S");
 
     class FSUtil
     {
     public:
-        static void ListAllFile(std::vector<std::string> &__cpp_lib_files, const std::string &path, const std::string &subfix);
+        /**
+         * @brief 递归列出目录下以subfix结尾的普通文件
+         * @param[in] threads 遍历线程数(见DirWalker), 默认1在调用线程中遍历, 不创建线程;
+         *                    配置重载等小目录用默认值, 很大的目录树再传0(CPU核数)或更大的值
+         * @details 结果按路径排序
+         */
+        static void ListAllFile(std::vector<std::string> &files, const std::string &path, const std::string &subfix, int threads = 1);
         static bool Mkdir(const std::string &dirname);
         static bool IsRuningPidfile(const std::string &pidfile);
         static bool Rm(const std::string &path);
@@ -79,13 +102,11 @@ namespace sylar
         if(it == m.end()){
             return def;
         }
-        try
-        {
-            return boost::lexical_cast<V>(it->second);
+        V v;
+        if(!TryLexicalCast(it->second, v)) {
+            return def;
         }
-        catch(...)
-        {       }
-        return def;
+        return v;
     }
 
     template<class V, class Map, class K>
@@ -94,12 +115,7 @@ bool CheckGetParamValue(const Map& m, const K& k, V& v) {
     if(it == m.end()) {
         return false;
     }
-    try {
-        v = boost::lexical_cast<V>(it->second);
-        return true;
-    } catch (...) {
-    }
-    return false;
+    return TryLexicalCast(it->second, v);
 }
 
 class TypeUtil {
@@ -113,79 +129,6 @@ public:
 };
 
 
-class Atomic {
-public:
-    template<class T, class S = T>
-    static T addFetch(volatile T& t, S v = 1) {
-        return __sync_add_and_fetch(&t, (T)v);
-    }
-
-    template<class T, class S = T>
-    static T subFetch(volatile T& t, S v = 1) {
-        return __sync_sub_and_fetch(&t, (T)v);
-    }
-
-    template<class T, class S>
-    static T orFetch(volatile T& t, S v) {
-        return __sync_or_and_fetch(&t, (T)v);
-    }
-
-    template<class T, class S>
-    static T andFetch(volatile T& t, S v) {
-        return __sync_and_and_fetch(&t, (T)v);
-    }
-
-    template<class T, class S>
-    static T xorFetch(volatile T& t, S v) {
-        return __sync_xor_and_fetch(&t, (T)v);
-    }
-
-    template<class T, class S>
-    static T nandFetch(volatile T& t, S v) {
-        return __sync_nand_and_fetch(&t, (T)v);
-    }
-
-    template<class T, class S>
-    static T fetchAdd(volatile T& t, S v = 1) {
-        return __sync_fetch_and_add(&t, (T)v);
-    }
-
-    template<class T, class S>
-    static T fetchSub(volatile T& t, S v = 1) {
-        return __sync_fetch_and_sub(&t, (T)v);
-    }
-
-    template<class T, class S>
-    static T fetchOr(volatile T& t, S v) {
-        return __sync_fetch_and_or(&t, (T)v);
-    }
-
-    template<class T, class S>
-    static T fetchAnd(volatile T& t, S v) {
-        return __sync_fetch_and_and(&t, (T)v);
-    }
-
-    template<class T, class S>
-    static T fetchXor(volatile T& t, S v) {
-        return __sync_fetch_and_xor(&t, (T)v);
-    }
-
-    template<class T, class S>
-    static T fetchNand(volatile T& t, S v) {
-        return __sync_fetch_and_nand(&t, (T)v);
-    }
-
-    template<class T, class S>
-    static T compareAndSwap(volatile T& t, S old_val, S new_val) {
-        return __sync_val_compare_and_swap(&t, (T)old_val, (T)new_val);
-    }
-
-    template<class T, class S>
-    static bool compareAndSwapBool(volatile T& t, S old_val, S new_val) {
-        return __sync_bool_compare_and_swap(&t, (T)old_val, (T)new_val);
-    }
-};
-
 template<class T>
 void nop(T*) {}
 
@@ -264,10 +207,31 @@ public:
     static std::string UrlEncode(const std::string& str, bool space_as_plus = true);
     static std::string UrlDecode(const std::string& str, bool space_as_plus = true);
 
+    /**
+     * @brief URL编码, 结果追加到out
+     * @details 用SIMD整块跳过不需要编码的字符, 只对需要编码的字符逐个处理
+     */
+    static void UrlEncodeAppend(std::string& out, std::string_view str, bool space_as_plus = true);
+
+    //URL解码, 结果追加到out
+    static void UrlDecodeAppend(std::string& out, std::string_view str, bool space_as_plus = true);
+
+    /**
+     * @brief 原地URL解码
+     * @return 解码后的长度(解码结果不会比原文长)
+     */
+    static size_t UrlDecodeInPlace(char* data, size_t len, bool space_as_plus = true);
+    static void UrlDecodeInPlace(std::string& str, bool space_as_plus = true);
+
     static std::string Trim(const std::string& str, const std::string& delimit = " \t\r\n");
     static std::string TrimLeft(const std::string& str, const std::string& delimit = " \t\r\n");
     static std::string TrimRight(const std::string& str, const std::string& delimit = " \t\r\n");
 
+    //返回去掉首尾分隔符后的视图, 不分配内存; delimit不超过4个字符时使用SIMD
+    static std::string_view TrimView(std::string_view str, std::string_view delimit = " \t\r\n");
+    static std::string_view TrimLeftView(std::string_view str, std::string_view delimit = " \t\r\n");
+    static std::string_view TrimRightView(std::string_view str, std::string_view delimit = " \t\r\n");
+
 
     static std::string WStringToString(const std::wstring& ws);
     static std::wstring StringToWString(const std::string& s);
@@ -279,30 +243,107 @@ std::string GetIPv4();
 
 bool YamlToJson(const YAML::Node& ynode, Json::Value& jnode);
 bool JsonToYaml(const Json::Value& jnode, YAML::Node& ynode);
+//流式转换, 不构造中间树, 失败时out中可能有部分输出, 见YamlJsonConverter
+bool YamlToJson(std::istream& in, std::ostream& out);
+bool JsonToYaml(std::istream& in, std::ostream& out);
 
+//abi::__cxa_demangle格式的类型名, 经Demangler缓存, 每个类型只反修饰一次
 template<class T>
-const char* TypeToName() {
-    static const char* s_name = abi::__cxa_demangle(typeid(T).name(), nullptr, nullptr, nullptr);
+const char* DemangledTypeName() {
+    static const char* s_name = Demangler::Demangle(typeid(T).name());
     return s_name;
 }
 
+/**
+ * @brief 类型名, 用于日志
+ * @details gcc/clang下在编译期从__PRETTY_FUNCTION__生成, 运行时没有开销。
+ *          格式与DemangledTypeName不同: 省略默认模板参数, 且随编译器变化,
+ *          如std::map<std::string, std::vector<int>>在gcc下为
+ *          "std::map<std::__cxx11::basic_string<char>, std::vector<int> >"。
+ *          需要保存、比较或对外输出的类型名用DemangledTypeName
+ */
+#if defined(__clang__) || defined(__GNUC__)
+template<class T>
+constexpr const char* TypeToName() {
+    return detail::TypeNameHolder<T>::value.data();
+}
+#else
+template<class T>
+const char* TypeToName() {
+    return DemangledTypeName<T>();
+}
+#endif
+
+//见PBJsonConverter, 按消息类型缓存转换计划, 直接写出JSON文本
 std::string PBToJsonString(const google::protobuf::Message& message);
+bool JsonStringToPB(const std::string& json, google::protobuf::Message& message);
 
+/**
+ * @brief 把[begin, end)的元素用tag连接后追加到out
+ * @details 元素可以转换为std::string_view时先算出总长度, out只扩容一次;
+ *          整数用to_chars直接写入out; 其他类型经operator<<输出
+ */
 template<class Iter>
-std::string Join(Iter begin, Iter end, const std::string& tag) {
-    std::stringstream ss;
-    for(Iter it = begin; it != end; ++it) {
-        if(it != begin) {
-            ss << tag;
+void JoinAppend(std::string& out, Iter begin, Iter end, std::string_view tag) {
+    typedef typename std::decay<decltype(*begin)>::type value_type;
+    typedef typename std::iterator_traits<Iter>::iterator_category category;
+    if constexpr (std::is_convertible<const value_type&, std::string_view>::value) {
+        if constexpr (std::is_base_of<std::forward_iterator_tag, category>::value) {
+            size_t len = 0;
+            size_t count = 0;
+            for(Iter it = begin; it != end; ++it) {
+                len += std::string_view(*it).size();
+                ++count;
+            }
+            if(count) {
+                out.reserve(out.size() + len + tag.size() * (count - 1));
+            }
+        }
+        for(Iter it = begin; it != end; ++it) {
+            if(it != begin) {
+                out.append(tag);
+            }
+            out.append(std::string_view(*it));
+        }
+    } else if constexpr (std::is_integral<value_type>::value
+            && !std::is_same<value_type, bool>::value
+            && !std::is_same<value_type, char>::value
+            && !std::is_same<value_type, signed char>::value
+            && !std::is_same<value_type, unsigned char>::value
+            && !std::is_same<value_type, wchar_t>::value
+            && !std::is_same<value_type, char16_t>::value
+            && !std::is_same<value_type, char32_t>::value) {
+        char buf[24];
+        for(Iter it = begin; it != end; ++it) {
+            if(it != begin) {
+                out.append(tag);
+            }
+            auto r = std::to_chars(buf, buf + sizeof(buf), *it);
+            out.append(buf, r.ptr - buf);
+        }
+    } else {
+        std::ostringstream ss;
+        for(Iter it = begin; it != end; ++it) {
+            if(it != begin) {
+                ss << tag;
+            }
+            ss << *it;
         }
-        ss << *it;
+        out.append(ss.str());
     }
-    return ss.str();
+}
+
+template<class Iter>
+std::string Join(Iter begin, Iter end, std::string_view tag) {
+    std::string rt;
+    JoinAppend(rt, begin, end, tag);
+    return rt;
 }
 
 //[begin, end)
 //if rt > 0, 存在,返回对应index
 //   rt < 0, 不存在,返回对于应该存在的-(index + 1)
+//同样约定的BranchlessSearch/LinearSearch/EytzingerSearch见search_util.h
 template<class T>
 int BinarySearch(const T* arr, int length, const T& v) {
     int m = 0;
@@ -337,7 +378,10 @@ bool ReadFromStream(std::istream& is, T& v) {
 
 template<class T>
 bool ReadFromStream(std::istream& is, std::vector<T>& v) {
-    return ReadFixFromStream(is, (char*)&v[0], sizeof(T) * v.size());
+    if(v.empty()) {
+        return (bool)is;
+    }
+    return ReadFixFromStream(is, (char*)v.data(), sizeof(T) * v.size());
 }
 
 template<class T>
@@ -354,62 +398,77 @@ bool WriteToStream(std::ostream& os, const std::vector<T>& v) {
     if(!os) {
         return false;
     }
-    os.write((const char*)&v[0], sizeof(T) * v.size());
+    if(!v.empty()) {
+        os.write((const char*)v.data(), sizeof(T) * v.size());
+    }
     return (bool)os;
 }
 
+//限速器, 基于无锁令牌桶, 可以多线程/多协程共享
 class SpeedLimit {
 public:
     typedef std::shared_ptr<SpeedLimit> ptr;
-    SpeedLimit(uint32_t speed);
-    void add(uint32_t v);
+    /**
+     * @brief 构造函数
+     * @param[in] speed 每秒允许的字节数
+     * @param[in] parent 上级限速器(如全局限速), 同时受其限制
+     * @param[in] burst 允许的突发字节数, 0表示等于speed
+     */
+    SpeedLimit(uint64_t speed, SpeedLimit::ptr parent = nullptr, uint64_t burst = 0);
+    //计入v字节, 超速时等待(协程中挂起协程而不是阻塞线程)
+    void add(uint64_t v);
+    //返回令牌桶
+    TokenBucket::ptr getBucket() const { return m_bucket;}
 private:
-    uint32_t m_speed;
-    float m_countPerMS;
-
-    uint32_t m_curCount;
-    uint32_t m_curSec;
+    TokenBucket::ptr m_bucket;
 };
 
+//speed为每秒字节数, -1表示不限速; limit不为空时额外受其限制(分层限速), 以下*WithSpeed同
 bool ReadFixFromStreamWithSpeed(std::istream& is, char* data,
-                    const uint64_t& size, const uint64_t& speed = -1);
+                    const uint64_t& size, const uint64_t& speed = -1,
+                    SpeedLimit::ptr limit = nullptr);
 
 bool WriteFixToStreamWithSpeed(std::ostream& os, const char* data,
-                            const uint64_t& size, const uint64_t& speed = -1);
+                            const uint64_t& size, const uint64_t& speed = -1,
+                            SpeedLimit::ptr limit = nullptr);
 
 template<class T>
 bool WriteToStreamWithSpeed(std::ostream& os, const T& v,
-                            const uint64_t& speed = -1) {
+                            const uint64_t& speed = -1,
+                            SpeedLimit::ptr limit = nullptr) {
     if(os) {
-        return WriteFixToStreamWithSpeed(os, (const char*)&v, sizeof(T), speed);
+        return WriteFixToStreamWithSpeed(os, (const char*)&v, sizeof(T), speed, limit);
     }
     return false;
 }
 
-emplate<class T>
+template<class T>
 bool WriteToStreamWithSpeed(std::ostream& os, const std::vector<T>& v,
                             const uint64_t& speed = -1,
-                            const uint64_t& min_duration_ms = 10) {
+                            const uint64_t& min_duration_ms = 10,
+                            SpeedLimit::ptr limit = nullptr) {
     if(os) {
-        return WriteFixToStreamWithSpeed(os, (const char*)&v[0], sizeof(T) * v.size(), speed);
+        return WriteFixToStreamWithSpeed(os, (const char*)v.data(), sizeof(T) * v.size(), speed, limit);
     }
     return false;
 }
 
 template<class T>
-bool ReadFromStreamWithSpeed(std::istream& is, const std::vector<T>& v,
-                            const uint64_t& speed = -1) {
+bool ReadFromStreamWithSpeed(std::istream& is, std::vector<T>& v,
+                            const uint64_t& speed = -1,
+                            SpeedLimit::ptr limit = nullptr) {
     if(is) {
-        return ReadFixFromStreamWithSpeed(is, (char*)&v[0], sizeof(T) * v.size(), speed);
+        return ReadFixFromStreamWithSpeed(is, (char*)v.data(), sizeof(T) * v.size(), speed, limit);
     }
     return false;
 }
 
 template<class T>
-bool ReadFromStreamWithSpeed(std::istream& is, const T& v,
-                            const uint64_t& speed = -1) {
+bool ReadFromStreamWithSpeed(std::istream& is, T& v,
+                            const uint64_t& speed = -1,
+                            SpeedLimit::ptr limit = nullptr) {
     if(is) {
-        return ReadFixFromStreamWithSpeed(is, (char*)&v, sizeof(T), speed);
+        return ReadFixFromStreamWithSpeed(is, (char*)&v, sizeof(T), speed, limit);
     }
     return false;
 }
@@ -417,28 +476,13 @@ bool ReadFromStreamWithSpeed(std::istream& is, const T& v,
 std::string Format(const char* fmt, ...);
 std::string Formatv(const char* fmt, va_list ap);
 
+//复制切分, 不需要复制时用SliceView; size为0时整个src作为一块
 template<class T>
 void Slice(std::vector<std::vector<T> >& dst, const std::vector<T>& src, size_t size) {
-    size_t left = src.size();
-    size_t pos = 0;
-    while(left > size) {
-        std::vector<T> tmp;
-        tmp.reserve(size);
-        for(size_t i = 0; i < size; ++i) {
-            tmp.push_back(src[pos + i]);
-        }
-        pos += size;
-        left -= size;
-        dst.push_back(tmp);
-    }
-
-    if(left > 0) {
-        std::vector<T> tmp;
-        tmp.reserve(left);
-        for(size_t i = 0; i < left; ++i) {
-            tmp.push_back(src[pos + i]);
-        }
-        dst.push_back(tmp);
+    auto views = SliceView(src, size);
+    dst.reserve(dst.size() + views.size());
+    for(auto& i : views) {
+        dst.emplace_back(i.begin(), i.end());
     }
 }
 
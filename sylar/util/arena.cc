@@ -0,0 +1,128 @@
+#include "sylar/util/arena.h"
+#include "sylar/fiber.h"
+#include <stdlib.h>
+#include <algorithm>
+
+namespace sylar
+{
+
+    //不在协程中时的当前Arena
+    static thread_local Arena *t_arena = nullptr;
+
+    void *ArenaResource::do_allocate(size_t bytes, size_t alignment)
+    {
+        return m_arena->allocate(bytes, alignment);
+    }
+
+    Arena::Arena(size_t block_size)
+        : m_blockSize(std::max(block_size, (size_t)256)), m_resource(this)
+    {
+    }
+
+    Arena::~Arena()
+    {
+        runCleanups();
+        for (Block *b : {m_head, m_large})
+        {
+            while (b)
+            {
+                Block *next = b->next;
+                free(b);
+                b = next;
+            }
+        }
+    }
+
+    Arena::Block *Arena::newBlock(size_t size)
+    {
+        Block *b = (Block *)malloc(sizeof(Block) + size);
+        if (!b)
+        {
+            throw std::bad_alloc();
+        }
+        b->size = size;
+        m_reserved += size;
+        ++m_blocks;
+        return b;
+    }
+
+    void *Arena::allocateSlow(size_t size, size_t align)
+    {
+        //大块单独申请, 不浪费当前块的剩余空间
+        if (size + align > m_blockSize / 4)
+        {
+            Block *b = newBlock(size + align);
+            b->next = m_large;
+            m_large = b;
+            uintptr_t begin = (uintptr_t)(b + 1);
+            ++m_allocs;
+            m_used += size;
+            return (void *)((begin + align - 1) & ~(uintptr_t)(align - 1));
+        }
+        Block *b = newBlock(m_blockSize);
+        b->next = m_head;
+        m_head = b;
+        m_ptr = (uintptr_t)(b + 1);
+        m_end = m_ptr + m_blockSize;
+        return allocate(size, align);
+    }
+
+    void Arena::runCleanups()
+    {
+        while (m_cleanups)
+        {
+            Cleanup *c = m_cleanups;
+            m_cleanups = c->next;
+            c->destroy(c->obj);
+        }
+    }
+
+    void Arena::reset()
+    {
+        runCleanups();
+        while (m_large)
+        {
+            Block *next = m_large->next;
+            m_reserved -= m_large->size;
+            --m_blocks;
+            free(m_large);
+            m_large = next;
+        }
+        //保留最早申请的块
+        while (m_head && m_head->next)
+        {
+            Block *next = m_head->next;
+            m_reserved -= m_head->size;
+            --m_blocks;
+            free(m_head);
+            m_head = next;
+        }
+        if (m_head)
+        {
+            m_ptr = (uintptr_t)(m_head + 1);
+            m_end = m_ptr + m_head->size;
+        }
+        m_allocs = 0;
+        m_used = 0;
+    }
+
+    Arena *Arena::GetCurrent()
+    {
+        if (Fiber::GetFiberId() != 0)
+        {
+            return Fiber::GetThis()->getArena();
+        }
+        return t_arena;
+    }
+
+    void Arena::SetCurrent(Arena *arena)
+    {
+        if (Fiber::GetFiberId() != 0)
+        {
+            Fiber::GetThis()->setArena(arena);
+            return;
+        }
+        t_arena = arena;
+    }
+
+}
\ No newline at end of file
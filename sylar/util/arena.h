@@ -0,0 +1,189 @@
+#ifndef __SYLAR_UTIL_ARENA_H__
+#define __SYLAR_UTIL_ARENA_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include "sylar/noncopyable.h"
+
+namespace sylar
+{
+
+    class Arena;
+
+    //Arena的std::pmr::memory_resource适配, deallocate为空操作
+    class ArenaResource : public std::pmr::memory_resource
+    {
+    public:
+        explicit ArenaResource(Arena *arena) : m_arena(arena) {}
+
+    protected:
+        void *do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void *, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+        {
+            return this == &other;
+        }
+
+    private:
+        Arena *m_arena;
+    };
+
+    /**
+     * @brief 指针递增分配的内存池
+     * @details 分配只移动块内指针, 单个对象不能释放, reset()或析构时整体回收。
+     *          适合生命周期与一次请求相同的临时对象: 请求开始时绑定到当前协程(ArenaScope),
+     *          请求结束时reset(), 保留的第一个块被下次请求复用。
+     *          非线程安全, 一个Arena同时只能被一个协程使用
+     */
+    class Arena : Noncopyable
+    {
+    public:
+        typedef std::shared_ptr<Arena> ptr;
+
+        /**
+         * @brief 构造函数
+         * @param[in] block_size 每次向系统申请的块大小, 超过块大小1/4的分配单独申请
+         */
+        explicit Arena(size_t block_size = 4096);
+        ~Arena();
+
+        /**
+         * @brief 分配内存
+         * @param[in] align 对齐, 必须是2的幂
+         */
+        void *allocate(size_t size, size_t align = alignof(std::max_align_t))
+        {
+            uintptr_t p = (m_ptr + align - 1) & ~(uintptr_t)(align - 1);
+            if (m_end && p >= m_ptr && p + size <= m_end)
+            {
+                m_ptr = p + size;
+                ++m_allocs;
+                m_used += size;
+                return (void *)p;
+            }
+            return allocateSlow(size, align);
+        }
+
+        /**
+         * @brief 在Arena上构造对象
+         * @details 析构函数非平凡的对象登记到清理链表, reset()或析构时逆序析构
+         */
+        template <class T, class... Args>
+        T *create(Args &&...args)
+        {
+            if (std::is_trivially_destructible<T>::value)
+            {
+                return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+            }
+            Cleanup *c = (Cleanup *)allocate(sizeof(Cleanup), alignof(Cleanup));
+            T *obj = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+            c->obj = obj;
+            c->destroy = [](void *o) { ((T *)o)->~T(); };
+            c->next = m_cleanups;
+            m_cleanups = c;
+            return obj;
+        }
+
+        //分配n个T的数组, 不构造
+        template <class T>
+        T *allocateArray(size_t n)
+        {
+            return (T *)allocate(sizeof(T) * n, alignof(T));
+        }
+
+        //复制字符串到Arena, 以'\0'结尾
+        char *strdup(std::string_view str)
+        {
+            char *p = (char *)allocate(str.size() + 1, 1);
+            memcpy(p, str.data(), str.size());
+            p[str.size()] = '\0';
+            return p;
+        }
+
+        /**
+         * @brief 回收全部分配
+         * @details 先析构create()创建的对象, 再释放除第一个普通块外的所有块
+         */
+        void reset();
+
+        //std::pmr适配, 生命周期与Arena相同
+        std::pmr::memory_resource *getResource() { return &m_resource; }
+
+        size_t getBlockSize() const { return m_blockSize; }
+        //自上次reset()以来的分配次数
+        uint64_t getAllocCount() const { return m_allocs; }
+        //自上次reset()以来分配的字节数(不含对齐填充)
+        size_t getUsedBytes() const { return m_used; }
+        //当前持有的块的总字节数
+        size_t getReservedBytes() const { return m_reserved; }
+        //当前持有的块数
+        size_t getBlockCount() const { return m_blocks; }
+
+    public:
+        /**
+         * @brief 当前的Arena
+         * @details 在协程中返回协程绑定的Arena, 否则返回线程绑定的Arena; 没有时返回nullptr
+         */
+        static Arena *GetCurrent();
+
+        //设置当前的Arena, 规则同GetCurrent
+        static void SetCurrent(Arena *arena);
+
+    private:
+        struct Block
+        {
+            Block *next;
+            size_t size;
+        };
+
+        struct Cleanup
+        {
+            Cleanup *next;
+            void *obj;
+            void (*destroy)(void *);
+        };
+
+        void *allocateSlow(size_t size, size_t align);
+        Block *newBlock(size_t size);
+        void runCleanups();
+
+    private:
+        size_t m_blockSize;
+        uintptr_t m_ptr = 0;
+        uintptr_t m_end = 0;
+        Block *m_head = nullptr;     /// 普通块链表, 最新的在前
+        Block *m_large = nullptr;    /// 单独申请的大块
+        Cleanup *m_cleanups = nullptr;
+        uint64_t m_allocs = 0;
+        size_t m_used = 0;
+        size_t m_reserved = 0;
+        size_t m_blocks = 0;
+        ArenaResource m_resource;
+    };
+
+    //在作用域内设置当前的Arena, 退出时恢复
+    class ArenaScope : Noncopyable
+    {
+    public:
+        explicit ArenaScope(Arena *arena)
+            : m_prev(Arena::GetCurrent())
+        {
+            Arena::SetCurrent(arena);
+        }
+
+        ~ArenaScope() { Arena::SetCurrent(m_prev); }
+
+    private:
+        Arena *m_prev;
+    };
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,75 @@
+#ifndef __SYLAR_UTIL_CPU_UTIL_H__
+#define __SYLAR_UTIL_CPU_UTIL_H__
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace sylar
+{
+
+    /**
+     * @brief CPU指令集检测
+     * @details 结果在首次调用时检测并缓存, SIMD内核据此在运行时选择实现
+     */
+    class CpuUtil
+    {
+    public:
+        //是否支持SSE4.1
+        static bool HasSSE41() { return Get().sse41; }
+        //是否支持SSE4.2(包含crc32指令)
+        static bool HasSSE42() { return Get().sse42; }
+
+        //是否支持AVX2
+        static bool HasAVX2() { return Get().avx2; }
+
+        //是否支持BMI2
+        static bool HasBMI2() { return Get().bmi2; }
+
+        //是否支持SHA指令扩展(SHA-NI)
+        static bool HasSHA() { return Get().sha; }
+
+        //是否支持PCLMULQDQ
+        static bool HasPCLMUL() { return Get().pclmul; }
+
+    private:
+        struct Features
+        {
+            bool sse41 = false;
+            bool sse42 = false;
+            bool avx2 = false;
+            bool bmi2 = false;
+            bool sha = false;
+            bool pclmul = false;
+        };
+
+        static const Features &Get()
+        {
+            static const Features s_features = Detect();
+            return s_features;
+        }
+
+        static Features Detect()
+        {
+            Features f;
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_cpu_init();
+            f.sse41 = __builtin_cpu_supports("sse4.1");
+            f.sse42 = __builtin_cpu_supports("sse4.2");
+            f.avx2 = __builtin_cpu_supports("avx2");
+            f.bmi2 = __builtin_cpu_supports("bmi2");
+            f.pclmul = __builtin_cpu_supports("pclmul");
+            unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+            //CPUID.(EAX=07H, ECX=0):EBX.SHA[bit 29]
+            if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+            {
+                f.sha = (ebx >> 29) & 1;
+            }
+#endif
+            return f;
+        }
+    };
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include "sylar/util/demangle.h"
+#include <cxxabi.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace sylar
+{
+
+    std::atomic<Demangler::Entry *> Demangler::s_buckets[Demangler::BUCKET_COUNT];
+    std::atomic<size_t> Demangler::s_count{0};
+
+    // FNV-1a
+    static uint64_t HashName(const char *name, size_t len)
+    {
+        uint64_t h = 0xcbf29ce484222325ull;
+        for (size_t i = 0; i < len; ++i)
+        {
+            h ^= (unsigned char)name[i];
+            h *= 0x100000001b3ull;
+        }
+        return h;
+    }
+
+    Mutex &Demangler::GetMutex()
+    {
+        static Mutex s_mutex;
+        return s_mutex;
+    }
+
+    Demangler::Entry *Demangler::Find(Entry *head, uint64_t hash, const char *mangled)
+    {
+        //节点发布后不再修改, next在发布前已写好
+        for (Entry *e = head; e; e = e->next)
+        {
+            if (e->hash == hash && strcmp(e->mangled, mangled) == 0)
+            {
+                return e;
+            }
+        }
+        return nullptr;
+    }
+
+    const char *Demangler::Demangle(const char *mangled)
+    {
+        size_t len = strlen(mangled);
+        uint64_t hash = HashName(mangled, len);
+        std::atomic<Entry *> &bucket = s_buckets[hash & (BUCKET_COUNT - 1)];
+        Entry *e = Find(bucket.load(std::memory_order_acquire), hash, mangled);
+        if (e)
+        {
+            return e->demangled;
+        }
+
+        //在锁外反修饰, 并发时最多重复计算, 插入前再检查一次
+        int status = 0;
+        char *v = abi::__cxa_demangle(mangled, nullptr, nullptr, &status);
+        const char *demangled = (status == 0 && v) ? v : mangled;
+        size_t dlen = strlen(demangled);
+
+        //修饰名和反修饰名放在同一块内存里
+        char *buf = (char *)malloc(sizeof(Entry) + len + 1 + dlen + 1);
+        Entry *ne = (Entry *)buf;
+        char *m = buf + sizeof(Entry);
+        char *d = m + len + 1;
+        memcpy(m, mangled, len + 1);
+        memcpy(d, demangled, dlen + 1);
+        free(v);
+        ne->hash = hash;
+        ne->mangled = m;
+        ne->demangled = d;
+
+        Mutex::Lock lock(GetMutex());
+        Entry *head = bucket.load(std::memory_order_relaxed);
+        e = Find(head, hash, mangled);
+        if (e)
+        {
+            free(buf);
+            return e->demangled;
+        }
+        ne->next = head;
+        bucket.store(ne, std::memory_order_release);
+        s_count.fetch_add(1, std::memory_order_relaxed);
+        return ne->demangled;
+    }
+
+    size_t Demangler::GetCount()
+    {
+        return s_count.load(std::memory_order_relaxed);
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#ifndef __SYLAR_UTIL_DEMANGLE_H__
+#define __SYLAR_UTIL_DEMANGLE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <array>
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <typeinfo>
+#include <utility>
+#include "sylar/mutex.h"
+
+namespace sylar
+{
+
+    /**
+     * @brief 全局的C++符号反修饰缓存
+     * @details 以修饰名为key, 每个名字只调用一次abi::__cxa_demangle。
+     *          结果驻留到进程结束, 返回的指针一直有效。
+     *          固定数量的桶, 每个桶是只在头部插入的单链表:
+     *          读取只做acquire加载和链表遍历, 不加锁; 插入用互斥锁串行
+     */
+    class Demangler
+    {
+    public:
+        /**
+         * @brief 反修饰
+         * @param[in] mangled 修饰名(如typeid(T).name()或符号表中的名字)
+         * @return 反修饰后的名字; 不是合法的修饰名时返回原名的副本
+         */
+        static const char *Demangle(const char *mangled);
+        static const char *Demangle(const std::string &mangled) { return Demangle(mangled.c_str()); }
+
+        //已缓存的名字数量
+        static size_t GetCount();
+
+    private:
+        struct Entry
+        {
+            uint64_t hash;
+            const char *mangled;
+            const char *demangled;
+            Entry *next;
+        };
+
+        static const size_t BUCKET_COUNT = 4096;
+
+        static Entry *Find(Entry *head, uint64_t hash, const char *mangled);
+
+        //插入锁, 用局部静态变量避免其他编译单元静态初始化时还未构造
+        static Mutex &GetMutex();
+
+    private:
+        static std::atomic<Entry *> s_buckets[BUCKET_COUNT]; /// 零初始化, 无需构造
+        static std::atomic<size_t> s_count;
+    };
+
+    namespace detail
+    {
+        //从__PRETTY_FUNCTION__中截取模板参数T的名字
+        template <class T>
+        constexpr std::string_view TypeNameView()
+        {
+#if defined(__clang__) || defined(__GNUC__)
+            std::string_view p = __PRETTY_FUNCTION__;
+            // gcc:   "... TypeNameView() [with T = int; std::string_view = ...]"
+            // clang: "... TypeNameView() [T = int]"
+            size_t begin = p.find("T = ");
+            if (begin == std::string_view::npos)
+            {
+                return std::string_view();
+            }
+            begin += 4;
+            size_t end = p.find(';', begin);
+            if (end == std::string_view::npos)
+            {
+                end = p.rfind(']');
+            }
+            return p.substr(begin, end - begin);
+#else
+            return std::string_view();
+#endif
+        }
+
+        template <size_t... I>
+        constexpr std::array<char, sizeof...(I) + 1> ToCharArray(std::string_view s, std::index_sequence<I...>)
+        {
+            return {{s[I]..., '\0'}};
+        }
+
+        //编译期生成的以'\0'结尾的类型名
+        template <class T>
+        struct TypeNameHolder
+        {
+            static constexpr std::string_view view = TypeNameView<T>();
+            static constexpr std::array<char, view.size() + 1> value =
+                ToCharArray(view, std::make_index_sequence<view.size()>());
+        };
+    }
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,351 @@
+#include "sylar/util/dir_walker.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <algorithm>
+#include <atomic>
+#include <set>
+#include <vector>
+
+namespace sylar
+{
+
+    bool DirEntry::isDir() const
+    {
+        return type == DT_DIR;
+    }
+
+    bool DirEntry::isFile() const
+    {
+        return type == DT_REG;
+    }
+
+    bool DirEntry::isLink() const
+    {
+        return type == DT_LNK;
+    }
+
+    namespace
+    {
+
+        //getdents64返回的记录, glibc没有导出这个结构
+        struct LinuxDirent64
+        {
+            uint64_t d_ino;
+            int64_t d_off;
+            unsigned short d_reclen;
+            unsigned char d_type;
+            char d_name[];
+        };
+
+        //每次getdents64读取的缓冲区大小
+        static const size_t s_dirent_buf_size = 64 * 1024;
+
+        //默认最多的工作线程数, 再多会被目录inode锁和磁盘限制
+        static const int s_max_default_threads = 8;
+
+        /**
+         * @brief 一次遍历的共享状态
+         * @details m_pending是已入队和正在扫描的目录数, 降为0时遍历结束
+         */
+        class WalkContext
+        {
+        public:
+            struct Task
+            {
+                std::string path;
+                int depth;
+            };
+
+            WalkContext(const DirWalker::Callback &cb, const DirWalker::Options &opt)
+                : m_cb(cb), m_opt(opt)
+            {
+            }
+
+            void push(Task &&task)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_tasks.push_back(std::move(task));
+                ++m_pending;
+            }
+
+            //工作线程主循环
+            void run()
+            {
+                std::vector<char> buf(s_dirent_buf_size);
+                std::vector<Task> subdirs;
+                Task task;
+                while (true)
+                {
+                    {
+                        std::unique_lock<std::mutex> lock(m_mutex);
+                        while (m_tasks.empty() && m_pending != 0 && !m_stop)
+                        {
+                            m_cond.wait(lock);
+                        }
+                        if (m_stop || m_tasks.empty())
+                        {
+                            return;
+                        }
+                        task = std::move(m_tasks.front());
+                        m_tasks.pop_front();
+                    }
+
+                    subdirs.clear();
+                    scan(task, buf, subdirs);
+
+                    //子目录入队和完成计数在同一次加锁中完成
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    for (auto &i : subdirs)
+                    {
+                        m_tasks.push_back(std::move(i));
+                    }
+                    m_pending += subdirs.size();
+                    --m_pending;
+                    if (m_pending == 0 || m_stop || subdirs.size() > 1)
+                    {
+                        m_cond.notify_all();
+                    }
+                    else if (!subdirs.empty())
+                    {
+                        m_cond.notify_one();
+                    }
+                }
+            }
+
+            bool isStopped() const { return m_stop; }
+
+        private:
+            void stop()
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stop = true;
+                m_cond.notify_all();
+            }
+
+            //跟随符号链接时记录已进入的目录, 重复返回false
+            bool markVisited(int fd)
+            {
+                struct stat st;
+                if (fstat(fd, &st) != 0)
+                {
+                    return false;
+                }
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return m_visited.insert(std::make_pair((uint64_t)st.st_dev, (uint64_t)st.st_ino)).second;
+            }
+
+            void scan(const Task &task, std::vector<char> &buf, std::vector<Task> &subdirs)
+            {
+                int fd = open(task.path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+                if (fd < 0)
+                {
+                    return;
+                }
+                if (m_opt.followSymlinks && !markVisited(fd))
+                {
+                    close(fd);
+                    return;
+                }
+                bool can_descend = m_opt.maxDepth < 0 || task.depth < m_opt.maxDepth;
+                bool need_slash = task.path.empty() || task.path.back() != '/';
+                DirEntry entry;
+                while (!m_stop)
+                {
+                    long n = syscall(SYS_getdents64, fd, buf.data(), buf.size());
+                    if (n < 0 && errno == EINTR)
+                    {
+                        continue;
+                    }
+                    if (n <= 0)
+                    {
+                        break;
+                    }
+                    for (long off = 0; off < n && !m_stop;)
+                    {
+                        const LinuxDirent64 *d = (const LinuxDirent64 *)(buf.data() + off);
+                        off += d->d_reclen;
+                        const char *name = d->d_name;
+                        if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+                        {
+                            continue;
+                        }
+                        if (m_opt.skipHidden && name[0] == '.')
+                        {
+                            continue;
+                        }
+
+                        entry.path.assign(task.path);
+                        if (need_slash)
+                        {
+                            entry.path.push_back('/');
+                        }
+                        entry.nameOffset = entry.path.size();
+                        entry.path.append(name);
+                        entry.ino = d->d_ino;
+                        entry.type = d->d_type;
+                        entry.depth = task.depth;
+                        entry.hasStat = false;
+                        if (m_opt.withStat || entry.type == DT_UNKNOWN)
+                        {
+                            if (fstatat(fd, name, &entry.st, AT_SYMLINK_NOFOLLOW) == 0)
+                            {
+                                entry.hasStat = m_opt.withStat;
+                                entry.type = IFTODT(entry.st.st_mode);
+                            }
+                        }
+
+                        bool descend = entry.type == DT_DIR;
+                        if (!descend && entry.type == DT_LNK && m_opt.followSymlinks && can_descend)
+                        {
+                            struct stat st;
+                            descend = fstatat(fd, name, &st, 0) == 0 && S_ISDIR(st.st_mode);
+                        }
+
+                        if (!m_cb(entry))
+                        {
+                            stop();
+                            break;
+                        }
+                        if (descend && can_descend && (!m_opt.dirFilter || m_opt.dirFilter(entry)))
+                        {
+                            subdirs.push_back(Task{entry.path, task.depth + 1});
+                        }
+                    }
+                }
+                close(fd);
+            }
+
+        private:
+            const DirWalker::Callback &m_cb;
+            const DirWalker::Options &m_opt;
+            std::mutex m_mutex;
+            std::condition_variable m_cond;
+            std::deque<Task> m_tasks;
+            size_t m_pending = 0;
+            std::atomic<bool> m_stop{false};
+            std::set<std::pair<uint64_t, uint64_t>> m_visited;
+        };
+
+    }
+
+    bool DirWalker::Walk(const std::string &root, const Callback &cb, const Options &opt)
+    {
+        struct stat st;
+        if (stat(root.c_str(), &st) != 0 || !S_ISDIR(st.st_mode))
+        {
+            return false;
+        }
+
+        WalkContext ctx(cb, opt);
+        ctx.push(WalkContext::Task{root, 0});
+
+        int threads = opt.threads;
+        if (threads <= 0)
+        {
+            threads = std::min((int)std::thread::hardware_concurrency(), s_max_default_threads);
+            threads = std::max(threads, 1);
+        }
+        //调用线程也参与扫描
+        std::vector<std::thread> workers;
+        for (int i = 1; i < threads; ++i)
+        {
+            workers.emplace_back(&WalkContext::run, &ctx);
+        }
+        ctx.run();
+        for (auto &i : workers)
+        {
+            i.join();
+        }
+        return !ctx.isStopped();
+    }
+
+    bool DirWalker::WalkFiles(const std::string &root, const std::string &suffix,
+                              const std::function<bool(const std::string &)> &cb, const Options &opt)
+    {
+        auto filter = [&suffix, &cb](const DirEntry &entry)
+        {
+            if (!entry.isFile())
+            {
+                return true;
+            }
+            std::string_view name = entry.name();
+            if (name.size() < suffix.size() || name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0)
+            {
+                return true;
+            }
+            return cb(entry.path);
+        };
+        return Walk(root, filter, opt);
+    }
+
+    DirScanner::DirScanner(const std::string &root, const DirWalker::Options &opt, size_t capacity)
+        : m_capacity(capacity ? capacity : 1)
+    {
+        m_thread = std::thread(&DirScanner::run, this, root, opt);
+    }
+
+    DirScanner::~DirScanner()
+    {
+        stop();
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+    }
+
+    void DirScanner::run(std::string root, DirWalker::Options opt)
+    {
+        bool rt = DirWalker::Walk(root, std::bind(&DirScanner::push, this, std::placeholders::_1), opt);
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_done = true;
+        m_complete = rt;
+        m_notEmpty.notify_all();
+    }
+
+    bool DirScanner::push(const DirEntry &entry)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_stop && m_queue.size() >= m_capacity)
+        {
+            m_notFull.wait(lock);
+        }
+        if (m_stop)
+        {
+            return false;
+        }
+        m_queue.push_back(entry);
+        m_notEmpty.notify_one();
+        return true;
+    }
+
+    bool DirScanner::next(DirEntry &entry)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (m_queue.empty() && !m_done && !m_stop)
+        {
+            m_notEmpty.wait(lock);
+        }
+        if (m_queue.empty())
+        {
+            return false;
+        }
+        entry = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_notFull.notify_one();
+        return true;
+    }
+
+    void DirScanner::stop()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        m_queue.clear();
+        m_notFull.notify_all();
+        m_notEmpty.notify_all();
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,144 @@
+#ifndef __SYLAR_UTIL_DIR_WALKER_H__
+#define __SYLAR_UTIL_DIR_WALKER_H__
+
+#include <stdint.h>
+#include <sys/stat.h>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include "sylar/noncopyable.h"
+
+namespace sylar
+{
+
+    //遍历得到的目录项
+    struct DirEntry
+    {
+        std::string path;       /// 完整路径(根目录 + "/" + 相对路径)
+        size_t nameOffset = 0;  /// 文件名在path中的起始位置
+        uint64_t ino = 0;       /// inode号
+        uint8_t type = 0;       /// DT_REG/DT_DIR/DT_LNK..., 文件系统不提供时用lstat补齐
+        int depth = 0;          /// 根目录下的直接子项为0
+        bool hasStat = false;   /// st是否有效(DirWalkOptions::withStat)
+        struct stat st;         /// lstat结果
+
+        //文件名
+        std::string_view name() const { return std::string_view(path).substr(nameOffset); }
+        bool isDir() const;
+        bool isFile() const;
+        bool isLink() const;
+    };
+
+    /**
+     * @brief 目录遍历选项
+     */
+    struct DirWalkOptions
+    {
+        //目录过滤, 返回false时不进入该目录(目录本身仍然交付给回调)
+        typedef std::function<bool(const DirEntry &)> DirFilter;
+
+        int threads = 0;              /// 工作线程数, 0为CPU核数(最多8), 1为在调用线程中遍历
+        int maxDepth = -1;            /// 最大深度, -1为不限制, 0为只列出根目录
+        bool withStat = false;        /// 是否对每一项调用fstatat填充DirEntry::st
+        bool followSymlinks = false;  /// 是否进入指向目录的符号链接(按dev+ino去重防止环)
+        bool skipHidden = false;      /// 是否跳过以'.'开头的项
+        DirFilter dirFilter;          /// 目录过滤
+    };
+
+    /**
+     * @brief 多线程目录遍历
+     * @details 直接调用getdents64批量读取目录项(每次64KB), 文件类型取自d_type,
+     *          只有文件系统返回DT_UNKNOWN或要求stat时才调用fstatat。
+     *          待扫描的目录放在共享的工作队列中, 多个线程同时扫描不同目录。
+     *          结果以回调方式逐个交付, 不在内存中汇总; 交付顺序不确定
+     */
+    class DirWalker
+    {
+    public:
+        /**
+         * @brief 结果回调
+         * @details 多线程遍历时会在多个工作线程中并发调用, 回调自身需要线程安全
+         * @return 返回false停止遍历
+         */
+        typedef std::function<bool(const DirEntry &)> Callback;
+
+        typedef DirWalkOptions Options;
+
+        /**
+         * @brief 遍历目录树
+         * @param[in] root 根目录
+         * @param[in] cb 每一项(文件/目录/链接等)调用一次
+         * @return 根目录无法打开或回调要求停止时返回false; 子目录打开失败会被忽略
+         */
+        static bool Walk(const std::string &root, const Callback &cb, const Options &opt = Options());
+
+        /**
+         * @brief 列出目录树中的普通文件
+         * @param[in] suffix 文件名后缀, 为空时不过滤
+         * @param[in] cb 多线程时并发调用
+         */
+        static bool WalkFiles(const std::string &root, const std::string &suffix,
+                              const std::function<bool(const std::string &)> &cb, const Options &opt = Options());
+    };
+
+    /**
+     * @brief 拉取式目录遍历
+     * @details 后台线程执行DirWalker::Walk, 结果经有界队列交给next(),
+     *          队列满时遍历线程阻塞, 内存占用与目录大小无关。
+     *          提前析构会停止遍历
+     *
+     *  DirScanner scanner("/data/logs");
+     *  DirEntry e;
+     *  while(scanner.next(e)) { ... }
+     */
+    class DirScanner : Noncopyable
+    {
+    public:
+        typedef std::shared_ptr<DirScanner> ptr;
+
+        /**
+         * @brief 构造并开始遍历
+         * @param[in] capacity 队列容量
+         */
+        DirScanner(const std::string &root, const DirWalker::Options &opt = DirWalker::Options(), size_t capacity = 1024);
+        ~DirScanner();
+
+        /**
+         * @brief 取下一项
+         * @return 遍历结束返回false
+         */
+        bool next(DirEntry &entry);
+
+        //停止遍历, 之后next()返回false
+        void stop();
+
+        //遍历是否完整结束(根目录打开失败或被stop()时为false), next()返回false后有效
+        bool isComplete() const { return m_complete; }
+
+    private:
+        //后台线程: 执行遍历
+        void run(std::string root, DirWalker::Options opt);
+
+        //遍历回调: 入队, 队列满时等待
+        bool push(const DirEntry &entry);
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_notEmpty;
+        std::condition_variable m_notFull;
+        std::deque<DirEntry> m_queue;
+        size_t m_capacity;
+        bool m_done = false;
+        bool m_stop = false;
+        bool m_complete = false;
+        std::thread m_thread;
+    };
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,849 @@
+#include "sylar/util/hash_util.h"
+#include "sylar/util/cpu_util.h"
+#include <algorithm>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SYLAR_HASH_SIMD_X86 1
+#endif
+
+namespace sylar
+{
+
+    namespace
+    {
+
+        inline uint64_t Read64(const uint8_t *p)
+        {
+            uint64_t v;
+            memcpy(&v, p, 8);
+            return v;
+        }
+
+        inline uint32_t Read32(const uint8_t *p)
+        {
+            uint32_t v;
+            memcpy(&v, p, 4);
+            return v;
+        }
+
+        inline uint32_t ReadBE32(const uint8_t *p)
+        {
+            return __builtin_bswap32(Read32(p));
+        }
+
+        inline void WriteBE32(uint8_t *p, uint32_t v)
+        {
+            v = __builtin_bswap32(v);
+            memcpy(p, &v, 4);
+        }
+
+        inline uint64_t Rotl64(uint64_t x, int r)
+        {
+            return (x << r) | (x >> (64 - r));
+        }
+
+        inline uint32_t Rotl32(uint32_t x, int r)
+        {
+            return (x << r) | (x >> (32 - r));
+        }
+
+        inline uint32_t Rotr32(uint32_t x, int r)
+        {
+            return (x >> r) | (x << (32 - r));
+        }
+
+        //---------------- wyhash ----------------
+
+        static const uint64_t s_wy_secret[4] = {0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+                                                0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull};
+
+        inline void WyMum(uint64_t &a, uint64_t &b)
+        {
+            __uint128_t r = (__uint128_t)a * b;
+            a = (uint64_t)r;
+            b = (uint64_t)(r >> 64);
+        }
+
+        inline uint64_t WyMix(uint64_t a, uint64_t b)
+        {
+            WyMum(a, b);
+            return a ^ b;
+        }
+
+        inline uint64_t WyRead3(const uint8_t *p, size_t k)
+        {
+            return ((uint64_t)p[0] << 16) | ((uint64_t)p[k >> 1] << 8) | p[k - 1];
+        }
+
+        //---------------- XXH64 ----------------
+
+        static const uint64_t s_xxh_p1 = 11400714785074694791ull;
+        static const uint64_t s_xxh_p2 = 14029467366897019727ull;
+        static const uint64_t s_xxh_p3 = 1609587929392839161ull;
+        static const uint64_t s_xxh_p4 = 9650029242287828579ull;
+        static const uint64_t s_xxh_p5 = 2870177450012600261ull;
+
+        inline uint64_t XXHRound(uint64_t acc, uint64_t input)
+        {
+            acc += input * s_xxh_p2;
+            acc = Rotl64(acc, 31);
+            return acc * s_xxh_p1;
+        }
+
+        inline uint64_t XXHMerge(uint64_t acc, uint64_t val)
+        {
+            acc ^= XXHRound(0, val);
+            return acc * s_xxh_p1 + s_xxh_p4;
+        }
+
+        //处理尽量多的32字节条带, 返回处理的字节数
+        inline size_t XXHStripes(uint64_t *v, const uint8_t *p, size_t len)
+        {
+            size_t n = 0;
+            for (; n + 32 <= len; n += 32)
+            {
+                v[0] = XXHRound(v[0], Read64(p + n));
+                v[1] = XXHRound(v[1], Read64(p + n + 8));
+                v[2] = XXHRound(v[2], Read64(p + n + 16));
+                v[3] = XXHRound(v[3], Read64(p + n + 24));
+            }
+            return n;
+        }
+
+        inline void XXHInit(uint64_t *v, uint64_t seed)
+        {
+            v[0] = seed + s_xxh_p1 + s_xxh_p2;
+            v[1] = seed + s_xxh_p2;
+            v[2] = seed;
+            v[3] = seed - s_xxh_p1;
+        }
+
+        //合并累加器, 处理不足32字节的尾部
+        uint64_t XXHFinish(const uint64_t *v, uint64_t seed, uint64_t total, const uint8_t *p, size_t len)
+        {
+            uint64_t h;
+            if (total >= 32)
+            {
+                h = Rotl64(v[0], 1) + Rotl64(v[1], 7) + Rotl64(v[2], 12) + Rotl64(v[3], 18);
+                for (int i = 0; i < 4; ++i)
+                {
+                    h = XXHMerge(h, v[i]);
+                }
+            }
+            else
+            {
+                h = seed + s_xxh_p5;
+            }
+            h += total;
+            for (; len >= 8; p += 8, len -= 8)
+            {
+                h ^= XXHRound(0, Read64(p));
+                h = Rotl64(h, 27) * s_xxh_p1 + s_xxh_p4;
+            }
+            if (len >= 4)
+            {
+                h ^= (uint64_t)Read32(p) * s_xxh_p1;
+                h = Rotl64(h, 23) * s_xxh_p2 + s_xxh_p3;
+                p += 4;
+                len -= 4;
+            }
+            for (; len > 0; ++p, --len)
+            {
+                h ^= *p * s_xxh_p5;
+                h = Rotl64(h, 11) * s_xxh_p1;
+            }
+            h ^= h >> 33;
+            h *= s_xxh_p2;
+            h ^= h >> 29;
+            h *= s_xxh_p3;
+            h ^= h >> 32;
+            return h;
+        }
+
+        //---------------- CRC32C ----------------
+
+        //反射多项式0x82F63B78的slicing-by-8表
+        struct Crc32cTable
+        {
+            uint32_t t[8][256];
+
+            Crc32cTable()
+            {
+                for (uint32_t i = 0; i < 256; ++i)
+                {
+                    uint32_t c = i;
+                    for (int k = 0; k < 8; ++k)
+                    {
+                        c = (c >> 1) ^ (0x82F63B78u & (0u - (c & 1)));
+                    }
+                    t[0][i] = c;
+                }
+                for (uint32_t i = 0; i < 256; ++i)
+                {
+                    for (int k = 1; k < 8; ++k)
+                    {
+                        t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xff];
+                    }
+                }
+            }
+        };
+
+        uint32_t Crc32cScalar(uint32_t crc, const uint8_t *p, size_t len)
+        {
+            static const Crc32cTable s_table;
+            const uint32_t(*t)[256] = s_table.t;
+            for (; len >= 8; p += 8, len -= 8)
+            {
+                uint32_t lo = Read32(p) ^ crc;
+                uint32_t hi = Read32(p + 4);
+                crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^
+                      t[3][hi & 0xff] ^ t[2][(hi >> 8) & 0xff] ^ t[1][(hi >> 16) & 0xff] ^ t[0][hi >> 24];
+            }
+            for (; len > 0; ++p, --len)
+            {
+                crc = (crc >> 8) ^ t[0][(crc ^ *p) & 0xff];
+            }
+            return crc;
+        }
+
+        //---------------- MD5 ----------------
+
+        static const uint32_t s_md5_k[64] = {
+            0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+            0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+            0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+            0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+            0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+            0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+            0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+            0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391};
+
+        static const int s_md5_r[64] = {7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+                                         5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+                                         4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+                                         6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21};
+
+        //MD5的一步, F为该轮的非线性函数
+        template <class F>
+        inline void Md5Step(uint32_t &a, uint32_t b, uint32_t c, uint32_t d, uint32_t m, int i, F f)
+        {
+            a = b + Rotl32(a + f(b, c, d) + s_md5_k[i] + m, s_md5_r[i]);
+        }
+
+        void Md5Compress(uint32_t *state, const uint8_t *p, size_t blocks)
+        {
+            auto f = [](uint32_t b, uint32_t c, uint32_t d) { return d ^ (b & (c ^ d)); };
+            auto g = [](uint32_t b, uint32_t c, uint32_t d) { return c ^ (d & (b ^ c)); };
+            auto h = [](uint32_t b, uint32_t c, uint32_t d) { return b ^ c ^ d; };
+            auto k = [](uint32_t b, uint32_t c, uint32_t d) { return c ^ (b | ~d); };
+            for (; blocks > 0; --blocks, p += 64)
+            {
+                uint32_t m[16];
+                for (int i = 0; i < 16; ++i)
+                {
+                    m[i] = Read32(p + i * 4);
+                }
+                uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+                //每4步轮换一次a/b/c/d的角色, 避免逐步搬移寄存器
+                for (int i = 0; i < 16; i += 4)
+                {
+                    Md5Step(a, b, c, d, m[i], i, f);
+                    Md5Step(d, a, b, c, m[i + 1], i + 1, f);
+                    Md5Step(c, d, a, b, m[i + 2], i + 2, f);
+                    Md5Step(b, c, d, a, m[i + 3], i + 3, f);
+                }
+                for (int i = 16; i < 32; i += 4)
+                {
+                    Md5Step(a, b, c, d, m[(5 * i + 1) & 15], i, g);
+                    Md5Step(d, a, b, c, m[(5 * i + 6) & 15], i + 1, g);
+                    Md5Step(c, d, a, b, m[(5 * i + 11) & 15], i + 2, g);
+                    Md5Step(b, c, d, a, m[(5 * i + 16) & 15], i + 3, g);
+                }
+                for (int i = 32; i < 48; i += 4)
+                {
+                    Md5Step(a, b, c, d, m[(3 * i + 5) & 15], i, h);
+                    Md5Step(d, a, b, c, m[(3 * i + 8) & 15], i + 1, h);
+                    Md5Step(c, d, a, b, m[(3 * i + 11) & 15], i + 2, h);
+                    Md5Step(b, c, d, a, m[(3 * i + 14) & 15], i + 3, h);
+                }
+                for (int i = 48; i < 64; i += 4)
+                {
+                    Md5Step(a, b, c, d, m[(7 * i) & 15], i, k);
+                    Md5Step(d, a, b, c, m[(7 * i + 7) & 15], i + 1, k);
+                    Md5Step(c, d, a, b, m[(7 * i + 14) & 15], i + 2, k);
+                    Md5Step(b, c, d, a, m[(7 * i + 21) & 15], i + 3, k);
+                }
+                state[0] += a;
+                state[1] += b;
+                state[2] += c;
+                state[3] += d;
+            }
+        }
+
+        //---------------- SHA-1 ----------------
+
+        void Sha1CompressScalar(uint32_t *state, const uint8_t *p, size_t blocks)
+        {
+            for (; blocks > 0; --blocks, p += 64)
+            {
+                uint32_t w[80];
+                for (int i = 0; i < 16; ++i)
+                {
+                    w[i] = ReadBE32(p + i * 4);
+                }
+                for (int i = 16; i < 80; ++i)
+                {
+                    w[i] = Rotl32(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+                }
+                uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+                for (int i = 0; i < 80; ++i)
+                {
+                    uint32_t f, k;
+                    if (i < 20)
+                    {
+                        f = (b & c) | (~b & d);
+                        k = 0x5a827999;
+                    }
+                    else if (i < 40)
+                    {
+                        f = b ^ c ^ d;
+                        k = 0x6ed9eba1;
+                    }
+                    else if (i < 60)
+                    {
+                        f = (b & c) | (b & d) | (c & d);
+                        k = 0x8f1bbcdc;
+                    }
+                    else
+                    {
+                        f = b ^ c ^ d;
+                        k = 0xca62c1d6;
+                    }
+                    uint32_t tmp = Rotl32(a, 5) + f + e + k + w[i];
+                    e = d;
+                    d = c;
+                    c = Rotl32(b, 30);
+                    b = a;
+                    a = tmp;
+                }
+                state[0] += a;
+                state[1] += b;
+                state[2] += c;
+                state[3] += d;
+                state[4] += e;
+            }
+        }
+
+        //---------------- SHA-256 ----------------
+
+        alignas(16) static const uint32_t s_sha256_k[64] = {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+        void Sha256CompressScalar(uint32_t *state, const uint8_t *p, size_t blocks)
+        {
+            for (; blocks > 0; --blocks, p += 64)
+            {
+                uint32_t w[64];
+                for (int i = 0; i < 16; ++i)
+                {
+                    w[i] = ReadBE32(p + i * 4);
+                }
+                for (int i = 16; i < 64; ++i)
+                {
+                    uint32_t s0 = Rotr32(w[i - 15], 7) ^ Rotr32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+                    uint32_t s1 = Rotr32(w[i - 2], 17) ^ Rotr32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+                    w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+                }
+                uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+                uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+                for (int i = 0; i < 64; ++i)
+                {
+                    uint32_t s1 = Rotr32(e, 6) ^ Rotr32(e, 11) ^ Rotr32(e, 25);
+                    uint32_t ch = (e & f) ^ (~e & g);
+                    uint32_t t1 = h + s1 + ch + s_sha256_k[i] + w[i];
+                    uint32_t s0 = Rotr32(a, 2) ^ Rotr32(a, 13) ^ Rotr32(a, 22);
+                    uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+                    uint32_t t2 = s0 + maj;
+                    h = g;
+                    g = f;
+                    f = e;
+                    e = d + t1;
+                    d = c;
+                    c = b;
+                    b = a;
+                    a = t1 + t2;
+                }
+                state[0] += a;
+                state[1] += b;
+                state[2] += c;
+                state[3] += d;
+                state[4] += e;
+                state[5] += f;
+                state[6] += g;
+                state[7] += h;
+            }
+        }
+
+#ifdef SYLAR_HASH_SIMD_X86
+
+#pragma GCC push_options
+#pragma GCC target("sse4.2")
+
+        uint32_t Crc32cSSE42(uint32_t crc, const uint8_t *p, size_t len)
+        {
+            uint64_t c = crc;
+            for (; len >= 8; p += 8, len -= 8)
+            {
+                c = _mm_crc32_u64(c, Read64(p));
+            }
+            crc = (uint32_t)c;
+            for (; len > 0; ++p, --len)
+            {
+                crc = _mm_crc32_u8(crc, *p);
+            }
+            return crc;
+        }
+
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("sse4.1,sha")
+
+        //SHA-1的4轮, G为4轮一组的序号(0-19), 消息调度与轮函数交错
+        template <int G>
+        inline void Sha1Rounds4(__m128i &abcd, __m128i &e0, __m128i &e1, __m128i *msg)
+        {
+            __m128i &ein = (G & 1) ? e1 : e0;
+            __m128i &eout = (G & 1) ? e0 : e1;
+            if (G == 0)
+            {
+                ein = _mm_add_epi32(ein, msg[0]);
+            }
+            else
+            {
+                ein = _mm_sha1nexte_epu32(ein, msg[G & 3]);
+            }
+            eout = abcd;
+            if (G >= 3 && G <= 18)
+            {
+                msg[(G + 1) & 3] = _mm_sha1msg2_epu32(msg[(G + 1) & 3], msg[G & 3]);
+            }
+            abcd = _mm_sha1rnds4_epu32(abcd, ein, G / 5);
+            if (G >= 1 && G <= 16)
+            {
+                msg[(G - 1) & 3] = _mm_sha1msg1_epu32(msg[(G - 1) & 3], msg[G & 3]);
+            }
+            if (G >= 2 && G <= 17)
+            {
+                msg[(G - 2) & 3] = _mm_xor_si128(msg[(G - 2) & 3], msg[G & 3]);
+            }
+        }
+
+        template <int... G>
+        inline void Sha1AllRounds(__m128i &abcd, __m128i &e0, __m128i &e1, __m128i *msg,
+                                  std::integer_sequence<int, G...>)
+        {
+            (Sha1Rounds4<G>(abcd, e0, e1, msg), ...);
+        }
+
+        void Sha1CompressSHANI(uint32_t *state, const uint8_t *p, size_t blocks)
+        {
+            const __m128i mask = _mm_set_epi64x(0x0001020304050607ull, 0x08090a0b0c0d0e0full);
+            __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)state), 0x1b);
+            __m128i e0 = _mm_set_epi32((int)state[4], 0, 0, 0);
+            __m128i e1;
+            for (; blocks > 0; --blocks, p += 64)
+            {
+                __m128i abcd_save = abcd;
+                __m128i e0_save = e0;
+                __m128i msg[4];
+                for (int i = 0; i < 4; ++i)
+                {
+                    msg[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(p + i * 16)), mask);
+                }
+                Sha1AllRounds(abcd, e0, e1, msg, std::make_integer_sequence<int, 20>());
+                e0 = _mm_sha1nexte_epu32(e0, e0_save);
+                abcd = _mm_add_epi32(abcd, abcd_save);
+            }
+            _mm_storeu_si128((__m128i *)state, _mm_shuffle_epi32(abcd, 0x1b));
+            state[4] = (uint32_t)_mm_extract_epi32(e0, 3);
+        }
+
+        void Sha256CompressSHANI(uint32_t *state, const uint8_t *p, size_t blocks)
+        {
+            const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bull, 0x0405060700010203ull);
+            __m128i tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)state), 0xb1); // CDAB
+            __m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i *)(state + 4)), 0x1b); // EFGH
+            __m128i state0 = _mm_alignr_epi8(tmp, state1, 8); // ABEF
+            state1 = _mm_blend_epi16(state1, tmp, 0xf0);      // CDGH
+            for (; blocks > 0; --blocks, p += 64)
+            {
+                __m128i abef_save = state0;
+                __m128i cdgh_save = state1;
+                __m128i msg[4];
+#pragma GCC unroll 16
+                for (int g = 0; g < 16; ++g)
+                {
+                    if (g < 4)
+                    {
+                        msg[g] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(p + g * 16)), mask);
+                    }
+                    __m128i m = _mm_add_epi32(msg[g & 3], _mm_load_si128((const __m128i *)(s_sha256_k + g * 4)));
+                    state1 = _mm_sha256rnds2_epu32(state1, state0, m);
+                    if (g >= 3 && g <= 14)
+                    {
+                        __m128i t = _mm_alignr_epi8(msg[g & 3], msg[(g - 1) & 3], 4);
+                        msg[(g + 1) & 3] = _mm_add_epi32(msg[(g + 1) & 3], t);
+                        msg[(g + 1) & 3] = _mm_sha256msg2_epu32(msg[(g + 1) & 3], msg[g & 3]);
+                    }
+                    state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(m, 0x0e));
+                    if (g >= 1 && g <= 12)
+                    {
+                        msg[(g - 1) & 3] = _mm_sha256msg1_epu32(msg[(g - 1) & 3], msg[g & 3]);
+                    }
+                }
+                state0 = _mm_add_epi32(state0, abef_save);
+                state1 = _mm_add_epi32(state1, cdgh_save);
+            }
+            tmp = _mm_shuffle_epi32(state0, 0x1b);            // FEBA
+            state1 = _mm_shuffle_epi32(state1, 0xb1);         // DCHG
+            state0 = _mm_blend_epi16(tmp, state1, 0xf0);      // DCBA
+            state1 = _mm_alignr_epi8(state1, tmp, 8);         // ABEF
+            _mm_storeu_si128((__m128i *)state, state0);
+            _mm_storeu_si128((__m128i *)(state + 4), state1);
+        }
+
+#pragma GCC pop_options
+
+#endif
+
+        //按CPU支持情况选择的内核
+        struct Kernels
+        {
+            uint32_t (*crc32c)(uint32_t, const uint8_t *, size_t);
+            void (*sha1)(uint32_t *, const uint8_t *, size_t);
+            void (*sha256)(uint32_t *, const uint8_t *, size_t);
+        };
+
+        Kernels SelectKernels()
+        {
+            Kernels k{Crc32cScalar, Sha1CompressScalar, Sha256CompressScalar};
+#ifdef SYLAR_HASH_SIMD_X86
+            if (CpuUtil::HasSSE42())
+            {
+                k.crc32c = Crc32cSSE42;
+            }
+            if (CpuUtil::HasSHA() && CpuUtil::HasSSE41())
+            {
+                k.sha1 = Sha1CompressSHANI;
+                k.sha256 = Sha256CompressSHANI;
+            }
+#endif
+            return k;
+        }
+
+        const Kernels &GetKernels()
+        {
+            static const Kernels s_kernels = SelectKernels();
+            return s_kernels;
+        }
+
+        //64字节分组的缓冲与填充, 各摘要算法共用
+        template <class Compress>
+        void BlockUpdate(uint32_t *state, uint8_t *buffer, size_t &used, uint64_t &total,
+                         const void *data, size_t len, Compress compress)
+        {
+            const uint8_t *p = (const uint8_t *)data;
+            total += len;
+            if (used)
+            {
+                size_t n = std::min(len, 64 - used);
+                memcpy(buffer + used, p, n);
+                used += n;
+                p += n;
+                len -= n;
+                if (used < 64)
+                {
+                    return;
+                }
+                compress(state, buffer, 1);
+                used = 0;
+            }
+            if (len >= 64)
+            {
+                compress(state, p, len / 64);
+                p += len & ~(size_t)63;
+                len &= 63;
+            }
+            if (len)
+            {
+                memcpy(buffer, p, len);
+                used = len;
+            }
+        }
+
+        //补0x80和0, 最后8字节写入比特长度(MD5小端, SHA大端)
+        template <class Compress>
+        void BlockFinal(uint32_t *state, uint8_t *buffer, size_t used, uint64_t total,
+                        bool big_endian, Compress compress)
+        {
+            buffer[used++] = 0x80;
+            if (used > 56)
+            {
+                memset(buffer + used, 0, 64 - used);
+                compress(state, buffer, 1);
+                used = 0;
+            }
+            memset(buffer + used, 0, 56 - used);
+            uint64_t bits = total * 8;
+            if (big_endian)
+            {
+                bits = __builtin_bswap64(bits);
+            }
+            memcpy(buffer + 56, &bits, 8);
+            compress(state, buffer, 1);
+        }
+
+    }
+
+    uint64_t HashUtil::WyHashSeeded(uint64_t seed, const void *data, size_t len)
+    {
+        const uint8_t *p = (const uint8_t *)data;
+        const uint64_t *secret = s_wy_secret;
+        seed ^= WyMix(seed ^ secret[0], secret[1]);
+        uint64_t a, b;
+        if (len <= 16)
+        {
+            if (len >= 4)
+            {
+                a = ((uint64_t)Read32(p) << 32) | Read32(p + ((len >> 3) << 2));
+                b = ((uint64_t)Read32(p + len - 4) << 32) | Read32(p + len - 4 - ((len >> 3) << 2));
+            }
+            else if (len > 0)
+            {
+                a = WyRead3(p, len);
+                b = 0;
+            }
+            else
+            {
+                a = b = 0;
+            }
+        }
+        else
+        {
+            size_t i = len;
+            if (i > 48)
+            {
+                uint64_t see1 = seed, see2 = seed;
+                do
+                {
+                    seed = WyMix(Read64(p) ^ secret[1], Read64(p + 8) ^ seed);
+                    see1 = WyMix(Read64(p + 16) ^ secret[2], Read64(p + 24) ^ see1);
+                    see2 = WyMix(Read64(p + 32) ^ secret[3], Read64(p + 40) ^ see2);
+                    p += 48;
+                    i -= 48;
+                } while (i > 48);
+                seed ^= see1 ^ see2;
+            }
+            while (i > 16)
+            {
+                seed = WyMix(Read64(p) ^ secret[1], Read64(p + 8) ^ seed);
+                i -= 16;
+                p += 16;
+            }
+            a = Read64(p + i - 16);
+            b = Read64(p + i - 8);
+        }
+        a ^= secret[1];
+        b ^= seed;
+        WyMum(a, b);
+        return WyMix(a ^ secret[0] ^ len, b ^ secret[1]);
+    }
+
+    uint64_t HashUtil::XXH64Seeded(uint64_t seed, const void *data, size_t len)
+    {
+        const uint8_t *p = (const uint8_t *)data;
+        uint64_t v[4];
+        XXHInit(v, seed);
+        size_t n = XXHStripes(v, p, len);
+        return XXHFinish(v, seed, len, p + n, len - n);
+    }
+
+    uint32_t HashUtil::Crc32cExtend(uint32_t crc, const void *data, size_t len)
+    {
+        return ~GetKernels().crc32c(~crc, (const uint8_t *)data, len);
+    }
+
+    std::string HashUtil::ToHex(const void *data, size_t len)
+    {
+        static const char s_hex[] = "0123456789abcdef";
+        const uint8_t *p = (const uint8_t *)data;
+        std::string rt(len * 2, '\0');
+        for (size_t i = 0; i < len; ++i)
+        {
+            rt[i * 2] = s_hex[p[i] >> 4];
+            rt[i * 2 + 1] = s_hex[p[i] & 0xf];
+        }
+        return rt;
+    }
+
+    void XXH64Hasher::reset(uint64_t seed)
+    {
+        XXHInit(m_v, seed);
+        m_seed = seed;
+        m_total = 0;
+        m_used = 0;
+    }
+
+    void XXH64Hasher::update(const void *data, size_t len)
+    {
+        const uint8_t *p = (const uint8_t *)data;
+        m_total += len;
+        if (m_used)
+        {
+            size_t n = std::min(len, sizeof(m_buffer) - m_used);
+            memcpy(m_buffer + m_used, p, n);
+            m_used += n;
+            p += n;
+            len -= n;
+            if (m_used < sizeof(m_buffer))
+            {
+                return;
+            }
+            XXHStripes(m_v, m_buffer, sizeof(m_buffer));
+            m_used = 0;
+        }
+        size_t n = XXHStripes(m_v, p, len);
+        if (len > n)
+        {
+            memcpy(m_buffer, p + n, len - n);
+            m_used = len - n;
+        }
+    }
+
+    uint64_t XXH64Hasher::digest() const
+    {
+        return XXHFinish(m_v, m_seed, m_total, m_buffer, m_used);
+    }
+
+    void Md5::reset()
+    {
+        m_state[0] = 0x67452301;
+        m_state[1] = 0xefcdab89;
+        m_state[2] = 0x98badcfe;
+        m_state[3] = 0x10325476;
+        m_used = 0;
+        m_total = 0;
+    }
+
+    void Md5::update(const void *data, size_t len)
+    {
+        BlockUpdate(m_state, m_buffer, m_used, m_total, data, len, Md5Compress);
+    }
+
+    void Md5::final(uint8_t *out)
+    {
+        BlockFinal(m_state, m_buffer, m_used, m_total, false, Md5Compress);
+        memcpy(out, m_state, DIGEST_SIZE);
+    }
+
+    std::string Md5::digest()
+    {
+        std::string rt(DIGEST_SIZE, '\0');
+        final((uint8_t *)&rt[0]);
+        return rt;
+    }
+
+    std::string Md5::Hash(std::string_view data)
+    {
+        Md5 h;
+        h.update(data);
+        return h.digest();
+    }
+
+    void Sha1::reset()
+    {
+        m_state[0] = 0x67452301;
+        m_state[1] = 0xefcdab89;
+        m_state[2] = 0x98badcfe;
+        m_state[3] = 0x10325476;
+        m_state[4] = 0xc3d2e1f0;
+        m_used = 0;
+        m_total = 0;
+    }
+
+    void Sha1::update(const void *data, size_t len)
+    {
+        BlockUpdate(m_state, m_buffer, m_used, m_total, data, len, GetKernels().sha1);
+    }
+
+    void Sha1::final(uint8_t *out)
+    {
+        BlockFinal(m_state, m_buffer, m_used, m_total, true, GetKernels().sha1);
+        for (int i = 0; i < 5; ++i)
+        {
+            WriteBE32(out + i * 4, m_state[i]);
+        }
+    }
+
+    std::string Sha1::digest()
+    {
+        std::string rt(DIGEST_SIZE, '\0');
+        final((uint8_t *)&rt[0]);
+        return rt;
+    }
+
+    std::string Sha1::Hash(std::string_view data)
+    {
+        Sha1 h;
+        h.update(data);
+        return h.digest();
+    }
+
+    void Sha256::reset()
+    {
+        static const uint32_t s_init[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                           0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+        memcpy(m_state, s_init, sizeof(m_state));
+        m_used = 0;
+        m_total = 0;
+    }
+
+    void Sha256::update(const void *data, size_t len)
+    {
+        BlockUpdate(m_state, m_buffer, m_used, m_total, data, len, GetKernels().sha256);
+    }
+
+    void Sha256::final(uint8_t *out)
+    {
+        BlockFinal(m_state, m_buffer, m_used, m_total, true, GetKernels().sha256);
+        for (int i = 0; i < 8; ++i)
+        {
+            WriteBE32(out + i * 4, m_state[i]);
+        }
+    }
+
+    std::string Sha256::digest()
+    {
+        std::string rt(DIGEST_SIZE, '\0');
+        final((uint8_t *)&rt[0]);
+        return rt;
+    }
+
+    std::string Sha256::Hash(std::string_view data)
+    {
+        Sha256 h;
+        h.update(data);
+        return h.digest();
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,223 @@
+#ifndef __SYLAR_UTIL_HASH_UTIL_H__
+#define __SYLAR_UTIL_HASH_UTIL_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <string>
+#include <string_view>
+
+namespace sylar
+{
+
+    /**
+     * @brief 非加密哈希与校验和
+     * @details CRC32C在支持SSE4.2的CPU上使用crc32指令, 否则查表; 实现在首次调用时选定。
+     *          带种子/初始CRC的版本单独命名且种子在前, 指针加一个整数只能匹配(data, len)
+     */
+    class HashUtil
+    {
+    public:
+        /**
+         * @brief wyhash(final4)
+         * @details 哈希表用, 短键很快; 只有一次性接口
+         */
+        static uint64_t WyHash(const void *data, size_t len) { return WyHashSeeded(0, data, len); }
+        static uint64_t WyHash(std::string_view str) { return WyHashSeeded(0, str.data(), str.size()); }
+        static uint64_t WyHashSeeded(uint64_t seed, const void *data, size_t len);
+        static uint64_t WyHashSeeded(uint64_t seed, std::string_view str) { return WyHashSeeded(seed, str.data(), str.size()); }
+
+        //XXH64, 增量计算用XXH64Hasher
+        static uint64_t XXH64(const void *data, size_t len) { return XXH64Seeded(0, data, len); }
+        static uint64_t XXH64(std::string_view str) { return XXH64Seeded(0, str.data(), str.size()); }
+        static uint64_t XXH64Seeded(uint64_t seed, const void *data, size_t len);
+        static uint64_t XXH64Seeded(uint64_t seed, std::string_view str) { return XXH64Seeded(seed, str.data(), str.size()); }
+
+        //CRC32C(Castagnoli)
+        static uint32_t Crc32c(const void *data, size_t len) { return Crc32cExtend(0, data, len); }
+        static uint32_t Crc32c(std::string_view str) { return Crc32cExtend(0, str.data(), str.size()); }
+
+        /**
+         * @brief 在前面数据的CRC上继续计算
+         * @param[in] crc 前面数据的CRC: Crc32cExtend(Crc32c(a), b) == Crc32c(a + b)
+         */
+        static uint32_t Crc32cExtend(uint32_t crc, const void *data, size_t len);
+        static uint32_t Crc32cExtend(uint32_t crc, std::string_view str) { return Crc32cExtend(crc, str.data(), str.size()); }
+
+        //二进制转小写十六进制
+        static std::string ToHex(const void *data, size_t len);
+        static std::string ToHex(std::string_view str) { return ToHex(str.data(), str.size()); }
+    };
+
+    //XXH64增量计算
+    class XXH64Hasher
+    {
+    public:
+        explicit XXH64Hasher(uint64_t seed = 0) { reset(seed); }
+
+        void reset(uint64_t seed = 0);
+        void update(const void *data, size_t len);
+        void update(std::string_view str) { update(str.data(), str.size()); }
+
+        //当前为止数据的哈希值, 不影响继续update
+        uint64_t digest() const;
+
+    private:
+        uint64_t m_v[4];
+        uint64_t m_seed;
+        uint64_t m_total;
+        uint8_t m_buffer[32];
+        size_t m_used;
+    };
+
+    /**
+     * @brief MD5
+     * @details 仅用于兼容已有协议和校验, 不要用于安全场景
+     */
+    class Md5
+    {
+    public:
+        static const size_t DIGEST_SIZE = 16;
+        static const size_t BLOCK_SIZE = 64;
+
+        Md5() { reset(); }
+
+        void reset();
+        void update(const void *data, size_t len);
+        void update(std::string_view str) { update(str.data(), str.size()); }
+
+        //结束计算, 摘要写入out; 之后需要reset()才能复用
+        void final(uint8_t *out);
+
+        //结束计算, 返回二进制摘要
+        std::string digest();
+
+        //结束计算, 返回十六进制摘要
+        std::string hexDigest() { return HashUtil::ToHex(digest()); }
+
+        //一次性计算二进制摘要
+        static std::string Hash(std::string_view data);
+
+    private:
+        uint32_t m_state[4];
+        uint8_t m_buffer[BLOCK_SIZE];
+        size_t m_used;
+        uint64_t m_total;
+    };
+
+    //SHA-1, 支持SHA-NI时使用硬件指令
+    class Sha1
+    {
+    public:
+        static const size_t DIGEST_SIZE = 20;
+        static const size_t BLOCK_SIZE = 64;
+
+        Sha1() { reset(); }
+
+        void reset();
+        void update(const void *data, size_t len);
+        void update(std::string_view str) { update(str.data(), str.size()); }
+        void final(uint8_t *out);
+        std::string digest();
+        std::string hexDigest() { return HashUtil::ToHex(digest()); }
+
+        static std::string Hash(std::string_view data);
+
+    private:
+        uint32_t m_state[5];
+        uint8_t m_buffer[BLOCK_SIZE];
+        size_t m_used;
+        uint64_t m_total;
+    };
+
+    //SHA-256, 支持SHA-NI时使用硬件指令
+    class Sha256
+    {
+    public:
+        static const size_t DIGEST_SIZE = 32;
+        static const size_t BLOCK_SIZE = 64;
+
+        Sha256() { reset(); }
+
+        void reset();
+        void update(const void *data, size_t len);
+        void update(std::string_view str) { update(str.data(), str.size()); }
+        void final(uint8_t *out);
+        std::string digest();
+        std::string hexDigest() { return HashUtil::ToHex(digest()); }
+
+        static std::string Hash(std::string_view data);
+
+    private:
+        uint32_t m_state[8];
+        uint8_t m_buffer[BLOCK_SIZE];
+        size_t m_used;
+        uint64_t m_total;
+    };
+
+    /**
+     * @brief HMAC(RFC 2104)
+     * @details H为Md5/Sha1/Sha256, 用于请求签名
+     */
+    template <class H>
+    class Hmac
+    {
+    public:
+        explicit Hmac(std::string_view key)
+        {
+            uint8_t k[H::BLOCK_SIZE] = {0};
+            if (key.size() > H::BLOCK_SIZE)
+            {
+                H h;
+                h.update(key);
+                h.final(k);
+            }
+            else
+            {
+                memcpy(k, key.data(), key.size());
+            }
+            uint8_t pad[H::BLOCK_SIZE];
+            for (size_t i = 0; i < H::BLOCK_SIZE; ++i)
+            {
+                pad[i] = k[i] ^ 0x36;
+            }
+            m_inner.update(pad, sizeof(pad));
+            for (size_t i = 0; i < H::BLOCK_SIZE; ++i)
+            {
+                pad[i] = k[i] ^ 0x5c;
+            }
+            m_outer.update(pad, sizeof(pad));
+        }
+
+        void update(const void *data, size_t len) { m_inner.update(data, len); }
+        void update(std::string_view str) { m_inner.update(str); }
+
+        //结束计算, 返回二进制摘要
+        std::string digest()
+        {
+            uint8_t inner[H::DIGEST_SIZE];
+            m_inner.final(inner);
+            m_outer.update(inner, sizeof(inner));
+            return m_outer.digest();
+        }
+
+        std::string hexDigest() { return HashUtil::ToHex(digest()); }
+
+        static std::string Hash(std::string_view key, std::string_view data)
+        {
+            Hmac h(key);
+            h.update(data);
+            return h.digest();
+        }
+
+    private:
+        H m_inner;
+        H m_outer;
+    };
+
+    typedef Hmac<Sha1> HmacSha1;
+    typedef Hmac<Sha256> HmacSha256;
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,1307 @@
+#include "sylar/util/json_parser.h"
+#include "sylar/util/cpu_util.h"
+#include "sylar/util/string_simd.h"
+#include <string.h>
+#include <charconv>
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SYLAR_JSON_SIMD_X86 1
+#endif
+
+namespace sylar
+{
+
+    namespace
+    {
+        //一个64字节块的字符分类结果, 每一位对应一个字节
+        struct BlockMasks
+        {
+            uint64_t backslash; /// '\\'
+            uint64_t quote;     /// '"'
+            uint64_t op;        /// {}[]:,
+            uint64_t ws;        /// 空格 \t \n \r
+            uint64_t ctrl;      /// 小于0x20的字符
+            uint64_t high;      /// 非ASCII字符
+        };
+
+        void ClassifyScalar(const uint8_t *p, BlockMasks &m)
+        {
+            memset(&m, 0, sizeof(m));
+            for (int i = 0; i < 64; ++i)
+            {
+                uint8_t c = p[i];
+                uint64_t bit = 1ull << i;
+                switch (c)
+                {
+                case '\\':
+                    m.backslash |= bit;
+                    break;
+                case '"':
+                    m.quote |= bit;
+                    break;
+                case '{':
+                case '}':
+                case '[':
+                case ']':
+                case ':':
+                case ',':
+                    m.op |= bit;
+                    break;
+                case ' ':
+                case '\t':
+                case '\n':
+                case '\r':
+                    m.ws |= bit;
+                    break;
+                default:
+                    break;
+                }
+                if (c < 0x20)
+                {
+                    m.ctrl |= bit;
+                }
+                else if (c >= 0x80)
+                {
+                    m.high |= bit;
+                }
+            }
+        }
+
+#ifdef SYLAR_JSON_SIMD_X86
+        void ClassifySSE2(const uint8_t *p, BlockMasks &m)
+        {
+            memset(&m, 0, sizeof(m));
+            const __m128i backslash = _mm_set1_epi8('\\');
+            const __m128i quote = _mm_set1_epi8('"');
+            const __m128i ctrl_max = _mm_set1_epi8(0x1f);
+            for (int i = 0; i < 4; ++i)
+            {
+                __m128i x = _mm_loadu_si128((const __m128i *)(p + i * 16));
+                __m128i op = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('{')), _mm_cmpeq_epi8(x, _mm_set1_epi8('}'))),
+                    _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('[')), _mm_cmpeq_epi8(x, _mm_set1_epi8(']'))));
+                op = _mm_or_si128(op, _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(':')),
+                                                   _mm_cmpeq_epi8(x, _mm_set1_epi8(','))));
+                __m128i ws = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(x, _mm_set1_epi8('\t'))),
+                    _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(x, _mm_set1_epi8('\r'))));
+                int shift = i * 16;
+                m.backslash |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(x, backslash)) << shift;
+                m.quote |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(x, quote)) << shift;
+                m.op |= (uint64_t)(uint16_t)_mm_movemask_epi8(op) << shift;
+                m.ws |= (uint64_t)(uint16_t)_mm_movemask_epi8(ws) << shift;
+                m.ctrl |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(x, ctrl_max), x)) << shift;
+                m.high |= (uint64_t)(uint16_t)_mm_movemask_epi8(x) << shift;
+            }
+        }
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+        void ClassifyAVX2(const uint8_t *p, BlockMasks &m)
+        {
+            memset(&m, 0, sizeof(m));
+            const __m256i backslash = _mm256_set1_epi8('\\');
+            const __m256i quote = _mm256_set1_epi8('"');
+            const __m256i ctrl_max = _mm256_set1_epi8(0x1f);
+            for (int i = 0; i < 2; ++i)
+            {
+                __m256i x = _mm256_loadu_si256((const __m256i *)(p + i * 32));
+                __m256i op = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('{')), _mm256_cmpeq_epi8(x, _mm256_set1_epi8('}'))),
+                    _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('[')), _mm256_cmpeq_epi8(x, _mm256_set1_epi8(']'))));
+                op = _mm256_or_si256(op, _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(':')),
+                                                         _mm256_cmpeq_epi8(x, _mm256_set1_epi8(','))));
+                __m256i ws = _mm256_or_si256(
+                    _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(' ')), _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\t'))),
+                    _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\r'))));
+                int shift = i * 32;
+                m.backslash |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, backslash)) << shift;
+                m.quote |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, quote)) << shift;
+                m.op |= (uint64_t)(uint32_t)_mm256_movemask_epi8(op) << shift;
+                m.ws |= (uint64_t)(uint32_t)_mm256_movemask_epi8(ws) << shift;
+                m.ctrl |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(x, ctrl_max), x)) << shift;
+                m.high |= (uint64_t)(uint32_t)_mm256_movemask_epi8(x) << shift;
+            }
+        }
+
+#pragma GCC pop_options
+
+#endif
+
+        typedef void (*ClassifyFunc)(const uint8_t *, BlockMasks &);
+
+        ClassifyFunc SelectClassify()
+        {
+#ifdef SYLAR_JSON_SIMD_X86
+            if (CpuUtil::HasAVX2())
+            {
+                return ClassifyAVX2;
+            }
+            return ClassifySSE2;
+#else
+            return ClassifyScalar;
+#endif
+        }
+
+        ClassifyFunc GetClassify()
+        {
+            static const ClassifyFunc s_classify = SelectClassify();
+            return s_classify;
+        }
+
+        //前缀异或: 第i位为第0..i位的异或, 用于由引号位置得到字符串区间
+        inline uint64_t PrefixXor(uint64_t x)
+        {
+            x ^= x << 1;
+            x ^= x << 2;
+            x ^= x << 4;
+            x ^= x << 8;
+            x ^= x << 16;
+            x ^= x << 32;
+            return x;
+        }
+
+        /**
+         * @brief 计算被转义的字符
+         * @details 连续反斜杠中, 从偶数位开始的奇数长度序列转义其后一个字符,
+         *          用加法进位一次性处理所有序列; prev_escaped记录跨块的转义
+         */
+        inline uint64_t FindEscaped(uint64_t backslash, uint64_t &prev_escaped)
+        {
+            const uint64_t even_bits = 0x5555555555555555ull;
+            backslash &= ~prev_escaped;
+            uint64_t follows_escape = backslash << 1 | prev_escaped;
+            uint64_t odd_sequence_starts = backslash & ~even_bits & ~follows_escape;
+            uint64_t sequences_starting_on_even_bits;
+            prev_escaped = __builtin_add_overflow(odd_sequence_starts, backslash, &sequences_starting_on_even_bits);
+            uint64_t invert_mask = sequences_starting_on_even_bits << 1;
+            return (even_bits ^ invert_mask) & follows_escape;
+        }
+
+        //校验UTF-8编码(拒绝过长编码, 代理区和超过U+10FFFF的码点)
+        bool ValidateUtf8(const uint8_t *p, size_t len, size_t &error_offset)
+        {
+            size_t i = 0;
+            while (i < len)
+            {
+                uint8_t c = p[i];
+                if (c < 0x80)
+                {
+                    ++i;
+                    continue;
+                }
+                size_t n;
+                uint32_t cp;
+                if ((c & 0xe0) == 0xc0)
+                {
+                    n = 2;
+                    cp = c & 0x1f;
+                }
+                else if ((c & 0xf0) == 0xe0)
+                {
+                    n = 3;
+                    cp = c & 0x0f;
+                }
+                else if ((c & 0xf8) == 0xf0)
+                {
+                    n = 4;
+                    cp = c & 0x07;
+                }
+                else
+                {
+                    error_offset = i;
+                    return false;
+                }
+                if (len - i < n)
+                {
+                    error_offset = i;
+                    return false;
+                }
+                for (size_t j = 1; j < n; ++j)
+                {
+                    if ((p[i + j] & 0xc0) != 0x80)
+                    {
+                        error_offset = i;
+                        return false;
+                    }
+                    cp = (cp << 6) | (p[i + j] & 0x3f);
+                }
+                static const uint32_t s_min[] = {0, 0, 0x80, 0x800, 0x10000};
+                if (cp < s_min[n] || cp > 0x10ffff || (cp >= 0xd800 && cp <= 0xdfff))
+                {
+                    error_offset = i;
+                    return false;
+                }
+                i += n;
+            }
+            return true;
+        }
+
+        inline bool IsScalarChar(char c)
+        {
+            switch (c)
+            {
+            case '{':
+            case '}':
+            case '[':
+            case ']':
+            case ':':
+            case ',':
+            case '"':
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+                return false;
+            default:
+                return true;
+            }
+        }
+
+        //标量(数字/true/false/null)的结束位置
+        inline size_t ScalarEnd(std::string_view json, size_t pos)
+        {
+            while (pos < json.size() && IsScalarChar(json[pos]))
+            {
+                ++pos;
+            }
+            return pos;
+        }
+
+        //字符串结束引号的位置, pos指向开始引号
+        size_t StringEnd(std::string_view json, size_t pos)
+        {
+            const char *begin = json.data();
+            const char *end = begin + json.size();
+            const char *p = begin + pos + 1;
+            while (true)
+            {
+                p = (const char *)memchr(p, '"', end - p);
+                if (!p)
+                {
+                    return json.size();
+                }
+                const char *b = p;
+                while (b[-1] == '\\')
+                {
+                    --b;
+                }
+                if (((p - b) & 1) == 0)
+                {
+                    return p - begin;
+                }
+                ++p;
+            }
+        }
+
+        inline bool IsDigit(char c)
+        {
+            return c >= '0' && c <= '9';
+        }
+
+        //校验JSON数字语法: -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+        bool CheckNumber(const char *p, const char *end)
+        {
+            if (p < end && *p == '-')
+            {
+                ++p;
+            }
+            if (p == end || !IsDigit(*p))
+            {
+                return false;
+            }
+            if (*p == '0')
+            {
+                ++p;
+            }
+            else
+            {
+                while (p < end && IsDigit(*p))
+                {
+                    ++p;
+                }
+            }
+            if (p < end && *p == '.')
+            {
+                ++p;
+                if (p == end || !IsDigit(*p))
+                {
+                    return false;
+                }
+                while (p < end && IsDigit(*p))
+                {
+                    ++p;
+                }
+            }
+            if (p < end && (*p == 'e' || *p == 'E'))
+            {
+                ++p;
+                if (p < end && (*p == '+' || *p == '-'))
+                {
+                    ++p;
+                }
+                if (p == end || !IsDigit(*p))
+                {
+                    return false;
+                }
+                while (p < end && IsDigit(*p))
+                {
+                    ++p;
+                }
+            }
+            return p == end;
+        }
+
+        //校验标量
+        bool CheckScalar(std::string_view json, size_t pos)
+        {
+            std::string_view v = json.substr(pos, ScalarEnd(json, pos) - pos);
+            switch (v[0])
+            {
+            case 't':
+                return v == "true";
+            case 'f':
+                return v == "false";
+            case 'n':
+                return v == "null";
+            default:
+                return CheckNumber(v.data(), v.data() + v.size());
+            }
+        }
+
+        inline int HexValue(char c)
+        {
+            if (c >= '0' && c <= '9')
+            {
+                return c - '0';
+            }
+            c |= 0x20;
+            if (c >= 'a' && c <= 'f')
+            {
+                return c - 'a' + 10;
+            }
+            return -1;
+        }
+
+        bool ReadHex4(const char *p, const char *end, uint32_t &v)
+        {
+            if (end - p < 4)
+            {
+                return false;
+            }
+            v = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                int h = HexValue(p[i]);
+                if (h < 0)
+                {
+                    return false;
+                }
+                v = (v << 4) | h;
+            }
+            return true;
+        }
+
+        void AppendUtf8(std::string &out, uint32_t cp)
+        {
+            if (cp < 0x80)
+            {
+                out.push_back((char)cp);
+            }
+            else if (cp < 0x800)
+            {
+                out.push_back((char)(0xc0 | (cp >> 6)));
+                out.push_back((char)(0x80 | (cp & 0x3f)));
+            }
+            else if (cp < 0x10000)
+            {
+                out.push_back((char)(0xe0 | (cp >> 12)));
+                out.push_back((char)(0x80 | ((cp >> 6) & 0x3f)));
+                out.push_back((char)(0x80 | (cp & 0x3f)));
+            }
+            else
+            {
+                out.push_back((char)(0xf0 | (cp >> 18)));
+                out.push_back((char)(0x80 | ((cp >> 12) & 0x3f)));
+                out.push_back((char)(0x80 | ((cp >> 6) & 0x3f)));
+                out.push_back((char)(0x80 | (cp & 0x3f)));
+            }
+        }
+
+        //处理字符串转义, 结果追加到out
+        bool Unescape(std::string_view raw, std::string &out)
+        {
+            const char *p = raw.data();
+            const char *end = p + raw.size();
+            while (p < end)
+            {
+                const char *bs = (const char *)memchr(p, '\\', end - p);
+                if (!bs)
+                {
+                    out.append(p, end - p);
+                    break;
+                }
+                out.append(p, bs - p);
+                p = bs + 1;
+                if (p == end)
+                {
+                    return false;
+                }
+                char c = *p++;
+                switch (c)
+                {
+                case '"':
+                case '\\':
+                case '/':
+                    out.push_back(c);
+                    break;
+                case 'b':
+                    out.push_back('\b');
+                    break;
+                case 'f':
+                    out.push_back('\f');
+                    break;
+                case 'n':
+                    out.push_back('\n');
+                    break;
+                case 'r':
+                    out.push_back('\r');
+                    break;
+                case 't':
+                    out.push_back('\t');
+                    break;
+                case 'u':
+                {
+                    uint32_t cp;
+                    if (!ReadHex4(p, end, cp))
+                    {
+                        return false;
+                    }
+                    p += 4;
+                    if (cp >= 0xd800 && cp <= 0xdbff)
+                    {
+                        uint32_t lo;
+                        if (end - p < 6 || p[0] != '\\' || p[1] != 'u' || !ReadHex4(p + 2, end, lo) || lo < 0xdc00 || lo > 0xdfff)
+                        {
+                            return false;
+                        }
+                        p += 6;
+                        cp = 0x10000 + ((cp - 0xd800) << 10) + (lo - 0xdc00);
+                    }
+                    else if (cp >= 0xdc00 && cp <= 0xdfff)
+                    {
+                        return false;
+                    }
+                    AppendUtf8(out, cp);
+                    break;
+                }
+                default:
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        //值之后的索引位置(跳过整个容器)
+        inline uint32_t SkipValue(const std::vector<JsonDocument::Token> &tokens, std::string_view json, uint32_t idx)
+        {
+            char c = json[tokens[idx].pos];
+            if (c == '{' || c == '[')
+            {
+                return tokens[idx].match + 1;
+            }
+            return idx + 1;
+        }
+    }
+
+    JsonDocument::JsonDocument()
+        : m_error(nullptr), m_errorOffset(0)
+    {
+    }
+
+    bool JsonDocument::setError(const char *error, size_t offset)
+    {
+        m_error = error;
+        m_errorOffset = offset;
+        m_tokens.clear();
+        return false;
+    }
+
+    bool JsonDocument::parse(std::string_view json)
+    {
+        m_json = json;
+        m_tokens.clear();
+        m_error = nullptr;
+        m_errorOffset = 0;
+        if (json.size() >= UINT32_MAX)
+        {
+            return setError("document too large", 0);
+        }
+        return buildIndex() && checkStructure();
+    }
+
+    bool JsonDocument::buildIndex()
+    {
+        ClassifyFunc classify = GetClassify();
+        const uint8_t *data = (const uint8_t *)m_json.data();
+        size_t len = m_json.size();
+        m_tokens.reserve(len / 8 + 16);
+
+        uint64_t prev_escaped = 0;
+        uint64_t prev_in_string = 0;
+        uint64_t prev_scalar = 0;
+        size_t first_high = len;
+        uint8_t tail[64];
+        BlockMasks m;
+        for (size_t offset = 0; offset < len; offset += 64)
+        {
+            const uint8_t *block = data + offset;
+            if (len - offset < 64)
+            {
+                //尾部不足64字节, 用空格补齐
+                memset(tail, ' ', sizeof(tail));
+                memcpy(tail, block, len - offset);
+                block = tail;
+            }
+            classify(block, m);
+
+            uint64_t escaped = FindEscaped(m.backslash, prev_escaped);
+            uint64_t quote = m.quote & ~escaped;
+            uint64_t in_string = PrefixXor(quote) ^ prev_in_string;
+            prev_in_string = (uint64_t)((int64_t)in_string >> 63);
+
+            if (m.ctrl & in_string)
+            {
+                return setError("control character in string", offset + __builtin_ctzll(m.ctrl & in_string));
+            }
+            if (m.high && first_high == len)
+            {
+                first_high = offset;
+            }
+
+            uint64_t scalar = ~(m.op | m.ws | m.quote | in_string);
+            uint64_t scalar_start = scalar & ~((scalar << 1) | prev_scalar);
+            prev_scalar = scalar >> 63;
+            uint64_t structurals = ((m.op | scalar_start) & ~in_string) | (quote & in_string);
+
+            size_t n = __builtin_popcountll(structurals);
+            size_t base = m_tokens.size();
+            m_tokens.resize(base + n);
+            Token *out = &m_tokens[base];
+            while (structurals)
+            {
+                out->pos = (uint32_t)(offset + __builtin_ctzll(structurals));
+                out->match = 0;
+                ++out;
+                structurals &= structurals - 1;
+            }
+        }
+        if (prev_in_string)
+        {
+            return setError("unclosed string", len);
+        }
+        size_t error_offset = 0;
+        if (first_high < len && !ValidateUtf8(data + first_high, len - first_high, error_offset))
+        {
+            return setError("invalid utf-8", first_high + error_offset);
+        }
+        if (m_tokens.empty())
+        {
+            return setError("empty document", 0);
+        }
+        return true;
+    }
+
+    bool JsonDocument::checkStructure()
+    {
+        enum State
+        {
+            VALUE,
+            FIRST_KEY,
+            KEY,
+            COLON,
+            FIRST_ELEMENT,
+            AFTER_VALUE
+        };
+        State state = VALUE;
+        std::vector<uint32_t> stack;
+        for (uint32_t i = 0; i < m_tokens.size(); ++i)
+        {
+            size_t pos = m_tokens[i].pos;
+            char c = m_json[pos];
+            switch (state)
+            {
+            case FIRST_KEY:
+                if (c == '}')
+                {
+                    m_tokens[stack.back()].match = i;
+                    m_tokens[i].match = stack.back();
+                    stack.pop_back();
+                    state = AFTER_VALUE;
+                    break;
+                }
+                //fallthrough
+            case KEY:
+                if (c != '"')
+                {
+                    return setError("expect object key", pos);
+                }
+                state = COLON;
+                break;
+            case COLON:
+                if (c != ':')
+                {
+                    return setError("expect ':'", pos);
+                }
+                state = VALUE;
+                break;
+            case FIRST_ELEMENT:
+                if (c == ']')
+                {
+                    m_tokens[stack.back()].match = i;
+                    m_tokens[i].match = stack.back();
+                    stack.pop_back();
+                    state = AFTER_VALUE;
+                    break;
+                }
+                //fallthrough
+            case VALUE:
+                if (c == '{' || c == '[')
+                {
+                    if (stack.size() >= MAX_DEPTH)
+                    {
+                        return setError("too deep", pos);
+                    }
+                    stack.push_back(i);
+                    state = c == '{' ? FIRST_KEY : FIRST_ELEMENT;
+                }
+                else if (c == '"')
+                {
+                    state = AFTER_VALUE;
+                }
+                else if (IsScalarChar(c))
+                {
+                    if (!CheckScalar(m_json, pos))
+                    {
+                        return setError("invalid literal", pos);
+                    }
+                    state = AFTER_VALUE;
+                }
+                else
+                {
+                    return setError("expect value", pos);
+                }
+                break;
+            case AFTER_VALUE:
+            {
+                if (stack.empty())
+                {
+                    return setError("trailing content", pos);
+                }
+                bool object = m_json[m_tokens[stack.back()].pos] == '{';
+                if (c == ',')
+                {
+                    state = object ? KEY : VALUE;
+                }
+                else if (c == (object ? '}' : ']'))
+                {
+                    m_tokens[stack.back()].match = i;
+                    m_tokens[i].match = stack.back();
+                    stack.pop_back();
+                }
+                else
+                {
+                    return setError(object ? "expect ',' or '}'" : "expect ',' or ']'", pos);
+                }
+                break;
+            }
+            }
+        }
+        if (state != AFTER_VALUE || !stack.empty())
+        {
+            return setError("unexpected end", m_json.size());
+        }
+        return true;
+    }
+
+    JsonValue JsonDocument::root() const
+    {
+        if (m_tokens.empty())
+        {
+            return JsonValue();
+        }
+        return JsonValue(this, 0);
+    }
+
+    JsonValue::Type JsonValue::getType() const
+    {
+        if (!m_doc)
+        {
+            return INVALID;
+        }
+        switch (m_doc->getJson()[m_doc->getTokens()[m_idx].pos])
+        {
+        case '{':
+            return OBJECT;
+        case '[':
+            return ARRAY;
+        case '"':
+            return STRING;
+        case 't':
+        case 'f':
+            return BOOL;
+        case 'n':
+            return NUL;
+        default:
+            return NUMBER;
+        }
+    }
+
+    JsonValue JsonValue::operator[](std::string_view key) const
+    {
+        if (!isObject())
+        {
+            return JsonValue();
+        }
+        for (auto it = begin(); it != end(); ++it)
+        {
+            if (it.key().stringEquals(key))
+            {
+                return it.value();
+            }
+        }
+        return JsonValue();
+    }
+
+    JsonValue JsonValue::operator[](size_t idx) const
+    {
+        if (!isArray())
+        {
+            return JsonValue();
+        }
+        for (auto it = begin(); it != end(); ++it)
+        {
+            if (idx-- == 0)
+            {
+                return it.value();
+            }
+        }
+        return JsonValue();
+    }
+
+    size_t JsonValue::size() const
+    {
+        Type type = getType();
+        if (type != OBJECT && type != ARRAY)
+        {
+            return 0;
+        }
+        size_t n = 0;
+        for (auto it = begin(); it != end(); ++it)
+        {
+            ++n;
+        }
+        return n;
+    }
+
+    JsonValue::Iterator JsonValue::begin() const
+    {
+        Type type = getType();
+        if (type != OBJECT && type != ARRAY)
+        {
+            return Iterator();
+        }
+        return Iterator(m_doc, m_idx + 1, type == OBJECT);
+    }
+
+    JsonValue::Iterator JsonValue::end() const
+    {
+        Type type = getType();
+        if (type != OBJECT && type != ARRAY)
+        {
+            return Iterator();
+        }
+        return Iterator(m_doc, m_doc->getTokens()[m_idx].match, type == OBJECT);
+    }
+
+    JsonValue JsonValue::Iterator::key() const
+    {
+        return m_object ? JsonValue(m_doc, m_idx) : JsonValue();
+    }
+
+    JsonValue JsonValue::Iterator::value() const
+    {
+        return JsonValue(m_doc, m_object ? m_idx + 2 : m_idx);
+    }
+
+    JsonValue::Iterator &JsonValue::Iterator::operator++()
+    {
+        auto &tokens = m_doc->getTokens();
+        std::string_view json = m_doc->getJson();
+        uint32_t next = SkipValue(tokens, json, m_object ? m_idx + 2 : m_idx);
+        m_idx = json[tokens[next].pos] == ',' ? next + 1 : next;
+        return *this;
+    }
+
+    std::string_view JsonValue::getRaw() const
+    {
+        if (!m_doc)
+        {
+            return std::string_view();
+        }
+        auto &tokens = m_doc->getTokens();
+        std::string_view json = m_doc->getJson();
+        size_t pos = tokens[m_idx].pos;
+        switch (json[pos])
+        {
+        case '{':
+        case '[':
+            return json.substr(pos, tokens[tokens[m_idx].match].pos + 1 - pos);
+        case '"':
+            return json.substr(pos, StringEnd(json, pos) + 1 - pos);
+        default:
+            return json.substr(pos, ScalarEnd(json, pos) - pos);
+        }
+    }
+
+    std::string_view JsonValue::getRawString() const
+    {
+        if (!isString())
+        {
+            return std::string_view();
+        }
+        std::string_view raw = getRaw();
+        return raw.substr(1, raw.size() - 2);
+    }
+
+    bool JsonValue::getString(std::string &v) const
+    {
+        if (!isString())
+        {
+            return false;
+        }
+        v.clear();
+        return Unescape(getRawString(), v);
+    }
+
+    bool JsonValue::stringEquals(std::string_view key) const
+    {
+        std::string_view raw = getRawString();
+        if (raw.find('\\') == std::string_view::npos)
+        {
+            return isString() && raw == key;
+        }
+        std::string v;
+        return getString(v) && v == key;
+    }
+
+    std::string JsonValue::asString(const std::string &default_value) const
+    {
+        std::string v;
+        return getString(v) ? v : default_value;
+    }
+
+    bool JsonValue::getInt64(int64_t &v) const
+    {
+        if (!isNumber())
+        {
+            return false;
+        }
+        std::string_view raw = getRaw();
+        auto rt = std::from_chars(raw.data(), raw.data() + raw.size(), v);
+        return rt.ec == std::errc() && rt.ptr == raw.data() + raw.size();
+    }
+
+    bool JsonValue::getUint64(uint64_t &v) const
+    {
+        if (!isNumber())
+        {
+            return false;
+        }
+        std::string_view raw = getRaw();
+        auto rt = std::from_chars(raw.data(), raw.data() + raw.size(), v);
+        return rt.ec == std::errc() && rt.ptr == raw.data() + raw.size();
+    }
+
+    bool JsonValue::getDouble(double &v) const
+    {
+        if (!isNumber())
+        {
+            return false;
+        }
+        std::string_view raw = getRaw();
+        auto rt = std::from_chars(raw.data(), raw.data() + raw.size(), v);
+        return rt.ec == std::errc() && rt.ptr == raw.data() + raw.size();
+    }
+
+    bool JsonValue::getBool(bool &v) const
+    {
+        if (!isBool())
+        {
+            return false;
+        }
+        v = m_doc->getJson()[m_doc->getTokens()[m_idx].pos] == 't';
+        return true;
+    }
+
+    bool JsonValue::toJson(Json::Value &json) const
+    {
+        switch (getType())
+        {
+        case OBJECT:
+            json = Json::Value(Json::objectValue);
+            for (auto it = begin(); it != end(); ++it)
+            {
+                std::string key;
+                if (!it.key().getString(key) || !it.value().toJson(json[key]))
+                {
+                    return false;
+                }
+            }
+            return true;
+        case ARRAY:
+            json = Json::Value(Json::arrayValue);
+            for (auto it = begin(); it != end(); ++it)
+            {
+                if (!it.value().toJson(json.append(Json::Value())))
+                {
+                    return false;
+                }
+            }
+            return true;
+        case STRING:
+        {
+            std::string v;
+            if (!getString(v))
+            {
+                return false;
+            }
+            json = v;
+            return true;
+        }
+        case NUMBER:
+        {
+            int64_t i64;
+            uint64_t u64;
+            double d;
+            if (getInt64(i64))
+            {
+                json = Json::Value((Json::Int64)i64);
+            }
+            else if (getUint64(u64))
+            {
+                json = Json::Value((Json::UInt64)u64);
+            }
+            else if (getDouble(d))
+            {
+                json = d;
+            }
+            else
+            {
+                return false;
+            }
+            return true;
+        }
+        case BOOL:
+        {
+            bool b = false;
+            getBool(b);
+            json = b;
+            return true;
+        }
+        case NUL:
+            json = Json::Value();
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    JsonStreamReader::JsonStreamReader(std::istream &is, size_t buffer_size)
+        : m_is(is), m_buf(std::max(buffer_size, (size_t)64)), m_pos(0), m_len(0), m_offset(0), m_state(EXPECT_VALUE), m_error(nullptr)
+    {
+    }
+
+    JsonStreamReader::Event JsonStreamReader::setError(const char *error)
+    {
+        m_error = error;
+        return ERROR;
+    }
+
+    bool JsonStreamReader::fill()
+    {
+        if (m_pos < m_len)
+        {
+            return true;
+        }
+        m_offset += m_len;
+        m_pos = m_len = 0;
+        if (!m_is)
+        {
+            return false;
+        }
+        m_is.read(&m_buf[0], m_buf.size());
+        m_len = m_is.gcount();
+        return m_len > 0;
+    }
+
+    int JsonStreamReader::peek()
+    {
+        while (fill())
+        {
+            while (m_pos < m_len)
+            {
+                char c = m_buf[m_pos];
+                if (c != ' ' && c != '\t' && c != '\n' && c != '\r')
+                {
+                    return (uint8_t)c;
+                }
+                ++m_pos;
+            }
+        }
+        return -1;
+    }
+
+    bool JsonStreamReader::readString()
+    {
+        m_value.clear();
+        auto get = [this]() -> int
+        {
+            return fill() ? (uint8_t)m_buf[m_pos++] : -1;
+        };
+        auto get_hex4 = [&get](uint32_t &v) -> bool
+        {
+            v = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                int c = get();
+                int h = c < 0 ? -1 : HexValue((char)c);
+                if (h < 0)
+                {
+                    return false;
+                }
+                v = (v << 4) | h;
+            }
+            return true;
+        };
+        while (true)
+        {
+            if (!fill())
+            {
+                setError("unclosed string");
+                return false;
+            }
+            //一次追加一段不需要处理的字符
+            size_t n = StringSimd::FindJsonEscape(&m_buf[m_pos], m_len - m_pos);
+            m_value.append(&m_buf[m_pos], n);
+            m_pos += n;
+            if (m_pos == m_len)
+            {
+                continue;
+            }
+            char c = m_buf[m_pos++];
+            if (c == '"')
+            {
+                return true;
+            }
+            if (c != '\\')
+            {
+                setError("control character in string");
+                return false;
+            }
+            int e = get();
+            switch (e)
+            {
+            case '"':
+            case '\\':
+            case '/':
+                m_value.push_back((char)e);
+                break;
+            case 'b':
+                m_value.push_back('\b');
+                break;
+            case 'f':
+                m_value.push_back('\f');
+                break;
+            case 'n':
+                m_value.push_back('\n');
+                break;
+            case 'r':
+                m_value.push_back('\r');
+                break;
+            case 't':
+                m_value.push_back('\t');
+                break;
+            case 'u':
+            {
+                uint32_t cp;
+                if (!get_hex4(cp))
+                {
+                    setError("invalid \\u escape");
+                    return false;
+                }
+                if (cp >= 0xd800 && cp <= 0xdbff)
+                {
+                    uint32_t lo;
+                    if (get() != '\\' || get() != 'u' || !get_hex4(lo) || lo < 0xdc00 || lo > 0xdfff)
+                    {
+                        setError("invalid surrogate pair");
+                        return false;
+                    }
+                    cp = 0x10000 + ((cp - 0xd800) << 10) + (lo - 0xdc00);
+                }
+                else if (cp >= 0xdc00 && cp <= 0xdfff)
+                {
+                    setError("invalid surrogate pair");
+                    return false;
+                }
+                AppendUtf8(m_value, cp);
+                break;
+            }
+            default:
+                setError("invalid escape");
+                return false;
+            }
+        }
+    }
+
+    JsonStreamReader::Event JsonStreamReader::readScalar()
+    {
+        m_value.clear();
+        while (fill() && IsScalarChar(m_buf[m_pos]))
+        {
+            if (m_value.size() >= 1024)
+            {
+                return setError("literal too long");
+            }
+            m_value.push_back(m_buf[m_pos++]);
+        }
+        m_state = m_stack.empty() ? FINISHED : EXPECT_COMMA;
+        if (m_value == "true" || m_value == "false")
+        {
+            return BOOL;
+        }
+        if (m_value == "null")
+        {
+            return NUL;
+        }
+        if (!CheckNumber(m_value.data(), m_value.data() + m_value.size()))
+        {
+            return setError("invalid literal");
+        }
+        return NUMBER;
+    }
+
+    JsonStreamReader::Event JsonStreamReader::readValue()
+    {
+        int c = peek();
+        switch (c)
+        {
+        case -1:
+            return setError("unexpected end");
+        case '{':
+        case '[':
+            if (m_stack.size() >= JsonDocument::MAX_DEPTH)
+            {
+                return setError("too deep");
+            }
+            ++m_pos;
+            m_stack.push_back((char)c);
+            m_state = c == '{' ? EXPECT_FIRST_KEY : EXPECT_FIRST_ELEMENT;
+            return c == '{' ? START_OBJECT : START_ARRAY;
+        case '"':
+            ++m_pos;
+            if (!readString())
+            {
+                return ERROR;
+            }
+            m_state = m_stack.empty() ? FINISHED : EXPECT_COMMA;
+            return STRING;
+        default:
+            if (!IsScalarChar((char)c))
+            {
+                return setError("expect value");
+            }
+            return readScalar();
+        }
+    }
+
+    JsonStreamReader::Event JsonStreamReader::next()
+    {
+        if (m_error)
+        {
+            return ERROR;
+        }
+        int c;
+        switch (m_state)
+        {
+        case FINISHED:
+            if (peek() != -1)
+            {
+                return setError("trailing content");
+            }
+            return END;
+        case EXPECT_VALUE:
+            return readValue();
+        case EXPECT_FIRST_ELEMENT:
+            if (peek() != ']')
+            {
+                return readValue();
+            }
+            ++m_pos;
+            m_stack.pop_back();
+            m_state = m_stack.empty() ? FINISHED : EXPECT_COMMA;
+            return END_ARRAY;
+        case EXPECT_FIRST_KEY:
+        case EXPECT_KEY:
+            c = peek();
+            if (c == '}' && m_state == EXPECT_FIRST_KEY)
+            {
+                ++m_pos;
+                m_stack.pop_back();
+                m_state = m_stack.empty() ? FINISHED : EXPECT_COMMA;
+                return END_OBJECT;
+            }
+            if (c != '"')
+            {
+                return setError("expect object key");
+            }
+            ++m_pos;
+            if (!readString())
+            {
+                return ERROR;
+            }
+            if (peek() != ':')
+            {
+                return setError("expect ':'");
+            }
+            ++m_pos;
+            m_state = EXPECT_VALUE;
+            return KEY;
+        case EXPECT_COMMA:
+        {
+            c = peek();
+            bool object = m_stack.back() == '{';
+            if (c == ',')
+            {
+                ++m_pos;
+                m_state = object ? EXPECT_KEY : EXPECT_VALUE;
+                return next();
+            }
+            if (c != (object ? '}' : ']'))
+            {
+                return setError(object ? "expect ',' or '}'" : "expect ',' or ']'");
+            }
+            ++m_pos;
+            m_stack.pop_back();
+            m_state = m_stack.empty() ? FINISHED : EXPECT_COMMA;
+            return object ? END_OBJECT : END_ARRAY;
+        }
+        }
+        return ERROR;
+    }
+
+}
\ No newline at end of file
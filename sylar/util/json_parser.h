@@ -0,0 +1,306 @@
+#ifndef __SYLAR_UTIL_JSON_PARSER_H__
+#define __SYLAR_UTIL_JSON_PARSER_H__
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <istream>
+#include <stdint.h>
+#include <json/json.h>
+
+namespace sylar
+{
+
+    class JsonDocument;
+
+    /**
+     * @brief 按需访问的JSON值
+     * @details 只是文档结构索引上的一个位置, 拷贝代价很小,
+     *          字符串/数字在读取时才解码, 不访问的部分不会被解析。
+     *          生命周期不能超过所属的JsonDocument
+     */
+    class JsonValue
+    {
+    public:
+        enum Type
+        {
+            INVALID = 0,
+            NUL,
+            BOOL,
+            NUMBER,
+            STRING,
+            ARRAY,
+            OBJECT
+        };
+
+        /**
+         * @brief 对象/数组迭代器
+         * @details 对象迭代时key()返回字段名, 数组迭代时key()无效
+         */
+        class Iterator
+        {
+        public:
+            Iterator()
+                : m_doc(nullptr), m_idx(0), m_object(false)
+            {
+            }
+            Iterator(const JsonDocument *doc, uint32_t idx, bool object)
+                : m_doc(doc), m_idx(idx), m_object(object)
+            {
+            }
+
+            //字段名(未解码的原始字符串值)
+            JsonValue key() const;
+
+            //元素值
+            JsonValue value() const;
+
+            Iterator &operator++();
+            bool operator==(const Iterator &o) const { return m_idx == o.m_idx; }
+            bool operator!=(const Iterator &o) const { return m_idx != o.m_idx; }
+
+        private:
+            const JsonDocument *m_doc;
+            uint32_t m_idx; /// 对象指向key, 数组指向值
+            bool m_object;
+        };
+
+    public:
+        JsonValue()
+            : m_doc(nullptr), m_idx(0)
+        {
+        }
+        JsonValue(const JsonDocument *doc, uint32_t idx)
+            : m_doc(doc), m_idx(idx)
+        {
+        }
+
+        //返回类型
+        Type getType() const;
+
+        bool isValid() const { return getType() != INVALID; }
+        bool isNull() const { return getType() == NUL; }
+        bool isBool() const { return getType() == BOOL; }
+        bool isNumber() const { return getType() == NUMBER; }
+        bool isString() const { return getType() == STRING; }
+        bool isArray() const { return getType() == ARRAY; }
+        bool isObject() const { return getType() == OBJECT; }
+
+        /**
+         * @brief 查找对象字段
+         * @details 顺序扫描字段, 跳过嵌套容器是O(1)的
+         * @return 不存在或不是对象时返回无效值
+         */
+        JsonValue operator[](std::string_view key) const;
+        JsonValue operator[](const char *key) const { return (*this)[std::string_view(key)]; }
+
+        //数组下标访问, 越界或不是数组时返回无效值
+        JsonValue operator[](size_t idx) const;
+
+        //是否包含字段
+        bool hasMember(std::string_view key) const { return (*this)[key].isValid(); }
+
+        //对象字段数或数组元素数
+        size_t size() const;
+
+        Iterator begin() const;
+        Iterator end() const;
+
+        //返回原始JSON文本(字符串包含引号, 容器包含括号)
+        std::string_view getRaw() const;
+
+        /**
+         * @brief 字符串值的原始内容(不含引号, 未处理转义)
+         * @return 不是字符串时返回空
+         */
+        std::string_view getRawString() const;
+
+        /**
+         * @brief 字符串值(处理转义)
+         * @return 不是字符串或转义非法时返回false
+         */
+        bool getString(std::string &v) const;
+
+        /**
+         * @brief 数字值
+         * @details 整数超出范围或带小数/指数时返回false
+         */
+        bool getInt64(int64_t &v) const;
+        bool getUint64(uint64_t &v) const;
+        bool getDouble(double &v) const;
+        bool getBool(bool &v) const;
+
+        //返回字符串值, 失败返回默认值
+        std::string asString(const std::string &default_value = "") const;
+
+        //转换为jsoncpp的Json::Value(兼容旧接口)
+        bool toJson(Json::Value &json) const;
+
+        /**
+         * @brief 比较字符串值和key
+         * @details 不含转义时直接比较原始内容, 不分配内存
+         */
+        bool stringEquals(std::string_view key) const;
+
+    private:
+        const JsonDocument *m_doc;
+        uint32_t m_idx;
+    };
+
+    /**
+     * @brief 两阶段JSON解析器
+     * @details
+     *  - 第一阶段: SIMD每次处理64字节, 用位运算找出转义/字符串区间,
+     *    记录所有结构字符({}[]:,)和标量起始位置, 同时检查控制字符和UTF-8
+     *  - 第二阶段: 遍历结构索引校验语法, 并记录括号匹配位置
+     *  之后通过JsonValue按需读取, 不构造DOM树。
+     *  文档不复制输入, 调用者需保证输入在文档生命周期内有效
+     */
+    class JsonDocument
+    {
+    public:
+        typedef std::shared_ptr<JsonDocument> ptr;
+
+        //结构索引项
+        struct Token
+        {
+            uint32_t pos;   /// 在输入中的偏移
+            uint32_t match; /// 括号的匹配位置(索引下标), 其他为0
+        };
+
+        JsonDocument();
+
+        /**
+         * @brief 解析JSON
+         * @param[in] json 输入, 长度不能超过4G
+         * @return 语法正确返回true
+         */
+        bool parse(std::string_view json);
+
+        //根节点, 解析失败时返回无效值
+        JsonValue root() const;
+
+        //错误信息
+        const char *getError() const { return m_error; }
+
+        //错误位置(输入偏移)
+        size_t getErrorOffset() const { return m_errorOffset; }
+
+        //原始输入
+        std::string_view getJson() const { return m_json; }
+
+        //结构索引
+        const std::vector<Token> &getTokens() const { return m_tokens; }
+
+        //最大嵌套深度
+        static const size_t MAX_DEPTH = 1024;
+
+    private:
+        //第一阶段: 构建结构索引
+        bool buildIndex();
+
+        //第二阶段: 语法校验和括号匹配
+        bool checkStructure();
+
+        //设置错误
+        bool setError(const char *error, size_t offset);
+
+    private:
+        std::string_view m_json;
+        std::vector<Token> m_tokens;
+        const char *m_error;
+        size_t m_errorOffset;
+    };
+
+    /**
+     * @brief 流式JSON读取器
+     * @details 从输入流增量读取, 每次返回一个事件, 内存占用只有读缓冲区、
+     *          当前字符串和嵌套栈, 用于处理无法整体载入内存的文档。
+     *          同时校验语法(不校验UTF-8编码), 出错后一直返回ERROR
+     */
+    class JsonStreamReader
+    {
+    public:
+        enum Event
+        {
+            ERROR = 0,    /// 语法错误或读取失败
+            END,          /// 文档结束
+            START_OBJECT, /// {
+            END_OBJECT,   /// }
+            START_ARRAY,  /// [
+            END_ARRAY,    /// ]
+            KEY,          /// 字段名, getValue()为解码后的字符串
+            STRING,       /// 字符串, getValue()为解码后的字符串
+            NUMBER,       /// 数字, getValue()为原始文本
+            BOOL,         /// 布尔, getValue()为"true"或"false"
+            NUL           /// null
+        };
+
+        /**
+         * @brief 构造函数
+         * @param[in] is 输入流
+         * @param[in] buffer_size 读缓冲区大小
+         */
+        JsonStreamReader(std::istream &is, size_t buffer_size = 64 * 1024);
+
+        //读取下一个事件
+        Event next();
+
+        //当前事件的值
+        const std::string &getValue() const { return m_value; }
+
+        //当前嵌套深度
+        size_t getDepth() const { return m_stack.size(); }
+
+        //错误信息
+        const char *getError() const { return m_error; }
+
+        //已读取的字节数(出错时为出错位置)
+        uint64_t getOffset() const { return m_offset + m_pos; }
+
+    private:
+        //读取更多数据, 没有数据返回false
+        bool fill();
+
+        //跳过空白, 返回下一个字符, 没有更多数据返回-1
+        int peek();
+
+        //读取字符串(开始引号已消费)
+        bool readString();
+
+        //读取数字或字面量
+        Event readScalar();
+
+        //读取一个值的开始
+        Event readValue();
+
+        //记录错误
+        Event setError(const char *error);
+
+    private:
+        //解析状态
+        enum State
+        {
+            EXPECT_VALUE,
+            EXPECT_FIRST_KEY,
+            EXPECT_KEY,
+            EXPECT_FIRST_ELEMENT,
+            EXPECT_COMMA,
+            FINISHED
+        };
+
+        std::istream &m_is;
+        std::vector<char> m_buf;
+        size_t m_pos;
+        size_t m_len;
+        uint64_t m_offset; /// m_buf[0]在输入中的偏移
+        std::vector<char> m_stack;
+        std::string m_value;
+        State m_state;
+        const char *m_error;
+    };
+
+}
+
+#endif
\ No newline at end of file
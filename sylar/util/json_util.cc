@@ -0,0 +1,399 @@
+#include "sylar/util/json_util.h"
+#include "sylar/util/string_simd.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <limits>
+
+namespace sylar
+{
+
+    JsonUtil::JsonUtil()
+    {
+    }
+
+    JsonUtil::~JsonUtil()
+    {
+    }
+
+    //写出单个需要转义的字符, 返回写入的字节数
+    static size_t WriteEscaped(char *out, unsigned char c)
+    {
+        static const char s_hex[] = "0123456789abcdef";
+        out[0] = '\\';
+        switch (c)
+        {
+        case '"':
+            out[1] = '"';
+            return 2;
+        case '\\':
+            out[1] = '\\';
+            return 2;
+        case '\b':
+            out[1] = 'b';
+            return 2;
+        case '\f':
+            out[1] = 'f';
+            return 2;
+        case '\n':
+            out[1] = 'n';
+            return 2;
+        case '\r':
+            out[1] = 'r';
+            return 2;
+        case '\t':
+            out[1] = 't';
+            return 2;
+        default:
+            out[1] = 'u';
+            out[2] = '0';
+            out[3] = '0';
+            out[4] = s_hex[c >> 4];
+            out[5] = s_hex[c & 0xf];
+            return 6;
+        }
+    }
+
+    bool JsonUtil::NeedEscape(const std::string &v)
+    {
+        return StringSimd::FindJsonEscape(v.data(), v.size()) != v.size();
+    }
+
+    std::string JsonUtil::Escape(const std::string &v)
+    {
+        size_t size = EscapeSize(v);
+        if (size == v.size())
+        {
+            return v;
+        }
+        std::string rt;
+        rt.resize(size);
+        EscapeTo(&rt[0], v);
+        return rt;
+    }
+
+    size_t JsonUtil::EscapeSize(std::string_view v)
+    {
+        return StringSimd::JsonEscapeSize(v.data(), v.size());
+    }
+
+    size_t JsonUtil::EscapeTo(char *out, std::string_view v)
+    {
+        const char *data = v.data();
+        size_t len = v.size();
+        char *w = out;
+        size_t pos = 0;
+        while (pos < len)
+        {
+            size_t n = StringSimd::FindJsonEscape(data + pos, len - pos);
+            memcpy(w, data + pos, n);
+            w += n;
+            pos += n;
+            if (pos < len)
+            {
+                w += WriteEscaped(w, data[pos++]);
+            }
+        }
+        return w - out;
+    }
+
+    void JsonUtil::EscapeAppend(std::string &out, std::string_view v)
+    {
+        const char *data = v.data();
+        size_t len = v.size();
+        size_t n = StringSimd::FindJsonEscape(data, len);
+        if (n == len)
+        {
+            out.append(data, len);
+            return;
+        }
+        //先按少量转义预留, 不够时成倍扩容, 最后截断到实际长度
+        size_t used = out.size();
+        out.resize(used + len + len / 8 + 16);
+        size_t pos = 0;
+        while (true)
+        {
+            if (out.size() - used < n + 6)
+            {
+                out.resize(std::max(out.size() * 2, used + n + 6 + (len - pos)));
+            }
+            memcpy(&out[used], data + pos, n);
+            used += n;
+            pos += n;
+            if (pos >= len)
+            {
+                break;
+            }
+            used += WriteEscaped(&out[used], data[pos++]);
+            n = StringSimd::FindJsonEscape(data + pos, len - pos);
+        }
+        out.resize(used);
+    }
+
+    std::string JsonUtil::GetString(const Json::Value &json, const std::string &name, const std::string &default_value)
+    {
+        if (!json.isMember(name))
+        {
+            return default_value;
+        }
+        auto &v = json[name];
+        if (v.isString())
+        {
+            return v.asString();
+        }
+        return default_value;
+    }
+
+    double JsonUtil::GetDouble(const Json::Value &json, const std::string &name, double default_value)
+    {
+        if (!json.isMember(name))
+        {
+            return default_value;
+        }
+        auto &v = json[name];
+        if (v.isDouble())
+        {
+            return v.asDouble();
+        }
+        else if (v.isString())
+        {
+            return atof(v.asString().c_str());
+        }
+        return default_value;
+    }
+
+    int32_t JsonUtil::GetInt32(const Json::Value &json, const std::string &name, int32_t default_value)
+    {
+        if (!json.isMember(name))
+        {
+            return default_value;
+        }
+        auto &v = json[name];
+        if (v.isInt())
+        {
+            return v.asInt();
+        }
+        else if (v.isString())
+        {
+            return atoi(v.asString().c_str());
+        }
+        return default_value;
+    }
+
+    uint32_t JsonUtil::GetUint32(const Json::Value &json, const std::string &name, uint32_t default_value)
+    {
+        if (!json.isMember(name))
+        {
+            return default_value;
+        }
+        auto &v = json[name];
+        if (v.isUInt())
+        {
+            return v.asUInt();
+        }
+        else if (v.isString())
+        {
+            return atoi(v.asString().c_str());
+        }
+        return default_value;
+    }
+
+    int64_t JsonUtil::GetInt64(const Json::Value &json, const std::string &name, int64_t default_value)
+    {
+        if (!json.isMember(name))
+        {
+            return default_value;
+        }
+        auto &v = json[name];
+        if (v.isInt64())
+        {
+            return v.asInt64();
+        }
+        else if (v.isString())
+        {
+            return atoll(v.asString().c_str());
+        }
+        return default_value;
+    }
+
+    uint64_t JsonUtil::GetUint64(const Json::Value &json, const std::string &name, uint64_t default_value)
+    {
+        if (!json.isMember(name))
+        {
+            return default_value;
+        }
+        auto &v = json[name];
+        if (v.isUInt64())
+        {
+            return v.asUInt64();
+        }
+        else if (v.isString())
+        {
+            return strtoull(v.asString().c_str(), nullptr, 10);
+        }
+        return default_value;
+    }
+
+    bool JsonUtil::FromString(Json::Value &json, const std::string &v)
+    {
+        JsonDocument doc;
+        if (!doc.parse(v))
+        {
+            return false;
+        }
+        return doc.root().toJson(json);
+    }
+
+    std::string JsonUtil::ToString(const Json::Value &json)
+    {
+        std::string rt;
+        ToString(rt, json);
+        return rt;
+    }
+
+    void JsonUtil::ToString(std::string &out, const Json::Value &json)
+    {
+        JsonWriter w(out);
+        w.value(json);
+    }
+
+    bool JsonUtil::FromString(JsonDocument &doc, std::string_view v)
+    {
+        return doc.parse(v);
+    }
+
+    /**
+     * @brief 取整数值, 和jsoncpp的isInt()/isInt64()等一致
+     * @details 整数直接取; 小数或指数形式的数字在值为整数且在T的范围内时也接受, 如3.0, 1e3
+     */
+    template <class T>
+    static bool GetIntegral(const JsonValue &v, T &out)
+    {
+        if (std::numeric_limits<T>::is_signed)
+        {
+            int64_t i;
+            if (v.getInt64(i))
+            {
+                if (i < (int64_t)std::numeric_limits<T>::min() || i > (int64_t)std::numeric_limits<T>::max())
+                {
+                    return false;
+                }
+                out = (T)i;
+                return true;
+            }
+        }
+        else
+        {
+            uint64_t u;
+            if (v.getUint64(u))
+            {
+                if (u > (uint64_t)std::numeric_limits<T>::max())
+                {
+                    return false;
+                }
+                out = (T)u;
+                return true;
+            }
+        }
+        double d;
+        if (!v.isNumber() || !v.getDouble(d) || d != std::trunc(d))
+        {
+            return false;
+        }
+        //[min, 2^digits)在double中可精确表示
+        if (!(d >= (double)std::numeric_limits<T>::min() && d < std::ldexp(1.0, std::numeric_limits<T>::digits)))
+        {
+            return false;
+        }
+        out = (T)d;
+        return true;
+    }
+
+    std::string JsonUtil::GetString(const JsonValue &json, const std::string &name, const std::string &default_value)
+    {
+        JsonValue v = json[name];
+        std::string rt;
+        if (v.getString(rt))
+        {
+            return rt;
+        }
+        return default_value;
+    }
+
+    double JsonUtil::GetDouble(const JsonValue &json, const std::string &name, double default_value)
+    {
+        JsonValue v = json[name];
+        double rt;
+        if (v.getDouble(rt))
+        {
+            return rt;
+        }
+        else if (v.isString())
+        {
+            return atof(v.asString().c_str());
+        }
+        return default_value;
+    }
+
+    int32_t JsonUtil::GetInt32(const JsonValue &json, const std::string &name, int32_t default_value)
+    {
+        JsonValue v = json[name];
+        int32_t rt;
+        if (GetIntegral(v, rt))
+        {
+            return rt;
+        }
+        else if (v.isString())
+        {
+            return atoi(v.asString().c_str());
+        }
+        return default_value;
+    }
+
+    uint32_t JsonUtil::GetUint32(const JsonValue &json, const std::string &name, uint32_t default_value)
+    {
+        JsonValue v = json[name];
+        uint32_t rt;
+        if (GetIntegral(v, rt))
+        {
+            return rt;
+        }
+        else if (v.isString())
+        {
+            return atoi(v.asString().c_str());
+        }
+        return default_value;
+    }
+
+    int64_t JsonUtil::GetInt64(const JsonValue &json, const std::string &name, int64_t default_value)
+    {
+        JsonValue v = json[name];
+        int64_t rt;
+        if (GetIntegral(v, rt))
+        {
+            return rt;
+        }
+        else if (v.isString())
+        {
+            return atoll(v.asString().c_str());
+        }
+        return default_value;
+    }
+
+    uint64_t JsonUtil::GetUint64(const JsonValue &json, const std::string &name, uint64_t default_value)
+    {
+        JsonValue v = json[name];
+        uint64_t rt;
+        if (GetIntegral(v, rt))
+        {
+            return rt;
+        }
+        else if (v.isString())
+        {
+            return strtoull(v.asString().c_str(), nullptr, 10);
+        }
+        return default_value;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#ifndef __SYLAR_UTIL_JSON_UTIL_H_
+#define __SYLAR_UTIL_JSON_UTIL_H_
+
+#include <string>
+#include <iostream>
+#include <string_view>
+#include <json/json.h>
+#include "json_parser.h"
+#include "json_writer.h"
+
+namespace sylar
+{
+
+    class JsonUtil
+    {
+    private:
+        /* data */
+    public:
+        JsonUtil(/* args */);
+        ~JsonUtil();
+        static bool NeedEscape(const std::string &v);
+        static std::string Escape(const std::string &v);
+
+        /**
+         * @brief 转义后的精确长度(不含两端引号)
+         * @details 一次SIMD扫描, 用于序列化前预先分配缓冲区
+         */
+        static size_t EscapeSize(std::string_view v);
+
+        /**
+         * @brief 转义到调用者提供的缓冲区
+         * @param[out] out 至少EscapeSize(v)字节
+         * @return 写入的字节数
+         */
+        static size_t EscapeTo(char *out, std::string_view v);
+
+        /**
+         * @brief 转义后追加到out(不含两端引号)
+         * @details 只扫描一次输入, 缓冲区按需成倍扩容
+         */
+        static void EscapeAppend(std::string &out, std::string_view v);
+        static std::string GetString(const Json::Value &json, const std::string &name, const std::string &default_value = "");
+        static double GetDouble(const Json::Value &json, const std::string &name, double default_value = 0);
+        static int32_t GetInt32(const Json::Value &json, const std::string &name, int32_t default_value = 0);
+        static uint32_t GetUint32(const Json::Value &json, const std::string &name, uint32_t default_value = 0);
+        static int64_t GetInt64(const Json::Value &json, const std::string &name, int64_t default_value = 0);
+        static uint64_t GetUint64(const Json::Value &json, const std::string &name, uint64_t default_value = 0);
+        static bool FromString(Json::Value &json, const std::string &v);
+        static std::string ToString(const Json::Value &json);
+
+        /**
+         * @brief 按需解析(不构造Json::Value)
+         * @details doc只索引v, v必须在doc使用期间有效
+         */
+        static bool FromString(JsonDocument &doc, std::string_view v);
+
+        /**
+         * @brief 按需读取字段, 规则和Json::Value版本一致
+         * @details 整数getter接受值为整数且不越界的小数(3.0, 1e3), 同isInt()/isInt64();
+         *          字段是字符串时用atoi/atoll/strtoull/atof转换, 同样只取前缀且不检查溢出;
+         *          其他类型或字段不存在时返回默认值
+         */
+        static std::string GetString(const JsonValue &json, const std::string &name, const std::string &default_value = "");
+        static double GetDouble(const JsonValue &json, const std::string &name, double default_value = 0);
+        static int32_t GetInt32(const JsonValue &json, const std::string &name, int32_t default_value = 0);
+        static uint32_t GetUint32(const JsonValue &json, const std::string &name, uint32_t default_value = 0);
+        static int64_t GetInt64(const JsonValue &json, const std::string &name, int64_t default_value = 0);
+        static uint64_t GetUint64(const JsonValue &json, const std::string &name, uint64_t default_value = 0);
+
+        //序列化追加到out, 不产生临时字符串
+        static void ToString(std::string &out, const Json::Value &json);
+    };
+}
+
+#endif
\ No newline at end of file
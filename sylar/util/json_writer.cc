@@ -0,0 +1,216 @@
+#include "sylar/util/json_writer.h"
+#include "sylar/util/json_parser.h"
+#include "sylar/util/json_util.h"
+#include <charconv>
+#include <cmath>
+#include <algorithm>
+
+namespace sylar
+{
+
+    JsonWriter::JsonWriter(std::string &out)
+        : m_out(out), m_afterKey(false), m_hasValue(false)
+    {
+    }
+
+    void JsonWriter::prefix()
+    {
+        if (m_afterKey)
+        {
+            m_afterKey = false;
+            return;
+        }
+        if (!m_stack.empty())
+        {
+            if (m_stack.back())
+            {
+                m_stack.back() = false;
+            }
+            else
+            {
+                m_out.push_back(',');
+            }
+        }
+        m_hasValue = true;
+    }
+
+    JsonWriter &JsonWriter::startObject()
+    {
+        prefix();
+        m_out.push_back('{');
+        m_stack.push_back(true);
+        return *this;
+    }
+
+    JsonWriter &JsonWriter::endObject()
+    {
+        m_out.push_back('}');
+        m_stack.pop_back();
+        return *this;
+    }
+
+    JsonWriter &JsonWriter::startArray()
+    {
+        prefix();
+        m_out.push_back('[');
+        m_stack.push_back(true);
+        return *this;
+    }
+
+    JsonWriter &JsonWriter::endArray()
+    {
+        m_out.push_back(']');
+        m_stack.pop_back();
+        return *this;
+    }
+
+    JsonWriter &JsonWriter::key(std::string_view k)
+    {
+        prefix();
+        writeString(k);
+        m_out.push_back(':');
+        m_afterKey = true;
+        return *this;
+    }
+
+    JsonWriter &JsonWriter::value(std::string_view v)
+    {
+        prefix();
+        writeString(v);
+        return *this;
+    }
+
+    JsonWriter &JsonWriter::value(int64_t v)
+    {
+        prefix();
+        char buf[24];
+        auto rt = std::to_chars(buf, buf + sizeof(buf), v);
+        m_out.append(buf, rt.ptr - buf);
+        return *this;
+    }
+
+    JsonWriter &JsonWriter::value(uint64_t v)
+    {
+        prefix();
+        char buf[24];
+        auto rt = std::to_chars(buf, buf + sizeof(buf), v);
+        m_out.append(buf, rt.ptr - buf);
+        return *this;
+    }
+
+    //最短的可精确还原的表示, 整数值补".0"以保留浮点类型
+    template <class T>
+    static void AppendFloat(std::string &out, T v)
+    {
+        char buf[32];
+        auto rt = std::to_chars(buf, buf + sizeof(buf), v);
+        out.append(buf, rt.ptr - buf);
+        if (std::find_if(buf, rt.ptr, [](char c)
+                         { return c == '.' || c == 'e'; }) == rt.ptr)
+        {
+            out.append(".0");
+        }
+    }
+
+    JsonWriter &JsonWriter::value(double v)
+    {
+        if (!std::isfinite(v))
+        {
+            return null();
+        }
+        prefix();
+        AppendFloat(m_out, v);
+        return *this;
+    }
+
+    JsonWriter &JsonWriter::value(float v)
+    {
+        if (!std::isfinite(v))
+        {
+            return null();
+        }
+        prefix();
+        AppendFloat(m_out, v);
+        return *this;
+    }
+
+    JsonWriter &JsonWriter::value(bool v)
+    {
+        prefix();
+        m_out.append(v ? "true" : "false");
+        return *this;
+    }
+
+    JsonWriter &JsonWriter::null()
+    {
+        prefix();
+        m_out.append("null");
+        return *this;
+    }
+
+    JsonWriter &JsonWriter::raw(std::string_view json)
+    {
+        prefix();
+        m_out.append(json.data(), json.size());
+        return *this;
+    }
+
+    JsonWriter &JsonWriter::value(const JsonValue &v)
+    {
+        if (!v.isValid())
+        {
+            return null();
+        }
+        return raw(v.getRaw());
+    }
+
+    JsonWriter &JsonWriter::value(const Json::Value &v)
+    {
+        switch (v.type())
+        {
+        case Json::nullValue:
+            return null();
+        case Json::intValue:
+            return value((int64_t)v.asInt64());
+        case Json::uintValue:
+            return value((uint64_t)v.asUInt64());
+        case Json::realValue:
+            return value(v.asDouble());
+        case Json::booleanValue:
+            return value(v.asBool());
+        case Json::stringValue:
+        {
+            const char *begin = nullptr;
+            const char *end = nullptr;
+            v.getString(&begin, &end);
+            return value(std::string_view(begin, end - begin));
+        }
+        case Json::arrayValue:
+            startArray();
+            for (Json::ArrayIndex i = 0; i < v.size(); ++i)
+            {
+                value(v[i]);
+            }
+            return endArray();
+        case Json::objectValue:
+            startObject();
+            for (auto it = v.begin(); it != v.end(); ++it)
+            {
+                const char *end = nullptr;
+                const char *begin = it.memberName(&end);
+                key(std::string_view(begin, end - begin));
+                value(*it);
+            }
+            return endObject();
+        }
+        return *this;
+    }
+
+    void JsonWriter::writeString(std::string_view v)
+    {
+        m_out.push_back('"');
+        JsonUtil::EscapeAppend(m_out, v);
+        m_out.push_back('"');
+    }
+
+}
\ No newline at end of file
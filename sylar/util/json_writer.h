@@ -0,0 +1,90 @@
+#ifndef __SYLAR_UTIL_JSON_WRITER_H__
+#define __SYLAR_UTIL_JSON_WRITER_H__
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <stdint.h>
+#include <json/json.h>
+
+namespace sylar
+{
+
+    class JsonValue;
+
+    /**
+     * @brief 流式JSON输出
+     * @details 直接追加到调用者提供的字符串, 不构造中间树,
+     *          自动处理逗号和冒号, 输出紧凑格式
+     *
+     *     std::string out;
+     *     JsonWriter w(out);
+     *     w.startObject().key("id").value(100).key("tags").startArray()
+     *      .value("a").value("b").endArray().endObject();
+     */
+    class JsonWriter
+    {
+    public:
+        /**
+         * @brief 构造函数
+         * @param[out] out 输出缓冲区, 内容追加在末尾
+         */
+        JsonWriter(std::string &out);
+
+        JsonWriter &startObject();
+        JsonWriter &endObject();
+        JsonWriter &startArray();
+        JsonWriter &endArray();
+
+        //写对象字段名, 之后必须写一个值
+        JsonWriter &key(std::string_view k);
+
+        JsonWriter &value(std::string_view v);
+        JsonWriter &value(const char *v) { return value(std::string_view(v)); }
+        JsonWriter &value(const std::string &v) { return value(std::string_view(v)); }
+        JsonWriter &value(int32_t v) { return value((int64_t)v); }
+        JsonWriter &value(uint32_t v) { return value((uint64_t)v); }
+        JsonWriter &value(int64_t v);
+        JsonWriter &value(uint64_t v);
+        //NaN和无穷输出为null
+        JsonWriter &value(double v);
+        //按float精度输出最短表示, 避免0.1f输出为0.10000000149011612
+        JsonWriter &value(float v);
+        JsonWriter &value(bool v);
+        JsonWriter &null();
+
+        //写jsoncpp的值(兼容旧接口)
+        JsonWriter &value(const Json::Value &v);
+
+        //原样复制按需解析得到的值, 不重新编码
+        JsonWriter &value(const JsonValue &v);
+
+        /**
+         * @brief 写入已经编码好的JSON文本
+         * @details 不做校验, 调用者保证其合法
+         */
+        JsonWriter &raw(std::string_view json);
+
+        //返回输出缓冲区
+        std::string &getOutput() { return m_out; }
+
+        //所有容器是否都已关闭
+        bool isComplete() const { return m_stack.empty() && m_hasValue; }
+
+    private:
+        //写值之前的分隔符
+        void prefix();
+
+        //写转义后的字符串(含引号)
+        void writeString(std::string_view v);
+
+    private:
+        std::string &m_out;
+        std::vector<bool> m_stack; /// 每层容器是否还没有元素
+        bool m_afterKey;
+        bool m_hasValue;
+    };
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,393 @@
+#include "sylar/util/mapped_file.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <algorithm>
+
+namespace sylar
+{
+
+    //透明大页大小
+    static const size_t s_huge_page_size = 2 * 1024 * 1024;
+
+    //预取线程每次发起WILLNEED的粒度
+    static const size_t s_prefetch_chunk = 2 * 1024 * 1024;
+
+    static size_t PageSize()
+    {
+        static const size_t s_page_size = sysconf(_SC_PAGESIZE);
+        return s_page_size;
+    }
+
+    MappedFile::MappedFile()
+    {
+    }
+
+    MappedFile::~MappedFile()
+    {
+        close();
+    }
+
+    MappedFile::ptr MappedFile::Open(const std::string &path, int flags, size_t size)
+    {
+        ptr file(new MappedFile);
+        if (!file->open(path, flags, size))
+        {
+            return nullptr;
+        }
+        return file;
+    }
+
+    bool MappedFile::open(const std::string &path, int flags, size_t size)
+    {
+        close();
+        int oflags = O_CLOEXEC | ((flags & WRITE) ? O_RDWR : O_RDONLY);
+        if ((flags & WRITE) && (flags & CREATE))
+        {
+            oflags |= O_CREAT;
+        }
+        int fd = ::open(path.c_str(), oflags, 0644);
+        if (fd < 0)
+        {
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+        {
+            int err = errno;
+            ::close(fd);
+            errno = err;
+            return false;
+        }
+        size_t file_size = st.st_size;
+        if ((flags & WRITE) && size && size != file_size)
+        {
+            if (ftruncate(fd, size) != 0)
+            {
+                int err = errno;
+                ::close(fd);
+                errno = err;
+                return false;
+            }
+            file_size = size;
+        }
+
+        m_fd = fd;
+        m_flags = flags;
+        m_path = path;
+        if (!map(file_size))
+        {
+            int err = errno;
+            ::close(m_fd);
+            m_fd = -1;
+            errno = err;
+            return false;
+        }
+        return true;
+    }
+
+    bool MappedFile::map(size_t size)
+    {
+        m_data = nullptr;
+        m_size = 0;
+        //长度为0的映射会失败, 空文件只保留fd
+        if (size == 0)
+        {
+            return true;
+        }
+        int prot = PROT_READ | ((m_flags & WRITE) ? PROT_WRITE : 0);
+        int mflags = MAP_SHARED | ((m_flags & POPULATE) ? MAP_POPULATE : 0);
+        void *addr = MAP_FAILED;
+        if ((m_flags & HUGE_ALIGN) && size >= s_huge_page_size)
+        {
+            //先保留多出一个大页的地址空间, 在其中对齐的位置上覆盖映射文件
+            size_t reserve = size + s_huge_page_size;
+            void *base = mmap(nullptr, reserve, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (base != MAP_FAILED)
+            {
+                uintptr_t aligned = ((uintptr_t)base + s_huge_page_size - 1) & ~(uintptr_t)(s_huge_page_size - 1);
+                addr = mmap((void *)aligned, size, prot, mflags | MAP_FIXED, m_fd, 0);
+                if (addr == MAP_FAILED)
+                {
+                    munmap(base, reserve);
+                }
+                else
+                {
+                    size_t map_end = aligned + ((size + PageSize() - 1) & ~(PageSize() - 1));
+                    if (aligned > (uintptr_t)base)
+                    {
+                        munmap(base, aligned - (uintptr_t)base);
+                    }
+                    if ((uintptr_t)base + reserve > map_end)
+                    {
+                        munmap((void *)map_end, (uintptr_t)base + reserve - map_end);
+                    }
+                }
+            }
+        }
+        if (addr == MAP_FAILED)
+        {
+            addr = mmap(nullptr, size, prot, mflags, m_fd, 0);
+            if (addr == MAP_FAILED)
+            {
+                return false;
+            }
+        }
+        m_data = (char *)addr;
+        m_size = size;
+        return true;
+    }
+
+    void MappedFile::unmap()
+    {
+        if (m_data)
+        {
+            munmap(m_data, m_size);
+            m_data = nullptr;
+            m_size = 0;
+        }
+    }
+
+    void MappedFile::close()
+    {
+        stopPrefetch();
+        unmap();
+        if (m_fd >= 0)
+        {
+            ::close(m_fd);
+            m_fd = -1;
+        }
+        m_path.clear();
+        m_flags = READ;
+    }
+
+    std::string_view MappedFile::view(size_t offset, size_t len) const
+    {
+        if (offset >= m_size)
+        {
+            return std::string_view();
+        }
+        return std::string_view(m_data + offset, std::min(len, m_size - offset));
+    }
+
+    bool MappedFile::advise(Advice advice, size_t offset, size_t len)
+    {
+        if (!m_data || offset >= m_size)
+        {
+            return false;
+        }
+        if (len == 0 || len > m_size - offset)
+        {
+            len = m_size - offset;
+        }
+        //madvise要求起始地址页对齐
+        size_t begin = offset & ~(PageSize() - 1);
+        len += offset - begin;
+
+        int adv = MADV_NORMAL;
+        switch (advice)
+        {
+        case NORMAL:
+            adv = MADV_NORMAL;
+            break;
+        case SEQUENTIAL:
+            adv = MADV_SEQUENTIAL;
+            break;
+        case RANDOM:
+            adv = MADV_RANDOM;
+            break;
+        case WILLNEED:
+            adv = MADV_WILLNEED;
+            break;
+        case DONTNEED:
+            adv = MADV_DONTNEED;
+            break;
+        case HUGEPAGE:
+#ifdef MADV_HUGEPAGE
+            adv = MADV_HUGEPAGE;
+            break;
+#else
+            errno = EINVAL;
+            return false;
+#endif
+        }
+        return madvise(m_data + begin, len, adv) == 0;
+    }
+
+    bool MappedFile::sync(bool async, size_t offset, size_t len)
+    {
+        if (!m_data || !isWritable())
+        {
+            return m_fd >= 0;
+        }
+        if (offset >= m_size)
+        {
+            return true;
+        }
+        if (len == 0 || len > m_size - offset)
+        {
+            len = m_size - offset;
+        }
+        size_t begin = offset & ~(PageSize() - 1);
+        len += offset - begin;
+        return msync(m_data + begin, len, async ? MS_ASYNC : MS_SYNC) == 0;
+    }
+
+    bool MappedFile::resize(size_t size)
+    {
+        if (m_fd < 0 || !isWritable())
+        {
+            errno = EBADF;
+            return false;
+        }
+        stopPrefetch();
+        if (ftruncate(m_fd, size) != 0)
+        {
+            return false;
+        }
+        if (m_data && size)
+        {
+            void *addr = mremap(m_data, m_size, size, MREMAP_MAYMOVE);
+            if (addr == MAP_FAILED)
+            {
+                return false;
+            }
+            m_data = (char *)addr;
+            m_size = size;
+            return true;
+        }
+        unmap();
+        return map(size);
+    }
+
+    bool MappedFile::startPrefetch(size_t window)
+    {
+        if (!m_data)
+        {
+            return false;
+        }
+        if (m_prefetchThread.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_prefetchDone)
+                {
+                    return false;
+                }
+            }
+            //上一次预取已经完成, 回收线程后重新启动
+            m_prefetchThread.join();
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopPrefetch = false;
+            m_prefetchDone = false;
+            m_readPos = 0;
+        }
+        m_prefetchThread = std::thread(&MappedFile::prefetchLoop, this, window);
+        return true;
+    }
+
+    void MappedFile::stopPrefetch()
+    {
+        if (!m_prefetchThread.joinable())
+        {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopPrefetch = true;
+        }
+        m_cond.notify_all();
+        m_prefetchThread.join();
+    }
+
+    void MappedFile::consume(size_t pos)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (pos <= m_readPos)
+            {
+                return;
+            }
+            m_readPos = pos;
+        }
+        m_cond.notify_one();
+    }
+
+    void MappedFile::prefetchLoop(size_t window)
+    {
+        size_t done = 0;
+        while (done < m_size)
+        {
+            size_t target = m_size;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                if (window)
+                {
+                    //已经领先一个窗口, 等待读取方推进
+                    while (!m_stopPrefetch && done >= std::min(m_size, m_readPos + window))
+                    {
+                        m_cond.wait(lock);
+                    }
+                    target = std::min(m_size, m_readPos + window);
+                }
+                if (m_stopPrefetch)
+                {
+                    return;
+                }
+            }
+            size_t len = std::min(target - done, s_prefetch_chunk);
+            advise(WILLNEED, done, len);
+            //WILLNEED只是发起预读, 逐页访问确保读入完成后才推进
+            const size_t page = PageSize();
+            volatile char sink = 0;
+            for (size_t off = done; off < done + len; off += page)
+            {
+                sink = m_data[off];
+            }
+            (void)sink;
+            done += len;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_prefetchDone = true;
+    }
+
+    ViewStreamBuf::ViewStreamBuf(std::string_view view)
+    {
+        char *p = const_cast<char *>(view.data());
+        setg(p, p, p + view.size());
+    }
+
+    ViewStreamBuf::pos_type ViewStreamBuf::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+    {
+        if (!(which & std::ios_base::in))
+        {
+            return pos_type(off_type(-1));
+        }
+        off_type base = 0;
+        if (dir == std::ios_base::cur)
+        {
+            base = gptr() - eback();
+        }
+        else if (dir == std::ios_base::end)
+        {
+            base = egptr() - eback();
+        }
+        off_type pos = base + off;
+        if (pos < 0 || pos > egptr() - eback())
+        {
+            return pos_type(off_type(-1));
+        }
+        setg(eback(), eback() + pos, egptr());
+        return pos_type(pos);
+    }
+
+    ViewStreamBuf::pos_type ViewStreamBuf::seekpos(pos_type pos, std::ios_base::openmode which)
+    {
+        return seekoff(off_type(pos), std::ios_base::beg, which);
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,161 @@
+#ifndef __SYLAR_UTIL_MAPPED_FILE_H__
+#define __SYLAR_UTIL_MAPPED_FILE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <thread>
+#include "sylar/noncopyable.h"
+
+namespace sylar
+{
+
+    /**
+     * @brief 内存映射文件
+     * @details 整个文件映射到进程地址空间, 通过view()原地解析, 不经过iostream拷贝。
+     *          只读映射和读写映射都是MAP_SHARED, 读写映射的修改直接落到页缓存,
+     *          sync()或close()后持久化。
+     *          可选的后台预取线程对大文件顺序读取提前发起MADV_WILLNEED,
+     *          读取方通过consume()报告进度, 预取始终领先一个窗口。
+     *          映射期间文件被其他进程截短时, 访问超出新长度的部分会触发SIGBUS,
+     *          所以只用于调用者自己拥有、不会被外部截断的文件; 配置、用户上传等外部文件用read读取
+     */
+    class MappedFile : Noncopyable
+    {
+    public:
+        typedef std::shared_ptr<MappedFile> ptr;
+
+        //打开标志, 可以按位组合
+        enum Flags
+        {
+            READ = 0x0,       /// 只读
+            WRITE = 0x1,      /// 读写
+            CREATE = 0x2,     /// 文件不存在时创建(需要WRITE)
+            POPULATE = 0x4,   /// 映射时预先读入全部页面(MAP_POPULATE)
+            HUGE_ALIGN = 0x8  /// 映射地址按2MB对齐, 配合HUGEPAGE使用
+        };
+
+        //madvise建议
+        enum Advice
+        {
+            NORMAL,     /// MADV_NORMAL
+            SEQUENTIAL, /// MADV_SEQUENTIAL, 加大预读, 读过的页面尽早回收
+            RANDOM,     /// MADV_RANDOM, 关闭预读
+            WILLNEED,   /// MADV_WILLNEED, 异步读入页缓存
+            DONTNEED,   /// MADV_DONTNEED, 释放映射的物理页
+            HUGEPAGE    /// MADV_HUGEPAGE, 透明大页(普通文件需要内核支持只读文件THP)
+        };
+
+        MappedFile();
+        ~MappedFile();
+
+        /**
+         * @brief 打开并映射文件
+         * @param[in] path 文件路径
+         * @param[in] flags Flags的组合
+         * @param[in] size 非0且可写时先把文件截断/扩展到size再映射
+         * @return 成功返回true; 失败返回false, errno为失败原因
+         */
+        bool open(const std::string &path, int flags = READ, size_t size = 0);
+
+        //打开并映射文件, 失败返回nullptr
+        static ptr Open(const std::string &path, int flags = READ, size_t size = 0);
+
+        //停止预取并解除映射, 关闭文件
+        void close();
+
+        bool isOpen() const { return m_fd >= 0; }
+        bool isWritable() const { return m_flags & WRITE; }
+        const std::string &getPath() const { return m_path; }
+
+        //映射的首地址, 空文件为nullptr
+        const char *data() const { return m_data; }
+
+        //可写映射的首地址, 只读映射返回nullptr
+        char *mutableData() { return isWritable() ? m_data : nullptr; }
+
+        size_t size() const { return m_size; }
+
+        //整个文件的只读视图
+        std::string_view view() const { return std::string_view(m_data, m_size); }
+
+        //[offset, offset + len)的视图, 越界部分截掉
+        std::string_view view(size_t offset, size_t len) const;
+
+        /**
+         * @brief 对[offset, offset + len)给出访问建议
+         * @param[in] len 为0表示到文件末尾
+         * @details 范围会被扩展到页边界
+         */
+        bool advise(Advice advice, size_t offset = 0, size_t len = 0);
+
+        /**
+         * @brief 把[offset, offset + len)的修改写回文件
+         * @param[in] async 为true时只发起写回(MS_ASYNC)
+         */
+        bool sync(bool async = false, size_t offset = 0, size_t len = 0);
+
+        /**
+         * @brief 改变文件大小并重新映射(只对可写映射有效)
+         * @details 映射地址可能改变, 之前取得的指针和视图失效; 会先停止预取
+         */
+        bool resize(size_t size);
+
+        /**
+         * @brief 启动后台预取线程
+         * @param[in] window 领先读取位置的字节数, 0表示不等待读取进度, 直接预取整个文件
+         * @return 已有预取线程在运行或未映射时返回false; 上一次预取已自行结束时可以重新启动
+         */
+        bool startPrefetch(size_t window = 16 * 1024 * 1024);
+
+        //停止预取线程
+        void stopPrefetch();
+
+        /**
+         * @brief 报告读取进度
+         * @details 预取线程据此推进窗口; 开启SEQUENTIAL时读过的部分可以由调用者DONTNEED
+         */
+        void consume(size_t pos);
+
+    private:
+        bool map(size_t size);
+        void unmap();
+        void prefetchLoop(size_t window);
+
+    private:
+        std::string m_path;
+        int m_fd = -1;
+        int m_flags = READ;
+        char *m_data = nullptr;
+        size_t m_size = 0;
+
+        std::mutex m_mutex;
+        std::condition_variable m_cond;
+        size_t m_readPos = 0;
+        bool m_stopPrefetch = false;
+        bool m_prefetchDone = false; /// 预取线程已自行结束, 等待join
+        std::thread m_prefetchThread;
+    };
+
+    /**
+     * @brief 只读内存区域的std::streambuf
+     * @details 给只接受std::istream的解析器(如yaml-cpp)直接读取映射内容, 不复制
+     */
+    class ViewStreamBuf : public std::streambuf
+    {
+    public:
+        explicit ViewStreamBuf(std::string_view view);
+
+    protected:
+        pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+        pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+    };
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,306 @@
+#include "sylar/util/number_parser.h"
+#include "sylar/util/cpu_util.h"
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <math.h>
+#include <charconv>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SYLAR_NUMBER_PARSER_X86 1
+#endif
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define SYLAR_NUMBER_PARSER_SWAR 1
+#endif
+
+namespace sylar
+{
+
+    namespace
+    {
+
+        //uint64_t能无溢出容纳的最大十进制位数
+        static const size_t s_max_fast_digits = 19;
+
+#ifdef SYLAR_NUMBER_PARSER_SWAR
+        //8个字节是否都是'0'-'9'
+        inline bool IsEightDigits(uint64_t v)
+        {
+            return ((v & 0xF0F0F0F0F0F0F0F0ull) | (((v + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4)) == 0x3333333333333333ull;
+        }
+
+        /**
+         * @brief 8位数字转换为整数
+         * @details 低地址字节是高位: 先两两合并成4个两位数, 再用两次乘法合并成8位
+         */
+        inline uint32_t ParseEightDigits(uint64_t v)
+        {
+            v -= 0x3030303030303030ull;
+            v = (v * 10) + (v >> 8);
+            v = (((v & 0x000000FF000000FFull) * (100 + (1000000ull << 32))) + (((v >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32)))) >> 32;
+            return (uint32_t)v;
+        }
+
+        //读取n(1-8)个字符, 高位用'0'补齐到8个
+        inline uint64_t LoadPadded(const char *p, size_t n)
+        {
+            uint64_t v = 0x3030303030303030ull;
+            memcpy((char *)&v + 8 - n, p, n);
+            return v;
+        }
+
+        //解析n(1-19)位数字, 第一段不足8位的部分补齐后一起处理
+        bool ParseDigitsSWAR(const char *p, size_t n, uint64_t &v)
+        {
+            uint64_t r = 0;
+            size_t head = n & 7;
+            if (head)
+            {
+                uint64_t c = LoadPadded(p, head);
+                if (!IsEightDigits(c))
+                {
+                    return false;
+                }
+                r = ParseEightDigits(c);
+                p += head;
+                n -= head;
+            }
+            while (n)
+            {
+                uint64_t c;
+                memcpy(&c, p, 8);
+                if (!IsEightDigits(c))
+                {
+                    return false;
+                }
+                r = r * 100000000ull + ParseEightDigits(c);
+                p += 8;
+                n -= 8;
+            }
+            v = r;
+            return true;
+        }
+#endif
+
+        bool ParseDigitsScalar(const char *p, size_t n, uint64_t &v)
+        {
+            uint64_t r = 0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                unsigned d = (unsigned char)p[i] - '0';
+                if (d > 9)
+                {
+                    return false;
+                }
+                r = r * 10 + d;
+            }
+            v = r;
+            return true;
+        }
+
+#ifdef SYLAR_NUMBER_PARSER_X86
+#pragma GCC push_options
+#pragma GCC target("sse4.1")
+
+        /**
+         * @brief 一次解析16位数字
+         * @details maddubs把相邻两位合并成两位数, madd合并成4位数,
+         *          packus压缩后再madd一次得到两个8位数
+         */
+        bool ParseSixteenDigitsSSE41(const char *p, uint64_t &v)
+        {
+            __m128i x = _mm_sub_epi8(_mm_loadu_si128((const __m128i *)p), _mm_set1_epi8('0'));
+            //无符号比较: 每个字节都<=9
+            __m128i ok = _mm_cmpeq_epi8(_mm_max_epu8(x, _mm_set1_epi8(9)), _mm_set1_epi8(9));
+            if (_mm_movemask_epi8(ok) != 0xFFFF)
+            {
+                return false;
+            }
+            const __m128i mul_1_10 = _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1);
+            const __m128i mul_1_100 = _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1);
+            const __m128i mul_1_10000 = _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1);
+            __m128i t = _mm_maddubs_epi16(x, mul_1_10);
+            t = _mm_madd_epi16(t, mul_1_100);
+            t = _mm_packus_epi32(t, t);
+            t = _mm_madd_epi16(t, mul_1_10000);
+            v = (uint64_t)(uint32_t)_mm_cvtsi128_si32(t) * 100000000ull + (uint32_t)_mm_extract_epi32(t, 1);
+            return true;
+        }
+
+#pragma GCC pop_options
+#endif
+
+        //解析n(1-19)位数字
+        bool ParseDigits(const char *p, size_t n, uint64_t &v)
+        {
+#ifdef SYLAR_NUMBER_PARSER_X86
+            //16位以上时一次SSE处理抵得过运行时检测的开销
+            static const bool s_sse41 = CpuUtil::HasSSE41();
+            if (n >= 16 && s_sse41)
+            {
+                uint64_t head = 0;
+                uint64_t tail;
+                if (!ParseDigitsScalar(p, n - 16, head) || !ParseSixteenDigitsSSE41(p + n - 16, tail))
+                {
+                    return false;
+                }
+                //head最多3位, 不会溢出
+                v = head * 10000000000000000ull + tail;
+                return true;
+            }
+#endif
+#ifdef SYLAR_NUMBER_PARSER_SWAR
+            return ParseDigitsSWAR(p, n, v);
+#else
+            return ParseDigitsScalar(p, n, v);
+#endif
+        }
+
+        //解析去掉符号后的数字部分
+        bool ParseMagnitude(std::string_view str, uint64_t &v)
+        {
+            if (str.empty())
+            {
+                return false;
+            }
+            if (str.size() <= s_max_fast_digits)
+            {
+                return ParseDigits(str.data(), str.size(), v);
+            }
+            //可能溢出(或者有很多前导0), 交给from_chars判断
+            if ((unsigned char)str[0] - '0' > 9)
+            {
+                return false;
+            }
+            uint64_t r;
+            auto rt = std::from_chars(str.data(), str.data() + str.size(), r);
+            if (rt.ec != std::errc() || rt.ptr != str.data() + str.size())
+            {
+                return false;
+            }
+            v = r;
+            return true;
+        }
+
+        template <class T>
+        bool ParseFloating(std::string_view str, T &v)
+        {
+            const char *begin = str.data();
+            const char *end = begin + str.size();
+            //from_chars不接受'+'
+            if (begin != end && *begin == '+')
+            {
+                ++begin;
+                if (begin != end && *begin == '-')
+                {
+                    return false;
+                }
+            }
+            if (begin == end)
+            {
+                return false;
+            }
+            T r;
+            auto rt = std::from_chars(begin, end, r, std::chars_format::general);
+            if (rt.ptr != end)
+            {
+                return false;
+            }
+            if (rt.ec == std::errc::result_out_of_range)
+            {
+                //下溢时from_chars报错, strtod返回0或非规格化数, 与lexical_cast一致只拒绝上溢
+                std::string tmp(begin, end);
+                r = std::is_same_v<T, float> ? strtof(tmp.c_str(), nullptr) : strtod(tmp.c_str(), nullptr);
+                if (isinf(r))
+                {
+                    return false;
+                }
+            }
+            else if (rt.ec != std::errc())
+            {
+                return false;
+            }
+            v = r;
+            return true;
+        }
+
+    }
+
+    bool NumberParser::ParseUint(std::string_view str, uint64_t &v)
+    {
+        if (!str.empty() && str[0] == '+')
+        {
+            str.remove_prefix(1);
+        }
+        return ParseMagnitude(str, v);
+    }
+
+    bool NumberParser::ParseInt(std::string_view str, int64_t &v)
+    {
+        bool neg = false;
+        if (!str.empty() && (str[0] == '+' || str[0] == '-'))
+        {
+            neg = str[0] == '-';
+            str.remove_prefix(1);
+        }
+        uint64_t m;
+        if (!ParseMagnitude(str, m))
+        {
+            return false;
+        }
+        if (neg)
+        {
+            if (m > (uint64_t)std::numeric_limits<int64_t>::max() + 1)
+            {
+                return false;
+            }
+            v = (int64_t)(0 - m);
+        }
+        else
+        {
+            if (m > (uint64_t)std::numeric_limits<int64_t>::max())
+            {
+                return false;
+            }
+            v = (int64_t)m;
+        }
+        return true;
+    }
+
+    bool NumberParser::ParseDouble(std::string_view str, double &v)
+    {
+        return ParseFloating(str, v);
+    }
+
+    bool NumberParser::ParseFloat(std::string_view str, float &v)
+    {
+        return ParseFloating(str, v);
+    }
+
+    bool NumberParser::ParseBool(std::string_view str, bool &v)
+    {
+        if (str.size() == 1)
+        {
+            if (str[0] == '1' || str[0] == '0')
+            {
+                v = str[0] == '1';
+                return true;
+            }
+            return false;
+        }
+        if (str.size() == 4 && strncasecmp(str.data(), "true", 4) == 0)
+        {
+            v = true;
+            return true;
+        }
+        if (str.size() == 5 && strncasecmp(str.data(), "false", 5) == 0)
+        {
+            v = false;
+            return true;
+        }
+        return false;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,152 @@
+#ifndef __SYLAR_UTIL_NUMBER_PARSER_H__
+#define __SYLAR_UTIL_NUMBER_PARSER_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <boost/lexical_cast.hpp>
+#include <boost/range/iterator_range.hpp>
+
+namespace sylar
+{
+
+    /**
+     * @brief 不抛异常的字符串到数值转换
+     * @details 整数: 每8位数字用一次SWAR(64位寄存器内并行)运算完成校验和转换,
+     *          16位以上且CPU支持SSE4.1时一次处理16位, 超过19位交给std::from_chars;
+     *          浮点数: std::from_chars。
+     *          所有接口都要求整个字符串是合法数值(不允许前后空白和多余字符),
+     *          失败时返回false且不修改输出参数
+     */
+    class NumberParser
+    {
+    public:
+        /**
+         * @brief 解析有符号整数
+         * @details 格式: [+-]?[0-9]+, 超出int64_t范围返回false
+         */
+        static bool ParseInt(std::string_view str, int64_t &v);
+
+        /**
+         * @brief 解析无符号整数
+         * @details 格式: [+]?[0-9]+, 负数和超出uint64_t范围返回false
+         */
+        static bool ParseUint(std::string_view str, uint64_t &v);
+
+        /**
+         * @brief 解析浮点数
+         * @details 格式同strtod(十进制), 允许前导'+'和inf/nan, 不接受十六进制
+         */
+        static bool ParseDouble(std::string_view str, double &v);
+        static bool ParseFloat(std::string_view str, float &v);
+
+        //解析布尔值: 1/0/true/false(不区分大小写)
+        static bool ParseBool(std::string_view str, bool &v);
+
+        /**
+         * @brief 按类型解析
+         * @details 算术类型使用上面的函数, char/signed char/unsigned char要求恰好一个字符
+         *          (与boost::lexical_cast一致), std::string直接复制,
+         *          其他类型用boost::conversion::try_lexical_convert(同样不抛异常)
+         */
+        template <class T>
+        static bool Parse(std::string_view str, T &v)
+        {
+            if constexpr (std::is_same_v<T, bool>)
+            {
+                return ParseBool(str, v);
+            }
+            else if constexpr (std::is_same_v<T, char> || std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>)
+            {
+                if (str.size() != 1)
+                {
+                    return false;
+                }
+                v = (T)str[0];
+                return true;
+            }
+            else if constexpr (IsInteger<T>::value && std::is_signed_v<T>)
+            {
+                int64_t t;
+                if (!ParseInt(str, t) || t < (int64_t)std::numeric_limits<T>::min() || t > (int64_t)std::numeric_limits<T>::max())
+                {
+                    return false;
+                }
+                v = (T)t;
+                return true;
+            }
+            else if constexpr (IsInteger<T>::value)
+            {
+                uint64_t t;
+                if (!ParseUint(str, t) || t > (uint64_t)std::numeric_limits<T>::max())
+                {
+                    return false;
+                }
+                v = (T)t;
+                return true;
+            }
+            else if constexpr (std::is_same_v<T, double>)
+            {
+                return ParseDouble(str, v);
+            }
+            else if constexpr (std::is_same_v<T, float>)
+            {
+                return ParseFloat(str, v);
+            }
+            else if constexpr (std::is_same_v<T, std::string>)
+            {
+                v.assign(str.data(), str.size());
+                return true;
+            }
+            else
+            {
+                T t;
+                if (!boost::conversion::try_lexical_convert(boost::make_iterator_range(str.data(), str.data() + str.size()), t))
+                {
+                    return false;
+                }
+                v = std::move(t);
+                return true;
+            }
+        }
+
+    private:
+        //除字符类型外的整数类型
+        template <class T>
+        struct IsInteger
+            : std::integral_constant<bool, std::is_integral_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, char> && !std::is_same_v<T, signed char> && !std::is_same_v<T, unsigned char> && !std::is_same_v<T, wchar_t> && !std::is_same_v<T, char16_t> && !std::is_same_v<T, char32_t>>
+        {
+        };
+    };
+
+    /**
+     * @brief 不抛异常的lexical_cast
+     * @details 源可以转换为std::string_view时走NumberParser::Parse,
+     *          否则用boost::conversion::try_lexical_convert
+     * @return 成功返回true并设置v, 失败不修改v
+     */
+    template <class V, class S>
+    bool TryLexicalCast(const S &src, V &v)
+    {
+        if constexpr (std::is_convertible_v<const S &, std::string_view>)
+        {
+            return NumberParser::Parse(std::string_view(src), v);
+        }
+        else
+        {
+            V t;
+            if (!boost::conversion::try_lexical_convert(src, t))
+            {
+                return false;
+            }
+            v = std::move(t);
+            return true;
+        }
+    }
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,714 @@
+#include "sylar/util/pb_json.h"
+#include "sylar/util/json_writer.h"
+#include "sylar/mutex.h"
+#include <google/protobuf/descriptor.h>
+#include <google/protobuf/unknown_field_set.h>
+#include <string.h>
+#include <math.h>
+#include <charconv>
+#include <limits>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace sylar
+{
+
+    namespace pb = google::protobuf;
+
+    //按字段类型特化的写函数
+    typedef void (*FieldWriter)(JsonWriter &w, const pb::Message &msg,
+                                const pb::Reflection *r, const pb::FieldDescriptor *f);
+
+    //单个字段的转换计划
+    struct FieldPlan
+    {
+        const pb::FieldDescriptor *field;
+        std::string_view name; /// 输出的字段名, 指向descriptor中的字符串
+        FieldWriter writer;
+    };
+
+    //消息类型的转换计划, 生成后只读
+    struct MessagePlan
+    {
+        std::vector<FieldPlan> fields;                                       /// 按声明顺序
+        std::unordered_map<std::string_view, const pb::FieldDescriptor *> names; /// name和json_name
+    };
+
+    static const MessagePlan *GetPlan(const pb::Descriptor *desc);
+    static void WriteMessage(JsonWriter &w, const pb::Message &msg);
+
+    template <class T>
+    static void WriteScalar(JsonWriter &w, T v)
+    {
+        w.value(v);
+    }
+
+    //proto3 JSON把NaN和无穷写为字符串; JsonWriter通用的null读回时会被跳过, 值变成0
+    template <class T>
+    static void WriteFloat(JsonWriter &w, T v)
+    {
+        if (std::isnan(v))
+        {
+            w.value("NaN");
+        }
+        else if (std::isinf(v))
+        {
+            w.value(v > 0 ? "Infinity" : "-Infinity");
+        }
+        else
+        {
+            w.value(v);
+        }
+    }
+
+    static void WriteScalar(JsonWriter &w, float v)
+    {
+        WriteFloat(w, v);
+    }
+
+    static void WriteScalar(JsonWriter &w, double v)
+    {
+        WriteFloat(w, v);
+    }
+
+    template <class T,
+              T (pb::Reflection::*Get)(const pb::Message &, const pb::FieldDescriptor *) const,
+              T (pb::Reflection::*GetRepeated)(const pb::Message &, const pb::FieldDescriptor *, int) const>
+    struct ScalarWriter
+    {
+        static void Single(JsonWriter &w, const pb::Message &msg,
+                           const pb::Reflection *r, const pb::FieldDescriptor *f)
+        {
+            WriteScalar(w, (r->*Get)(msg, f));
+        }
+
+        static void Repeated(JsonWriter &w, const pb::Message &msg,
+                             const pb::Reflection *r, const pb::FieldDescriptor *f)
+        {
+            int size = r->FieldSize(msg, f);
+            w.startArray();
+            for (int i = 0; i < size; ++i)
+            {
+                WriteScalar(w, (r->*GetRepeated)(msg, f, i));
+            }
+            w.endArray();
+        }
+    };
+
+    static void WriteString(JsonWriter &w, const pb::Message &msg,
+                            const pb::Reflection *r, const pb::FieldDescriptor *f)
+    {
+        std::string scratch;
+        w.value(r->GetStringReference(msg, f, &scratch));
+    }
+
+    static void WriteRepeatedString(JsonWriter &w, const pb::Message &msg,
+                                    const pb::Reflection *r, const pb::FieldDescriptor *f)
+    {
+        std::string scratch;
+        int size = r->FieldSize(msg, f);
+        w.startArray();
+        for (int i = 0; i < size; ++i)
+        {
+            w.value(r->GetRepeatedStringReference(msg, f, i, &scratch));
+        }
+        w.endArray();
+    }
+
+    //proto3 JSON中bytes字段使用标准base64编码(带填充)
+    static void Base64Encode(std::string_view src, std::string &out)
+    {
+        static const char s_table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        const unsigned char *p = (const unsigned char *)src.data();
+        size_t len = src.size();
+        out.clear();
+        out.reserve((len + 2) / 3 * 4);
+        size_t i = 0;
+        for (; i + 3 <= len; i += 3)
+        {
+            uint32_t v = (p[i] << 16) | (p[i + 1] << 8) | p[i + 2];
+            out.push_back(s_table[v >> 18]);
+            out.push_back(s_table[(v >> 12) & 0x3f]);
+            out.push_back(s_table[(v >> 6) & 0x3f]);
+            out.push_back(s_table[v & 0x3f]);
+        }
+        if (i < len)
+        {
+            uint32_t v = p[i] << 16;
+            if (i + 1 < len)
+            {
+                v |= p[i + 1] << 8;
+            }
+            out.push_back(s_table[v >> 18]);
+            out.push_back(s_table[(v >> 12) & 0x3f]);
+            out.push_back(i + 1 < len ? s_table[(v >> 6) & 0x3f] : '=');
+            out.push_back('=');
+        }
+    }
+
+    //解码接受标准和URL安全两种字母表, 填充可省略
+    static bool Base64Decode(std::string_view src, std::string &out)
+    {
+        while (!src.empty() && src.back() == '=')
+        {
+            src.remove_suffix(1);
+        }
+        if (src.size() % 4 == 1)
+        {
+            return false;
+        }
+        out.clear();
+        out.reserve(src.size() * 3 / 4);
+        uint32_t v = 0;
+        int bits = 0;
+        for (char c : src)
+        {
+            int d;
+            if (c >= 'A' && c <= 'Z')
+            {
+                d = c - 'A';
+            }
+            else if (c >= 'a' && c <= 'z')
+            {
+                d = c - 'a' + 26;
+            }
+            else if (c >= '0' && c <= '9')
+            {
+                d = c - '0' + 52;
+            }
+            else if (c == '+' || c == '-')
+            {
+                d = 62;
+            }
+            else if (c == '/' || c == '_')
+            {
+                d = 63;
+            }
+            else
+            {
+                return false;
+            }
+            v = (v << 6) | d;
+            bits += 6;
+            if (bits >= 8)
+            {
+                bits -= 8;
+                out.push_back((char)((v >> bits) & 0xff));
+            }
+        }
+        return true;
+    }
+
+    static void WriteBytes(JsonWriter &w, const pb::Message &msg,
+                           const pb::Reflection *r, const pb::FieldDescriptor *f)
+    {
+        std::string scratch;
+        std::string encoded;
+        Base64Encode(r->GetStringReference(msg, f, &scratch), encoded);
+        w.value(encoded);
+    }
+
+    static void WriteRepeatedBytes(JsonWriter &w, const pb::Message &msg,
+                                   const pb::Reflection *r, const pb::FieldDescriptor *f)
+    {
+        std::string scratch;
+        std::string encoded;
+        int size = r->FieldSize(msg, f);
+        w.startArray();
+        for (int i = 0; i < size; ++i)
+        {
+            Base64Encode(r->GetRepeatedStringReference(msg, f, i, &scratch), encoded);
+            w.value(encoded);
+        }
+        w.endArray();
+    }
+
+    static void WriteSubMessage(JsonWriter &w, const pb::Message &msg,
+                                const pb::Reflection *r, const pb::FieldDescriptor *f)
+    {
+        WriteMessage(w, r->GetMessage(msg, f));
+    }
+
+    static void WriteRepeatedMessage(JsonWriter &w, const pb::Message &msg,
+                                     const pb::Reflection *r, const pb::FieldDescriptor *f)
+    {
+        int size = r->FieldSize(msg, f);
+        w.startArray();
+        for (int i = 0; i < size; ++i)
+        {
+            WriteMessage(w, r->GetRepeatedMessage(msg, f, i));
+        }
+        w.endArray();
+    }
+
+    static FieldWriter SelectWriter(const pb::FieldDescriptor *f)
+    {
+        bool repeated = f->is_repeated();
+        switch (f->cpp_type())
+        {
+#define XX(cpptype, type, method)                                                                  \
+    case pb::FieldDescriptor::CPPTYPE_##cpptype:                                                   \
+    {                                                                                              \
+        typedef ScalarWriter<type, &pb::Reflection::Get##method, &pb::Reflection::GetRepeated##method> W; \
+        return repeated ? &W::Repeated : &W::Single;                                               \
+    }
+            XX(INT32, int32_t, Int32);
+            XX(UINT32, uint32_t, UInt32);
+            XX(INT64, int64_t, Int64);
+            XX(UINT64, uint64_t, UInt64);
+            XX(FLOAT, float, Float);
+            XX(DOUBLE, double, Double);
+            XX(BOOL, bool, Bool);
+            XX(ENUM, int, EnumValue);
+#undef XX
+        case pb::FieldDescriptor::CPPTYPE_STRING:
+            if (f->type() == pb::FieldDescriptor::TYPE_BYTES)
+            {
+                return repeated ? &WriteRepeatedBytes : &WriteBytes;
+            }
+            return repeated ? &WriteRepeatedString : &WriteString;
+        case pb::FieldDescriptor::CPPTYPE_MESSAGE:
+            return repeated ? &WriteRepeatedMessage : &WriteSubMessage;
+        }
+        return nullptr;
+    }
+
+    static MessagePlan *BuildPlan(const pb::Descriptor *desc)
+    {
+        MessagePlan *plan = new MessagePlan;
+        plan->fields.reserve(desc->field_count());
+        for (int i = 0; i < desc->field_count(); ++i)
+        {
+            const pb::FieldDescriptor *f = desc->field(i);
+            FieldPlan fp;
+            fp.field = f;
+            fp.name = f->name();
+            fp.writer = SelectWriter(f);
+            if (!fp.writer)
+            {
+                continue;
+            }
+            plan->fields.push_back(fp);
+            plan->names[f->name()] = f;
+            plan->names.emplace(f->json_name(), f);
+        }
+        return plan;
+    }
+
+    static const MessagePlan *GetSharedPlan(const pb::Descriptor *desc)
+    {
+        //Descriptor在程序运行期间不会释放, 计划也一直保留
+        static RWMutex s_mutex;
+        static std::unordered_map<const pb::Descriptor *, std::unique_ptr<MessagePlan>> s_plans;
+        {
+            RWMutex::ReadLock lock(s_mutex);
+            auto it = s_plans.find(desc);
+            if (it != s_plans.end())
+            {
+                return it->second.get();
+            }
+        }
+        std::unique_ptr<MessagePlan> plan(BuildPlan(desc));
+        RWMutex::WriteLock lock(s_mutex);
+        auto rt = s_plans.emplace(desc, std::move(plan));
+        return rt.first->second.get();
+    }
+
+    static const MessagePlan *GetPlan(const pb::Descriptor *desc)
+    {
+        static thread_local std::unordered_map<const pb::Descriptor *, const MessagePlan *> t_plans;
+        auto it = t_plans.find(desc);
+        if (it != t_plans.end())
+        {
+            return it->second;
+        }
+        const MessagePlan *plan = GetSharedPlan(desc);
+        t_plans[desc] = plan;
+        return plan;
+    }
+
+    //未知字段按字段号输出, 同一字段号出现多次时输出为数组
+    static void SerializeUnknownFieldSet(const pb::UnknownFieldSet &ufs, Json::Value &jnode)
+    {
+        std::map<int, std::vector<Json::Value>> kvs;
+        for (int i = 0; i < ufs.field_count(); ++i)
+        {
+            const auto &uf = ufs.field(i);
+            switch ((int)uf.type())
+            {
+            case pb::UnknownField::TYPE_VARINT:
+                kvs[uf.number()].push_back((Json::Int64)uf.varint());
+                break;
+            case pb::UnknownField::TYPE_FIXED32:
+                kvs[uf.number()].push_back((Json::UInt)uf.fixed32());
+                break;
+            case pb::UnknownField::TYPE_FIXED64:
+                kvs[uf.number()].push_back((Json::UInt64)uf.fixed64());
+                break;
+            case pb::UnknownField::TYPE_LENGTH_DELIMITED:
+            {
+                pb::UnknownFieldSet tmp;
+                auto &v = uf.length_delimited();
+                if (!v.empty() && tmp.ParseFromString(v))
+                {
+                    Json::Value vv;
+                    SerializeUnknownFieldSet(tmp, vv);
+                    kvs[uf.number()].push_back(vv);
+                }
+                else
+                {
+                    kvs[uf.number()].push_back(v);
+                }
+                break;
+            }
+            }
+        }
+
+        for (auto &i : kvs)
+        {
+            if (i.second.size() > 1)
+            {
+                for (auto &n : i.second)
+                {
+                    jnode[std::to_string(i.first)].append(n);
+                }
+            }
+            else
+            {
+                jnode[std::to_string(i.first)] = i.second[0];
+            }
+        }
+    }
+
+    static void WriteMessage(JsonWriter &w, const pb::Message &msg)
+    {
+        const MessagePlan *plan = GetPlan(msg.GetDescriptor());
+        const pb::Reflection *r = msg.GetReflection();
+        w.startObject();
+        for (auto &i : plan->fields)
+        {
+            if (i.field->is_repeated())
+            {
+                if (!r->FieldSize(msg, i.field))
+                {
+                    continue;
+                }
+            }
+            else if (!r->HasField(msg, i.field))
+            {
+                continue;
+            }
+            w.key(i.name);
+            i.writer(w, msg, r, i.field);
+        }
+
+        const pb::UnknownFieldSet &ufs = r->GetUnknownFields(msg);
+        if (!ufs.empty())
+        {
+            Json::Value unknown;
+            SerializeUnknownFieldSet(ufs, unknown);
+            for (auto it = unknown.begin(); it != unknown.end(); ++it)
+            {
+                w.key(it.name()).value(*it);
+            }
+        }
+        w.endObject();
+    }
+
+    void PBJsonConverter::ToJson(std::string &out, const pb::Message &message)
+    {
+        JsonWriter w(out);
+        WriteMessage(w, message);
+    }
+
+    std::string PBJsonConverter::ToJson(const pb::Message &message)
+    {
+        std::string rt;
+        ToJson(rt, message);
+        return rt;
+    }
+
+    static bool SetError(std::string *error, const std::string &msg)
+    {
+        if (error)
+        {
+            *error = msg;
+        }
+        return false;
+    }
+
+    //整数接受数字或数字字符串, 必须完整匹配且不超出范围;
+    //和proto3 JSON一致, 也接受值为整数的小数/指数形式, 如3.0, 1e3
+    template <class T>
+    static bool ParseInteger(const JsonValue &v, T &out)
+    {
+        std::string_view s;
+        if (v.isNumber())
+        {
+            s = v.getRaw();
+        }
+        else if (v.isString())
+        {
+            s = v.getRawString();
+        }
+        else
+        {
+            return false;
+        }
+        auto rt = std::from_chars(s.data(), s.data() + s.size(), out);
+        if (rt.ec == std::errc() && rt.ptr == s.data() + s.size())
+        {
+            return true;
+        }
+        if (rt.ec == std::errc::result_out_of_range
+            || s.find_first_of(".eE") == std::string_view::npos)
+        {
+            return false;
+        }
+        double d;
+        auto drt = std::from_chars(s.data(), s.data() + s.size(), d);
+        if (drt.ec != std::errc() || drt.ptr != s.data() + s.size()
+            || d != std::trunc(d))
+        {
+            return false;
+        }
+        //[-2^digits, 2^digits)在double中可精确表示, 比较不会因舍入越界
+        double bound = std::ldexp(1.0, std::numeric_limits<T>::digits);
+        double lo = std::numeric_limits<T>::is_signed ? -bound : 0.0;
+        if (!(d >= lo && d < bound))
+        {
+            return false;
+        }
+        out = (T)d;
+        return true;
+    }
+
+    static bool ParseBytes(const JsonValue &v, std::string &out)
+    {
+        std::string tmp;
+        if (!v.getString(tmp))
+        {
+            return false;
+        }
+        return Base64Decode(tmp, out);
+    }
+
+    //浮点数接受数字, 或者"NaN"/"Infinity"/"-Infinity"/数字字符串
+    template <class T>
+    static bool ParseFloat(const JsonValue &v, T &out)
+    {
+        if (v.isNumber())
+        {
+            double d;
+            if (!v.getDouble(d))
+            {
+                return false;
+            }
+            out = (T)d;
+            return true;
+        }
+        if (!v.isString())
+        {
+            return false;
+        }
+        std::string_view s = v.getRawString();
+        if (s == "NaN")
+        {
+            out = std::numeric_limits<T>::quiet_NaN();
+            return true;
+        }
+        else if (s == "Infinity")
+        {
+            out = std::numeric_limits<T>::infinity();
+            return true;
+        }
+        else if (s == "-Infinity")
+        {
+            out = -std::numeric_limits<T>::infinity();
+            return true;
+        }
+        auto rt = std::from_chars(s.data(), s.data() + s.size(), out);
+        return rt.ec == std::errc() && rt.ptr == s.data() + s.size();
+    }
+
+    static bool ParseBool(const JsonValue &v, bool &out)
+    {
+        return v.getBool(out);
+    }
+
+    static bool ParseString(const JsonValue &v, std::string &out)
+    {
+        return v.getString(out);
+    }
+
+    //枚举接受数字或枚举值名称
+    static bool ParseEnum(const JsonValue &v, const pb::FieldDescriptor *f, int &out)
+    {
+        if (v.isNumber())
+        {
+            return ParseInteger(v, out);
+        }
+        std::string name;
+        if (!v.getString(name))
+        {
+            return false;
+        }
+        const pb::EnumValueDescriptor *ev = f->enum_type()->FindValueByName(name);
+        if (!ev)
+        {
+            return false;
+        }
+        out = ev->number();
+        return true;
+    }
+
+    static bool ReadMessage(const JsonValue &json, pb::Message &msg, std::string *error);
+
+    //读取一个值, add为true时追加到repeated字段
+    static bool ReadField(const JsonValue &v, pb::Message &msg, const pb::Reflection *r,
+                          const pb::FieldDescriptor *f, bool add, std::string *error)
+    {
+        switch (f->cpp_type())
+        {
+#define XX(cpptype, type, method, parse)                                       \
+    case pb::FieldDescriptor::CPPTYPE_##cpptype:                               \
+    {                                                                          \
+        type val;                                                              \
+        if (!parse(v, val))                                                    \
+        {                                                                      \
+            return SetError(error, "field " + f->full_name() + ": type mismatch"); \
+        }                                                                      \
+        if (add)                                                               \
+        {                                                                      \
+            r->Add##method(&msg, f, std::move(val));                           \
+        }                                                                      \
+        else                                                                   \
+        {                                                                      \
+            r->Set##method(&msg, f, std::move(val));                           \
+        }                                                                      \
+        return true;                                                           \
+    }
+            XX(INT32, int32_t, Int32, ParseInteger);
+            XX(UINT32, uint32_t, UInt32, ParseInteger);
+            XX(INT64, int64_t, Int64, ParseInteger);
+            XX(UINT64, uint64_t, UInt64, ParseInteger);
+            XX(FLOAT, float, Float, ParseFloat);
+            XX(DOUBLE, double, Double, ParseFloat);
+            XX(BOOL, bool, Bool, ParseBool);
+#undef XX
+        case pb::FieldDescriptor::CPPTYPE_STRING:
+        {
+            std::string val;
+            bool bytes = f->type() == pb::FieldDescriptor::TYPE_BYTES;
+            if (!(bytes ? ParseBytes(v, val) : ParseString(v, val)))
+            {
+                return SetError(error, "field " + f->full_name()
+                                           + (bytes ? ": invalid base64" : ": type mismatch"));
+            }
+            if (add)
+            {
+                r->AddString(&msg, f, std::move(val));
+            }
+            else
+            {
+                r->SetString(&msg, f, std::move(val));
+            }
+            return true;
+        }
+        case pb::FieldDescriptor::CPPTYPE_ENUM:
+        {
+            int val;
+            if (!ParseEnum(v, f, val))
+            {
+                return SetError(error, "field " + f->full_name() + ": invalid enum value");
+            }
+            if (add)
+            {
+                r->AddEnumValue(&msg, f, val);
+            }
+            else
+            {
+                r->SetEnumValue(&msg, f, val);
+            }
+            return true;
+        }
+        case pb::FieldDescriptor::CPPTYPE_MESSAGE:
+        {
+            pb::Message *sub = add ? r->AddMessage(&msg, f) : r->MutableMessage(&msg, f);
+            return ReadMessage(v, *sub, error);
+        }
+        }
+        return SetError(error, "field " + f->full_name() + ": unsupported type");
+    }
+
+    static bool ReadMessage(const JsonValue &json, pb::Message &msg, std::string *error)
+    {
+        const pb::Descriptor *desc = msg.GetDescriptor();
+        if (!json.isObject())
+        {
+            return SetError(error, desc->full_name() + ": expect object");
+        }
+        const MessagePlan *plan = GetPlan(desc);
+        const pb::Reflection *r = msg.GetReflection();
+        std::string tmp;
+        for (auto it = json.begin(); it != json.end(); ++it)
+        {
+            JsonValue k = it.key();
+            std::string_view name = k.getRawString();
+            if (memchr(name.data(), '\\', name.size()))
+            {
+                k.getString(tmp);
+                name = tmp;
+            }
+            auto fit = plan->names.find(name);
+            if (fit == plan->names.end())
+            {
+                continue;
+            }
+            const pb::FieldDescriptor *f = fit->second;
+            JsonValue v = it.value();
+            if (v.isNull())
+            {
+                continue;
+            }
+            if (!f->is_repeated())
+            {
+                if (!ReadField(v, msg, r, f, false, error))
+                {
+                    return false;
+                }
+                continue;
+            }
+            if (!v.isArray())
+            {
+                return SetError(error, "field " + f->full_name() + ": expect array");
+            }
+            for (auto e = v.begin(); e != v.end(); ++e)
+            {
+                if (!ReadField(e.value(), msg, r, f, true, error))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    bool PBJsonConverter::FromJson(const JsonValue &json, pb::Message &message, std::string *error)
+    {
+        return ReadMessage(json, message, error);
+    }
+
+    bool PBJsonConverter::FromJson(std::string_view json, pb::Message &message, std::string *error)
+    {
+        JsonDocument doc;
+        if (!doc.parse(json))
+        {
+            return SetError(error, std::string(doc.getError()) + " at offset " + std::to_string(doc.getErrorOffset()));
+        }
+        return ReadMessage(doc.root(), message, error);
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#ifndef __SYLAR_UTIL_PB_JSON_H__
+#define __SYLAR_UTIL_PB_JSON_H__
+
+#include <string>
+#include <string_view>
+#include <google/protobuf/message.h>
+#include "json_parser.h"
+
+namespace sylar
+{
+
+    /**
+     * @brief protobuf消息和JSON之间的转换
+     * @details 每种消息类型(Descriptor)第一次转换时生成一份转换计划并缓存:
+     *          每个字段对应一个按类型特化的写函数和字段名查找表,
+     *          之后的转换只按计划调用反射的取值/赋值接口, 通过JsonWriter
+     *          直接写入输出缓冲区, 不构造Json::Value树。
+     *          线程首次使用某个类型时查一次全局缓存, 之后命中线程本地缓存, 不加锁
+     *
+     *  格式规则:
+     *  - 字段名使用proto中的原始名称, 解析时也接受json_name(lowerCamelCase)
+     *  - 只输出已设置的字段(repeated非空, proto3标量非默认值), 按字段声明顺序
+     *  - 枚举输出数字, 解析时接受数字或枚举名
+     *  - 64位整数输出为数字, 解析时接受数字或数字字符串, 以及值为整数的小数/指数(3.0, 1e3)
+     *  - bytes输出为标准base64字符串, 解析时也接受URL安全字母表和省略填充
+     *  - map字段按repeated的{"key":..,"value":..}对象数组处理
+     *  - 未知字段以字段号为key输出, 解析时忽略JSON中的未知字段
+     */
+    class PBJsonConverter
+    {
+    public:
+        /**
+         * @brief 消息转换为紧凑JSON
+         * @param[out] out 输出缓冲区, 内容追加在末尾
+         * @param[in] message 消息
+         */
+        static void ToJson(std::string &out, const google::protobuf::Message &message);
+
+        //消息转换为紧凑JSON
+        static std::string ToJson(const google::protobuf::Message &message);
+
+        /**
+         * @brief 从JSON对象填充消息
+         * @details 只设置JSON中出现的字段, 不先清空消息; null值忽略
+         * @param[in] json JSON对象
+         * @param[out] message 消息
+         * @param[out] error 失败时的错误信息
+         * @return 成功返回true, 失败时消息可能已被部分修改
+         */
+        static bool FromJson(const JsonValue &json, google::protobuf::Message &message, std::string *error = nullptr);
+
+        //解析JSON文本并填充消息
+        static bool FromJson(std::string_view json, google::protobuf::Message &message, std::string *error = nullptr);
+    };
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,225 @@
+#ifndef __SYLAR_UTIL_REF_BUFFER_H__
+#define __SYLAR_UTIL_REF_BUFFER_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <utility>
+#include "slab_pool.h"
+
+namespace sylar
+{
+
+    //非原子引用计数, 只能在一个线程内共享
+    struct LocalRefCount
+    {
+        uint32_t count;
+
+        explicit LocalRefCount(uint32_t v) : count(v) {}
+        void add() { ++count; }
+        //返回true表示已减到0
+        bool release() { return --count == 0; }
+        uint32_t get() const { return count; }
+    };
+
+    //原子引用计数, 可以跨线程共享
+    struct AtomicRefCount
+    {
+        std::atomic<uint32_t> count;
+
+        explicit AtomicRefCount(uint32_t v) : count(v) {}
+        void add() { count.fetch_add(1, std::memory_order_relaxed); }
+        bool release()
+        {
+            if (count.fetch_sub(1, std::memory_order_release) == 1)
+            {
+                std::atomic_thread_fence(std::memory_order_acquire);
+                return true;
+            }
+            return false;
+        }
+        uint32_t get() const { return count.load(std::memory_order_relaxed); }
+    };
+
+    /**
+     * @brief 侵入式引用计数的字节缓冲区
+     * @details 引用计数和容量放在数据前面, 与数据同一次分配(经SlabPool),
+     *          复制只增加计数, 没有shared_ptr的控制块。
+     *          每个对象是底层缓冲区上的一段[offset, offset + size)视图,
+     *          slice()产生共享同一缓冲区的子视图, 适合在流水线各阶段之间传递IO数据而不拷贝。
+     *          RefCount为LocalRefCount时计数非原子, 缓冲区的所有副本必须在同一线程;
+     *          跨线程传递用AtomicRefCount
+     */
+    template <class RefCount>
+    class BasicRefBuffer
+    {
+    public:
+        static const size_t npos = (size_t)-1;
+
+        BasicRefBuffer() {}
+
+        //分配size字节的缓冲区, 内容未初始化
+        explicit BasicRefBuffer(size_t size)
+            : m_block(NewBlock(size)), m_data(m_block->data()), m_size(size)
+        {
+        }
+
+        //复制data到新缓冲区
+        BasicRefBuffer(const void *data, size_t size)
+            : BasicRefBuffer(size)
+        {
+            if (size)
+            {
+                memcpy(m_data, data, size);
+            }
+        }
+
+        explicit BasicRefBuffer(std::string_view str)
+            : BasicRefBuffer(str.data(), str.size())
+        {
+        }
+
+        BasicRefBuffer(const BasicRefBuffer &r)
+            : m_block(r.m_block), m_data(r.m_data), m_size(r.m_size)
+        {
+            if (m_block)
+            {
+                m_block->ref.add();
+            }
+        }
+
+        BasicRefBuffer(BasicRefBuffer &&r) noexcept
+            : m_block(r.m_block), m_data(r.m_data), m_size(r.m_size)
+        {
+            r.m_block = nullptr;
+            r.m_data = nullptr;
+            r.m_size = 0;
+        }
+
+        ~BasicRefBuffer() { release(); }
+
+        BasicRefBuffer &operator=(const BasicRefBuffer &r)
+        {
+            BasicRefBuffer(r).swap(*this);
+            return *this;
+        }
+
+        BasicRefBuffer &operator=(BasicRefBuffer &&r) noexcept
+        {
+            BasicRefBuffer(std::move(r)).swap(*this);
+            return *this;
+        }
+
+        //视图首地址
+        char *data() const { return m_data; }
+        //视图长度
+        size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        char &operator[](size_t i) const { return m_data[i]; }
+        char *begin() const { return m_data; }
+        char *end() const { return m_data + m_size; }
+
+        std::string_view view() const { return std::string_view(m_data, m_size); }
+        std::string toString() const { return std::string(m_data, m_size); }
+
+        /**
+         * @brief 子视图
+         * @details 与当前对象共享缓冲区, 越界部分截掉
+         */
+        BasicRefBuffer slice(size_t offset, size_t len = npos) const
+        {
+            BasicRefBuffer rt(*this);
+            rt.trim(offset, len);
+            return rt;
+        }
+
+        //去掉前n字节
+        void removePrefix(size_t n)
+        {
+            n = std::min(n, m_size);
+            m_data += n;
+            m_size -= n;
+        }
+
+        //去掉后n字节
+        void removeSuffix(size_t n) { m_size -= std::min(n, m_size); }
+
+        //视图在缓冲区中的偏移
+        size_t offset() const { return m_block ? m_data - m_block->data() : 0; }
+        //底层缓冲区大小
+        size_t capacity() const { return m_block ? m_block->capacity : 0; }
+
+        //共享缓冲区的对象数
+        uint32_t use_count() const { return m_block ? m_block->ref.get() : 0; }
+        //是否独占缓冲区, 独占时可以安全地原地修改
+        bool unique() const { return use_count() == 1; }
+
+        void swap(BasicRefBuffer &r)
+        {
+            std::swap(m_block, r.m_block);
+            std::swap(m_data, r.m_data);
+            std::swap(m_size, r.m_size);
+        }
+
+        //释放引用, 变为空对象
+        void reset()
+        {
+            release();
+            m_block = nullptr;
+            m_data = nullptr;
+            m_size = 0;
+        }
+
+        bool operator!() const { return !m_block; }
+        explicit operator bool() const { return m_block != nullptr; }
+
+    private:
+        struct Block
+        {
+            RefCount ref;
+            size_t capacity;
+
+            char *data() { return (char *)(this + 1); }
+        };
+
+        static Block *NewBlock(size_t size)
+        {
+            return new (SlabPool::Allocate(sizeof(Block) + size)) Block{RefCount(1), size};
+        }
+
+        void trim(size_t offset, size_t len)
+        {
+            offset = std::min(offset, m_size);
+            m_data += offset;
+            m_size = std::min(len, m_size - offset);
+        }
+
+        void release()
+        {
+            if (m_block && m_block->ref.release())
+            {
+                size_t size = sizeof(Block) + m_block->capacity;
+                m_block->~Block();
+                SlabPool::Deallocate(m_block, size);
+            }
+        }
+
+    private:
+        Block *m_block = nullptr;
+        char *m_data = nullptr;
+        size_t m_size = 0;
+    };
+
+    //单线程使用的缓冲区
+    typedef BasicRefBuffer<LocalRefCount> RefBuffer;
+    //可以跨线程共享的缓冲区
+    typedef BasicRefBuffer<AtomicRefCount> SyncRefBuffer;
+
+}
+
+#endif
\ No newline at end of file
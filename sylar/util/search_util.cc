@@ -0,0 +1,212 @@
+#include "sylar/util/search_util.h"
+#include "sylar/util/cpu_util.h"
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SYLAR_SEARCH_SIMD_X86 1
+#endif
+
+namespace sylar
+{
+
+    namespace
+    {
+
+        //数组只通过memcpy和SIMD加载读取, 调用方的元素类型可以是任意同宽度的整数类型
+        inline uint32_t Load32(const void *arr, size_t i)
+        {
+            uint32_t x;
+            memcpy(&x, (const char *)arr + i * 4, 4);
+            return x;
+        }
+
+        inline uint64_t Load64(const void *arr, size_t i)
+        {
+            uint64_t x;
+            memcpy(&x, (const char *)arr + i * 8, 8);
+            return x;
+        }
+
+        //元素与v都异或bias后做有符号比较: bias为0时是有符号比较, 为符号位时是无符号比较
+        size_t CountLess32Scalar(const void *arr, size_t len, uint32_t v, uint32_t bias)
+        {
+            int32_t bv = (int32_t)(v ^ bias);
+            size_t i = 0;
+            while (i < len && (int32_t)(Load32(arr, i) ^ bias) < bv)
+            {
+                ++i;
+            }
+            return i;
+        }
+
+        size_t CountLess64Scalar(const void *arr, size_t len, uint64_t v, uint64_t bias)
+        {
+            int64_t bv = (int64_t)(v ^ bias);
+            size_t i = 0;
+            while (i < len && (int64_t)(Load64(arr, i) ^ bias) < bv)
+            {
+                ++i;
+            }
+            return i;
+        }
+
+#ifdef SYLAR_SEARCH_SIMD_X86
+
+        size_t CountLess32SSE2(const void *arr, size_t len, uint32_t v, uint32_t bias)
+        {
+            const char *p = (const char *)arr;
+            const __m128i vb = _mm_set1_epi32((int32_t)bias);
+            const __m128i vv = _mm_set1_epi32((int32_t)(v ^ bias));
+            size_t i = 0;
+            for (; i + 4 <= len; i += 4)
+            {
+                __m128i x = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(p + i * 4)), vb);
+                int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(vv, x)));
+                if (mask != 0xf)
+                {
+                    return i + __builtin_popcount(mask);
+                }
+            }
+            return i + CountLess32Scalar(p + i * 4, len - i, v, bias);
+        }
+
+#pragma GCC push_options
+#pragma GCC target("sse4.2")
+
+        size_t CountLess64SSE42(const void *arr, size_t len, uint64_t v, uint64_t bias)
+        {
+            const char *p = (const char *)arr;
+            const __m128i vb = _mm_set1_epi64x((int64_t)bias);
+            const __m128i vv = _mm_set1_epi64x((int64_t)(v ^ bias));
+            size_t i = 0;
+            for (; i + 2 <= len; i += 2)
+            {
+                __m128i x = _mm_xor_si128(_mm_loadu_si128((const __m128i *)(p + i * 8)), vb);
+                int mask = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(vv, x)));
+                if (mask != 0x3)
+                {
+                    return i + __builtin_popcount(mask);
+                }
+            }
+            return i + CountLess64Scalar(p + i * 8, len - i, v, bias);
+        }
+
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+        //尾部交给非VEX编码的SSE实现, 调用前vzeroupper, 避免AVX-SSE切换惩罚
+        size_t CountLess32AVX2(const void *arr, size_t len, uint32_t v, uint32_t bias)
+        {
+            const char *p = (const char *)arr;
+            const __m256i vb = _mm256_set1_epi32((int32_t)bias);
+            const __m256i vv = _mm256_set1_epi32((int32_t)(v ^ bias));
+            size_t i = 0;
+            //一次比较16个元素, 小数组里通常一两轮就结束
+            for (; i + 16 <= len; i += 16)
+            {
+                __m256i x0 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(p + i * 4)), vb);
+                __m256i x1 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(p + i * 4 + 32)), vb);
+                uint32_t m0 = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(vv, x0)));
+                uint32_t m1 = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(vv, x1)));
+                uint32_t mask = m0 | (m1 << 8);
+                if (mask != 0xffff)
+                {
+                    return i + __builtin_popcount(mask);
+                }
+            }
+            _mm256_zeroupper();
+            return i + CountLess32SSE2(p + i * 4, len - i, v, bias);
+        }
+
+        size_t CountLess64AVX2(const void *arr, size_t len, uint64_t v, uint64_t bias)
+        {
+            const char *p = (const char *)arr;
+            const __m256i vb = _mm256_set1_epi64x((int64_t)bias);
+            const __m256i vv = _mm256_set1_epi64x((int64_t)(v ^ bias));
+            size_t i = 0;
+            for (; i + 8 <= len; i += 8)
+            {
+                __m256i x0 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(p + i * 8)), vb);
+                __m256i x1 = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(p + i * 8 + 32)), vb);
+                uint32_t m0 = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(vv, x0)));
+                uint32_t m1 = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(vv, x1)));
+                uint32_t mask = m0 | (m1 << 4);
+                if (mask != 0xff)
+                {
+                    return i + __builtin_popcount(mask);
+                }
+            }
+            _mm256_zeroupper();
+            return i + CountLess64SSE42(p + i * 8, len - i, v, bias);
+        }
+
+#pragma GCC pop_options
+
+#endif
+
+        //按CPU支持情况选择的内核, bias为0时有符号比较, 为符号位时无符号比较
+        struct Kernels
+        {
+            size_t (*countLess32)(const void *, size_t, uint32_t, uint32_t);
+            size_t (*countLess64)(const void *, size_t, uint64_t, uint64_t);
+        };
+
+        Kernels SelectKernels()
+        {
+#ifdef SYLAR_SEARCH_SIMD_X86
+            if (CpuUtil::HasAVX2())
+            {
+                return Kernels{CountLess32AVX2, CountLess64AVX2};
+            }
+            if (CpuUtil::HasSSE42())
+            {
+                return Kernels{CountLess32SSE2, CountLess64SSE42};
+            }
+            return Kernels{CountLess32SSE2, CountLess64Scalar};
+#else
+            return Kernels{CountLess32Scalar, CountLess64Scalar};
+#endif
+        }
+
+        const Kernels &GetKernels()
+        {
+            static const Kernels s_kernels = SelectKernels();
+            return s_kernels;
+        }
+
+    }
+
+    size_t SearchSimd::CountLess(const int32_t *arr, size_t len, int32_t v)
+    {
+        return CountLess32(arr, len, (uint32_t)v, true);
+    }
+
+    size_t SearchSimd::CountLess(const uint32_t *arr, size_t len, uint32_t v)
+    {
+        return CountLess32(arr, len, v, false);
+    }
+
+    size_t SearchSimd::CountLess(const int64_t *arr, size_t len, int64_t v)
+    {
+        return CountLess64(arr, len, (uint64_t)v, true);
+    }
+
+    size_t SearchSimd::CountLess(const uint64_t *arr, size_t len, uint64_t v)
+    {
+        return CountLess64(arr, len, v, false);
+    }
+
+    size_t SearchSimd::CountLess32(const void *arr, size_t len, uint32_t v, bool is_signed)
+    {
+        return GetKernels().countLess32(arr, len, v, is_signed ? 0 : 0x80000000u);
+    }
+
+    size_t SearchSimd::CountLess64(const void *arr, size_t len, uint64_t v, bool is_signed)
+    {
+        return GetKernels().countLess64(arr, len, v, is_signed ? 0 : 0x8000000000000000ull);
+    }
+
+}
\ No newline at end of file
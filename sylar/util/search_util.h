@@ -0,0 +1,229 @@
+#ifndef __SYLAR_UTIL_SEARCH_UTIL_H__
+#define __SYLAR_UTIL_SEARCH_UTIL_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+namespace sylar
+{
+
+    /**
+     * @brief 有序整数数组的SIMD线性计数
+     * @details 返回arr[0, len)中小于v的元素个数, 即lower_bound的下标;
+     *          遇到第一个不小于v的块即停止。按CPU支持情况选择AVX2/SSE实现
+     */
+    class SearchSimd
+    {
+    public:
+        static size_t CountLess(const int32_t *arr, size_t len, int32_t v);
+        static size_t CountLess(const uint32_t *arr, size_t len, uint32_t v);
+        static size_t CountLess(const int64_t *arr, size_t len, int64_t v);
+        static size_t CountLess(const uint64_t *arr, size_t len, uint64_t v);
+
+        /**
+         * @brief 按位模式比较的版本
+         * @details arr为任意4/8字节整数类型的数组(如long long, wchar_t), 只经由memcpy和SIMD加载读取,
+         *          不会通过不同类型的指针访问元素; v为元素的位模式, is_signed指定按有符号还是无符号比较
+         */
+        static size_t CountLess32(const void *arr, size_t len, uint32_t v, bool is_signed);
+        static size_t CountLess64(const void *arr, size_t len, uint64_t v, bool is_signed);
+    };
+
+    namespace detail
+    {
+
+        //可以交给SearchSimd的类型: 4/8字节整数(不含bool和字符类型)
+        template <class T>
+        struct IsSimdSearchable
+            : std::integral_constant<bool, std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+                                               (sizeof(T) == 4 || sizeof(T) == 8)>
+        {
+        };
+
+        template <class T>
+        size_t LinearLowerBound(const T *arr, size_t len, const T &v)
+        {
+            if constexpr (IsSimdSearchable<T>::value)
+            {
+                //T可能与int64_t等是不同的类型(如long long), 不能转换指针类型后读取, 按位模式传入
+                if constexpr (sizeof(T) == 4)
+                {
+                    return SearchSimd::CountLess32(arr, len, (uint32_t)v, std::is_signed<T>::value);
+                }
+                else
+                {
+                    return SearchSimd::CountLess64(arr, len, (uint64_t)v, std::is_signed<T>::value);
+                }
+            }
+            else
+            {
+                size_t n = 0;
+                while (n < len && arr[n] < v)
+                {
+                    ++n;
+                }
+                return n;
+            }
+        }
+
+        //idx为lower_bound下标, 转换为BinarySearch的返回约定
+        template <class T>
+        int SearchResult(const T *arr, int length, int idx, const T &v)
+        {
+            if (idx < length && !(v < arr[idx]))
+            {
+                return idx;
+            }
+            return -idx - 1;
+        }
+
+    }
+
+    /**
+     * @brief 线性查找
+     * @details 返回约定与BinarySearch相同: 存在时返回下标, 否则返回应插入位置的-(index + 1);
+     *          有重复元素时返回第一个。
+     *          4/8字节整数使用SIMD, 几十个元素以内的小数组比二分查找快
+     */
+    template <class T>
+    int LinearSearch(const T *arr, int length, const T &v)
+    {
+        if (length <= 0)
+        {
+            return -1;
+        }
+        return detail::SearchResult(arr, length, (int)detail::LinearLowerBound(arr, length, v), v);
+    }
+
+    /**
+     * @brief 无分支二分查找
+     * @details 每步只根据比较结果移动起点(编译为条件传送), 循环次数固定为log2(length),
+     *          没有分支预测失败; 同时预取下一步可能访问的两个位置。
+     *          返回约定与BinarySearch相同, 有重复元素时返回第一个
+     */
+    template <class T>
+    int BranchlessSearch(const T *arr, int length, const T &v)
+    {
+        if (length <= 0)
+        {
+            return -1;
+        }
+        const T *base = arr;
+        int n = length;
+        while (n > 1)
+        {
+            int half = n / 2;
+            __builtin_prefetch(base + half / 2);
+            __builtin_prefetch(base + half + half / 2);
+            base = (base[half] < v) ? base + half : base;
+            n -= half;
+        }
+        int idx = (int)(base - arr) + (*base < v);
+        return detail::SearchResult(arr, length, idx, v);
+    }
+
+    namespace detail
+    {
+
+        //Eytzinger布局中节点k(1起始)在有序数组中的下标, n为节点数
+        inline size_t EytzingerRank(size_t k, size_t n)
+        {
+            size_t height = 63 - __builtin_clzll(n);
+            size_t depth = 63 - __builtin_clzll(k);
+            //满二叉树中的中序位置
+            size_t r = ((2 * (k - ((size_t)1 << depth)) + 1) << (height - depth)) - 1;
+            //最后一层不满, 减去排在前面的缺失叶子(满二叉树中叶子在偶数位置)
+            size_t leaves = n - ((size_t)1 << height) + 1;
+            size_t before = (r + 1) / 2;
+            return before > leaves ? r - (before - leaves) : r;
+        }
+
+    }
+
+    /**
+     * @brief 把有序数组转换为Eytzinger布局
+     * @details 按完全二叉树的层序(BFS)排列, out[k - 1]的子节点为out[2k - 1]和out[2k]。
+     *          out不能与sorted重叠
+     */
+    template <class T>
+    void EytzingerLayout(const T *sorted, int length, T *out)
+    {
+        for (int k = 1; k <= length; ++k)
+        {
+            out[k - 1] = sorted[detail::EytzingerRank(k, length)];
+        }
+    }
+
+    /**
+     * @brief 在Eytzinger布局的数组上查找
+     * @details arr由EytzingerLayout生成。查找路径上前几层集中在同一组缓存行,
+     *          并且每步预取4层之后的节点块, 大表(超出L2)上比二分查找的缓存未命中少得多。
+     *          返回约定与BinarySearch相同, 下标是原有序数组的下标, 有重复元素时返回第一个
+     */
+    template <class T>
+    int EytzingerSearch(const T *arr, int length, const T &v)
+    {
+        if (length <= 0)
+        {
+            return -1;
+        }
+        //4层之后的子树节点在k * 16附近, 按元素大小换算成一个缓存行
+        const size_t stride = sizeof(T) >= 64 ? 1 : 64 / sizeof(T);
+        const T *tree = arr - 1;
+        size_t n = length;
+        size_t k = 1;
+        while (k <= n)
+        {
+            __builtin_prefetch(arr + std::min(k * stride, n) - 1);
+            k = 2 * k + (tree[k] < v);
+        }
+        //去掉最后连续向右走的步数, 回到第一个不小于v的节点
+        k >>= __builtin_ffsll(~k);
+        if (k == 0)
+        {
+            return -length - 1;
+        }
+        int idx = (int)detail::EytzingerRank(k, n);
+        return v < tree[k] ? -idx - 1 : idx;
+    }
+
+    /**
+     * @brief 拥有存储的Eytzinger查找树
+     * @details 构建后只读, 可以多线程并发查找; find()返回的是原有序数组的下标
+     */
+    template <class T>
+    class EytzingerTree
+    {
+    public:
+        EytzingerTree() {}
+
+        //arr必须已排序
+        EytzingerTree(const T *arr, int length) { build(arr, length); }
+
+        explicit EytzingerTree(const std::vector<T> &sorted) { build(sorted.data(), (int)sorted.size()); }
+
+        //从有序数组构建
+        void build(const T *arr, int length)
+        {
+            m_tree.resize(length > 0 ? length : 0);
+            EytzingerLayout(arr, length, m_tree.data());
+        }
+
+        //查找v, 返回约定同EytzingerSearch
+        int find(const T &v) const { return EytzingerSearch(m_tree.data(), (int)m_tree.size(), v); }
+
+        int size() const { return (int)m_tree.size(); }
+
+        //Eytzinger布局的数据
+        const T *data() const { return m_tree.data(); }
+
+    private:
+        std::vector<T> m_tree;
+    };
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,420 @@
+#include "sylar/util/slab_pool.h"
+#include "sylar/mutex.h"
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <set>
+
+namespace sylar
+{
+
+    namespace
+    {
+
+        //大小级别数: 16-128按16递增8级, 128-4096每个2的幂4级共20级
+        static const size_t s_class_count = 28;
+
+        //每个slab的最小大小
+        static const size_t s_slab_size = 64 * 1024;
+
+        //每个slab至少切出的对象数
+        static const size_t s_min_objects_per_slab = 8;
+
+        inline size_t ClassIndex(size_t size)
+        {
+            if (size <= 128)
+            {
+                return size ? (size + 15) / 16 - 1 : 0;
+            }
+            size_t lg = 63 - __builtin_clzll(size - 1);
+            return 8 + (lg - 7) * 4 + ((size - 1) >> (lg - 2)) - 4;
+        }
+
+        inline size_t ClassSize(size_t idx)
+        {
+            if (idx < 8)
+            {
+                return (idx + 1) * 16;
+            }
+            size_t k = idx - 8;
+            size_t lg = 7 + k / 4;
+            return ((size_t)1 << lg) + (k % 4 + 1) * ((size_t)1 << (lg - 2));
+        }
+
+        //线程缓存每级最多保留的对象数, 超过时还回一半; 也是与全局链表交换的批量
+        inline uint32_t CacheLimit(size_t idx)
+        {
+            return (uint32_t)std::max<size_t>(8, std::min<size_t>(256, 32 * 1024 / ClassSize(idx)));
+        }
+
+        //空闲对象的第一个字用作链表指针
+        inline void *&NextOf(void *p)
+        {
+            return *(void **)p;
+        }
+
+        //只由一个线程写入的计数器, 其他线程可以读到近似值
+        struct Counter
+        {
+            std::atomic<uint64_t> value{0};
+
+            void inc() { value.store(value.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed); }
+            uint64_t get() const { return value.load(std::memory_order_relaxed); }
+        };
+
+        //全局链表
+        struct CentralList
+        {
+            Spinlock mutex;
+            void *head = nullptr;
+            size_t count = 0;
+            uint64_t slabs = 0;
+            uint64_t reservedBytes = 0;
+        };
+
+        class ThreadCache;
+
+        /**
+         * @brief 全局状态
+         * @details 有意不析构: 其他静态对象析构时仍可能释放池化对象
+         */
+        struct Central
+        {
+            CentralList lists[s_class_count];
+
+            Mutex registryMutex;
+            std::set<ThreadCache *> caches;
+            //已退出线程的计数
+            uint64_t deadAllocs[s_class_count] = {0};
+            uint64_t deadFrees[s_class_count] = {0};
+
+            std::atomic<uint64_t> largeAllocs{0};
+            std::atomic<uint64_t> largeFrees{0};
+
+            static Central &Get()
+            {
+                static Central *s_central = new Central;
+                return *s_central;
+            }
+
+            /**
+             * @brief 取出最多n个对象, 链表为空时切分新slab
+             * @return 链表头, 实际个数写入got
+             */
+            void *fetch(size_t idx, uint32_t n, uint32_t &got)
+            {
+                CentralList &cl = lists[idx];
+                Spinlock::Lock lock(cl.mutex);
+                if (!cl.head)
+                {
+                    size_t osize = ClassSize(idx);
+                    size_t bytes = std::max(s_slab_size, osize * s_min_objects_per_slab);
+                    size_t count = bytes / osize;
+                    char *slab = (char *)aligned_alloc(SlabPool::ALIGNMENT, count * osize);
+                    if (!slab)
+                    {
+                        got = 0;
+                        return nullptr;
+                    }
+                    for (size_t i = 0; i < count; ++i)
+                    {
+                        void *p = slab + i * osize;
+                        NextOf(p) = cl.head;
+                        cl.head = p;
+                    }
+                    cl.count += count;
+                    ++cl.slabs;
+                    cl.reservedBytes += count * osize;
+                }
+                void *head = cl.head;
+                void *tail = head;
+                got = 1;
+                while (got < n && NextOf(tail))
+                {
+                    tail = NextOf(tail);
+                    ++got;
+                }
+                cl.head = NextOf(tail);
+                NextOf(tail) = nullptr;
+                cl.count -= got;
+                return head;
+            }
+
+            //归还[head, tail]共n个对象
+            void release(size_t idx, void *head, void *tail, uint32_t n)
+            {
+                CentralList &cl = lists[idx];
+                Spinlock::Lock lock(cl.mutex);
+                NextOf(tail) = cl.head;
+                cl.head = head;
+                cl.count += n;
+            }
+        };
+
+        struct FreeList
+        {
+            void *head = nullptr;
+            uint32_t count = 0;
+        };
+
+        static thread_local ThreadCache *t_cache = nullptr;
+        static thread_local bool t_cache_dead = false;
+
+        /**
+         * @brief 线程缓存
+         * @details 只由所属线程访问; 线程退出时空闲对象还给全局链表
+         */
+        class ThreadCache
+        {
+        public:
+            ThreadCache()
+            {
+                Central &c = Central::Get();
+                Mutex::Lock lock(c.registryMutex);
+                c.caches.insert(this);
+            }
+
+            ~ThreadCache()
+            {
+                flush();
+                Central &c = Central::Get();
+                Mutex::Lock lock(c.registryMutex);
+                for (size_t i = 0; i < s_class_count; ++i)
+                {
+                    c.deadAllocs[i] += allocs[i].get();
+                    c.deadFrees[i] += frees[i].get();
+                }
+                c.caches.erase(this);
+                t_cache = nullptr;
+                t_cache_dead = true;
+            }
+
+            void *allocate(size_t idx)
+            {
+                allocs[idx].inc();
+                FreeList &fl = lists[idx];
+                if (fl.head)
+                {
+                    void *p = fl.head;
+                    fl.head = NextOf(p);
+                    --fl.count;
+                    return p;
+                }
+                uint32_t got = 0;
+                void *head = Central::Get().fetch(idx, CacheLimit(idx), got);
+                if (!head)
+                {
+                    throw std::bad_alloc();
+                }
+                fl.head = NextOf(head);
+                fl.count = got - 1;
+                return head;
+            }
+
+            void deallocate(void *p, size_t idx)
+            {
+                frees[idx].inc();
+                FreeList &fl = lists[idx];
+                NextOf(p) = fl.head;
+                fl.head = p;
+                uint32_t limit = CacheLimit(idx);
+                if (++fl.count > limit)
+                {
+                    //还回一半, 保留的一半应付接下来的分配
+                    releaseBatch(idx, fl.count - limit / 2);
+                }
+            }
+
+            void flush()
+            {
+                for (size_t i = 0; i < s_class_count; ++i)
+                {
+                    if (lists[i].count)
+                    {
+                        releaseBatch(i, lists[i].count);
+                    }
+                }
+            }
+
+            uint64_t getAllocs(size_t idx) const { return allocs[idx].get(); }
+            uint64_t getFrees(size_t idx) const { return frees[idx].get(); }
+
+        private:
+            void releaseBatch(size_t idx, uint32_t n)
+            {
+                FreeList &fl = lists[idx];
+                void *head = fl.head;
+                void *tail = head;
+                for (uint32_t i = 1; i < n; ++i)
+                {
+                    tail = NextOf(tail);
+                }
+                fl.head = NextOf(tail);
+                fl.count -= n;
+                Central::Get().release(idx, head, tail, n);
+            }
+
+        private:
+            FreeList lists[s_class_count];
+            Counter allocs[s_class_count];
+            Counter frees[s_class_count];
+        };
+
+        //线程退出后(其他thread_local对象析构时)返回nullptr, 直接使用全局链表
+        inline ThreadCache *GetThreadCache()
+        {
+            if (t_cache)
+            {
+                return t_cache;
+            }
+            if (t_cache_dead)
+            {
+                return nullptr;
+            }
+            static thread_local ThreadCache s_cache;
+            t_cache = &s_cache;
+            return t_cache;
+        }
+
+        class SlabResource : public std::pmr::memory_resource
+        {
+        protected:
+            void *do_allocate(size_t bytes, size_t alignment) override
+            {
+                if (alignment > SlabPool::ALIGNMENT)
+                {
+                    return ::operator new(bytes, std::align_val_t(alignment));
+                }
+                return SlabPool::Allocate(bytes);
+            }
+
+            void do_deallocate(void *p, size_t bytes, size_t alignment) override
+            {
+                if (alignment > SlabPool::ALIGNMENT)
+                {
+                    ::operator delete(p, bytes, std::align_val_t(alignment));
+                    return;
+                }
+                SlabPool::Deallocate(p, bytes);
+            }
+
+            bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+            {
+                return this == &other;
+            }
+        };
+
+    }
+
+    void *SlabPool::Allocate(size_t size)
+    {
+        if (size > MAX_SIZE)
+        {
+            Central::Get().largeAllocs.fetch_add(1, std::memory_order_relaxed);
+            return ::operator new(size);
+        }
+        size_t idx = ClassIndex(size);
+        ThreadCache *cache = GetThreadCache();
+        if (cache)
+        {
+            return cache->allocate(idx);
+        }
+        uint32_t got = 0;
+        void *p = Central::Get().fetch(idx, 1, got);
+        if (!p)
+        {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+
+    void SlabPool::Deallocate(void *p, size_t size)
+    {
+        if (!p)
+        {
+            return;
+        }
+        if (size > MAX_SIZE)
+        {
+            Central::Get().largeFrees.fetch_add(1, std::memory_order_relaxed);
+            ::operator delete(p);
+            return;
+        }
+        size_t idx = ClassIndex(size);
+        ThreadCache *cache = GetThreadCache();
+        if (cache)
+        {
+            cache->deallocate(p, idx);
+            return;
+        }
+        Central::Get().release(idx, p, p, 1);
+    }
+
+    size_t SlabPool::GetAllocSize(size_t size)
+    {
+        return size > MAX_SIZE ? size : ClassSize(ClassIndex(size));
+    }
+
+    void SlabPool::GetStats(std::vector<SlabStats> &stats)
+    {
+        Central &c = Central::Get();
+        stats.assign(s_class_count + 1, SlabStats());
+        {
+            Mutex::Lock lock(c.registryMutex);
+            for (size_t i = 0; i < s_class_count; ++i)
+            {
+                stats[i].allocs = c.deadAllocs[i];
+                stats[i].frees = c.deadFrees[i];
+            }
+            for (auto cache : c.caches)
+            {
+                for (size_t i = 0; i < s_class_count; ++i)
+                {
+                    stats[i].allocs += cache->getAllocs(i);
+                    stats[i].frees += cache->getFrees(i);
+                }
+            }
+        }
+        for (size_t i = 0; i < s_class_count; ++i)
+        {
+            CentralList &cl = c.lists[i];
+            Spinlock::Lock lock(cl.mutex);
+            stats[i].objectSize = ClassSize(i);
+            stats[i].slabs = cl.slabs;
+            stats[i].reservedBytes = cl.reservedBytes;
+        }
+        stats[s_class_count].allocs = c.largeAllocs.load(std::memory_order_relaxed);
+        stats[s_class_count].frees = c.largeFrees.load(std::memory_order_relaxed);
+    }
+
+    SlabStats SlabPool::GetTotalStats()
+    {
+        std::vector<SlabStats> stats;
+        GetStats(stats);
+        SlabStats total;
+        for (auto &i : stats)
+        {
+            total.allocs += i.allocs;
+            total.frees += i.frees;
+            total.slabs += i.slabs;
+            total.reservedBytes += i.reservedBytes;
+        }
+        return total;
+    }
+
+    void SlabPool::FlushThreadCache()
+    {
+        if (t_cache)
+        {
+            t_cache->flush();
+        }
+    }
+
+    std::pmr::memory_resource *SlabPool::GetResource()
+    {
+        //与Central一样不析构
+        static SlabResource *s_resource = new SlabResource;
+        return s_resource;
+    }
+
+}
\ No newline at end of file
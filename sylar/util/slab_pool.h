@@ -0,0 +1,116 @@
+#ifndef __SYLAR_UTIL_SLAB_POOL_H__
+#define __SYLAR_UTIL_SLAB_POOL_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace sylar
+{
+
+    //一个大小级别的分配统计
+    struct SlabStats
+    {
+        size_t objectSize = 0;      /// 对象大小, 0表示超过最大级别直接走operator new的分配
+        uint64_t allocs = 0;        /// 累计分配次数
+        uint64_t frees = 0;         /// 累计释放次数
+        uint64_t slabs = 0;         /// 向系统申请的slab数
+        uint64_t reservedBytes = 0; /// slab占用的字节数
+
+        //正在使用的对象数
+        uint64_t inUse() const { return allocs - frees; }
+    };
+
+    /**
+     * @brief 按大小分级的slab内存池
+     * @details 不超过MAX_SIZE的请求按大小级别(16字节步长到128, 之后每个2的幂分4级)
+     *          从对应级别的空闲链表分配。每个线程有自己的缓存, 分配/释放通常不加锁;
+     *          线程缓存为空或过多时与全局链表成批交换。
+     *          全局链表从64KB的slab切分对象, slab不归还给系统。
+     *          释放时必须给出分配时的大小(sized delete)
+     */
+    class SlabPool
+    {
+    public:
+        //池化的最大对象大小
+        static const size_t MAX_SIZE = 4096;
+        //对象对齐
+        static const size_t ALIGNMENT = 16;
+
+        //分配size字节, 16字节对齐
+        static void *Allocate(size_t size);
+
+        //释放, size必须与分配时一致
+        static void Deallocate(void *p, size_t size);
+
+        //size所在级别的实际对象大小, 超过MAX_SIZE时返回size
+        static size_t GetAllocSize(size_t size);
+
+        /**
+         * @brief 分配统计
+         * @details 每个大小级别一项, 最后一项是超过MAX_SIZE的分配;
+         *          线程缓存的计数只由所属线程写入, 读取结果是近似的快照
+         */
+        static void GetStats(std::vector<SlabStats> &stats);
+
+        //汇总统计
+        static SlabStats GetTotalStats();
+
+        //当前线程缓存的空闲对象全部还给全局链表(线程长时间空闲前调用)
+        static void FlushThreadCache();
+
+        //基于SlabPool的std::pmr::memory_resource, 全局唯一
+        static std::pmr::memory_resource *GetResource();
+    };
+
+    /**
+     * @brief 使派生类的new/delete走SlabPool
+     * @details 只适合没有派生类或析构函数为虚函数的类型, 否则sized delete拿到的大小不对
+     */
+    struct SlabAllocated
+    {
+        static void *operator new(size_t size) { return SlabPool::Allocate(size); }
+        static void operator delete(void *p, size_t size) { SlabPool::Deallocate(p, size); }
+    };
+
+    /**
+     * @brief 定长对象池
+     * @details SlabPool的类型化封装
+     */
+    template <class T>
+    class ObjectPool
+    {
+    public:
+        static_assert(alignof(T) <= SlabPool::ALIGNMENT, "over-aligned type");
+
+        template <class... Args>
+        static T *New(Args &&...args)
+        {
+            void *p = SlabPool::Allocate(sizeof(T));
+            try
+            {
+                return new (p) T(std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                SlabPool::Deallocate(p, sizeof(T));
+                throw;
+            }
+        }
+
+        static void Delete(T *p)
+        {
+            if (p)
+            {
+                p->~T();
+                SlabPool::Deallocate(p, sizeof(T));
+            }
+        }
+    };
+
+}
+
+#endif
\ No newline at end of file
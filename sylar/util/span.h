@@ -0,0 +1,118 @@
+#ifndef __SYLAR_UTIL_SPAN_H__
+#define __SYLAR_UTIL_SPAN_H__
+
+#include <stddef.h>
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+namespace sylar
+{
+
+    /**
+     * @brief 连续内存的非拥有视图
+     * @details C++17下std::span的最小替代, 只引用数据, 不复制, 生命周期由数据所有者保证
+     */
+    template <class T>
+    class Span
+    {
+    public:
+        typedef T element_type;
+        typedef typename std::remove_cv<T>::type value_type;
+        typedef T *iterator;
+
+        Span() {}
+        Span(T *data, size_t size) : m_data(data), m_size(size) {}
+
+        template <class U, class = typename std::enable_if<std::is_convertible<U (*)[], T (*)[]>::value>::type>
+        Span(const Span<U> &r) : m_data(r.data()), m_size(r.size()) {}
+
+        template <class U, class A, class = typename std::enable_if<std::is_convertible<U (*)[], T (*)[]>::value>::type>
+        Span(std::vector<U, A> &v) : m_data(v.data()), m_size(v.size()) {}
+
+        template <class U, class A, class = typename std::enable_if<std::is_convertible<const U (*)[], T (*)[]>::value>::type>
+        Span(const std::vector<U, A> &v) : m_data(v.data()), m_size(v.size()) {}
+
+        T *data() const { return m_data; }
+        size_t size() const { return m_size; }
+        bool empty() const { return m_size == 0; }
+
+        T &operator[](size_t i) const { return m_data[i]; }
+        T *begin() const { return m_data; }
+        T *end() const { return m_data + m_size; }
+        T &front() const { return m_data[0]; }
+        T &back() const { return m_data[m_size - 1]; }
+
+        //[offset, offset + count)的子视图, 越界部分截掉
+        Span subspan(size_t offset, size_t count = (size_t)-1) const
+        {
+            offset = std::min(offset, m_size);
+            return Span(m_data + offset, std::min(count, m_size - offset));
+        }
+
+        Span first(size_t count) const { return subspan(0, count); }
+        Span last(size_t count) const { return subspan(m_size - std::min(count, m_size)); }
+
+    private:
+        T *m_data = nullptr;
+        size_t m_size = 0;
+    };
+
+    template <class T, class A>
+    Span<T> MakeSpan(std::vector<T, A> &v)
+    {
+        return Span<T>(v.data(), v.size());
+    }
+
+    template <class T, class A>
+    Span<const T> MakeSpan(const std::vector<T, A> &v)
+    {
+        return Span<const T>(v.data(), v.size());
+    }
+
+    //src按每块size个元素切分的块数; size为0时非空的src算作一块
+    inline size_t SliceCount(size_t total, size_t size)
+    {
+        if (size == 0)
+        {
+            return total ? 1 : 0;
+        }
+        return (total + size - 1) / size;
+    }
+
+    /**
+     * @brief 把src按每块size个元素切分为视图, 最后一块可能不足size
+     * @details 只产生视图, 不复制元素; size为0时整个src作为一块, 与ParallelFor一致
+     */
+    template <class T>
+    std::vector<Span<T>> SliceView(Span<T> src, size_t size)
+    {
+        std::vector<Span<T>> rt;
+        size_t count = SliceCount(src.size(), size);
+        if (size == 0)
+        {
+            size = src.size();
+        }
+        rt.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            rt.push_back(src.subspan(i * size, size));
+        }
+        return rt;
+    }
+
+    template <class T, class A>
+    std::vector<Span<const T>> SliceView(const std::vector<T, A> &src, size_t size)
+    {
+        return SliceView(MakeSpan(src), size);
+    }
+
+    template <class T, class A>
+    std::vector<Span<T>> SliceView(std::vector<T, A> &src, size_t size)
+    {
+        return SliceView(MakeSpan(src), size);
+    }
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,394 @@
+#include "sylar/util/stack_trace.h"
+#include "sylar/util/demangle.h"
+#include <execinfo.h>
+#include <dlfcn.h>
+#include <link.h>
+#include <elf.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/wait.h>
+#include <algorithm>
+#include <map>
+#include <sstream>
+
+extern char **environ;
+
+namespace sylar
+{
+
+    //backtrace()第一次调用会dlopen libgcc_s, 不是异步信号安全的, 启动时先调用一次
+    struct BacktracePreloader
+    {
+        BacktracePreloader()
+        {
+            void *buf[1];
+            ::backtrace(buf, 1);
+        }
+    };
+    static BacktracePreloader s_backtrace_preloader;
+
+    //两个相邻栈帧之间允许的最大距离, 超出认为帧指针链已损坏
+    static const uintptr_t s_max_frame_size = 8 * 1024 * 1024;
+
+    __attribute__((noinline)) int StackTrace::capture(int skip, bool use_frame_pointer, int max_depth)
+    {
+        if (max_depth > MAX_DEPTH)
+        {
+            max_depth = MAX_DEPTH;
+        }
+        if (skip < 0)
+        {
+            skip = 0;
+        }
+        size = 0;
+        if (use_frame_pointer)
+        {
+            //帧记录布局: [fp] = 上一层fp, [fp + 1] = 返回地址
+            void **fp = (void **)__builtin_frame_address(0);
+            int idx = 0;
+            while (fp && size < max_depth)
+            {
+                void **next = (void **)fp[0];
+                void *ret = fp[1];
+                if (!ret)
+                {
+                    break;
+                }
+                if (idx++ >= skip)
+                {
+                    frames[size++] = ret;
+                }
+                if (next <= fp || (uintptr_t)next - (uintptr_t)fp > s_max_frame_size || ((uintptr_t)next & (sizeof(void *) - 1)))
+                {
+                    break;
+                }
+                fp = next;
+            }
+            return size;
+        }
+
+        //buf[0]是本函数
+        void *buf[MAX_DEPTH + 32];
+        int want = skip + 1 + max_depth;
+        if (want > (int)(sizeof(buf) / sizeof(buf[0])))
+        {
+            want = sizeof(buf) / sizeof(buf[0]);
+        }
+        int n = ::backtrace(buf, want);
+        for (int i = skip + 1; i < n && size < max_depth; ++i)
+        {
+            frames[size++] = buf[i];
+        }
+        return size;
+    }
+
+    uint64_t StackTrace::hash() const
+    {
+        uint64_t h = 0x9e3779b97f4a7c15ull ^ (uint64_t)size;
+        for (int i = 0; i < size; ++i)
+        {
+            h ^= (uint64_t)(uintptr_t)frames[i];
+            h *= 0xff51afd7ed558ccdull;
+            h ^= h >> 33;
+        }
+        return h;
+    }
+
+    bool StackTrace::operator==(const StackTrace &o) const
+    {
+        return size == o.size && memcmp(frames, o.frames, size * sizeof(void *)) == 0;
+    }
+
+    /**
+     * @brief 计算地址所在的模块和用于符号化的偏移
+     * @details 返回地址指向call的下一条指令, 减1后落在call指令内, 行号才准确。
+     *          位置无关的模块(ET_DYN)用相对加载基址的偏移, 非PIE可执行文件用绝对地址
+     */
+    static bool ModuleOffset(void *addr, Dl_info &info, uintptr_t &offset)
+    {
+        uintptr_t pc = (uintptr_t)addr - 1;
+        if (!dladdr((void *)pc, &info) || !info.dli_fbase)
+        {
+            return false;
+        }
+        const ElfW(Ehdr) *ehdr = (const ElfW(Ehdr) *)info.dli_fbase;
+        if (memcmp(ehdr->e_ident, ELFMAG, SELFMAG) == 0 && ehdr->e_type == ET_EXEC)
+        {
+            offset = pc;
+        }
+        else
+        {
+            offset = pc - (uintptr_t)info.dli_fbase;
+        }
+        return true;
+    }
+
+    //dladdr返回的主程序路径可能为空, 用/proc/self/exe代替
+    static std::string ModulePath(const Dl_info &info)
+    {
+        if (info.dli_fname && info.dli_fname[0])
+        {
+            return info.dli_fname;
+        }
+        char buf[4096];
+        ssize_t n = readlink("/proc/self/exe", buf, sizeof(buf) - 1);
+        return n > 0 ? std::string(buf, n) : std::string();
+    }
+
+    std::string StackTrace::toRawString(const std::string &prefix) const
+    {
+        std::stringstream ss;
+        for (int i = 0; i < size; ++i)
+        {
+            Dl_info info;
+            uintptr_t offset = 0;
+            ss << prefix;
+            if (ModuleOffset(frames[i], info, offset))
+            {
+                ss << ModulePath(info) << "+0x" << std::hex << offset << std::dec;
+            }
+            else
+            {
+                ss << frames[i];
+            }
+            ss << std::endl;
+        }
+        return ss.str();
+    }
+
+    std::string StackFrame::toString() const
+    {
+        std::stringstream ss;
+        ss << (function.empty() ? "??" : function);
+        if (!function.empty() && funcOffset)
+        {
+            ss << "+0x" << std::hex << funcOffset << std::dec;
+        }
+        if (!module.empty())
+        {
+            ss << " (" << module << "+0x" << std::hex << offset << std::dec << ")";
+        }
+        else
+        {
+            ss << " [" << addr << "]";
+        }
+        if (!file.empty())
+        {
+            ss << " " << file << ":" << line;
+        }
+        return ss.str();
+    }
+
+    Symbolizer::Symbolizer()
+        : m_addr2line("addr2line")
+    {
+    }
+
+    void Symbolizer::Resolve(void *addr, StackFrame &frame)
+    {
+        frame.addr = addr;
+        Dl_info info;
+        if (!ModuleOffset(addr, info, frame.offset))
+        {
+            return;
+        }
+        frame.module = ModulePath(info);
+        if (info.dli_sname)
+        {
+            frame.function = Demangler::Demangle(info.dli_sname);
+            frame.funcOffset = (uintptr_t)addr - (uintptr_t)info.dli_saddr;
+        }
+    }
+
+    void Symbolizer::symbolize(void *const *addrs, size_t size, std::vector<StackFrame> &frames, bool use_addr2line)
+    {
+        frames.resize(size);
+        std::vector<size_t> missing;
+        {
+            RWMutexType::ReadLock lock(m_mutex);
+            for (size_t i = 0; i < size; ++i)
+            {
+                auto it = m_cache.find(addrs[i]);
+                if (it == m_cache.end() || (use_addr2line && !it->second.lines))
+                {
+                    missing.push_back(i);
+                }
+                else
+                {
+                    frames[i] = it->second.frame;
+                }
+            }
+        }
+        if (missing.empty())
+        {
+            return;
+        }
+
+        //不持锁解析, addr2line是外部进程, 可能很慢
+        std::vector<Entry> entries(missing.size());
+        std::map<std::string, std::vector<Entry *>> modules;
+        for (size_t i = 0; i < missing.size(); ++i)
+        {
+            Resolve(addrs[missing[i]], entries[i].frame);
+            entries[i].lines = use_addr2line;
+            if (use_addr2line && !entries[i].frame.module.empty())
+            {
+                modules[entries[i].frame.module].push_back(&entries[i]);
+            }
+        }
+        for (auto &i : modules)
+        {
+            runAddr2line(i.first, i.second);
+        }
+
+        RWMutexType::WriteLock lock(m_mutex);
+        for (size_t i = 0; i < missing.size(); ++i)
+        {
+            frames[missing[i]] = entries[i].frame;
+            m_cache[addrs[missing[i]]] = std::move(entries[i]);
+        }
+    }
+
+    //执行addr2line并返回标准输出
+    static bool RunCommand(const std::vector<std::string> &args, std::string &output)
+    {
+        int fds[2];
+        if (pipe2(fds, O_CLOEXEC) != 0)
+        {
+            return false;
+        }
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+        posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+
+        std::vector<char *> argv;
+        for (auto &i : args)
+        {
+            argv.push_back(const_cast<char *>(i.c_str()));
+        }
+        argv.push_back(nullptr);
+
+        pid_t pid;
+        int rt = posix_spawnp(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+        posix_spawn_file_actions_destroy(&actions);
+        close(fds[1]);
+        if (rt != 0)
+        {
+            close(fds[0]);
+            return false;
+        }
+
+        char buf[4096];
+        while (true)
+        {
+            ssize_t n = read(fds[0], buf, sizeof(buf));
+            if (n > 0)
+            {
+                output.append(buf, n);
+            }
+            else if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            else
+            {
+                break;
+            }
+        }
+        close(fds[0]);
+        int status = 0;
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+        {
+        }
+        return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+
+    void Symbolizer::runAddr2line(const std::string &module, std::vector<Entry *> &entries)
+    {
+        //命令行长度有限, 每次最多解析一批
+        static const size_t s_batch = 128;
+        std::string addr2line;
+        {
+            RWMutexType::ReadLock lock(m_mutex);
+            addr2line = m_addr2line;
+        }
+        for (size_t begin = 0; begin < entries.size(); begin += s_batch)
+        {
+            size_t end = std::min(entries.size(), begin + s_batch);
+            std::vector<std::string> args = {addr2line, "-f", "-C", "-e", module};
+            for (size_t i = begin; i < end; ++i)
+            {
+                std::stringstream ss;
+                ss << "0x" << std::hex << entries[i]->frame.offset;
+                args.push_back(ss.str());
+            }
+            std::string output;
+            if (!RunCommand(args, output))
+            {
+                return;
+            }
+
+            //每个地址输出两行: 函数名, 文件:行号
+            std::stringstream ss(output);
+            std::string func, loc;
+            for (size_t i = begin; i < end && std::getline(ss, func) && std::getline(ss, loc); ++i)
+            {
+                StackFrame &frame = entries[i]->frame;
+                //dladdr只认识导出符号, 静态函数会被算到前面最近的导出符号上, 以addr2line为准
+                if (func != "??" && func != frame.function)
+                {
+                    frame.function = func;
+                    frame.funcOffset = 0;
+                }
+                size_t pos = loc.find(" (discriminator");
+                if (pos != std::string::npos)
+                {
+                    loc.resize(pos);
+                }
+                pos = loc.rfind(':');
+                if (pos == std::string::npos || loc.compare(0, 2, "??") == 0)
+                {
+                    continue;
+                }
+                frame.file = loc.substr(0, pos);
+                frame.line = atoi(loc.c_str() + pos + 1);
+            }
+        }
+    }
+
+    std::string Symbolizer::toString(const StackTrace &st, const std::string &prefix, bool use_addr2line)
+    {
+        std::vector<StackFrame> frames;
+        symbolize(st, frames, use_addr2line);
+        std::stringstream ss;
+        for (auto &i : frames)
+        {
+            ss << prefix << i.toString() << std::endl;
+        }
+        return ss.str();
+    }
+
+    void Symbolizer::setAddr2line(const std::string &v)
+    {
+        RWMutexType::WriteLock lock(m_mutex);
+        m_addr2line = v;
+    }
+
+    void Symbolizer::clear()
+    {
+        RWMutexType::WriteLock lock(m_mutex);
+        m_cache.clear();
+    }
+
+    size_t Symbolizer::getCacheSize()
+    {
+        RWMutexType::ReadLock lock(m_mutex);
+        return m_cache.size();
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+#ifndef __SYLAR_UTIL_STACK_TRACE_H__
+#define __SYLAR_UTIL_STACK_TRACE_H__
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "sylar/mutex.h"
+#include "sylar/singleton.h"
+
+namespace sylar
+{
+
+    /**
+     * @brief 调用栈快照
+     * @details 只保存原始返回地址, 定长数组, 采集时不分配内存,
+     *          可以作为值保存/拷贝, 之后或离线再符号化
+     */
+    struct StackTrace
+    {
+        //最大层数
+        static const int MAX_DEPTH = 64;
+
+        void *frames[MAX_DEPTH]; /// 返回地址, frames[0]是最内层
+        int size = 0;            /// 有效层数
+
+        /**
+         * @brief 采集当前线程的调用栈
+         * @details 异步信号安全, 可以在信号处理函数和采样钩子中调用
+         * @param[in] skip 跳过栈顶的层数(不含Capture自身)
+         * @param[in] use_frame_pointer 沿帧指针链回溯, 只有-fno-omit-frame-pointer编译的
+         *            代码才完整, 但开销只有几十纳秒; 否则使用libgcc的unwinder
+         * @param[in] max_depth 最多采集的层数, 不超过MAX_DEPTH
+         * @return 采集到的层数
+         */
+        int capture(int skip = 0, bool use_frame_pointer = false, int max_depth = MAX_DEPTH);
+
+        /**
+         * @brief 调用栈的哈希值
+         * @details 用于按调用点聚合采样结果
+         */
+        uint64_t hash() const;
+
+        bool operator==(const StackTrace &o) const;
+
+        /**
+         * @brief 不做符号化的文本形式
+         * @details 每层一行"模块路径+0x偏移", 可以保存后用addr2line离线解析
+         */
+        std::string toRawString(const std::string &prefix = "") const;
+    };
+
+    /**
+     * @brief 符号化后的单层栈信息
+     */
+    struct StackFrame
+    {
+        void *addr = nullptr;      /// 返回地址
+        std::string module;        /// 所在模块(可执行文件或动态库)路径
+        uintptr_t offset = 0;      /// 相对模块加载基址的偏移
+        std::string function;      /// 反修饰后的函数名, 未知为空
+        uintptr_t funcOffset = 0;  /// 相对函数起始的偏移
+        std::string file;          /// 源文件, 需要addr2line和调试信息
+        int line = 0;              /// 行号
+
+        //格式: 函数+0x偏移 (模块+0x偏移) 文件:行号
+        std::string toString() const;
+    };
+
+    /**
+     * @brief 带缓存的符号化
+     * @details 默认只用dladdr(只能看到导出的动态符号), 开启addr2line后
+     *          按模块分批调用一次addr2line得到静态函数名和源码行号。
+     *          结果按地址缓存, 同一调用点只解析一次
+     */
+    class Symbolizer
+    {
+    public:
+        typedef RWMutex RWMutexType;
+
+        Symbolizer();
+
+        /**
+         * @brief 符号化一批地址
+         * @param[in] addrs 返回地址
+         * @param[out] frames 与addrs一一对应的结果
+         * @param[in] use_addr2line 是否调用addr2line解析源码行号
+         */
+        void symbolize(void *const *addrs, size_t size, std::vector<StackFrame> &frames, bool use_addr2line = false);
+
+        //符号化调用栈
+        void symbolize(const StackTrace &st, std::vector<StackFrame> &frames, bool use_addr2line = false)
+        {
+            symbolize(st.frames, st.size, frames, use_addr2line);
+        }
+
+        /**
+         * @brief 符号化后格式化输出
+         * @param[in] prefix 每行的前缀
+         */
+        std::string toString(const StackTrace &st, const std::string &prefix = "", bool use_addr2line = false);
+
+        //设置addr2line程序路径, 默认从PATH查找
+        void setAddr2line(const std::string &v);
+
+        //清空缓存(模块卸载/重新加载后)
+        void clear();
+
+        //缓存的地址数
+        size_t getCacheSize();
+
+    private:
+        //缓存项
+        struct Entry
+        {
+            StackFrame frame;
+            bool lines = false; /// 是否已经用addr2line解析过
+        };
+
+        //用dladdr填充模块和导出符号
+        static void Resolve(void *addr, StackFrame &frame);
+
+        //对同一模块的一批地址调用addr2line
+        void runAddr2line(const std::string &module, std::vector<Entry *> &entries);
+
+    private:
+        RWMutexType m_mutex;
+        std::unordered_map<void *, Entry> m_cache;
+        std::string m_addr2line;
+    };
+
+    typedef sylar::SingleTon<Symbolizer> SymbolizerMgr;
+
+}
+
+#endif
\ No newline at end of file
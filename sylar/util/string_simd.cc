@@ -0,0 +1,631 @@
+#include "sylar/util/string_simd.h"
+#include "sylar/util/cpu_util.h"
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SYLAR_STRING_SIMD_X86 1
+#endif
+
+namespace sylar
+{
+
+    //不需要URL编码的字符表
+    static const char s_url_safe[256] = {
+        /* 0 */
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 1, 0, 0, 1, 0, 0, 1, 1, 1, 1, 0, 0, 1, 1, 0,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 1, 0, 0,
+        /* 64 */
+        0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 1,
+        0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 1, 0,
+        /* 128 */
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+    bool StringSimd::IsUrlSafe(unsigned char c)
+    {
+        return s_url_safe[c];
+    }
+
+    namespace
+    {
+
+        //字符集合, 用于标量查找
+        struct CharSet
+        {
+            CharSet(const char *set, size_t set_len)
+            {
+                memset(table, 0, sizeof(table));
+                for (size_t i = 0; i < set_len; ++i)
+                {
+                    table[(uint8_t)set[i]] = true;
+                }
+            }
+
+            bool contains(char c) const { return table[(uint8_t)c]; }
+
+            bool table[256];
+        };
+
+        size_t FindUrlEscapeScalar(const char *data, size_t len)
+        {
+            for (size_t i = 0; i < len; ++i)
+            {
+                if (!s_url_safe[(uint8_t)data[i]])
+                {
+                    return i;
+                }
+            }
+            return len;
+        }
+
+        size_t FindUrlUnescapeScalar(const char *data, size_t len, bool space_as_plus)
+        {
+            for (size_t i = 0; i < len; ++i)
+            {
+                if (data[i] == '%' || (space_as_plus && data[i] == '+'))
+                {
+                    return i;
+                }
+            }
+            return len;
+        }
+
+        size_t FindFirstNotOfScalar(const char *data, size_t len, const char *set, size_t set_len)
+        {
+            CharSet cs(set, set_len);
+            for (size_t i = 0; i < len; ++i)
+            {
+                if (!cs.contains(data[i]))
+                {
+                    return i;
+                }
+            }
+            return len;
+        }
+
+        size_t FindLastNotOfScalar(const char *data, size_t len, const char *set, size_t set_len)
+        {
+            CharSet cs(set, set_len);
+            while (len > 0 && cs.contains(data[len - 1]))
+            {
+                --len;
+            }
+            return len;
+        }
+
+        void ToUpperScalar(char *data, size_t len)
+        {
+            for (size_t i = 0; i < len; ++i)
+            {
+                if (data[i] >= 'a' && data[i] <= 'z')
+                {
+                    data[i] -= 0x20;
+                }
+            }
+        }
+
+        void ToLowerScalar(char *data, size_t len)
+        {
+            for (size_t i = 0; i < len; ++i)
+            {
+                if (data[i] >= 'A' && data[i] <= 'Z')
+                {
+                    data[i] += 0x20;
+                }
+            }
+        }
+
+        //JSON字符串中需要转义的字符: '"' '\\' 和控制字符
+        inline bool IsJsonSpecial(uint8_t c)
+        {
+            return c < 0x20 || c == '"' || c == '\\';
+        }
+
+        //转义增加的长度, \b \t \n \f \r '"' '\\'为2字节, 其他控制字符为\u00XX共6字节
+        inline size_t JsonEscapeExtra(uint8_t c)
+        {
+            if (!IsJsonSpecial(c))
+            {
+                return 0;
+            }
+            return (c >= 0x20 || (c >= '\b' && c <= '\n') || c == '\f' || c == '\r') ? 1 : 5;
+        }
+
+        size_t FindJsonEscapeScalar(const char *data, size_t len)
+        {
+            for (size_t i = 0; i < len; ++i)
+            {
+                if (IsJsonSpecial(data[i]))
+                {
+                    return i;
+                }
+            }
+            return len;
+        }
+
+        size_t JsonEscapeSizeScalar(const char *data, size_t len)
+        {
+            size_t size = len;
+            for (size_t i = 0; i < len; ++i)
+            {
+                size += JsonEscapeExtra(data[i]);
+            }
+            return size;
+        }
+
+#ifdef SYLAR_STRING_SIMD_X86
+
+        //x中落在[lo, hi]内的字节置为0xFF(lo, hi均小于0x80)
+        inline __m128i InRange128(__m128i x, char lo, char hi)
+        {
+            return _mm_and_si128(_mm_cmpgt_epi8(x, _mm_set1_epi8(lo - 1)),
+                                 _mm_cmplt_epi8(x, _mm_set1_epi8(hi + 1)));
+        }
+
+        //x中不需要URL编码的字节置为0xFF
+        inline __m128i UrlSafe128(__m128i x)
+        {
+            __m128i m = InRange128(_mm_or_si128(x, _mm_set1_epi8(0x20)), 'a', 'z');
+            m = _mm_or_si128(m, InRange128(x, '0', '9'));
+            m = _mm_or_si128(m, InRange128(x, '\'', '*'));
+            m = _mm_or_si128(m, InRange128(x, '-', '.'));
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(x, _mm_set1_epi8('!')));
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(x, _mm_set1_epi8('$')));
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(x, _mm_set1_epi8('=')));
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(x, _mm_set1_epi8('_')));
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(x, _mm_set1_epi8('~')));
+            return m;
+        }
+
+        //x中属于集合的字节置为0xFF, 集合补齐为4个字符
+        inline __m128i InSet128(__m128i x, const char *set4)
+        {
+            __m128i m = _mm_cmpeq_epi8(x, _mm_set1_epi8(set4[0]));
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(x, _mm_set1_epi8(set4[1])));
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(x, _mm_set1_epi8(set4[2])));
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(x, _mm_set1_epi8(set4[3])));
+            return m;
+        }
+
+        //把不超过4个字符的集合补齐为4个
+        inline void PadSet(const char *set, size_t set_len, char *set4)
+        {
+            for (size_t i = 0; i < 4; ++i)
+            {
+                set4[i] = set[i < set_len ? i : 0];
+            }
+        }
+
+        //x中需要JSON转义的字节置为0xFF
+        inline __m128i JsonSpecial128(__m128i x)
+        {
+            __m128i m = _mm_cmpeq_epi8(_mm_min_epu8(x, _mm_set1_epi8(0x1f)), x);
+            m = _mm_or_si128(m, _mm_cmpeq_epi8(x, _mm_set1_epi8('"')));
+            return _mm_or_si128(m, _mm_cmpeq_epi8(x, _mm_set1_epi8('\\')));
+        }
+
+        //x中需要\u00XX形式转义的字节置为0xFF
+        inline __m128i JsonLongEscape128(__m128i x)
+        {
+            __m128i ctrl = _mm_cmpeq_epi8(_mm_min_epu8(x, _mm_set1_epi8(0x1f)), x);
+            __m128i short_ctrl = _mm_or_si128(InRange128(x, '\b', '\n'), InRange128(x, '\f', '\r'));
+            return _mm_andnot_si128(short_ctrl, ctrl);
+        }
+
+        size_t FindJsonEscapeSSE2(const char *data, size_t len)
+        {
+            size_t i = 0;
+            for (; i + 16 <= len; i += 16)
+            {
+                __m128i x = _mm_loadu_si128((const __m128i *)(data + i));
+                uint32_t mask = _mm_movemask_epi8(JsonSpecial128(x));
+                if (mask)
+                {
+                    return i + __builtin_ctz(mask);
+                }
+            }
+            return i + FindJsonEscapeScalar(data + i, len - i);
+        }
+
+        size_t JsonEscapeSizeSSE2(const char *data, size_t len)
+        {
+            size_t extra = 0;
+            size_t i = 0;
+            for (; i + 16 <= len; i += 16)
+            {
+                __m128i x = _mm_loadu_si128((const __m128i *)(data + i));
+                uint32_t mask = _mm_movemask_epi8(JsonSpecial128(x));
+                if (mask)
+                {
+                    extra += __builtin_popcount(mask) + 4 * __builtin_popcount(_mm_movemask_epi8(JsonLongEscape128(x)));
+                }
+            }
+            return i + extra + JsonEscapeSizeScalar(data + i, len - i);
+        }
+
+        size_t FindUrlEscapeSSE2(const char *data, size_t len)
+        {
+            size_t i = 0;
+            for (; i + 16 <= len; i += 16)
+            {
+                __m128i x = _mm_loadu_si128((const __m128i *)(data + i));
+                uint32_t mask = ~_mm_movemask_epi8(UrlSafe128(x)) & 0xFFFF;
+                if (mask)
+                {
+                    return i + __builtin_ctz(mask);
+                }
+            }
+            return i + FindUrlEscapeScalar(data + i, len - i);
+        }
+
+        size_t FindUrlUnescapeSSE2(const char *data, size_t len, bool space_as_plus)
+        {
+            const __m128i pct = _mm_set1_epi8('%');
+            const __m128i plus = _mm_set1_epi8(space_as_plus ? '+' : '%');
+            size_t i = 0;
+            for (; i + 16 <= len; i += 16)
+            {
+                __m128i x = _mm_loadu_si128((const __m128i *)(data + i));
+                uint32_t mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(x, pct), _mm_cmpeq_epi8(x, plus)));
+                if (mask)
+                {
+                    return i + __builtin_ctz(mask);
+                }
+            }
+            return i + FindUrlUnescapeScalar(data + i, len - i, space_as_plus);
+        }
+
+        size_t FindFirstNotOfSSE2(const char *data, size_t len, const char *set, size_t set_len)
+        {
+            if (set_len == 0 || set_len > 4)
+            {
+                return FindFirstNotOfScalar(data, len, set, set_len);
+            }
+            char set4[4];
+            PadSet(set, set_len, set4);
+            size_t i = 0;
+            for (; i + 16 <= len; i += 16)
+            {
+                __m128i x = _mm_loadu_si128((const __m128i *)(data + i));
+                uint32_t mask = ~_mm_movemask_epi8(InSet128(x, set4)) & 0xFFFF;
+                if (mask)
+                {
+                    return i + __builtin_ctz(mask);
+                }
+            }
+            return i + FindFirstNotOfScalar(data + i, len - i, set, set_len);
+        }
+
+        size_t FindLastNotOfSSE2(const char *data, size_t len, const char *set, size_t set_len)
+        {
+            if (set_len == 0 || set_len > 4)
+            {
+                return FindLastNotOfScalar(data, len, set, set_len);
+            }
+            char set4[4];
+            PadSet(set, set_len, set4);
+            while (len >= 16)
+            {
+                __m128i x = _mm_loadu_si128((const __m128i *)(data + len - 16));
+                uint32_t mask = ~_mm_movemask_epi8(InSet128(x, set4)) & 0xFFFF;
+                if (mask)
+                {
+                    return len - 16 + (32 - __builtin_clz(mask));
+                }
+                len -= 16;
+            }
+            return FindLastNotOfScalar(data, len, set, set_len);
+        }
+
+        //转换[lo, hi]范围内的字母大小写
+        inline void FlipCaseSSE2(char *data, size_t len, char lo, char hi)
+        {
+            const __m128i bit = _mm_set1_epi8(0x20);
+            size_t i = 0;
+            for (; i + 16 <= len; i += 16)
+            {
+                __m128i x = _mm_loadu_si128((const __m128i *)(data + i));
+                __m128i m = InRange128(x, lo, hi);
+                _mm_storeu_si128((__m128i *)(data + i), _mm_xor_si128(x, _mm_and_si128(m, bit)));
+            }
+            if (lo == 'a')
+            {
+                ToUpperScalar(data + i, len - i);
+            }
+            else
+            {
+                ToLowerScalar(data + i, len - i);
+            }
+        }
+
+        void ToUpperSSE2(char *data, size_t len)
+        {
+            FlipCaseSSE2(data, len, 'a', 'z');
+        }
+
+        void ToLowerSSE2(char *data, size_t len)
+        {
+            FlipCaseSSE2(data, len, 'A', 'Z');
+        }
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+
+        //以下AVX2内核处理完整的32字节块后, 尾部交给非VEX编码的SSE2/标量实现;
+        //调用前必须vzeroupper清掉ymm高半部分, 否则每次调用都有AVX-SSE切换惩罚,
+        //短字符串(大部分JSON键和URL参数)会慢一个数量级。GCC不会在这里自动插入
+
+        inline __m256i InRange256(__m256i x, char lo, char hi)
+        {
+            return _mm256_and_si256(_mm256_cmpgt_epi8(x, _mm256_set1_epi8(lo - 1)),
+                                    _mm256_cmpgt_epi8(_mm256_set1_epi8(hi + 1), x));
+        }
+
+        inline __m256i UrlSafe256(__m256i x)
+        {
+            __m256i m = InRange256(_mm256_or_si256(x, _mm256_set1_epi8(0x20)), 'a', 'z');
+            m = _mm256_or_si256(m, InRange256(x, '0', '9'));
+            m = _mm256_or_si256(m, InRange256(x, '\'', '*'));
+            m = _mm256_or_si256(m, InRange256(x, '-', '.'));
+            m = _mm256_or_si256(m, _mm256_cmpeq_epi8(x, _mm256_set1_epi8('!')));
+            m = _mm256_or_si256(m, _mm256_cmpeq_epi8(x, _mm256_set1_epi8('$')));
+            m = _mm256_or_si256(m, _mm256_cmpeq_epi8(x, _mm256_set1_epi8('=')));
+            m = _mm256_or_si256(m, _mm256_cmpeq_epi8(x, _mm256_set1_epi8('_')));
+            m = _mm256_or_si256(m, _mm256_cmpeq_epi8(x, _mm256_set1_epi8('~')));
+            return m;
+        }
+
+        inline __m256i InSet256(__m256i x, const char *set4)
+        {
+            __m256i m = _mm256_cmpeq_epi8(x, _mm256_set1_epi8(set4[0]));
+            m = _mm256_or_si256(m, _mm256_cmpeq_epi8(x, _mm256_set1_epi8(set4[1])));
+            m = _mm256_or_si256(m, _mm256_cmpeq_epi8(x, _mm256_set1_epi8(set4[2])));
+            m = _mm256_or_si256(m, _mm256_cmpeq_epi8(x, _mm256_set1_epi8(set4[3])));
+            return m;
+        }
+
+        inline __m256i JsonSpecial256(__m256i x)
+        {
+            __m256i m = _mm256_cmpeq_epi8(_mm256_min_epu8(x, _mm256_set1_epi8(0x1f)), x);
+            m = _mm256_or_si256(m, _mm256_cmpeq_epi8(x, _mm256_set1_epi8('"')));
+            return _mm256_or_si256(m, _mm256_cmpeq_epi8(x, _mm256_set1_epi8('\\')));
+        }
+
+        inline __m256i JsonLongEscape256(__m256i x)
+        {
+            __m256i ctrl = _mm256_cmpeq_epi8(_mm256_min_epu8(x, _mm256_set1_epi8(0x1f)), x);
+            __m256i short_ctrl = _mm256_or_si256(InRange256(x, '\b', '\n'), InRange256(x, '\f', '\r'));
+            return _mm256_andnot_si256(short_ctrl, ctrl);
+        }
+
+        size_t FindJsonEscapeAVX2(const char *data, size_t len)
+        {
+            size_t i = 0;
+            for (; i + 32 <= len; i += 32)
+            {
+                __m256i x = _mm256_loadu_si256((const __m256i *)(data + i));
+                uint32_t mask = _mm256_movemask_epi8(JsonSpecial256(x));
+                if (mask)
+                {
+                    return i + __builtin_ctz(mask);
+                }
+            }
+            _mm256_zeroupper();
+            return i + FindJsonEscapeSSE2(data + i, len - i);
+        }
+
+        size_t JsonEscapeSizeAVX2(const char *data, size_t len)
+        {
+            size_t extra = 0;
+            size_t i = 0;
+            for (; i + 32 <= len; i += 32)
+            {
+                __m256i x = _mm256_loadu_si256((const __m256i *)(data + i));
+                uint32_t mask = _mm256_movemask_epi8(JsonSpecial256(x));
+                if (mask)
+                {
+                    extra += __builtin_popcount(mask) + 4 * __builtin_popcount(_mm256_movemask_epi8(JsonLongEscape256(x)));
+                }
+            }
+            _mm256_zeroupper();
+            return i + extra + JsonEscapeSizeSSE2(data + i, len - i);
+        }
+
+        size_t FindUrlEscapeAVX2(const char *data, size_t len)
+        {
+            size_t i = 0;
+            for (; i + 32 <= len; i += 32)
+            {
+                __m256i x = _mm256_loadu_si256((const __m256i *)(data + i));
+                uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(UrlSafe256(x));
+                if (mask)
+                {
+                    return i + __builtin_ctz(mask);
+                }
+            }
+            _mm256_zeroupper();
+            return i + FindUrlEscapeSSE2(data + i, len - i);
+        }
+
+        size_t FindUrlUnescapeAVX2(const char *data, size_t len, bool space_as_plus)
+        {
+            const __m256i pct = _mm256_set1_epi8('%');
+            const __m256i plus = _mm256_set1_epi8(space_as_plus ? '+' : '%');
+            size_t i = 0;
+            for (; i + 32 <= len; i += 32)
+            {
+                __m256i x = _mm256_loadu_si256((const __m256i *)(data + i));
+                uint32_t mask = _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(x, pct), _mm256_cmpeq_epi8(x, plus)));
+                if (mask)
+                {
+                    return i + __builtin_ctz(mask);
+                }
+            }
+            _mm256_zeroupper();
+            return i + FindUrlUnescapeSSE2(data + i, len - i, space_as_plus);
+        }
+
+        size_t FindFirstNotOfAVX2(const char *data, size_t len, const char *set, size_t set_len)
+        {
+            if (set_len == 0 || set_len > 4)
+            {
+                return FindFirstNotOfScalar(data, len, set, set_len);
+            }
+            char set4[4];
+            PadSet(set, set_len, set4);
+            size_t i = 0;
+            for (; i + 32 <= len; i += 32)
+            {
+                __m256i x = _mm256_loadu_si256((const __m256i *)(data + i));
+                uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(InSet256(x, set4));
+                if (mask)
+                {
+                    return i + __builtin_ctz(mask);
+                }
+            }
+            _mm256_zeroupper();
+            return i + FindFirstNotOfSSE2(data + i, len - i, set, set_len);
+        }
+
+        size_t FindLastNotOfAVX2(const char *data, size_t len, const char *set, size_t set_len)
+        {
+            if (set_len == 0 || set_len > 4)
+            {
+                return FindLastNotOfScalar(data, len, set, set_len);
+            }
+            char set4[4];
+            PadSet(set, set_len, set4);
+            while (len >= 32)
+            {
+                __m256i x = _mm256_loadu_si256((const __m256i *)(data + len - 32));
+                uint32_t mask = ~(uint32_t)_mm256_movemask_epi8(InSet256(x, set4));
+                if (mask)
+                {
+                    return len - 32 + (32 - __builtin_clz(mask));
+                }
+                len -= 32;
+            }
+            _mm256_zeroupper();
+            return FindLastNotOfSSE2(data, len, set, set_len);
+        }
+
+        inline void FlipCaseAVX2(char *data, size_t len, char lo, char hi)
+        {
+            const __m256i bit = _mm256_set1_epi8(0x20);
+            size_t i = 0;
+            for (; i + 32 <= len; i += 32)
+            {
+                __m256i x = _mm256_loadu_si256((const __m256i *)(data + i));
+                __m256i m = InRange256(x, lo, hi);
+                _mm256_storeu_si256((__m256i *)(data + i), _mm256_xor_si256(x, _mm256_and_si256(m, bit)));
+            }
+            _mm256_zeroupper();
+            FlipCaseSSE2(data + i, len - i, lo, hi);
+        }
+
+        void ToUpperAVX2(char *data, size_t len)
+        {
+            FlipCaseAVX2(data, len, 'a', 'z');
+        }
+
+        void ToLowerAVX2(char *data, size_t len)
+        {
+            FlipCaseAVX2(data, len, 'A', 'Z');
+        }
+
+#pragma GCC pop_options
+
+#endif
+
+        //按CPU支持情况选择的内核
+        struct Kernels
+        {
+            size_t (*findUrlEscape)(const char *, size_t);
+            size_t (*findUrlUnescape)(const char *, size_t, bool);
+            size_t (*findFirstNotOf)(const char *, size_t, const char *, size_t);
+            size_t (*findLastNotOf)(const char *, size_t, const char *, size_t);
+            void (*toUpper)(char *, size_t);
+            void (*toLower)(char *, size_t);
+            size_t (*findJsonEscape)(const char *, size_t);
+            size_t (*jsonEscapeSize)(const char *, size_t);
+        };
+
+        Kernels SelectKernels()
+        {
+#ifdef SYLAR_STRING_SIMD_X86
+            if (CpuUtil::HasAVX2())
+            {
+                return Kernels{FindUrlEscapeAVX2, FindUrlUnescapeAVX2, FindFirstNotOfAVX2,
+                               FindLastNotOfAVX2, ToUpperAVX2, ToLowerAVX2,
+                               FindJsonEscapeAVX2, JsonEscapeSizeAVX2};
+            }
+            return Kernels{FindUrlEscapeSSE2, FindUrlUnescapeSSE2, FindFirstNotOfSSE2,
+                           FindLastNotOfSSE2, ToUpperSSE2, ToLowerSSE2,
+                           FindJsonEscapeSSE2, JsonEscapeSizeSSE2};
+#else
+            return Kernels{FindUrlEscapeScalar, FindUrlUnescapeScalar, FindFirstNotOfScalar,
+                           FindLastNotOfScalar, ToUpperScalar, ToLowerScalar,
+                           FindJsonEscapeScalar, JsonEscapeSizeScalar};
+#endif
+        }
+
+        const Kernels &GetKernels()
+        {
+            static const Kernels s_kernels = SelectKernels();
+            return s_kernels;
+        }
+    }
+
+    size_t StringSimd::FindUrlEscape(const char *data, size_t len)
+    {
+        return GetKernels().findUrlEscape(data, len);
+    }
+
+    size_t StringSimd::FindUrlUnescape(const char *data, size_t len, bool space_as_plus)
+    {
+        return GetKernels().findUrlUnescape(data, len, space_as_plus);
+    }
+
+    size_t StringSimd::FindFirstNotOf(const char *data, size_t len, const char *set, size_t set_len)
+    {
+        return GetKernels().findFirstNotOf(data, len, set, set_len);
+    }
+
+    size_t StringSimd::FindLastNotOf(const char *data, size_t len, const char *set, size_t set_len)
+    {
+        return GetKernels().findLastNotOf(data, len, set, set_len);
+    }
+
+    void StringSimd::ToUpper(char *data, size_t len)
+    {
+        GetKernels().toUpper(data, len);
+    }
+
+    void StringSimd::ToLower(char *data, size_t len)
+    {
+        GetKernels().toLower(data, len);
+    }
+
+    size_t StringSimd::FindJsonEscape(const char *data, size_t len)
+    {
+        return GetKernels().findJsonEscape(data, len);
+    }
+
+    size_t StringSimd::JsonEscapeSize(const char *data, size_t len)
+    {
+        return GetKernels().jsonEscapeSize(data, len);
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#ifndef __SYLAR_UTIL_STRING_SIMD_H__
+#define __SYLAR_UTIL_STRING_SIMD_H__
+
+#include <stddef.h>
+
+namespace sylar
+{
+
+    /**
+     * @brief 字符串扫描SIMD内核
+     * @details 每个函数都有标量/SSE2/AVX2三种实现, 首次调用时按CPU支持情况选择,
+     *          SSE2每次处理16字节, AVX2每次处理32字节
+     */
+    class StringSimd
+    {
+    public:
+        /**
+         * @brief 查找第一个需要URL编码的字符
+         * @details 不需要编码的字符: 字母 数字 ! $ ' ( ) * - . = _ ~
+         * @return 字符下标, 不存在返回len
+         */
+        static size_t FindUrlEscape(const char *data, size_t len);
+
+        /**
+         * @brief 查找第一个需要URL解码的字符('%', space_as_plus时还包括'+')
+         * @return 字符下标, 不存在返回len
+         */
+        static size_t FindUrlUnescape(const char *data, size_t len, bool space_as_plus);
+
+        /**
+         * @brief 查找第一个不在set中的字符
+         * @details set不超过4个字符时使用SIMD, 否则使用查表
+         * @return 字符下标, 不存在返回len
+         */
+        static size_t FindFirstNotOf(const char *data, size_t len, const char *set, size_t set_len);
+
+        /**
+         * @brief 查找最后一个不在set中的字符
+         * @return 该字符的下标+1, 不存在返回0
+         */
+        static size_t FindLastNotOf(const char *data, size_t len, const char *set, size_t set_len);
+
+        //原地转为大写(只处理ASCII)
+        static void ToUpper(char *data, size_t len);
+
+        //原地转为小写(只处理ASCII)
+        static void ToLower(char *data, size_t len);
+
+        /**
+         * @brief 查找第一个需要JSON转义的字符('"', '\\'和小于0x20的控制字符)
+         * @return 字符下标, 不存在返回len
+         */
+        static size_t FindJsonEscape(const char *data, size_t len);
+
+        /**
+         * @brief JSON转义后的精确长度(不含两端引号)
+         * @details 单次扫描, 有短转义形式的字符加1, 其他控制字符按\u00XX加5
+         */
+        static size_t JsonEscapeSize(const char *data, size_t len);
+
+        //是否为不需要URL编码的字符
+        static bool IsUrlSafe(unsigned char c);
+    };
+
+}
+
+#endif
\ No newline at end of file
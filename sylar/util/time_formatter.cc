@@ -0,0 +1,589 @@
+#include "sylar/util/time_formatter.h"
+#include <string.h>
+#include <ctype.h>
+#include <atomic>
+
+namespace sylar
+{
+
+    //时区偏移缓存: 每项为(15分钟序号 + 偏置) << 24 | (偏移 + 2^23), 0表示空
+    static const int64_t s_tz_span = 900;
+    static const size_t s_tz_slots = 256;
+    static std::atomic<uint64_t> s_tz_cache[s_tz_slots];
+    static std::atomic<uint32_t> s_tz_generation{0};
+    static std::atomic<uint64_t> s_formatter_id{0};
+
+    static int64_t FloorDiv(int64_t a, int64_t b)
+    {
+        int64_t q = a / b;
+        return (a % b < 0) ? q - 1 : q;
+    }
+
+    //公历日期到1970-01-01的天数
+    static int64_t DaysFromCivil(int64_t y, int64_t m, int64_t d)
+    {
+        //月份超出范围时先进位到年
+        y += FloorDiv(m - 1, 12);
+        m = m - 1 - FloorDiv(m - 1, 12) * 12 + 1;
+        y -= m <= 2;
+        const int64_t era = (y >= 0 ? y : y - 399) / 400;
+        const int64_t yoe = y - era * 400;
+        const int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+        const int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + doe - 719468;
+    }
+
+    static void CivilFromDays(int64_t z, CivilTime &ct)
+    {
+        z += 719468;
+        const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+        const int64_t doe = z - era * 146097;
+        const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const int64_t mp = (5 * doy + 2) / 153;
+        ct.day = (int)(doy - (153 * mp + 2) / 5 + 1);
+        ct.month = (int)(mp < 10 ? mp + 3 : mp - 9);
+        ct.year = (int)(yoe + era * 400 + (ct.month <= 2));
+    }
+
+    int TimeFormatter::GetTimezoneOffset(time_t ts)
+    {
+        int64_t span = FloorDiv(ts, s_tz_span);
+        uint64_t key = (uint64_t)(span + (1ll << 39));
+        std::atomic<uint64_t> &slot = s_tz_cache[(uint64_t)span & (s_tz_slots - 1)];
+        uint64_t v = slot.load(std::memory_order_relaxed);
+        if (v && (v >> 24) == key)
+        {
+            return (int)(v & 0xffffff) - (1 << 23);
+        }
+        struct tm tm;
+        if (!localtime_r(&ts, &tm))
+        {
+            return 0;
+        }
+        int offset = (int)tm.tm_gmtoff;
+        slot.store((key << 24) | (uint64_t)(offset + (1 << 23)), std::memory_order_relaxed);
+        return offset;
+    }
+
+    void TimeFormatter::ResetTimezone()
+    {
+        tzset();
+        for (auto &i : s_tz_cache)
+        {
+            i.store(0, std::memory_order_relaxed);
+        }
+        s_tz_generation.fetch_add(1, std::memory_order_release);
+    }
+
+    void TimeFormatter::ToCivil(time_t ts, bool utc, CivilTime &ct)
+    {
+        ct.offset = utc ? 0 : GetTimezoneOffset(ts);
+        int64_t t = (int64_t)ts + ct.offset;
+        int64_t days = FloorDiv(t, 86400);
+        int64_t secs = t - days * 86400;
+        CivilFromDays(days, ct);
+        ct.hour = (int)(secs / 3600);
+        ct.minute = (int)(secs / 60 % 60);
+        ct.second = (int)(secs % 60);
+        ct.wday = (int)((days % 7 + 11) % 7); // 1970-01-01是周四
+        ct.yday = (int)(days - DaysFromCivil(ct.year, 1, 1));
+    }
+
+    time_t TimeFormatter::FromCivil(const CivilTime &ct, bool utc)
+    {
+        int64_t local = DaysFromCivil(ct.year, ct.month, ct.day) * 86400 + (int64_t)ct.hour * 3600 + (int64_t)ct.minute * 60 + ct.second;
+        if (utc)
+        {
+            return (time_t)local;
+        }
+        //先按local附近的偏移估算, 再用估算结果处的偏移修正一次
+        int off = GetTimezoneOffset((time_t)(local - GetTimezoneOffset((time_t)local)));
+        time_t t = (time_t)(local - off);
+        int off2 = GetTimezoneOffset(t);
+        if (off2 != off)
+        {
+            t = (time_t)(local - off2);
+        }
+        return t;
+    }
+
+    TimeFormatter::TimeFormatter(const std::string &format, bool utc)
+        : m_format(format), m_id(++s_formatter_id), m_utc(utc), m_fixed(false), m_hasOther(false)
+    {
+        compile();
+    }
+
+    void TimeFormatter::compile()
+    {
+        m_fixed = m_format == "%Y-%m-%d %H:%M:%S";
+        auto literal = [this](const char *s, size_t n)
+        {
+            if (!m_items.empty() && m_items.back().type == Item::LITERAL)
+            {
+                m_items.back().text.append(s, n);
+            }
+            else
+            {
+                m_items.push_back(Item{Item::LITERAL, std::string(s, n)});
+            }
+        };
+        auto field = [this](Item::Type t)
+        {
+            m_items.push_back(Item{t, std::string()});
+        };
+
+        const std::string &f = m_format;
+        for (size_t i = 0; i < f.size(); ++i)
+        {
+            char c = f[i];
+            if (c != '%')
+            {
+                if (isspace((unsigned char)c))
+                {
+                    m_items.push_back(Item{Item::SPACE, std::string(1, c)});
+                }
+                else
+                {
+                    literal(&c, 1);
+                }
+                continue;
+            }
+            if (++i >= f.size())
+            {
+                m_hasOther = true;
+                break;
+            }
+            switch (f[i])
+            {
+            case 'Y':
+                field(Item::YEAR);
+                break;
+            case 'y':
+                field(Item::YEAR2);
+                break;
+            case 'm':
+                field(Item::MONTH);
+                break;
+            case 'd':
+                field(Item::DAY);
+                break;
+            case 'e':
+                field(Item::DAY_SP);
+                break;
+            case 'H':
+                field(Item::HOUR);
+                break;
+            case 'M':
+                field(Item::MINUTE);
+                break;
+            case 'S':
+                field(Item::SECOND);
+                break;
+            case 's':
+                field(Item::EPOCH);
+                break;
+            case 'z':
+                field(Item::ZONE);
+                break;
+            case 'T':
+                field(Item::HOUR);
+                literal(":", 1);
+                field(Item::MINUTE);
+                literal(":", 1);
+                field(Item::SECOND);
+                break;
+            case 'R':
+                field(Item::HOUR);
+                literal(":", 1);
+                field(Item::MINUTE);
+                break;
+            case 'F':
+                field(Item::YEAR);
+                literal("-", 1);
+                field(Item::MONTH);
+                literal("-", 1);
+                field(Item::DAY);
+                break;
+            case 'D':
+                field(Item::MONTH);
+                literal("/", 1);
+                field(Item::DAY);
+                literal("/", 1);
+                field(Item::YEAR2);
+                break;
+            case 'n':
+                m_items.push_back(Item{Item::SPACE, "\n"});
+                break;
+            case 't':
+                m_items.push_back(Item{Item::SPACE, "\t"});
+                break;
+            case '%':
+                literal("%", 1);
+                break;
+            default:
+                m_hasOther = true;
+                break;
+            }
+        }
+    }
+
+    static inline void Append2(std::string &out, int v)
+    {
+        char buf[2] = {(char)('0' + v / 10), (char)('0' + v % 10)};
+        out.append(buf, 2);
+    }
+
+    void TimeFormatter::appendSlow(std::string &out, time_t ts) const
+    {
+        if (m_hasOther)
+        {
+            struct tm tm;
+            if (m_utc ? !gmtime_r(&ts, &tm) : !localtime_r(&ts, &tm))
+            {
+                return;
+            }
+            char buf[128];
+            size_t n = strftime(buf, sizeof(buf), m_format.c_str(), &tm);
+            if (n || m_format.empty())
+            {
+                out.append(buf, n);
+                return;
+            }
+            std::string tmp(m_format.size() * 8 + 256, '\0');
+            n = strftime(&tmp[0], tmp.size(), m_format.c_str(), &tm);
+            out.append(tmp.data(), n);
+            return;
+        }
+
+        CivilTime ct;
+        ToCivil(ts, m_utc, ct);
+        for (auto &i : m_items)
+        {
+            switch (i.type)
+            {
+            case Item::LITERAL:
+            case Item::SPACE:
+                out.append(i.text);
+                break;
+            case Item::YEAR:
+                if (ct.year >= 0 && ct.year <= 9999)
+                {
+                    Append2(out, ct.year / 100);
+                    Append2(out, ct.year % 100);
+                }
+                else
+                {
+                    out.append(std::to_string(ct.year));
+                }
+                break;
+            case Item::YEAR2:
+                Append2(out, (ct.year % 100 + 100) % 100);
+                break;
+            case Item::MONTH:
+                Append2(out, ct.month);
+                break;
+            case Item::DAY:
+                Append2(out, ct.day);
+                break;
+            case Item::DAY_SP:
+                if (ct.day < 10)
+                {
+                    out.push_back(' ');
+                    out.push_back('0' + ct.day);
+                }
+                else
+                {
+                    Append2(out, ct.day);
+                }
+                break;
+            case Item::HOUR:
+                Append2(out, ct.hour);
+                break;
+            case Item::MINUTE:
+                Append2(out, ct.minute);
+                break;
+            case Item::SECOND:
+                Append2(out, ct.second);
+                break;
+            case Item::EPOCH:
+                out.append(std::to_string((int64_t)ts));
+                break;
+            case Item::ZONE:
+            {
+                int off = ct.offset;
+                out.push_back(off < 0 ? '-' : '+');
+                off = off < 0 ? -off : off;
+                Append2(out, off / 3600);
+                Append2(out, off / 60 % 60);
+                break;
+            }
+            }
+        }
+    }
+
+    //每个线程缓存最近格式化过的几个(格式, 秒)
+    struct FormatCache
+    {
+        uint64_t id = 0;
+        uint32_t generation = 0;
+        time_t ts = 0;
+        std::string text;
+    };
+    static thread_local FormatCache t_format_cache[4];
+
+    void TimeFormatter::append(std::string &out, time_t ts) const
+    {
+        uint32_t gen = s_tz_generation.load(std::memory_order_acquire);
+        FormatCache &c = t_format_cache[m_id & 3];
+        if (c.id == m_id && c.ts == ts && c.generation == gen)
+        {
+            out.append(c.text);
+            return;
+        }
+        size_t pos = out.size();
+        appendSlow(out, ts);
+        c.id = m_id;
+        c.ts = ts;
+        c.generation = gen;
+        c.text.assign(out, pos, std::string::npos);
+    }
+
+    std::string TimeFormatter::format(time_t ts) const
+    {
+        std::string rt;
+        append(rt, ts);
+        return rt;
+    }
+
+    bool TimeFormatter::parse(std::string_view str, time_t &ts) const
+    {
+        if (m_fixed && parseFixed(str, ts))
+        {
+            return true;
+        }
+        return parseSlow(str, ts);
+    }
+
+    //"YYYY-mm-dd HH:MM:SS", 每个位置单独检查, 不匹配时交给通用解析(允许一位数的月日等)
+    bool TimeFormatter::parseFixed(std::string_view str, time_t &ts) const
+    {
+        if (str.size() < 19)
+        {
+            return false;
+        }
+        const unsigned char *p = (const unsigned char *)str.data();
+        unsigned d0 = p[0] - '0', d1 = p[1] - '0', d2 = p[2] - '0', d3 = p[3] - '0';
+        unsigned d5 = p[5] - '0', d6 = p[6] - '0';
+        unsigned d8 = p[8] - '0', d9 = p[9] - '0';
+        unsigned d11 = p[11] - '0', d12 = p[12] - '0';
+        unsigned d14 = p[14] - '0', d15 = p[15] - '0';
+        unsigned d17 = p[17] - '0', d18 = p[18] - '0';
+        //非数字字符减'0'后作为无符号数一定大于9, 所有检查合并成一次分支
+        bool bad = (d0 > 9) | (d1 > 9) | (d2 > 9) | (d3 > 9) | (d5 > 9) | (d6 > 9) | (d8 > 9) | (d9 > 9) | (d11 > 9) | (d12 > 9) | (d14 > 9) | (d15 > 9) | (d17 > 9) | (d18 > 9) | (p[4] != '-') | (p[7] != '-') | (p[10] != ' ') | (p[13] != ':') | (p[16] != ':');
+        if (bad)
+        {
+            return false;
+        }
+        CivilTime ct;
+        ct.year = (int)(d0 * 1000 + d1 * 100 + d2 * 10 + d3);
+        ct.month = (int)(d5 * 10 + d6);
+        ct.day = (int)(d8 * 10 + d9);
+        ct.hour = (int)(d11 * 10 + d12);
+        ct.minute = (int)(d14 * 10 + d15);
+        ct.second = (int)(d17 * 10 + d18);
+        if (ct.month < 1 || ct.month > 12 || ct.day < 1 || ct.day > 31 || ct.hour > 23 || ct.minute > 59 || ct.second > 61)
+        {
+            return false;
+        }
+        ts = FromCivil(ct, m_utc);
+        return true;
+    }
+
+    //读取最多max_digits位数字, 和strptime一样先跳过空白
+    static bool ReadNumber(const char *&p, const char *end, int max_digits, int min_value, int max_value, int &v)
+    {
+        while (p < end && isspace((unsigned char)*p))
+        {
+            ++p;
+        }
+        int n = 0;
+        v = 0;
+        while (p < end && n < max_digits && (unsigned)(*p - '0') < 10)
+        {
+            v = v * 10 + (*p - '0');
+            ++p;
+            ++n;
+        }
+        return n > 0 && v >= min_value && v <= max_value;
+    }
+
+    bool TimeFormatter::parseSlow(std::string_view str, time_t &ts) const
+    {
+        if (m_hasOther)
+        {
+            std::string tmp(str);
+            struct tm t;
+            memset(&t, 0, sizeof(t));
+            if (!strptime(tmp.c_str(), m_format.c_str(), &t))
+            {
+                return false;
+            }
+            CivilTime ct;
+            ct.year = t.tm_year + 1900;
+            ct.month = t.tm_mon + 1;
+            ct.day = t.tm_mday;
+            ct.hour = t.tm_hour;
+            ct.minute = t.tm_min;
+            ct.second = t.tm_sec;
+            ts = FromCivil(ct, m_utc);
+            return true;
+        }
+
+        const char *p = str.data();
+        const char *end = p + str.size();
+        CivilTime ct;
+        bool has_epoch = false;
+        bool has_zone = false;
+        int64_t epoch = 0;
+        int zone = 0;
+        for (auto &i : m_items)
+        {
+            switch (i.type)
+            {
+            case Item::LITERAL:
+                if ((size_t)(end - p) < i.text.size() || memcmp(p, i.text.data(), i.text.size()))
+                {
+                    return false;
+                }
+                p += i.text.size();
+                break;
+            case Item::SPACE:
+                while (p < end && isspace((unsigned char)*p))
+                {
+                    ++p;
+                }
+                break;
+            case Item::YEAR:
+                if (!ReadNumber(p, end, 4, 0, 9999, ct.year))
+                {
+                    return false;
+                }
+                break;
+            case Item::YEAR2:
+            {
+                int y;
+                if (!ReadNumber(p, end, 2, 0, 99, y))
+                {
+                    return false;
+                }
+                ct.year = y < 69 ? 2000 + y : 1900 + y;
+                break;
+            }
+            case Item::MONTH:
+                if (!ReadNumber(p, end, 2, 1, 12, ct.month))
+                {
+                    return false;
+                }
+                break;
+            case Item::DAY:
+            case Item::DAY_SP:
+                if (!ReadNumber(p, end, 2, 1, 31, ct.day))
+                {
+                    return false;
+                }
+                break;
+            case Item::HOUR:
+                if (!ReadNumber(p, end, 2, 0, 23, ct.hour))
+                {
+                    return false;
+                }
+                break;
+            case Item::MINUTE:
+                if (!ReadNumber(p, end, 2, 0, 59, ct.minute))
+                {
+                    return false;
+                }
+                break;
+            case Item::SECOND:
+                if (!ReadNumber(p, end, 2, 0, 61, ct.second))
+                {
+                    return false;
+                }
+                break;
+            case Item::EPOCH:
+            {
+                bool neg = p < end && *p == '-';
+                p += neg;
+                const char *b = p;
+                epoch = 0;
+                while (p < end && (unsigned)(*p - '0') < 10 && p - b < 18)
+                {
+                    epoch = epoch * 10 + (*p - '0');
+                    ++p;
+                }
+                if (p == b)
+                {
+                    return false;
+                }
+                epoch = neg ? -epoch : epoch;
+                has_epoch = true;
+                break;
+            }
+            case Item::ZONE:
+            {
+                //Z, +hh, +hhmm, +hh:mm
+                if (p < end && *p == 'Z')
+                {
+                    ++p;
+                    zone = 0;
+                    has_zone = true;
+                    break;
+                }
+                if (p >= end || (*p != '+' && *p != '-'))
+                {
+                    return false;
+                }
+                bool neg = *p++ == '-';
+                int hh = 0, mm = 0;
+                if (end - p < 2 || (unsigned)(p[0] - '0') > 9 || (unsigned)(p[1] - '0') > 9)
+                {
+                    return false;
+                }
+                hh = (p[0] - '0') * 10 + (p[1] - '0');
+                p += 2;
+                if (p < end && *p == ':')
+                {
+                    ++p;
+                }
+                if (end - p >= 2 && (unsigned)(p[0] - '0') <= 9 && (unsigned)(p[1] - '0') <= 9)
+                {
+                    mm = (p[0] - '0') * 10 + (p[1] - '0');
+                    p += 2;
+                }
+                if (hh > 24 || mm > 59)
+                {
+                    return false;
+                }
+                zone = (hh * 3600 + mm * 60) * (neg ? -1 : 1);
+                has_zone = true;
+                break;
+            }
+            }
+        }
+        if (has_epoch)
+        {
+            ts = (time_t)epoch;
+        }
+        else if (has_zone)
+        {
+            ts = FromCivil(ct, true) - zone;
+        }
+        else
+        {
+            ts = FromCivil(ct, m_utc);
+        }
+        return true;
+    }
+
+}
\ No newline at end of file
@@ -0,0 +1,135 @@
+#ifndef __SYLAR_UTIL_TIME_FORMATTER_H__
+#define __SYLAR_UTIL_TIME_FORMATTER_H__
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <stdint.h>
+#include <time.h>
+
+namespace sylar
+{
+
+    //分解后的日历时间
+    struct CivilTime
+    {
+        int year = 1970;
+        int month = 1; /// 1-12
+        int day = 1;   /// 1-31
+        int hour = 0;
+        int minute = 0;
+        int second = 0;
+        int wday = 4;  /// 0-6, 0为周日
+        int yday = 0;  /// 0-365
+        int offset = 0; /// 相对UTC的秒数(东为正)
+    };
+
+    /**
+     * @brief 预编译的时间格式化/解析器
+     * @details 格式串在构造时解析成字段列表, 日历计算用纯算术完成,
+     *          不调用localtime/mktime, 因而不会争用glibc的时区锁。
+     *          时区偏移按15分钟为单位缓存在全局无锁表中, 只有缓存未命中时才调用localtime_r。
+     *          每个线程缓存最近一次格式化的秒和结果, 同一秒内重复格式化直接复制。
+     *          对象构造后只读, 可以被多个线程同时使用
+     *
+     *  支持的格式: %Y %m %d %e %H %M %S %y %s %z %T %F %D %R %n %t %%,
+     *  包含其他格式符时整个格式交给strftime/strptime处理(结果一致, 但没有加速)。
+     *  "%Y-%m-%d %H:%M:%S"的解析使用固定位置的展开实现
+     */
+    class TimeFormatter
+    {
+    public:
+        typedef std::shared_ptr<TimeFormatter> ptr;
+
+        /**
+         * @brief 构造函数
+         * @param[in] format strftime风格的格式
+         * @param[in] utc 为true时按UTC格式化/解析, 否则按本地时区
+         */
+        TimeFormatter(const std::string &format = "%Y-%m-%d %H:%M:%S", bool utc = false);
+
+        //格式化
+        std::string format(time_t ts) const;
+
+        //格式化并追加到out
+        void append(std::string &out, time_t ts) const;
+
+        /**
+         * @brief 解析时间字符串
+         * @details 和strptime一样, 格式中的空白匹配任意个空白, 输入末尾多余的字符忽略,
+         *          %S允许0-61并向后进位; 没有%z时按构造时指定的时区解释。
+         *          与glibc不同的是%s接受负数, 可以读回1970年以前的时间戳
+         * @param[out] ts 解析得到的时间戳
+         * @return 格式不匹配或数值越界返回false
+         */
+        bool parse(std::string_view str, time_t &ts) const;
+
+        //返回格式串
+        const std::string &getFormat() const { return m_format; }
+
+        //是否按UTC处理
+        bool isUtc() const { return m_utc; }
+
+        /**
+         * @brief 时间戳分解为日历时间
+         * @param[in] utc 为true时不加时区偏移
+         */
+        static void ToCivil(time_t ts, bool utc, CivilTime &ct);
+
+        /**
+         * @brief 日历时间转换为时间戳
+         * @details 只使用年月日时分秒, 超出范围时按mktime的方式进位;
+         *          本地时间落在夏令时切换的重叠/空缺区间时结果与mktime一致
+         */
+        static time_t FromCivil(const CivilTime &ct, bool utc);
+
+        //返回ts时刻本地时区相对UTC的秒数
+        static int GetTimezoneOffset(time_t ts);
+
+        /**
+         * @brief 重新读取时区(TZ环境变量改变后调用)
+         * @details 清空偏移缓存并使各线程的格式化缓存失效
+         */
+        static void ResetTimezone();
+
+    private:
+        //格式字段
+        struct Item
+        {
+            enum Type
+            {
+                LITERAL, /// 原样输出
+                SPACE,   /// 格式中的空白, 解析时匹配任意个空白
+                YEAR,    /// %Y
+                YEAR2,   /// %y
+                MONTH,   /// %m
+                DAY,     /// %d
+                DAY_SP,  /// %e
+                HOUR,    /// %H
+                MINUTE,  /// %M
+                SECOND,  /// %S
+                EPOCH,   /// %s
+                ZONE     /// %z
+            };
+            Type type;
+            std::string text; /// LITERAL/SPACE的内容
+        };
+
+        void compile();
+        void appendSlow(std::string &out, time_t ts) const;
+        bool parseFixed(std::string_view str, time_t &ts) const;
+        bool parseSlow(std::string_view str, time_t &ts) const;
+
+    private:
+        std::string m_format;
+        std::vector<Item> m_items;
+        uint64_t m_id;     /// 全局唯一id, 作为线程缓存的key
+        bool m_utc;        /// 是否按UTC处理
+        bool m_fixed;      /// 格式为"%Y-%m-%d %H:%M:%S"
+        bool m_hasOther;   /// 包含只能由strftime/strptime处理的格式符
+    };
+
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,484 @@
+#include "sylar/util/yaml_json.h"
+#include "sylar/util/json_parser.h"
+#include "sylar/util/json_writer.h"
+#include <yaml-cpp/yaml.h>
+#include <yaml-cpp/eventhandler.h>
+#include <string.h>
+#include <ctype.h>
+#include <charconv>
+#include <unordered_map>
+#include <vector>
+
+namespace sylar
+{
+
+    static inline bool IsDigit(char c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    //从pos开始跳过满足pred的字符, 返回跳过的个数
+    template <class Pred>
+    static size_t SkipWhile(std::string_view v, size_t &pos, Pred pred)
+    {
+        size_t begin = pos;
+        while (pos < v.size() && pred(v[pos]))
+        {
+            ++pos;
+        }
+        return pos - begin;
+    }
+
+    YamlJsonConverter::PlainType YamlJsonConverter::ResolvePlain(std::string_view v)
+    {
+        if (v.empty() || v == "~" || v == "null" || v == "Null" || v == "NULL")
+        {
+            return PLAIN_NULL;
+        }
+        if (v == "true" || v == "True" || v == "TRUE" || v == "false" || v == "False" || v == "FALSE")
+        {
+            return PLAIN_BOOL;
+        }
+        if (v.size() > 2 && v[0] == '0' && (v[1] == 'o' || v[1] == 'x'))
+        {
+            size_t pos = 2;
+            bool hex = v[1] == 'x';
+            SkipWhile(v, pos, [hex](char c)
+                      { return hex ? isxdigit((unsigned char)c) != 0 : (c >= '0' && c <= '7'); });
+            return pos == v.size() ? PLAIN_INT : PLAIN_STRING;
+        }
+
+        size_t pos = 0;
+        if (v[0] == '-' || v[0] == '+')
+        {
+            ++pos;
+        }
+        std::string_view rest = v.substr(pos);
+        if (rest == ".inf" || rest == ".Inf" || rest == ".INF")
+        {
+            return PLAIN_FLOAT;
+        }
+        if (pos == 0 && (v == ".nan" || v == ".NaN" || v == ".NAN"))
+        {
+            return PLAIN_FLOAT;
+        }
+
+        //[-+]?(\.[0-9]+|[0-9]+(\.[0-9]*)?)([eE][-+]?[0-9]+)?
+        size_t int_digits = SkipWhile(v, pos, IsDigit);
+        bool is_float = false;
+        if (pos < v.size() && v[pos] == '.')
+        {
+            ++pos;
+            size_t frac_digits = SkipWhile(v, pos, IsDigit);
+            if (int_digits == 0 && frac_digits == 0)
+            {
+                return PLAIN_STRING;
+            }
+            is_float = true;
+        }
+        else if (int_digits == 0)
+        {
+            return PLAIN_STRING;
+        }
+        if (pos < v.size() && (v[pos] == 'e' || v[pos] == 'E'))
+        {
+            ++pos;
+            if (pos < v.size() && (v[pos] == '-' || v[pos] == '+'))
+            {
+                ++pos;
+            }
+            if (SkipWhile(v, pos, IsDigit) == 0)
+            {
+                return PLAIN_STRING;
+            }
+            is_float = true;
+        }
+        if (pos != v.size())
+        {
+            return PLAIN_STRING;
+        }
+        return is_float ? PLAIN_FLOAT : PLAIN_INT;
+    }
+
+    namespace
+    {
+
+        static const char *s_tag_prefix = "tag:yaml.org,2002:";
+
+        /**
+         * @brief YAML解析事件转JSON输出
+         * @details 输出先写入缓冲区, 超过阈值后写到输出流;
+         *          带锚点的节点在结束时保存其JSON文本, 供别名引用时原样写入,
+         *          保存期间不刷新缓冲区
+         */
+        class YamlToJsonHandler : public YAML::EventHandler
+        {
+        public:
+            YamlToJsonHandler(std::ostream &os)
+                : m_os(os), m_writer(m_buf)
+            {
+            }
+
+            void OnDocumentStart(const YAML::Mark &) override {}
+            void OnDocumentEnd() override {}
+
+            void OnNull(const YAML::Mark &, YAML::anchor_t anchor) override
+            {
+                if (isKey())
+                {
+                    writeKey("null", anchor);
+                    return;
+                }
+                beginNode(anchor);
+                m_writer.null();
+                endNode(anchor);
+            }
+
+            void OnAlias(const YAML::Mark &mark, YAML::anchor_t anchor) override
+            {
+                auto it = m_anchors.find(anchor);
+                if (it == m_anchors.end())
+                {
+                    setError(mark, "unknown alias");
+                    return;
+                }
+                if (isKey())
+                {
+                    setError(mark, "alias as mapping key is not supported");
+                    return;
+                }
+                m_writer.raw(it->second);
+                afterValue();
+            }
+
+            void OnScalar(const YAML::Mark &, const std::string &tag,
+                          YAML::anchor_t anchor, const std::string &value) override
+            {
+                if (isKey())
+                {
+                    writeKey(value, anchor);
+                    return;
+                }
+                beginNode(anchor);
+                writeScalar(tag, value);
+                endNode(anchor);
+            }
+
+            void OnSequenceStart(const YAML::Mark &mark, const std::string &,
+                                 YAML::anchor_t anchor, YAML::EmitterStyle::value) override
+            {
+                if (isKey())
+                {
+                    setError(mark, "sequence as mapping key is not supported");
+                    return;
+                }
+                beginNode(anchor);
+                m_writer.startArray();
+                m_stack.push_back(Frame{false, false, anchor});
+            }
+
+            void OnSequenceEnd() override
+            {
+                m_writer.endArray();
+                YAML::anchor_t anchor = m_stack.back().anchor;
+                m_stack.pop_back();
+                endNode(anchor);
+            }
+
+            void OnMapStart(const YAML::Mark &mark, const std::string &,
+                            YAML::anchor_t anchor, YAML::EmitterStyle::value) override
+            {
+                if (isKey())
+                {
+                    setError(mark, "map as mapping key is not supported");
+                    return;
+                }
+                beginNode(anchor);
+                m_writer.startObject();
+                m_stack.push_back(Frame{true, true, anchor});
+            }
+
+            void OnMapEnd() override
+            {
+                m_writer.endObject();
+                YAML::anchor_t anchor = m_stack.back().anchor;
+                m_stack.pop_back();
+                endNode(anchor);
+            }
+
+            //写出剩余的输出
+            void finish()
+            {
+                m_os.write(m_buf.data(), m_buf.size());
+                m_buf.clear();
+            }
+
+        private:
+            struct Frame
+            {
+                bool map;
+                bool expectKey;
+                YAML::anchor_t anchor;
+            };
+
+            struct Capture
+            {
+                YAML::anchor_t anchor;
+                size_t start;
+            };
+
+            bool isKey() const
+            {
+                return !m_stack.empty() && m_stack.back().map && m_stack.back().expectKey;
+            }
+
+            void setError(const YAML::Mark &mark, const char *error)
+            {
+                //handler无法中止解析, 抛出异常由调用者捕获
+                throw YAML::ParserException(mark, error);
+            }
+
+            void writeKey(const std::string &key, YAML::anchor_t anchor)
+            {
+                m_writer.key(key);
+                m_stack.back().expectKey = false;
+                if (anchor)
+                {
+                    std::string json;
+                    JsonWriter(json).value(key);
+                    m_anchors[anchor] = json;
+                }
+            }
+
+            void beginNode(YAML::anchor_t anchor)
+            {
+                if (anchor)
+                {
+                    m_captures.push_back(Capture{anchor, m_buf.size()});
+                }
+            }
+
+            void endNode(YAML::anchor_t anchor)
+            {
+                if (anchor)
+                {
+                    size_t start = m_captures.back().start;
+                    m_captures.pop_back();
+                    //去掉写值前的逗号
+                    if (start < m_buf.size() && m_buf[start] == ',')
+                    {
+                        ++start;
+                    }
+                    m_anchors[anchor] = m_buf.substr(start);
+                }
+                afterValue();
+            }
+
+            void afterValue()
+            {
+                if (!m_stack.empty() && m_stack.back().map)
+                {
+                    m_stack.back().expectKey = true;
+                }
+                if (m_captures.empty() && m_buf.size() >= 64 * 1024)
+                {
+                    finish();
+                }
+            }
+
+            void writeScalar(const std::string &tag, const std::string &value)
+            {
+                YamlJsonConverter::PlainType type = YamlJsonConverter::PLAIN_STRING;
+                if (tag == "?" || tag.empty())
+                {
+                    type = YamlJsonConverter::ResolvePlain(value);
+                }
+                else if (tag.compare(0, strlen(s_tag_prefix), s_tag_prefix) == 0)
+                {
+                    std::string name = tag.substr(strlen(s_tag_prefix));
+                    YamlJsonConverter::PlainType resolved = YamlJsonConverter::ResolvePlain(value);
+                    if ((name == "int" && resolved == YamlJsonConverter::PLAIN_INT) || (name == "float" && (resolved == YamlJsonConverter::PLAIN_FLOAT || resolved == YamlJsonConverter::PLAIN_INT)) || (name == "bool" && resolved == YamlJsonConverter::PLAIN_BOOL) || (name == "null" && resolved == YamlJsonConverter::PLAIN_NULL))
+                    {
+                        type = resolved;
+                    }
+                }
+
+                switch (type)
+                {
+                case YamlJsonConverter::PLAIN_NULL:
+                    m_writer.null();
+                    break;
+                case YamlJsonConverter::PLAIN_BOOL:
+                    m_writer.value(value[0] == 't' || value[0] == 'T');
+                    break;
+                case YamlJsonConverter::PLAIN_INT:
+                    writeInt(value);
+                    break;
+                case YamlJsonConverter::PLAIN_FLOAT:
+                    writeFloat(value);
+                    break;
+                default:
+                    m_writer.value(value);
+                    break;
+                }
+            }
+
+            void writeInt(const std::string &value)
+            {
+                const char *begin = value.data();
+                const char *end = begin + value.size();
+                int base = 10;
+                if (value.size() > 2 && value[0] == '0' && (value[1] == 'x' || value[1] == 'o'))
+                {
+                    base = value[1] == 'x' ? 16 : 8;
+                    begin += 2;
+                }
+                else if (*begin == '+')
+                {
+                    ++begin;
+                }
+                int64_t i64;
+                auto rt = std::from_chars(begin, end, i64, base);
+                if (rt.ec == std::errc() && rt.ptr == end)
+                {
+                    m_writer.value(i64);
+                    return;
+                }
+                uint64_t u64;
+                rt = std::from_chars(begin, end, u64, base);
+                if (rt.ec == std::errc() && rt.ptr == end)
+                {
+                    m_writer.value(u64);
+                    return;
+                }
+                //超过64位的整数按浮点输出
+                writeFloat(value);
+            }
+
+            void writeFloat(const std::string &value)
+            {
+                const char *begin = value.data();
+                const char *end = begin + value.size();
+                if (*begin == '+')
+                {
+                    ++begin;
+                }
+                double d;
+                auto rt = std::from_chars(begin, end, d);
+                if (value.find_first_of("iInN") != std::string::npos || rt.ec != std::errc() || rt.ptr != end)
+                {
+                    //.inf/.nan和超出范围的值保留原文
+                    m_writer.value(value);
+                    return;
+                }
+                m_writer.value(d);
+            }
+
+        private:
+            std::ostream &m_os;
+            std::string m_buf;
+            JsonWriter m_writer;
+            std::vector<Frame> m_stack;
+            std::vector<Capture> m_captures;
+            std::unordered_map<YAML::anchor_t, std::string> m_anchors;
+        };
+
+        //JSON字符串写为YAML标量, 会被解析为其他类型时加双引号
+        void EmitString(YAML::Emitter &emitter, const std::string &v)
+        {
+            if (YamlJsonConverter::ResolvePlain(v) != YamlJsonConverter::PLAIN_STRING)
+            {
+                emitter << YAML::DoubleQuoted << v;
+            }
+            else
+            {
+                emitter << v;
+            }
+        }
+
+    }
+
+    bool YamlJsonConverter::YamlToJson(std::istream &in, std::ostream &out, std::string *error)
+    {
+        YamlToJsonHandler handler(out);
+        try
+        {
+            YAML::Parser parser(in);
+            if (!parser.HandleNextDocument(handler))
+            {
+                //空文档和YAML::Load("")一样视为null, 与树版本的YamlToJson一致
+                handler.OnNull(YAML::Mark(), YAML::NullAnchor);
+            }
+        }
+        catch (const YAML::Exception &e)
+        {
+            if (error)
+            {
+                *error = e.what();
+            }
+            return false;
+        }
+        handler.finish();
+        return (bool)out;
+    }
+
+    bool YamlJsonConverter::JsonToYaml(std::istream &in, std::ostream &out, std::string *error)
+    {
+        JsonStreamReader reader(in);
+        YAML::Emitter emitter(out);
+        while (true)
+        {
+            JsonStreamReader::Event event = reader.next();
+            switch (event)
+            {
+            case JsonStreamReader::ERROR:
+                if (error)
+                {
+                    *error = std::string(reader.getError()) + " at offset " + std::to_string(reader.getOffset());
+                }
+                return false;
+            case JsonStreamReader::END:
+                out << '\n';
+                if (!emitter.good())
+                {
+                    if (error)
+                    {
+                        *error = emitter.GetLastError();
+                    }
+                    return false;
+                }
+                return (bool)out;
+            case JsonStreamReader::START_OBJECT:
+                emitter << YAML::BeginMap;
+                break;
+            case JsonStreamReader::END_OBJECT:
+                emitter << YAML::EndMap;
+                break;
+            case JsonStreamReader::START_ARRAY:
+                emitter << YAML::BeginSeq;
+                break;
+            case JsonStreamReader::END_ARRAY:
+                emitter << YAML::EndSeq;
+                break;
+            case JsonStreamReader::KEY:
+                emitter << YAML::Key;
+                EmitString(emitter, reader.getValue());
+                emitter << YAML::Value;
+                break;
+            case JsonStreamReader::STRING:
+                EmitString(emitter, reader.getValue());
+                break;
+            case JsonStreamReader::NUMBER:
+                emitter << reader.getValue();
+                break;
+            case JsonStreamReader::BOOL:
+                emitter << (reader.getValue() == "true");
+                break;
+            case JsonStreamReader::NUL:
+                emitter << YAML::Null;
+                break;
+            }
+        }
+    }
+
+}
\ No newline at end of file
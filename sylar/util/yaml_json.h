@@ -0,0 +1,62 @@
+#ifndef __SYLAR_UTIL_YAML_JSON_H__
+#define __SYLAR_UTIL_YAML_JSON_H__
+
+#include <iostream>
+#include <string>
+#include <string_view>
+
+namespace sylar
+{
+
+    /**
+     * @brief YAML和JSON之间的流式转换
+     * @details 不构造YAML::Node或Json::Value树, 解析事件直接写入另一种格式的输出,
+     *          内存占用与嵌套深度相关而与文档大小无关(YAML锚点引用的子树除外)。
+     *
+     *  类型规则(YAML 1.2 core schema):
+     *  - YAML未加引号的标量按null/bool/int/float/字符串解析, 加引号的始终是字符串
+     *  - YAML的.inf/.nan在JSON中没有对应类型, 输出为字符串
+     *  - JSON字符串如果会被YAML解析为其他类型(如"true", "123"), 输出时加双引号
+     *  - YAML多文档流只转换第一个文档, 锚点引用原样展开, 合并键(<<)不做合并
+     */
+    class YamlJsonConverter
+    {
+    public:
+        /**
+         * @brief YAML转换为紧凑JSON
+         * @details 空文档输出null。输出每积累64KB写一次out, 不等整个文档解析完;
+         *          失败时out中可能已有部分JSON, 内容未定义。需要全有或全无时先写入
+         *          std::ostringstream, 成功后再复制
+         * @param[in] in YAML输入流
+         * @param[out] out JSON输出流
+         * @param[out] error 失败时的错误信息
+         * @return 成功返回true
+         */
+        static bool YamlToJson(std::istream &in, std::ostream &out, std::string *error = nullptr);
+
+        /**
+         * @brief JSON转换为块格式YAML
+         * @param[in] in JSON输入流
+         * @param[out] out YAML输出流
+         * @param[out] error 失败时的错误信息
+         * @return 成功返回true
+         */
+        static bool JsonToYaml(std::istream &in, std::ostream &out, std::string *error = nullptr);
+
+        //未加引号的YAML标量会被解析成的类型
+        enum PlainType
+        {
+            PLAIN_NULL,
+            PLAIN_BOOL,
+            PLAIN_INT,
+            PLAIN_FLOAT,
+            PLAIN_STRING
+        };
+
+        //按YAML 1.2 core schema解析未加引号的标量类型
+        static PlainType ResolvePlain(std::string_view v);
+    };
+
+}
+
+#endif
\ No newline at end of file
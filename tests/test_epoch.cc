@@ -0,0 +1,206 @@
+//EpochManager: 读者持有期间不回收, 嵌套和跨线程离开, 线程退出遗留对象的接管, 并发读写下无释放后使用
+#include "test_util.h"
+#include "sylar/epoch.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+struct Obj
+{
+    static std::atomic<int> s_live;
+
+    explicit Obj(int v) : value(v) { ++s_live; }
+    ~Obj()
+    {
+        value = -1;
+        --s_live;
+    }
+
+    int value;
+};
+
+std::atomic<int> Obj::s_live{0};
+
+//读者进入临界区后retire的对象, 在读者离开前不能释放
+static void test_reader_blocks_reclaim()
+{
+    sylar::EpochManager mgr;
+    mgr.setBatchSize(1);
+    std::atomic<int> step{0};
+    std::thread reader([&]() {
+        sylar::EpochGuard guard(&mgr);
+        step = 1;
+        while (step != 2)
+        {
+            std::this_thread::yield();
+        }
+    });
+    while (step != 1)
+    {
+        std::this_thread::yield();
+    }
+
+    mgr.retire(new Obj(1));
+    for (int i = 0; i < 10; ++i)
+    {
+        mgr.collect();
+    }
+    SYLAR_CHECK(mgr.getRetiredCount() == 1);
+    SYLAR_CHECK(mgr.getReclaimedCount() == 0);
+    SYLAR_CHECK(Obj::s_live == 1);
+
+    step = 2;
+    reader.join();
+    mgr.synchronize();
+    SYLAR_CHECK(mgr.getReclaimedCount() == 1);
+    SYLAR_CHECK(Obj::s_live == 0);
+}
+
+//嵌套的临界区借用池中的记录, 内层离开后外层仍然阻止回收
+static void test_nested()
+{
+    sylar::EpochManager mgr;
+    {
+        sylar::EpochGuard outer(&mgr);
+        {
+            sylar::EpochGuard inner(&mgr);
+        }
+        mgr.retire(new Obj(2));
+        mgr.collect();
+        mgr.collect();
+        SYLAR_CHECK(mgr.getReclaimedCount() == 0);
+    }
+    mgr.synchronize();
+    SYLAR_CHECK(mgr.getReclaimedCount() == 1);
+    SYLAR_CHECK(Obj::s_live == 0);
+}
+
+//模拟协程迁移: 在一个线程进入, 另一个线程离开
+static void test_leave_on_other_thread()
+{
+    sylar::EpochManager mgr;
+    bool pooled = false;
+    sylar::EpochRecord *rec = nullptr;
+    std::thread a([&]() { rec = mgr.enter(pooled); });
+    a.join();
+
+    mgr.retire(new Obj(3));
+    mgr.collect();
+    SYLAR_CHECK(mgr.getReclaimedCount() == 0);
+
+    std::thread b([&]() { mgr.leave(rec, pooled); });
+    b.join();
+    mgr.synchronize();
+    SYLAR_CHECK(mgr.getReclaimedCount() == 1);
+    SYLAR_CHECK(Obj::s_live == 0);
+}
+
+//线程退出时未达到批量的对象交给管理器, 由其他线程回收
+static void test_thread_exit_orphans()
+{
+    sylar::EpochManager mgr;
+    mgr.setBatchSize(1000);
+    std::thread t([&]() {
+        for (int i = 0; i < 10; ++i)
+        {
+            mgr.retire(new Obj(i));
+        }
+    });
+    t.join();
+    SYLAR_CHECK(Obj::s_live == 10);
+    mgr.synchronize();
+    SYLAR_CHECK(mgr.getReclaimedCount() == 10);
+    SYLAR_CHECK(Obj::s_live == 0);
+}
+
+//析构时释放尚未回收的对象
+static void test_destructor()
+{
+    {
+        sylar::EpochManager mgr;
+        mgr.setBatchSize(1000);
+        mgr.retire(new Obj(4));
+        mgr.retire(new Obj(5));
+    }
+    SYLAR_CHECK(Obj::s_live == 0);
+}
+
+//多个读者不断读取, 写者不断替换; 读到的对象必须有效, 结束后只剩当前对象
+static void test_concurrent()
+{
+    sylar::EpochManager mgr;
+    std::atomic<bool> stop{false};
+    std::atomic<int> bad{0};
+    {
+        sylar::EpochPtr<Obj> ptr(new Obj(0), &mgr);
+        std::vector<std::thread> readers;
+        for (int i = 0; i < 4; ++i)
+        {
+            readers.emplace_back([&]() {
+                while (!stop)
+                {
+                    sylar::EpochGuard guard(&mgr);
+                    Obj *o = ptr.load();
+                    int v = o->value;
+                    {
+                        sylar::EpochGuard nested(&mgr);
+                        if (ptr.load()->value < v)
+                        {
+                            ++bad;
+                        }
+                    }
+                    if (v < 0 || o->value != v)
+                    {
+                        ++bad;
+                    }
+                }
+            });
+        }
+        std::thread writer([&]() {
+            for (int i = 1; i <= 100000; ++i)
+            {
+                ptr.store(new Obj(i));
+            }
+            mgr.synchronize();
+        });
+        writer.join();
+        stop = true;
+        for (auto &i : readers)
+        {
+            i.join();
+        }
+        mgr.synchronize();
+        SYLAR_CHECK(bad == 0);
+        SYLAR_CHECK(mgr.getRetiredCount() == 100000);
+        SYLAR_CHECK_MSG(mgr.getReclaimedCount() == 100000, "reclaimed=%llu", (unsigned long long)mgr.getReclaimedCount());
+        SYLAR_CHECK(Obj::s_live == 1);
+    }
+    SYLAR_CHECK(Obj::s_live == 0);
+}
+
+//全局单例: 进程退出时主线程的状态先于单例析构, 遗留对象由单例析构释放
+static void test_global()
+{
+    sylar::EpochPtr<Obj> ptr(new Obj(0));
+    {
+        sylar::EpochGuard guard;
+        SYLAR_CHECK(ptr.load()->value == 0);
+    }
+    ptr.store(new Obj(1));
+    sylar::EpochMgr::GetInstance()->synchronize();
+    SYLAR_CHECK(Obj::s_live == 1);
+    sylar::EpochMgr::GetInstance()->retire(new Obj(2));
+}
+
+int main()
+{
+    test_reader_blocks_reclaim();
+    test_nested();
+    test_leave_on_other_thread();
+    test_thread_exit_orphans();
+    test_destructor();
+    test_concurrent();
+    test_global();
+    return sylar::test::Result("test_epoch");
+}
\ No newline at end of file
@@ -0,0 +1,229 @@
+//HashUtil/Md5/Sha1/Sha256/Hmac与已知向量对比; CRC32C与逐位参考实现对比, 覆盖硬件路径的各种长度和对齐
+#include "test_util.h"
+#include "sylar/util/hash_util.h"
+#include <stdint.h>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#define CHECK_HEX(expr, expect)                                                          \
+    do                                                                                   \
+    {                                                                                    \
+        std::string hex_ = (expr);                                                       \
+        SYLAR_CHECK_MSG(hex_ == (expect), "%s = %s, expect %s", #expr, hex_.c_str(), expect); \
+    } while (0)
+
+//按定义逐位计算的CRC32C(反射多项式0x82f63b78)
+static uint32_t Crc32cRef(const uint8_t *p, size_t len, uint32_t crc)
+{
+    crc = ~crc;
+    for (size_t i = 0; i < len; ++i)
+    {
+        crc ^= p[i];
+        for (int k = 0; k < 8; ++k)
+        {
+            crc = (crc >> 1) ^ (0x82f63b78u & (0u - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+//长度0到299的前缀, 覆盖所有分块和填充边界
+static std::string PatternData()
+{
+    std::string data(300, '\0');
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = (char)(i * 7 + 3);
+    }
+    return data;
+}
+
+//每个前缀的摘要依次送入同一算法, 与Python hashlib算出的结果对比
+template <class H>
+static std::string PrefixChain(const std::string &data)
+{
+    H acc;
+    for (size_t n = 0; n < data.size(); ++n)
+    {
+        acc.update(H::Hash(std::string_view(data.data(), n)));
+    }
+    return acc.hexDigest();
+}
+
+static void test_md5()
+{
+    CHECK_HEX(sylar::Md5().hexDigest(), "d41d8cd98f00b204e9800998ecf8427e");
+    CHECK_HEX(sylar::HashUtil::ToHex(sylar::Md5::Hash("abc")), "900150983cd24fb0d6963f7d28e17f72");
+    CHECK_HEX(sylar::HashUtil::ToHex(sylar::Md5::Hash("message digest")), "f96b697d7cb7938d525a2f31aaf161d0");
+    CHECK_HEX(sylar::HashUtil::ToHex(sylar::Md5::Hash("12345678901234567890123456789012345678901234567890123456789012345678901234567890")),
+              "57edf4a22be3c955ac49da2e2107b67a");
+    CHECK_HEX(PrefixChain<sylar::Md5>(PatternData()), "7822672476780d31feb48545a90bc2ae");
+}
+
+static void test_sha1()
+{
+    CHECK_HEX(sylar::Sha1().hexDigest(), "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+    CHECK_HEX(sylar::HashUtil::ToHex(sylar::Sha1::Hash("abc")), "a9993e364706816aba3e25717850c26c9cd0d89d");
+    CHECK_HEX(sylar::HashUtil::ToHex(sylar::Sha1::Hash("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")),
+              "84983e441c3bd26ebaae4aa1f95129e5e54670f1");
+    CHECK_HEX(sylar::HashUtil::ToHex(sylar::Sha1::Hash("abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmn"
+                                                       "hijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu")),
+              "a49b2446a02c645bf419f995b67091253a04a259");
+    CHECK_HEX(PrefixChain<sylar::Sha1>(PatternData()), "ca9349a03c700fe25e6c2cde997aa96ac2227d8a");
+}
+
+static void test_sha256()
+{
+    CHECK_HEX(sylar::Sha256().hexDigest(), "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    CHECK_HEX(sylar::HashUtil::ToHex(sylar::Sha256::Hash("abc")), "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    CHECK_HEX(sylar::HashUtil::ToHex(sylar::Sha256::Hash("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")),
+              "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+    CHECK_HEX(sylar::HashUtil::ToHex(sylar::Sha256::Hash("abcdefghbcdefghicdefghijdefghijkefghijklfghijklmghijklmn"
+                                                         "hijklmnoijklmnopjklmnopqklmnopqrlmnopqrsmnopqrstnopqrstu")),
+              "cf5b16a778af8380036ce59e7b0492370b249b11e8f07a51afac45037afee9d1");
+    CHECK_HEX(PrefixChain<sylar::Sha256>(PatternData()), "7b074096cabb18dd0d1b468a173cb2f97f80e952525bca29542e606fd6d0753a");
+}
+
+//一百万个'a', 分成不规则的小段写入, 检查跨块的缓冲处理
+static void test_million_a()
+{
+    std::string chunk(1024, 'a');
+    sylar::Md5 md5;
+    sylar::Sha1 sha1;
+    sylar::Sha256 sha256;
+    size_t total = 0;
+    for (size_t step = 1; total < 1000000; step = step % 997 + 13)
+    {
+        size_t n = std::min(step, 1000000 - total);
+        md5.update(chunk.data(), n);
+        sha1.update(chunk.data(), n);
+        sha256.update(chunk.data(), n);
+        total += n;
+    }
+    CHECK_HEX(md5.hexDigest(), "7707d6ae4e027c70eea2a935c2296f21");
+    CHECK_HEX(sha1.hexDigest(), "34aa973cd4c4daa4f61eeb2bdbad27316534016f");
+    CHECK_HEX(sha256.hexDigest(), "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+}
+
+//RFC 2202/4231的测试用例
+static void test_hmac()
+{
+    CHECK_HEX(sylar::HashUtil::ToHex(sylar::HmacSha256::Hash(std::string(20, '\x0b'), "Hi There")),
+              "b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7");
+    CHECK_HEX(sylar::HashUtil::ToHex(sylar::HmacSha256::Hash("Jefe", "what do ya want for nothing?")),
+              "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+    CHECK_HEX(sylar::HashUtil::ToHex(sylar::HmacSha256::Hash(std::string(131, '\xaa'), "Test Using Larger Than Block-Size Key - Hash Key First")),
+              "60e431591ee0b67f0d8a26aacbf5b77f8e0bc6213728c5140546040f0ee37f54");
+    CHECK_HEX(sylar::HashUtil::ToHex(sylar::HmacSha1::Hash(std::string(20, '\x0b'), "Hi There")),
+              "b617318655057264e28bc0b6fb378c8ef146be00");
+    CHECK_HEX(sylar::HashUtil::ToHex(sylar::HmacSha1::Hash(std::string(80, '\xaa'), "Test Using Larger Than Block-Size Key - Hash Key First")),
+              "aa4ae5e15272d00e95705637ce8a3b55ed402112");
+    CHECK_HEX(sylar::HashUtil::ToHex(sylar::Hmac<sylar::Md5>::Hash(std::string(16, '\x0b'), "Hi There")),
+              "9294727a3638bb1c13f48ef8158bfc9d");
+
+    sylar::HmacSha256 h("Jefe");
+    h.update("what do ya want ");
+    h.update("for nothing?");
+    CHECK_HEX(h.hexDigest(), "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+}
+
+//带种子/初始CRC的接口不能以(指针, 整数)调用, 避免把种子当成长度
+template <class... Args>
+static auto CallXXH64Seeded(int) -> decltype(sylar::HashUtil::XXH64Seeded(std::declval<Args>()...), std::true_type());
+template <class... Args>
+static std::false_type CallXXH64Seeded(...);
+template <class... Args>
+static auto CallCrc32cExtend(int) -> decltype(sylar::HashUtil::Crc32cExtend(std::declval<Args>()...), std::true_type());
+template <class... Args>
+static std::false_type CallCrc32cExtend(...);
+static_assert(!decltype(CallXXH64Seeded<const char *, int>(0))::value, "XXH64Seeded(ptr, seed)");
+static_assert(decltype(CallXXH64Seeded<int, const char *>(0))::value, "XXH64Seeded(seed, str)");
+static_assert(!decltype(CallCrc32cExtend<const char *, uint32_t>(0))::value, "Crc32cExtend(ptr, crc)");
+static_assert(decltype(CallCrc32cExtend<uint32_t, const char *>(0))::value, "Crc32cExtend(crc, str)");
+
+static void test_crc32c()
+{
+    SYLAR_CHECK(sylar::HashUtil::Crc32c("123456789") == 0xe3069283u);
+    SYLAR_CHECK(sylar::HashUtil::Crc32c("") == 0);
+    //RFC 3720 B.4
+    SYLAR_CHECK(sylar::HashUtil::Crc32c(std::string(32, '\0')) == 0x8a9136aau);
+    SYLAR_CHECK(sylar::HashUtil::Crc32c(std::string(32, '\xff')) == 0x62a8ab43u);
+    std::string inc(32, '\0');
+    for (size_t i = 0; i < inc.size(); ++i)
+    {
+        inc[i] = (char)i;
+    }
+    SYLAR_CHECK(sylar::HashUtil::Crc32c(inc) == 0x46dd794eu);
+
+    //随机内容的各种长度和起始对齐, 以及分段计算
+    std::mt19937 rng(7);
+    std::vector<uint8_t> buf(4096 + 16);
+    for (auto &i : buf)
+    {
+        i = (uint8_t)rng();
+    }
+    for (size_t len = 0; len <= 4096; len += (len < 300 ? 1 : 97))
+    {
+        for (size_t align = 0; align < 8; ++align)
+        {
+            const uint8_t *p = buf.data() + align;
+            uint32_t expect = Crc32cRef(p, len, 0);
+            uint32_t crc = sylar::HashUtil::Crc32c(p, len);
+            SYLAR_CHECK_MSG(crc == expect, "len=%zu align=%zu crc=%08x expect=%08x", len, align, crc, expect);
+            size_t split = len ? rng() % len : 0;
+            uint32_t part = sylar::HashUtil::Crc32cExtend(sylar::HashUtil::Crc32c(p, split), p + split, len - split);
+            SYLAR_CHECK_MSG(part == expect, "len=%zu split=%zu crc=%08x expect=%08x", len, split, part, expect);
+        }
+    }
+}
+
+static void test_xxh64()
+{
+    SYLAR_CHECK(sylar::HashUtil::XXH64("") == 0xef46db3751d8e999ull);
+    SYLAR_CHECK(sylar::HashUtil::XXH64("a") == 0xd24ec4f1a98c6e5bull);
+    SYLAR_CHECK(sylar::HashUtil::XXH64("abc") == 0x44bc2cf5ad770999ull);
+    SYLAR_CHECK(sylar::HashUtil::XXH64Seeded(1, "abc") == 0xbea9ca8199328908ull);
+    //指针加一个整数只能是(data, len)
+    SYLAR_CHECK(sylar::HashUtil::XXH64("abc", 1) == sylar::HashUtil::XXH64("a"));
+    SYLAR_CHECK(sylar::HashUtil::XXH64("Nobody inspects the spammish repetition") == 0xfbcea83c8a378bf1ull);
+
+    //每个前缀以长度为种子的哈希按小端拼接后再哈希, 结果来自libxxhash
+    std::string data = PatternData();
+    std::string cat;
+    for (size_t n = 0; n < data.size(); ++n)
+    {
+        uint64_t h = sylar::HashUtil::XXH64Seeded(n, data.data(), n);
+        for (int k = 0; k < 8; ++k)
+        {
+            cat.push_back((char)(h >> (k * 8)));
+        }
+    }
+    uint64_t chain = sylar::HashUtil::XXH64(cat);
+    SYLAR_CHECK_MSG(chain == 0xaa35314bfa5cb2b0ull, "chain=%016llx", (unsigned long long)chain);
+
+    //增量计算与一次性计算一致, 中途digest()不影响后续update
+    for (size_t n = 0; n < data.size(); n += 7)
+    {
+        sylar::XXH64Hasher hasher(n);
+        size_t split = n / 3;
+        hasher.update(data.data(), split);
+        hasher.digest();
+        hasher.update(data.data() + split, n - split);
+        SYLAR_CHECK_MSG(hasher.digest() == sylar::HashUtil::XXH64Seeded(n, data.data(), n), "n=%zu", n);
+    }
+}
+
+int main()
+{
+    test_md5();
+    test_sha1();
+    test_sha256();
+    test_million_a();
+    test_hmac();
+    test_crc32c();
+    test_xxh64();
+    return sylar::test::Result("test_hash_util");
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+//JsonUtil::Get*: JsonValue版本与Json::Value版本对比, 覆盖整数形式的小数, 越界, 字符串前缀转换和类型不符
+#include "test_util.h"
+#include "sylar/util/json_util.h"
+#include <string>
+#include <vector>
+
+static void Compare(const std::string &field)
+{
+    std::string text = "{\"v\":" + field + "}";
+    Json::Value tree;
+    sylar::JsonDocument doc;
+    if (!sylar::JsonUtil::FromString(tree, text) || !sylar::JsonUtil::FromString(doc, text))
+    {
+        SYLAR_CHECK_MSG(false, "parse %s", text.c_str());
+        return;
+    }
+    sylar::JsonValue root = doc.root();
+#define XX(method, fmt, def)                                                                  \
+    {                                                                                         \
+        auto a = sylar::JsonUtil::method(tree, "v", def);                                     \
+        auto b = sylar::JsonUtil::method(root, "v", def);                                     \
+        SYLAR_CHECK_MSG(a == b, "%s(%s): Json::Value " fmt " JsonValue " fmt, #method, field.c_str(), a, b); \
+    }
+    XX(GetInt32, "%d", 7);
+    XX(GetUint32, "%u", 7u);
+    XX(GetInt64, "%lld", 7ll);
+    XX(GetUint64, "%llu", 7ull);
+    XX(GetDouble, "%g", 7.0);
+#undef XX
+    std::string a = sylar::JsonUtil::GetString(tree, "v", "def");
+    std::string b = sylar::JsonUtil::GetString(root, "v", "def");
+    SYLAR_CHECK_MSG(a == b, "GetString(%s): %s %s", field.c_str(), a.c_str(), b.c_str());
+}
+
+int main()
+{
+    std::vector<std::string> fields = {
+        "0", "1", "-1", "3.0", "-3.0", "3.5", "1e3", "-1e3", "1E2", "0.0", "-0.0", "1e-3",
+        "2147483647", "2147483648", "-2147483648", "-2147483649", "4294967295", "4294967296",
+        "2147483647.0", "2147483648.0", "4294967295.0", "4294967296.0", "-2147483648.0",
+        "9223372036854775807", "9223372036854775808", "-9223372036854775808", "18446744073709551615",
+        "18446744073709551616", "9.2233720368547758e18", "-9.2233720368547758e18",
+        "1.8446744073709552e19", "1.8446744073709550e19", "1e300", "-1e300",
+        "\"12\"", "\"12abc\"", "\"  -5\"", "\"\\n7\"", "\"+9\"", "\"abc\"", "\"\"", "\"3.7\"",
+        "\"-1\"", "\"4294967295\"", "\"99999999999\"", "\"99999999999999999999\"",
+        "\"-99999999999999999999\"", "\"1e3\"", "\"0x10\"",
+        "true", "false", "null", "[1]", "{\"a\":1}"};
+    for (auto &i : fields)
+    {
+        Compare(i);
+    }
+    return sylar::test::Result("test_json_util");
+}
\ No newline at end of file
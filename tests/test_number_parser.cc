@@ -0,0 +1,267 @@
+//NumberParser与strtoll/strtoull/strtod/strtof对比: 各长度的数字串, 溢出边界, 非法字符和浮点特殊值
+#include "test_util.h"
+#include "sylar/util/number_parser.h"
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <random>
+#include <string>
+#include <vector>
+
+//strtoll要求整个字符串都被消费, 不允许前导空白, 不溢出
+static bool RefInt(const std::string &s, int64_t &v)
+{
+    if (s.empty() || isspace((unsigned char)s[0]))
+    {
+        return false;
+    }
+    char *end = nullptr;
+    errno = 0;
+    long long r = strtoll(s.c_str(), &end, 10);
+    if (end != s.c_str() + s.size() || errno == ERANGE)
+    {
+        return false;
+    }
+    v = r;
+    return true;
+}
+
+//strtoull会把负数回绕成大整数, 先排除'-'
+static bool RefUint(const std::string &s, uint64_t &v)
+{
+    if (s.empty() || isspace((unsigned char)s[0]) || s[0] == '-')
+    {
+        return false;
+    }
+    char *end = nullptr;
+    errno = 0;
+    unsigned long long r = strtoull(s.c_str(), &end, 10);
+    if (end != s.c_str() + s.size() || errno == ERANGE)
+    {
+        return false;
+    }
+    v = r;
+    return true;
+}
+
+//strtod/strtof: 下溢得到0或非规格化数时仍算成功, 只有上溢失败; 十六进制不在比较范围内
+template <class T>
+static bool RefFloating(const std::string &s, T &v)
+{
+    if (s.empty() || isspace((unsigned char)s[0]))
+    {
+        return false;
+    }
+    char *end = nullptr;
+    errno = 0;
+    T r = std::is_same_v<T, float> ? strtof(s.c_str(), &end) : strtod(s.c_str(), &end);
+    if (end != s.c_str() + s.size())
+    {
+        return false;
+    }
+    if (errno == ERANGE && isinf(r))
+    {
+        return false;
+    }
+    v = r;
+    return true;
+}
+
+template <class T>
+static bool SameFloating(T a, T b)
+{
+    if (isnan(a) || isnan(b))
+    {
+        return isnan(a) && isnan(b);
+    }
+    return memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+static void CheckInt(const std::string &s)
+{
+    int64_t expect = 0;
+    bool expect_ok = RefInt(s, expect);
+    int64_t v = 12345;
+    bool ok = sylar::NumberParser::ParseInt(s, v);
+    SYLAR_CHECK_MSG(ok == expect_ok, "ParseInt(\"%s\") ok=%d expect=%d", s.c_str(), ok, expect_ok);
+    if (ok && expect_ok)
+    {
+        SYLAR_CHECK_MSG(v == expect, "ParseInt(\"%s\")=%lld expect=%lld", s.c_str(), (long long)v, (long long)expect);
+    }
+    if (!ok)
+    {
+        SYLAR_CHECK_MSG(v == 12345, "ParseInt(\"%s\") modified output on failure", s.c_str());
+    }
+
+    uint64_t uexpect = 0;
+    bool uexpect_ok = RefUint(s, uexpect);
+    uint64_t u = 12345;
+    ok = sylar::NumberParser::ParseUint(s, u);
+    SYLAR_CHECK_MSG(ok == uexpect_ok, "ParseUint(\"%s\") ok=%d expect=%d", s.c_str(), ok, uexpect_ok);
+    if (ok && uexpect_ok)
+    {
+        SYLAR_CHECK_MSG(u == uexpect, "ParseUint(\"%s\")=%llu expect=%llu", s.c_str(), (unsigned long long)u, (unsigned long long)uexpect);
+    }
+    if (!ok)
+    {
+        SYLAR_CHECK_MSG(u == 12345, "ParseUint(\"%s\") modified output on failure", s.c_str());
+    }
+
+    //窄类型的范围检查
+    int32_t i32 = 0;
+    bool i32_ok = expect_ok && expect >= INT32_MIN && expect <= INT32_MAX;
+    SYLAR_CHECK_MSG(sylar::NumberParser::Parse(s, i32) == i32_ok, "Parse<int32_t>(\"%s\")", s.c_str());
+    uint16_t u16 = 0;
+    bool u16_ok = uexpect_ok && uexpect <= UINT16_MAX;
+    SYLAR_CHECK_MSG(sylar::NumberParser::Parse(s, u16) == u16_ok, "Parse<uint16_t>(\"%s\")", s.c_str());
+}
+
+template <class T>
+static void CheckFloating(const std::string &s)
+{
+    T expect = 0;
+    bool expect_ok = RefFloating(s, expect);
+    T v = 12345;
+    bool ok = sylar::NumberParser::Parse(s, v);
+    SYLAR_CHECK_MSG(ok == expect_ok, "Parse<%s>(\"%s\") ok=%d expect=%d", sizeof(T) == 4 ? "float" : "double", s.c_str(), ok, expect_ok);
+    if (ok && expect_ok)
+    {
+        SYLAR_CHECK_MSG(SameFloating(v, expect), "Parse<%s>(\"%s\")=%.17g expect=%.17g", sizeof(T) == 4 ? "float" : "double", s.c_str(), (double)v, (double)expect);
+    }
+    if (!ok)
+    {
+        SYLAR_CHECK_MSG(v == 12345, "Parse<floating>(\"%s\") modified output on failure", s.c_str());
+    }
+}
+
+static void test_int_edges()
+{
+    const char *cases[] = {
+        "", "+", "-", "0", "-0", "+0", "00", "007", "+-1", "-+1", " 1", "1 ", "1\n", "1_000",
+        "9223372036854775807", "9223372036854775808", "-9223372036854775808", "-9223372036854775809",
+        "18446744073709551615", "18446744073709551616", "99999999999999999999", "-1",
+        "000000000000000000000000000000009223372036854775807",
+        "00000000000000000000000000000000018446744073709551615",
+        "12345678", "123456789", "1234567890123456", "12345678901234567", "1234567890123456789",
+        "1234567/", "1234567:", "/1234567", ":1234567", "12345678901234/6", "1234567890123456:",
+        "0x10", "1e3", "1.0", "\xb0\xb1", "12\xb3", "2147483647", "2147483648", "-2147483648",
+        "-2147483649", "65535", "65536",
+    };
+    for (auto c : cases)
+    {
+        CheckInt(c);
+    }
+}
+
+//各长度的随机数字串, 含前导零, 符号和任意位置的非法字符
+static void test_int_random()
+{
+    std::mt19937_64 rng(20240101);
+    const char bad[] = "/:a -+.\x80";
+    for (int round = 0; round < 200000; ++round)
+    {
+        size_t len = 1 + rng() % 24;
+        std::string s;
+        switch (rng() % 4)
+        {
+        case 0:
+            s = "-";
+            break;
+        case 1:
+            s = "+";
+            break;
+        default:
+            break;
+        }
+        for (size_t i = 0; i < len; ++i)
+        {
+            s.push_back((char)('0' + rng() % 10));
+        }
+        if (rng() % 8 == 0)
+        {
+            s[rng() % s.size()] = bad[rng() % (sizeof(bad) - 1)];
+        }
+        CheckInt(s);
+    }
+}
+
+static void test_floating_edges()
+{
+    const char *cases[] = {
+        "", "+", "-", ".", "0", "-0", "+0.0", ".5", "5.", "1e", "1e+", "e5", "1.5e3", "1.5E-3", "+1e10",
+        "+-1", "1e308", "1.7976931348623157e308", "1.7976931348623159e308", "1e309", "-1e309",
+        "1e-400", "4.9e-324", "2.4703282292062328e-324", "2.2250738585072011e-308",
+        "3.4028235e38", "3.5e38", "1e-50", "1.17549435e-38",
+        "inf", "-inf", "+inf", "Infinity", "-INFINITY", "nan", "NaN", "-nan", "nan(123)",
+        "0.1", "0.30000000000000004", "123456789012345678901234567890", "1 ", " 1", "1,5", "1.2.3",
+        "9007199254740993", "1e0000000000000000000001",
+    };
+    for (auto c : cases)
+    {
+        CheckFloating<double>(c);
+        CheckFloating<float>(c);
+    }
+    //strtod接受十六进制浮点数, NumberParser不接受
+    double d = 0;
+    SYLAR_CHECK(!sylar::NumberParser::ParseDouble("0x1p3", d));
+    SYLAR_CHECK(!sylar::NumberParser::ParseDouble("0X1.8", d));
+}
+
+//随机位模式的double按不同格式输出后解析, 以及随机的十进制串
+static void test_floating_random()
+{
+    std::mt19937_64 rng(42);
+    const char *formats[] = {"%.17g", "%g", "%.3f", "%e", "%.25e"};
+    char buf[512];
+    for (int round = 0; round < 100000; ++round)
+    {
+        uint64_t bits = rng();
+        double d;
+        memcpy(&d, &bits, sizeof(d));
+        const char *fmt = formats[rng() % (sizeof(formats) / sizeof(formats[0]))];
+        snprintf(buf, sizeof(buf), fmt, d);
+        CheckFloating<double>(buf);
+        CheckFloating<float>(buf);
+
+        std::string s;
+        size_t len = 1 + rng() % 30;
+        for (size_t i = 0; i < len; ++i)
+        {
+            s.push_back((char)('0' + rng() % 10));
+        }
+        if (rng() % 2)
+        {
+            s.insert(rng() % s.size(), ".");
+        }
+        if (rng() % 2)
+        {
+            s += "e" + std::to_string((int)(rng() % 700) - 350);
+        }
+        CheckFloating<double>(s);
+        CheckFloating<float>(s);
+    }
+}
+
+static void test_bool()
+{
+    bool v = false;
+    SYLAR_CHECK(sylar::NumberParser::ParseBool("1", v) && v);
+    SYLAR_CHECK(sylar::NumberParser::ParseBool("0", v) && !v);
+    SYLAR_CHECK(sylar::NumberParser::ParseBool("TRUE", v) && v);
+    SYLAR_CHECK(sylar::NumberParser::ParseBool("False", v) && !v);
+    SYLAR_CHECK(!sylar::NumberParser::ParseBool("yes", v));
+    SYLAR_CHECK(!sylar::NumberParser::ParseBool("2", v));
+    SYLAR_CHECK(!sylar::NumberParser::ParseBool("", v));
+}
+
+int main()
+{
+    test_int_edges();
+    test_int_random();
+    test_floating_edges();
+    test_floating_random();
+    test_bool();
+    return sylar::test::Result("test_number_parser");
+}
\ No newline at end of file
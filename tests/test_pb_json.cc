@@ -0,0 +1,123 @@
+//PBJsonConverter往返测试: bytes字段的base64编解码(含任意二进制), 整数字段接受3.0/1e3形式
+#include "test_util.h"
+#include "sylar/util/pb_json.h"
+#include <google/protobuf/descriptor.pb.h>
+#include <google/protobuf/dynamic_message.h>
+#include <string>
+
+namespace pb = google::protobuf;
+
+static void TestBytesRoundTrip()
+{
+    pb::UninterpretedOption src;
+    src.set_string_value(std::string("\xff\0\x80 ok", 6));
+    src.set_identifier_value("id");
+    std::string json = sylar::PBJsonConverter::ToJson(src);
+    SYLAR_CHECK_MSG(json.find("\"string_value\":\"/wCAIG9r\"") != std::string::npos, "%s", json.c_str());
+
+    pb::UninterpretedOption dst;
+    std::string error;
+    SYLAR_CHECK_MSG(sylar::PBJsonConverter::FromJson(json, dst, &error), "%s", error.c_str());
+    SYLAR_CHECK(dst.string_value() == src.string_value());
+    SYLAR_CHECK(dst.identifier_value() == "id");
+
+    //所有字节值, 以及各种长度的填充
+    for (size_t len = 0; len <= 260; ++len)
+    {
+        std::string v;
+        for (size_t i = 0; i < len; ++i)
+        {
+            v.push_back((char)(i * 7 + len));
+        }
+        src.set_string_value(v);
+        json = sylar::PBJsonConverter::ToJson(src);
+        dst.Clear();
+        SYLAR_CHECK_MSG(sylar::PBJsonConverter::FromJson(json, dst, &error), "len=%zu %s", len, error.c_str());
+        SYLAR_CHECK_MSG(dst.string_value() == v, "len=%zu", len);
+    }
+}
+
+static void TestBytesDecode()
+{
+    pb::UninterpretedOption dst;
+    //URL安全字母表, 省略填充
+    SYLAR_CHECK(sylar::PBJsonConverter::FromJson("{\"string_value\":\"-_8\"}", dst));
+    SYLAR_CHECK(dst.string_value() == "\xfb\xff");
+    SYLAR_CHECK(sylar::PBJsonConverter::FromJson("{\"stringValue\":\"+/8=\"}", dst));
+    SYLAR_CHECK(dst.string_value() == "\xfb\xff");
+    SYLAR_CHECK(sylar::PBJsonConverter::FromJson("{\"string_value\":\"\"}", dst));
+    SYLAR_CHECK(dst.string_value().empty());
+
+    std::string error;
+    SYLAR_CHECK(!sylar::PBJsonConverter::FromJson("{\"string_value\":\"a\"}", dst, &error));
+    SYLAR_CHECK_MSG(error.find("base64") != std::string::npos, "%s", error.c_str());
+    SYLAR_CHECK(!sylar::PBJsonConverter::FromJson("{\"string_value\":\"ab$d\"}", dst));
+    SYLAR_CHECK(!sylar::PBJsonConverter::FromJson("{\"string_value\":1}", dst));
+}
+
+//repeated bytes没有现成的消息类型, 用动态消息构造
+static void TestRepeatedBytes()
+{
+    pb::FileDescriptorProto file;
+    file.set_name("test_pb_json.proto");
+    file.set_syntax("proto3");
+    pb::DescriptorProto *msg = file.add_message_type();
+    msg->set_name("Blobs");
+    pb::FieldDescriptorProto *f = msg->add_field();
+    f->set_name("items");
+    f->set_number(1);
+    f->set_type(pb::FieldDescriptorProto::TYPE_BYTES);
+    f->set_label(pb::FieldDescriptorProto::LABEL_REPEATED);
+
+    pb::DescriptorPool pool;
+    const pb::FileDescriptor *fd = pool.BuildFile(file);
+    SYLAR_CHECK(fd != nullptr);
+    if (!fd)
+    {
+        return;
+    }
+    pb::DynamicMessageFactory factory(&pool);
+    const pb::Descriptor *desc = fd->FindMessageTypeByName("Blobs");
+    const pb::FieldDescriptor *items = desc->FindFieldByName("items");
+    std::unique_ptr<pb::Message> src(factory.GetPrototype(desc)->New());
+    src->GetReflection()->AddString(src.get(), items, std::string("\0\1\2", 3));
+    src->GetReflection()->AddString(src.get(), items, "\xc3\x28");
+    src->GetReflection()->AddString(src.get(), items, "");
+
+    std::string json = sylar::PBJsonConverter::ToJson(*src);
+    SYLAR_CHECK_MSG(json == "{\"items\":[\"AAEC\",\"wyg=\",\"\"]}", "%s", json.c_str());
+    std::unique_ptr<pb::Message> dst(factory.GetPrototype(desc)->New());
+    std::string error;
+    SYLAR_CHECK_MSG(sylar::PBJsonConverter::FromJson(json, *dst, &error), "%s", error.c_str());
+    SYLAR_CHECK(dst->SerializeAsString() == src->SerializeAsString());
+}
+
+static void TestIntegralFloat()
+{
+    pb::UninterpretedOption dst;
+    std::string error;
+    SYLAR_CHECK_MSG(sylar::PBJsonConverter::FromJson(
+                        "{\"positive_int_value\":1e3,\"negative_int_value\":-3.0}", dst, &error),
+                    "%s", error.c_str());
+    SYLAR_CHECK(dst.positive_int_value() == 1000);
+    SYLAR_CHECK(dst.negative_int_value() == -3);
+    SYLAR_CHECK(sylar::PBJsonConverter::FromJson("{\"positive_int_value\":\"2.5e1\"}", dst));
+    SYLAR_CHECK(dst.positive_int_value() == 25);
+    SYLAR_CHECK(sylar::PBJsonConverter::FromJson("{\"negative_int_value\":-9.223372036854775808e18}", dst));
+    SYLAR_CHECK(dst.negative_int_value() == INT64_MIN);
+
+    SYLAR_CHECK(!sylar::PBJsonConverter::FromJson("{\"positive_int_value\":3.5}", dst));
+    SYLAR_CHECK(!sylar::PBJsonConverter::FromJson("{\"positive_int_value\":-1.0}", dst));
+    SYLAR_CHECK(!sylar::PBJsonConverter::FromJson("{\"positive_int_value\":1.8446744073709551616e19}", dst));
+    SYLAR_CHECK(!sylar::PBJsonConverter::FromJson("{\"negative_int_value\":9.223372036854775808e18}", dst));
+    SYLAR_CHECK(!sylar::PBJsonConverter::FromJson("{\"negative_int_value\":1e400}", dst));
+}
+
+int main()
+{
+    TestBytesRoundTrip();
+    TestBytesDecode();
+    TestRepeatedBytes();
+    TestIntegralFloat();
+    return sylar::test::Result("test_pb_json");
+}
\ No newline at end of file
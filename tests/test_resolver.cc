@@ -0,0 +1,124 @@
+//DnsCache: TTL过期, 失败结果缓存, 并发解析合并, 用StubResolver代替真实DNS
+#include "test_util.h"
+#include "sylar/resolver.h"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+static void SleepMS(int ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+static std::string FirstAddr(sylar::DnsCache &cache, const std::string &host)
+{
+    std::vector<sylar::IPAddress::ptr> addrs;
+    if (!cache.lookup(host, addrs) || addrs.empty())
+    {
+        return "";
+    }
+    return addrs[0]->toString();
+}
+
+//成功结果在positive_ttl内命中缓存, 过期后重新解析并拿到新地址
+static void test_positive_ttl()
+{
+    sylar::DnsCache cache;
+    sylar::StubResolver::ptr stub(new sylar::StubResolver);
+    stub->setHost("svc.example", {"10.0.0.1"});
+    cache.setResolver(stub);
+    cache.setPositiveTTL(100);
+
+    SYLAR_CHECK(FirstAddr(cache, "svc.example") == "10.0.0.1:0");
+    SYLAR_CHECK(stub->getCallCount() == 1);
+
+    stub->setHost("svc.example", {"10.0.0.2"});
+    SYLAR_CHECK(FirstAddr(cache, "svc.example") == "10.0.0.1:0");
+    SYLAR_CHECK(stub->getCallCount() == 1);
+    SYLAR_CHECK(cache.getHits() >= 1);
+
+    SleepMS(150);
+    SYLAR_CHECK(FirstAddr(cache, "svc.example") == "10.0.0.2:0");
+    SYLAR_CHECK(stub->getCallCount() == 2);
+
+    //返回的是副本, 修改端口不影响缓存
+    sylar::IPAddress::ptr addr = cache.lookupAny("svc.example");
+    SYLAR_CHECK(addr);
+    if (addr)
+    {
+        addr->setPort(8080);
+    }
+    addr = cache.lookupAny("svc.example");
+    SYLAR_CHECK(addr && addr->getPort() == 0);
+}
+
+//失败结果在negative_ttl内直接返回失败, 不再调用解析器
+static void test_negative_ttl()
+{
+    sylar::DnsCache cache;
+    sylar::StubResolver::ptr stub(new sylar::StubResolver);
+    cache.setResolver(stub);
+    cache.setNegativeTTL(100);
+
+    SYLAR_CHECK(!cache.lookupAny("missing.example"));
+    SYLAR_CHECK(stub->getCallCount() == 1);
+
+    stub->setHost("missing.example", {"10.0.0.3"});
+    SYLAR_CHECK(!cache.lookupAny("missing.example"));
+    SYLAR_CHECK(stub->getCallCount() == 1);
+
+    SleepMS(150);
+    SYLAR_CHECK(FirstAddr(cache, "missing.example") == "10.0.0.3:0");
+    SYLAR_CHECK(stub->getCallCount() == 2);
+
+    //negative_ttl为0时失败结果不缓存
+    cache.setNegativeTTL(0);
+    SYLAR_CHECK(!cache.lookupAny("other.example"));
+    SYLAR_CHECK(!cache.lookupAny("other.example"));
+    SYLAR_CHECK(stub->getCallCount() == 4);
+}
+
+//同一主机名的N个并发查询只调用一次解析器
+static void test_single_flight()
+{
+    const int N = 16;
+    sylar::DnsCache cache;
+    sylar::StubResolver::ptr stub(new sylar::StubResolver);
+    stub->setHost("hot.example", {"10.0.1.1", "10.0.1.2"});
+    stub->setDelay(200);
+    cache.setResolver(stub);
+
+    std::atomic<int> ok{0};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < N; ++i)
+    {
+        threads.emplace_back([&]()
+                             {
+            if (cache.lookupAny("hot.example"))
+            {
+                ++ok;
+            } });
+    }
+    for (auto &i : threads)
+    {
+        i.join();
+    }
+    SYLAR_CHECK(ok == N);
+    SYLAR_CHECK_MSG(stub->getCallCount() == 1, "calls=%lu", (unsigned long)stub->getCallCount());
+    SYLAR_CHECK(cache.getJoins() + cache.getHits() == N - 1);
+
+    //不同的地址族是不同的查询
+    stub->setDelay(0);
+    cache.lookupAny("hot.example", AF_INET6);
+    SYLAR_CHECK(stub->getCallCount() == 2);
+}
+
+int main()
+{
+    test_positive_ttl();
+    test_negative_ttl();
+    test_single_flight();
+    return sylar::test::Result("test_resolver");
+}
\ No newline at end of file
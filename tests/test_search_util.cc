@@ -0,0 +1,142 @@
+//LinearSearch/BranchlessSearch/EytzingerSearch与std::lower_bound对比, 覆盖重复元素, 边界值和SIMD尾部
+#include "test_util.h"
+#include "sylar/util/search_util.h"
+#include <stdint.h>
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <typeinfo>
+#include <vector>
+
+//std::lower_bound换算成BinarySearch的返回约定
+template <class T>
+static int Expected(const std::vector<T> &arr, const T &v)
+{
+    int idx = (int)(std::lower_bound(arr.begin(), arr.end(), v) - arr.begin());
+    if (idx < (int)arr.size() && !(v < arr[idx]))
+    {
+        return idx;
+    }
+    return -idx - 1;
+}
+
+template <class T>
+static void CheckOne(const std::vector<T> &arr, const std::vector<T> &layout,
+                     const sylar::EytzingerTree<T> &tree, const T &v)
+{
+    int n = (int)arr.size();
+    int expect = Expected(arr, v);
+    int linear = sylar::LinearSearch(arr.data(), n, v);
+    int branchless = sylar::BranchlessSearch(arr.data(), n, v);
+    int eytzinger = sylar::EytzingerSearch(layout.data(), n, v);
+    int found = tree.find(v);
+    SYLAR_CHECK_MSG(linear == expect, "%s n=%d linear=%d expect=%d", typeid(T).name(), n, linear, expect);
+    SYLAR_CHECK_MSG(branchless == expect, "%s n=%d branchless=%d expect=%d", typeid(T).name(), n, branchless, expect);
+    SYLAR_CHECK_MSG(eytzinger == expect, "%s n=%d eytzinger=%d expect=%d", typeid(T).name(), n, eytzinger, expect);
+    SYLAR_CHECK_MSG(found == expect, "%s n=%d tree=%d expect=%d", typeid(T).name(), n, found, expect);
+}
+
+//arr已排序; 查询每个元素及其前后的值和类型的极值
+template <class T>
+static void CheckArray(const std::vector<T> &arr)
+{
+    std::vector<T> layout(arr.size());
+    sylar::EytzingerLayout(arr.data(), (int)arr.size(), layout.data());
+    sylar::EytzingerTree<T> tree(arr);
+
+    std::vector<T> queries = {std::numeric_limits<T>::lowest(), std::numeric_limits<T>::max(), T()};
+    for (auto &i : arr)
+    {
+        queries.push_back(i);
+        if (i != std::numeric_limits<T>::lowest())
+        {
+            queries.push_back(i - 1);
+        }
+        if (i != std::numeric_limits<T>::max())
+        {
+            queries.push_back(i + 1);
+        }
+    }
+    for (auto &v : queries)
+    {
+        CheckOne(arr, layout, tree, v);
+    }
+}
+
+/**
+ * @brief 随机有序数组
+ * @details 取值集中在较小的范围内以产生重复元素, 并混入极值和符号位附近的值,
+ *          无符号类型的最高位元素用来检查SIMD的偏置比较
+ */
+template <class T>
+static std::vector<T> RandomSorted(std::mt19937_64 &rng, size_t n)
+{
+    std::vector<T> arr(n);
+    for (auto &i : arr)
+    {
+        uint64_t r = rng();
+        switch (r % 8)
+        {
+        case 0:
+            i = std::numeric_limits<T>::lowest();
+            break;
+        case 1:
+            i = std::numeric_limits<T>::max();
+            break;
+        case 2:
+            i = (T)(std::numeric_limits<T>::max() / 2 + 1);
+            break;
+        default:
+            i = (T)((int64_t)(r >> 8) % 200 - 100);
+            break;
+        }
+    }
+    std::sort(arr.begin(), arr.end());
+    return arr;
+}
+
+template <class T>
+static void test_type()
+{
+    std::mt19937_64 rng(12345);
+    //覆盖0到两轮AVX2块之后的所有尾部长度, 以及完全/不完全的Eytzinger树
+    for (size_t n = 0; n <= 70; ++n)
+    {
+        CheckArray(RandomSorted<T>(rng, n));
+    }
+    for (size_t n : {127, 128, 255, 256, 1000, 4097})
+    {
+        CheckArray(RandomSorted<T>(rng, n));
+    }
+    //不重复的递增数组
+    std::vector<T> arr;
+    for (int i = 0; i < 1000; ++i)
+    {
+        arr.push_back((T)(i * 3));
+    }
+    CheckArray(arr);
+}
+
+static void test_double()
+{
+    std::vector<double> arr;
+    for (int i = 0; i < 300; ++i)
+    {
+        arr.push_back(i * 0.5 - 20);
+    }
+    CheckArray(arr);
+}
+
+int main()
+{
+    test_type<int32_t>();
+    test_type<uint32_t>();
+    test_type<int64_t>();
+    test_type<uint64_t>();
+    //与int64_t不同的类型, 走按位模式比较的接口
+    test_type<long long>();
+    test_type<unsigned long long>();
+    test_type<int16_t>();
+    test_double();
+    return sylar::test::Result("test_search_util");
+}
\ No newline at end of file
@@ -0,0 +1,194 @@
+//TimeFormatter与strftime/strptime+mktime对比: 多个时区(含夏令时和非整点偏移), 1901到2200年的时间戳
+#include "test_util.h"
+#include "sylar/util/time_formatter.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <random>
+#include <string>
+#include <vector>
+
+static void SetTimezone(const char *tz)
+{
+    setenv("TZ", tz, 1);
+    tzset();
+    sylar::TimeFormatter::ResetTimezone();
+}
+
+static std::string RefFormat(time_t ts, const char *format, bool utc)
+{
+    struct tm t;
+    if (utc)
+    {
+        gmtime_r(&ts, &t);
+    }
+    else
+    {
+        localtime_r(&ts, &t);
+    }
+    char buf[256];
+    size_t n = strftime(buf, sizeof(buf), format, &t);
+    return std::string(buf, n);
+}
+
+//strptime后本地时间用mktime(由它决定夏令时), UTC用timegm; 有%z时按输入中的偏移换算
+static bool RefParse(const std::string &str, const char *format, bool utc, time_t &ts)
+{
+    struct tm t;
+    memset(&t, 0, sizeof(t));
+    t.tm_mday = 1;
+    if (!strptime(str.c_str(), format, &t))
+    {
+        return false;
+    }
+    if (strstr(format, "%s"))
+    {
+        ts = mktime(&t);
+        return true;
+    }
+    if (strstr(format, "%z"))
+    {
+        long off = t.tm_gmtoff;
+        ts = timegm(&t) - off;
+        return true;
+    }
+    if (utc)
+    {
+        ts = timegm(&t);
+    }
+    else
+    {
+        t.tm_isdst = -1;
+        ts = mktime(&t);
+    }
+    return true;
+}
+
+//测试用的时间戳: 随机分布, 以及各时区夏令时切换前后
+static std::vector<time_t> TestTimes()
+{
+    std::vector<time_t> rt = {0, -1, 1, 86399, 86400, 951782400, 951868800, 1234567890, 2147483647, 2147483648ll,
+                              -2147483648ll, 4102444800ll, 7258118400ll - 1};
+    std::mt19937_64 rng(99);
+    for (int i = 0; i < 20000; ++i)
+    {
+        rt.push_back((time_t)(rng() % 9400000000ull) - 2147483648ll);
+    }
+    //2024年美国和澳洲的夏令时切换时刻附近
+    for (time_t t : {1710054000ll, 1730613600ll, 1712412000ll, 1728143400ll})
+    {
+        for (int d = -7200; d <= 7200; d += 900)
+        {
+            rt.push_back(t + d);
+            rt.push_back(t + d - 1);
+        }
+    }
+    return rt;
+}
+
+static void test_format(const std::vector<time_t> &times, const char *tz)
+{
+    const char *formats[] = {
+        "%Y-%m-%d %H:%M:%S", "%F %T", "%D %R", "%y%m%d-%H%M%S", "%e/%m/%Y", "%s", "%z",
+        "%Y-%m-%dT%H:%M:%S%z", "[%Y] %% %n%t%H", "%a, %d %b %Y %H:%M:%S", "",
+    };
+    for (auto f : formats)
+    {
+        for (bool utc : {false, true})
+        {
+            sylar::TimeFormatter fmt(f, utc);
+            for (auto ts : times)
+            {
+                //%s和%z的strftime总是按本地时区, UTC格式化器不比较
+                if (utc && (strstr(f, "%s") || strstr(f, "%z")))
+                {
+                    continue;
+                }
+                std::string expect = RefFormat(ts, f, utc);
+                std::string got = fmt.format(ts);
+                SYLAR_CHECK_MSG(got == expect, "TZ=%s utc=%d format=\"%s\" ts=%lld got=\"%s\" expect=\"%s\"",
+                                tz, utc, f, (long long)ts, got.c_str(), expect.c_str());
+                //同一秒的第二次格式化走线程缓存
+                SYLAR_CHECK(fmt.format(ts) == got);
+            }
+        }
+    }
+}
+
+static void test_parse(const std::vector<time_t> &times, const char *tz)
+{
+    const char *formats[] = {"%Y-%m-%d %H:%M:%S", "%F %T", "%Y-%m-%dT%H:%M:%S%z", "%s", "%Y%m%d %H%M", "%d %b %Y %H:%M:%S"};
+    for (auto f : formats)
+    {
+        for (bool utc : {false, true})
+        {
+            if (utc && (strstr(f, "%s") || strstr(f, "%z")))
+            {
+                continue;
+            }
+            sylar::TimeFormatter fmt(f, utc);
+            for (auto ts : times)
+            {
+                std::string str = RefFormat(ts, f, utc);
+                time_t expect = 0;
+                bool expect_ok = RefParse(str, f, utc, expect);
+                //glibc的%s不接受负数, TimeFormatter可以读回strftime的输出
+                if (!expect_ok && ts < 0 && !strcmp(f, "%s"))
+                {
+                    expect_ok = true;
+                    expect = ts;
+                }
+                time_t got = 0;
+                bool ok = fmt.parse(str, got);
+                SYLAR_CHECK_MSG(ok == expect_ok, "TZ=%s utc=%d format=\"%s\" str=\"%s\" ok=%d", tz, utc, f, str.c_str(), ok);
+                //夏令时结束时重复的一小时有两个合法解释, mktime的选择取决于之前的调用, 两者都接受
+                bool ambiguous = got != expect && RefFormat(got, f, utc) == str && RefFormat(expect, f, utc) == str;
+                if (ok && expect_ok && !ambiguous)
+                {
+                    SYLAR_CHECK_MSG(got == expect, "TZ=%s utc=%d format=\"%s\" str=\"%s\" got=%lld expect=%lld",
+                                    tz, utc, f, str.c_str(), (long long)got, (long long)expect);
+                }
+            }
+        }
+    }
+}
+
+//不合法的输入与strptime一样失败
+static void test_parse_invalid()
+{
+    sylar::TimeFormatter fmt("%Y-%m-%d %H:%M:%S");
+    const char *cases[] = {
+        "", "2024", "2024-13-01 00:00:00", "2024-00-10 00:00:00", "2024-01-32 00:00:00", "2024-01-01 24:00:00",
+        "2024-01-01 00:60:00", "2024-01-01 00:00:62", "2024/01/01 00:00:00", "2024-01-01T00:00:00", "abcd-01-01 00:00:00",
+    };
+    for (auto c : cases)
+    {
+        time_t expect = 0;
+        bool expect_ok = RefParse(c, "%Y-%m-%d %H:%M:%S", false, expect);
+        time_t got = 12345;
+        bool ok = fmt.parse(c, got);
+        SYLAR_CHECK_MSG(ok == expect_ok, "str=\"%s\" ok=%d expect=%d", c, ok, expect_ok);
+    }
+    //一位数的月日和多余的后缀与strptime一致
+    for (const char *c : {"2024-1-5 3:04:05", "2024-01-05 03:04:05.123", " 2024-01-05 03:04:05", "2024-12-31 23:59:60", "2024-12-31 23:59:61"})
+    {
+        time_t expect = 0;
+        bool expect_ok = RefParse(c, "%Y-%m-%d %H:%M:%S", false, expect);
+        time_t got = 0;
+        bool ok = fmt.parse(c, got);
+        SYLAR_CHECK_MSG(ok == expect_ok && (!ok || got == expect), "str=\"%s\" ok=%d expect=%d", c, ok, expect_ok);
+    }
+}
+
+int main()
+{
+    std::vector<time_t> times = TestTimes();
+    for (const char *tz : {"UTC0", "Asia/Shanghai", "America/New_York", "Australia/Lord_Howe", "Asia/Kathmandu"})
+    {
+        SetTimezone(tz);
+        test_format(times, tz);
+        test_parse(times, tz);
+        test_parse_invalid();
+    }
+    return sylar::test::Result("test_time_formatter");
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+//测试程序公用的检查宏
+#ifndef __SYLAR_TESTS_TEST_UTIL_H__
+#define __SYLAR_TESTS_TEST_UTIL_H__
+
+#include <stdio.h>
+
+namespace sylar
+{
+    namespace test
+    {
+
+        //失败的检查数
+        inline int &FailCount()
+        {
+            static int s_count = 0;
+            return s_count;
+        }
+
+        //输出测试结果, 返回值作为main的退出码
+        inline int Result(const char *name)
+        {
+            if (FailCount())
+            {
+                printf("%s: %d check(s) failed\n", name, FailCount());
+                return 1;
+            }
+            printf("%s: ok\n", name);
+            return 0;
+        }
+
+    }
+}
+
+//检查失败时输出位置和表达式, 继续执行后面的检查
+#define SYLAR_CHECK(cond)                                                              \
+    do                                                                                 \
+    {                                                                                  \
+        if (!(cond))                                                                   \
+        {                                                                              \
+            ++sylar::test::FailCount();                                                \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        }                                                                              \
+    } while (0)
+
+//同SYLAR_CHECK, 失败时额外输出printf格式的上下文(如出错的输入)
+#define SYLAR_CHECK_MSG(cond, ...)                                                     \
+    do                                                                                 \
+    {                                                                                  \
+        if (!(cond))                                                                   \
+        {                                                                              \
+            ++sylar::test::FailCount();                                                \
+            fprintf(stderr, "%s:%d: check failed: %s: ", __FILE__, __LINE__, #cond); \
+            fprintf(stderr, __VA_ARGS__);                                              \
+            fputc('\n', stderr);                                                       \
+        }                                                                              \
+    } while (0)
+
+#endif
\ No newline at end of file